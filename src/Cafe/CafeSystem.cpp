@@ -22,6 +22,7 @@
 #include "Cafe/OS/libs/snd_core/ax.h"
 #include "Cafe/OS/RPL/rpl.h"
 #include "Cafe/HW/Latte/Core/Latte.h"
+#include "Cafe/HW/MMU/MemoryWriteTracker.h"
 #include "Cafe/Filesystem/FST/FST.h"
 #include "Common/FileStream.h"
 #include "GamePatch.h"
@@ -244,6 +245,8 @@ void InfoLog_PrintActiveSettings()
 	cemuLog_log(LogType::Force, "Load shared libraries: {}{}", ActiveSettings::LoadSharedLibrariesEnabled() ? "true" : "false", g_current_game_profile->ShouldLoadSharedLibraries().has_value() ? " (gameprofile)" : "");
 	cemuLog_log(LogType::Force, "Use precompiled shaders: {}{}", fmt::format("{}", ActiveSettings::GetPrecompiledShadersOption()), g_current_game_profile->GetPrecompiledShadersState().has_value() ? " (gameprofile)" : "");
 	cemuLog_log(LogType::Force, "Full sync at GX2DrawDone: {}", ActiveSettings::WaitForGX2DrawDoneEnabled() ? "true" : "false");
+	cemuLog_log(LogType::Force, "Page write tracking: {}", ActiveSettings::PageWriteTrackingEnabled() ? "true" : "false");
+	cemuLog_log(LogType::Force, "GPU command pre-decoding: {}", ActiveSettings::GPUCommandPreDecodingEnabled() ? "true" : "false");
 	cemuLog_log(LogType::Force, "Strict shader mul: {}", g_current_game_profile->GetAccurateShaderMul() == AccurateShaderMulOption::True ? "true" : "false");
 	if (ActiveSettings::GetGraphicsAPI() == GraphicAPI::kVulkan)
 	{
@@ -409,6 +412,8 @@ void cemu_initForGame()
 	}
 	LatteGPUState.isDRCPrimary = ActiveSettings::DisplayDRCEnabled();
 	InfoLog_PrintActiveSettings();
+	if (ActiveSettings::PageWriteTrackingEnabled())
+		MemoryWriteTracker_Enable();
 	Latte_Start();
 	// check for debugger entrypoint bp
     if (g_gdbstub)
@@ -420,6 +425,8 @@ void cemu_initForGame()
 	// load graphic packs
 	cemuLog_log(LogType::Force, "------- Activate graphic packs -------");
 	GraphicPack2::ActivateForCurrentTitle();
+	// queue functions recompiled in previous sessions, this needs to happen after all code patches are applied
+	PPCRecompilerCache_Open(CafeSystem::GetForegroundTitleId());
 	// print audio log
 	IAudioAPI::PrintLogging();
 	IAudioInputAPI::PrintLogging();
@@ -830,6 +837,7 @@ namespace CafeSystem
 
     void DestroyMemorySpace()
     {
+        MemoryWriteTracker_Disable();
         memory_unmapForCurrentTitle();
     }
 
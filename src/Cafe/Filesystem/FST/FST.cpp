@@ -3,6 +3,7 @@
 #include "Cemu/ncrypto/ncrypto.h"
 #include "Cafe/Filesystem/WUD/wud.h"
 #include "util/crypto/aes128.h"
+#include "util/helpers/helpers.h"
 #include "openssl/sha.h" /* SHA1 / SHA256 */
 #include "fstUtil.h"
 
@@ -693,6 +694,7 @@ bool FSTVolume::OpenFile(std::string_view path, FSTFileHandle& fileHandleOut, bo
 		// empty path pointers to root directory
 		if(openOnlyFiles)
 			return false;
+		fileHandleOut = {};
 		fileHandleOut.m_fstIndex = 0;
 		return true;
 	}
@@ -739,6 +741,7 @@ bool FSTVolume::OpenFile(std::string_view path, FSTFileHandle& fileHandleOut, bo
 		return false;
 	if (openOnlyFiles && m_entries[fstIndex].GetType() != FSTEntry::TYPE::FILE)
 		return false;
+	fileHandleOut = {};
 	fileHandleOut.m_fstIndex = fstIndex;
 	return true;
 }
@@ -807,6 +810,14 @@ uint32 FSTVolume::GetFileSize(const FSTFileHandle& fileHandle) const
 	return m_entries[fileHandle.m_fstIndex].fileInfo.fileSize;
 }
 
+constexpr size_t BLOCK_SIZE = 0x10000;
+constexpr size_t BLOCK_HASH_SIZE = 0x0400;
+constexpr size_t BLOCK_FILE_SIZE = 0xFC00;
+
+constexpr uint32 READ_AHEAD_NUM_BLOCKS = 8; // how many blocks are decrypted ahead of a sequential read
+constexpr uint32 READ_AHEAD_MAX_THREADS = 4;
+constexpr uint32 READ_AHEAD_BATCH_SIZE = 4; // number of blocks a read-ahead thread takes at once, they are read from the data source together
+
 uint32 FSTVolume::ReadFile(FSTFileHandle& fileHandle, uint32 offset, uint32 size, void* dataOut)
 {
 	FSTEntry& entry = m_entries[fileHandle.m_fstIndex];
@@ -814,6 +825,22 @@ uint32 FSTVolume::ReadFile(FSTFileHandle& fileHandle, uint32 offset, uint32 size
 		return 0;
 	cemu_assert_debug(!HAS_FLAG(entry.GetFlags(), FSTEntry::FLAGS::FLAG_LINK));
 	FSTCluster& cluster = m_cluster[entry.fileInfo.clusterIndex];
+	// if the file is read sequentially then decrypt the blocks following the requested range on the read-ahead threads
+	// the second sequential read is the earliest point at which we start reading ahead, this avoids wasting work on small files which are read only once
+	if (offset == fileHandle.m_nextReadOffset)
+		fileHandle.m_sequentialReadCount++;
+	else
+		fileHandle.m_sequentialReadCount = 0;
+	fileHandle.m_nextReadOffset = offset + size;
+	if (fileHandle.m_sequentialReadCount >= 2 && offset + size < entry.fileInfo.fileSize)
+	{
+		uint64 readAheadStart = (uint64)entry.fileInfo.fileOffset * m_offsetFactor + offset + size;
+		uint64 fileEnd = (uint64)entry.fileInfo.fileOffset * m_offsetFactor + entry.fileInfo.fileSize;
+		uint64 blockDataSize = cluster.hashMode == ClusterHashMode::HASH_INTERLEAVED ? BLOCK_FILE_SIZE : m_sectorSize;
+		uint32 firstBlockIndex = (uint32)(readAheadStart / blockDataSize);
+		uint32 lastBlockIndex = std::min<uint32>((uint32)((fileEnd - 1) / blockDataSize), firstBlockIndex + READ_AHEAD_NUM_BLOCKS - 1);
+		QueueReadAhead(entry.fileInfo.clusterIndex, firstBlockIndex, lastBlockIndex);
+	}
 	if (cluster.hashMode == ClusterHashMode::RAW || cluster.hashMode == ClusterHashMode::RAW_STREAM)
 		return ReadFile_HashModeRaw(entry.fileInfo.clusterIndex, entry, offset, size, dataOut);
 	else if (cluster.hashMode == ClusterHashMode::HASH_INTERLEAVED)
@@ -822,15 +849,6 @@ uint32 FSTVolume::ReadFile(FSTFileHandle& fileHandle, uint32 offset, uint32 size
 	return 0;
 }
 
-constexpr size_t BLOCK_SIZE = 0x10000;
-constexpr size_t BLOCK_HASH_SIZE = 0x0400;
-constexpr size_t BLOCK_FILE_SIZE = 0xFC00;
-
-struct FSTRawBlock
-{
-	std::vector<uint8> rawData; // unhashed block size depends on sector size field in partition header
-};
-
 struct FSTHashedBlock
 {
 	uint8 rawData[BLOCK_SIZE];
@@ -872,209 +890,320 @@ struct FSTHashedBlock
 
 static_assert(sizeof(FSTHashedBlock) == BLOCK_SIZE);
 
-struct FSTCachedRawBlock
+// a decrypted block of a raw or hashed cluster
+// blocks are created in the QUEUED state and become visible in the cache immediately, so that a reader which requests
+// a block that is still being decrypted by a read-ahead thread waits for it instead of decrypting it a second time
+struct FSTCachedBlock
 {
-	FSTRawBlock blockData;
-	NCrypto::AesIv ivForNextBlock;
-	uint64 lastAccess;
+	enum class STATE : uint8
+	{
+		QUEUED, // waiting for a read-ahead thread
+		DECRYPTING,
+		READY,
+		FAILED,
+	};
+
+	uint32 clusterIndex;
+	uint32 blockIndex;
+	STATE state{STATE::QUEUED};
+	bool isHashed; // if true, data holds a FSTHashedBlock
+	bool isReadAhead{false}; // queued by read-ahead and not yet handed to a reader, counted in m_readAheadPendingSize
+	std::vector<uint8> data;
+	std::list<FSTCachedBlock*>::iterator lruItr;
+
+	FSTHashedBlock* GetHashedBlock()
+	{
+		cemu_assert_debug(isHashed && data.size() == sizeof(FSTHashedBlock));
+		return (FSTHashedBlock*)data.data();
+	}
 };
 
-struct FSTCachedHashedBlock 
+static uint64 _GetCacheBlockId(uint32 clusterIndex, uint32 blockIndex)
 {
-	FSTHashedBlock blockData;
-	uint64 lastAccess;
-};
+	return ((uint64)clusterIndex << (64 - 16)) | (uint64)blockIndex;
+}
 
-// Checks cache fill state and if necessary drops least recently accessed block from the cache. Optionally allows to recycle the released cache entry to cut down cost of memory allocation and clearing
-void FSTVolume::TrimCacheIfRequired(FSTCachedRawBlock** droppedRawBlock, FSTCachedHashedBlock** droppedHashedBlock)
+void FSTVolume::SetBlockCacheBudget(size_t budgetInBytes)
 {
-	// calculate size used by cache
-	size_t cacheSize = 0;
-	for (auto& itr : m_cacheDecryptedRawBlocks)
-		cacheSize += itr.second->blockData.rawData.size();
-	for (auto& itr : m_cacheDecryptedHashedBlocks)
-		cacheSize += sizeof(FSTCachedHashedBlock) + sizeof(FSTHashedBlock);
-	// only trim if cache is full (larger than 2MB)
-	if (cacheSize < 2*1024*1024) // 2MB
-		return;
-	// scan both cache lists to find least recently accessed block to drop
-	auto dropRawItr = std::min_element(m_cacheDecryptedRawBlocks.begin(), m_cacheDecryptedRawBlocks.end(), [](const auto& a, const auto& b) -> bool
-										{ return a.second->lastAccess < b.second->lastAccess; });
-	auto dropHashedItr = std::min_element(m_cacheDecryptedHashedBlocks.begin(), m_cacheDecryptedHashedBlocks.end(), [](const auto& a, const auto& b) -> bool
-										{ return a.second->lastAccess < b.second->lastAccess; });
-	uint64 lastAccess = std::numeric_limits<uint64>::max();
-	if(dropRawItr != m_cacheDecryptedRawBlocks.end())
-		lastAccess = dropRawItr->second->lastAccess;
-	if(dropHashedItr != m_cacheDecryptedHashedBlocks.end())
-		lastAccess = std::min<uint64>(lastAccess, dropHashedItr->second->lastAccess);
-	if(dropRawItr != m_cacheDecryptedRawBlocks.end() && dropRawItr->second->lastAccess == lastAccess)
-	{
-		if (droppedRawBlock)
-			*droppedRawBlock = dropRawItr->second;
-		else
-			delete dropRawItr->second;
-		m_cacheDecryptedRawBlocks.erase(dropRawItr);
-		return;
-	}
-	else if(dropHashedItr != m_cacheDecryptedHashedBlocks.end() && dropHashedItr->second->lastAccess == lastAccess)
+	std::unique_lock _l(m_cacheMutex);
+	m_blockCacheBudget = budgetInBytes;
+	TrimCacheIfRequired();
+}
+
+// drop least recently accessed blocks until the cache fits into the memory budget. Blocks which are still queued or being decrypted are kept
+// m_cacheMutex must be held
+void FSTVolume::TrimCacheIfRequired()
+{
+	auto itr = m_blockCacheLRU.end();
+	while (m_blockCacheSize > m_blockCacheBudget && itr != m_blockCacheLRU.begin())
 	{
-		if (droppedHashedBlock)
-			*droppedHashedBlock = dropHashedItr->second;
-		else
-			delete dropHashedItr->second;
-		m_cacheDecryptedHashedBlocks.erase(dropHashedItr);
+		--itr;
+		FSTCachedBlock* block = *itr;
+		if (block->state == FSTCachedBlock::STATE::QUEUED || block->state == FSTCachedBlock::STATE::DECRYPTING)
+			continue;
+		itr = m_blockCacheLRU.erase(itr);
+		m_blockCacheSize -= block->data.size();
+		ReleaseReadAheadBlock(block);
+		m_blockCache.erase(_GetCacheBlockId(block->clusterIndex, block->blockIndex)); // releases the block unless a reader still holds a reference
 	}
 }
 
-void FSTVolume::DetermineUnhashedBlockIV(uint32 clusterIndex, uint32 blockIndex, NCrypto::AesIv& ivOut)
+// m_cacheMutex must be held
+std::shared_ptr<FSTCachedBlock> FSTVolume::CreateCachedBlock(uint32 clusterIndex, uint32 blockIndex)
+{
+	TrimCacheIfRequired();
+	auto block = std::make_shared<FSTCachedBlock>();
+	block->clusterIndex = clusterIndex;
+	block->blockIndex = blockIndex;
+	block->isHashed = m_cluster[clusterIndex].hashMode == ClusterHashMode::HASH_INTERLEAVED;
+	block->data.resize(block->isHashed ? BLOCK_SIZE : m_sectorSize);
+	m_blockCacheLRU.emplace_front(block.get());
+	block->lruItr = m_blockCacheLRU.begin();
+	m_blockCacheSize += block->data.size();
+	m_blockCache.emplace(_GetCacheBlockId(clusterIndex, blockIndex), block);
+	return block;
+}
+
+// m_cacheMutex must be held
+void FSTVolume::RemoveCachedBlock(FSTCachedBlock* block)
 {
-	ivOut = {};
-	if(blockIndex == 0)
+	auto itr = m_blockCache.find(_GetCacheBlockId(block->clusterIndex, block->blockIndex));
+	if (itr == m_blockCache.end() || itr->second.get() != block)
+		return;
+	m_blockCacheLRU.erase(block->lruItr);
+	m_blockCacheSize -= block->data.size();
+	ReleaseReadAheadBlock(block);
+	m_blockCache.erase(itr);
+}
+
+// stop counting a block towards the read-ahead limit once it was consumed or evicted
+// m_cacheMutex must be held
+void FSTVolume::ReleaseReadAheadBlock(FSTCachedBlock* block)
+{
+	if (!block->isReadAhead)
+		return;
+	block->isReadAhead = false;
+	cemu_assert_debug(m_readAheadPendingSize >= block->data.size());
+	m_readAheadPendingSize -= block->data.size();
+}
+
+// reads and decrypts a set of blocks, the result for each block is written to successOut
+// called without holding m_cacheMutex, so this can run on multiple threads in parallel. Only reading from the data source is serialized
+void FSTVolume::ReadAndDecryptBlocks(std::span<FSTCachedBlock* const> blocks, bool* successOut)
+{
+	cemu_assert_debug(blocks.size() <= READ_AHEAD_BATCH_SIZE);
+	NCrypto::AesIv rawIVs[READ_AHEAD_BATCH_SIZE]{};
+	// read encrypted data
 	{
-		ivOut.iv[0] = (uint8)(clusterIndex >> 8);
-		ivOut.iv[1] = (uint8)(clusterIndex >> 0);
+		std::unique_lock _l(m_dataSourceMutex);
+		for (size_t i = 0; i < blocks.size(); i++)
+		{
+			FSTCachedBlock& block = *blocks[i];
+			uint64 clusterOffset = (uint64)m_cluster[block.clusterIndex].offset * m_sectorSize;
+			successOut[i] = false;
+			if (block.isHashed)
+			{
+				if (m_dataSource->readData(block.clusterIndex, clusterOffset, (uint64)block.blockIndex * BLOCK_SIZE, block.data.data(), BLOCK_SIZE) != BLOCK_SIZE)
+				{
+					cemuLog_log(LogType::Force, "Failed to read hashed FST block");
+					continue;
+				}
+				successOut[i] = true;
+				continue;
+			}
+			if (m_dataSource->readData(block.clusterIndex, clusterOffset, (uint64)block.blockIndex * m_sectorSize, block.data.data(), m_sectorSize) != m_sectorSize)
+			{
+				cemuLog_log(LogType::Force, "Failed to read raw FST block");
+				continue;
+			}
+			// the IV is the zero-padded cluster index for the first block, for all other blocks it's the last 16 encrypted bytes of the previous block (AES CBC)
+			if (block.blockIndex == 0)
+			{
+				rawIVs[i].iv[0] = (uint8)(block.clusterIndex >> 8);
+				rawIVs[i].iv[1] = (uint8)(block.clusterIndex >> 0);
+			}
+			else
+			{
+				cemu_assert(m_sectorSize >= NCrypto::AesIv::SIZE);
+				if (m_dataSource->readData(block.clusterIndex, clusterOffset, (uint64)block.blockIndex * m_sectorSize - NCrypto::AesIv::SIZE, rawIVs[i].iv, NCrypto::AesIv::SIZE) != NCrypto::AesIv::SIZE)
+				{
+					cemuLog_log(LogType::Force, "Failed to read IV for raw FST block");
+					continue;
+				}
+			}
+			successOut[i] = true;
+		}
 	}
-	else
+	// decrypt raw blocks. For hashed blocks decrypt the hash data first, it contains the IV of the file data
+	for (size_t i = 0; i < blocks.size(); i++)
 	{
-		// the last 16 encrypted bytes of the previous block are the IV (AES CBC)
-		// if the previous block is cached we can grab the IV from there. Otherwise we have to read the 16 bytes from the data source
-		uint32 prevBlockIndex = blockIndex - 1;
-		uint64 cacheBlockId = ((uint64)clusterIndex << (64 - 16)) | (uint64)prevBlockIndex;
-		auto itr = m_cacheDecryptedRawBlocks.find(cacheBlockId);
-		if (itr != m_cacheDecryptedRawBlocks.end())
+		if (!successOut[i])
+			continue;
+		FSTCachedBlock& block = *blocks[i];
+		if (!block.isHashed)
 		{
-			ivOut = itr->second->ivForNextBlock;
+			AES128_CBC_decrypt(block.data.data(), block.data.data(), m_sectorSize, m_partitionTitlekey.b, rawIVs[i].iv);
+			continue;
 		}
-		else
+		FSTHashedBlock* hashedBlock = block.GetHashedBlock();
+		AES128_CBC_decrypt(hashedBlock->getHashData(), hashedBlock->getHashData(), BLOCK_HASH_SIZE, m_partitionTitlekey.b, nullptr);
+		AES128_CBC_decrypt(hashedBlock->getFileData(), hashedBlock->getFileData(), BLOCK_FILE_SIZE, m_partitionTitlekey.b, hashedBlock->getH0Hash(block.blockIndex % 16));
+	}
+	// compare with H0 to verify data integrity
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		if (!successOut[i] || !blocks[i]->isHashed)
+			continue;
+		FSTHashedBlock* hashedBlock = blocks[i]->GetHashedBlock();
+		NCrypto::CHash160 h0;
+		SHA1(hashedBlock->getFileData(), BLOCK_FILE_SIZE, h0.b);
+		uint32 h0Index = (blocks[i]->blockIndex % 4096);
+		if (memcmp(h0.b, hashedBlock->getH0Hash(h0Index & 0xF), sizeof(h0.b)) != 0)
 		{
-			cemu_assert(m_sectorSize >= NCrypto::AesIv::SIZE);
-			uint64 clusterOffset = (uint64)m_cluster[clusterIndex].offset * m_sectorSize;
-			NCrypto::AesIv prevIV{};
-			if (m_dataSource->readData(clusterIndex, clusterOffset, blockIndex * m_sectorSize - NCrypto::AesIv::SIZE, prevIV.iv, NCrypto::AesIv::SIZE) != NCrypto::AesIv::SIZE)
-			{
-				cemuLog_log(LogType::Force, "Failed to read IV for raw FST block");
-				m_detectedCorruption = true;
-				return;
-			}
-			ivOut = prevIV;
+			cemuLog_log(LogType::Force, "FST: Hash H0 mismatch in hashed block (section {} index {})", blocks[i]->clusterIndex, blocks[i]->blockIndex);
+			successOut[i] = false;
 		}
 	}
 }
 
-FSTCachedRawBlock* FSTVolume::GetDecryptedRawBlock(uint32 clusterIndex, uint32 blockIndex)
+// the content hash of raw clusters covers the whole cluster and has to be calculated in block order
+// blocks are hashed when they are first handed to a reader, blocks which are not accessed in order are not verified
+// m_cacheMutex must be held
+bool FSTVolume::VerifyRawBlockContentHash(uint32 clusterIndex, uint32 blockIndex, const FSTCachedBlock& block)
 {
 	FSTCluster& cluster = m_cluster[clusterIndex];
-	uint64 clusterOffset = (uint64)cluster.offset * m_sectorSize;
-	// generate id for cache
-	uint64 cacheBlockId = ((uint64)clusterIndex << (64 - 16)) | (uint64)blockIndex;
-	// lookup block in cache
-	FSTCachedRawBlock* block = nullptr;
-	auto itr = m_cacheDecryptedRawBlocks.find(cacheBlockId);
-	if (itr != m_cacheDecryptedRawBlocks.end())
+	if (!cluster.hasContentHash || cluster.singleHashNumBlocksHashed != blockIndex)
+		return true;
+	cemu_assert_debug(!(cluster.contentSize % m_sectorSize)); // size should be multiple of sector size? Regardless, the hashing code below can handle non-aligned sizes
+	bool isLastBlock = blockIndex == (std::max<uint32>(cluster.contentSize / m_sectorSize, 1) - 1);
+	uint32 hashSize = m_sectorSize;
+	if(isLastBlock)
+		hashSize = cluster.contentSize - (uint64)blockIndex*m_sectorSize;
+	EVP_DigestUpdate(cluster.singleHashCtx.get(), block.data.data(), hashSize);
+	cluster.singleHashNumBlocksHashed++;
+	if(isLastBlock)
 	{
-		block = itr->second;
-		block->lastAccess = ++m_cacheAccessCounter;
-		return block;
-	}
-	// if cache already full, drop least recently accessed block and recycle FSTCachedRawBlock object if possible
-	TrimCacheIfRequired(&block, nullptr);
-	if (!block)
-		block = new FSTCachedRawBlock();
-	block->blockData.rawData.resize(m_sectorSize);
-	// block not cached, read new
-	block->lastAccess = ++m_cacheAccessCounter;
-	if (m_dataSource->readData(clusterIndex, clusterOffset, blockIndex * m_sectorSize, block->blockData.rawData.data(), m_sectorSize) != m_sectorSize)
-	{
-		cemuLog_log(LogType::Force, "Failed to read raw FST block");
-		delete block;
-		m_detectedCorruption = true;
-		return nullptr;
-	}
-	// decrypt hash data
-	NCrypto::AesIv iv{};
-	DetermineUnhashedBlockIV(clusterIndex, blockIndex, iv);
-	std::copy(block->blockData.rawData.data() + m_sectorSize - NCrypto::AesIv::SIZE, block->blockData.rawData.data() + m_sectorSize, block->ivForNextBlock.iv);
-	AES128_CBC_decrypt(block->blockData.rawData.data(), block->blockData.rawData.data(), m_sectorSize, m_partitionTitlekey.b, iv.iv);
-	// if this is the next block, then hash it
-	if(cluster.hasContentHash)
-	{
-		if(cluster.singleHashNumBlocksHashed == blockIndex)
+		uint8 hash[32];
+		EVP_DigestFinal_ex(cluster.singleHashCtx.get(), hash, nullptr);
+		if(memcmp(hash, cluster.contentHash32, cluster.contentHashIsSHA1 ? 20 : 32) != 0)
 		{
-			cemu_assert_debug(!(cluster.contentSize % m_sectorSize)); // size should be multiple of sector size? Regardless, the hashing code below can handle non-aligned sizes
-			bool isLastBlock = blockIndex == (std::max<uint32>(cluster.contentSize / m_sectorSize, 1) - 1);
-			uint32 hashSize = m_sectorSize;
-			if(isLastBlock)
-				hashSize = cluster.contentSize - (uint64)blockIndex*m_sectorSize;
-			EVP_DigestUpdate(cluster.singleHashCtx.get(), block->blockData.rawData.data(), hashSize);
-			cluster.singleHashNumBlocksHashed++;
-			if(isLastBlock)
-			{
-				uint8 hash[32];
-				EVP_DigestFinal_ex(cluster.singleHashCtx.get(), hash, nullptr);
-				if(memcmp(hash, cluster.contentHash32, cluster.contentHashIsSHA1 ? 20 : 32) != 0)
-				{
-					cemuLog_log(LogType::Force, "FST: Raw section hash mismatch");
-					delete block;
-					m_detectedCorruption = true;
-					return nullptr;
-				}
-			}
+			cemuLog_log(LogType::Force, "FST: Raw section hash mismatch");
+			return false;
 		}
 	}
-	// register in cache
-	m_cacheDecryptedRawBlocks.emplace(cacheBlockId, block);
-	return block;
+	return true;
 }
 
-FSTCachedHashedBlock* FSTVolume::GetDecryptedHashedBlock(uint32 clusterIndex, uint32 blockIndex)
+std::shared_ptr<FSTCachedBlock> FSTVolume::GetDecryptedBlock(uint32 clusterIndex, uint32 blockIndex)
 {
-	const FSTCluster& cluster = m_cluster[clusterIndex];
-	uint64 clusterOffset = (uint64)cluster.offset * m_sectorSize;
-	// generate id for cache
-	uint64 cacheBlockId = ((uint64)clusterIndex << (64 - 16)) | (uint64)blockIndex;
-	// lookup block in cache
-	FSTCachedHashedBlock* block = nullptr;
-	auto itr = m_cacheDecryptedHashedBlocks.find(cacheBlockId);
-	if (itr != m_cacheDecryptedHashedBlocks.end())
+	std::unique_lock _l(m_cacheMutex);
+	std::shared_ptr<FSTCachedBlock> block;
+	auto itr = m_blockCache.find(_GetCacheBlockId(clusterIndex, blockIndex));
+	if (itr != m_blockCache.end())
 	{
 		block = itr->second;
-		block->lastAccess = ++m_cacheAccessCounter;
-		return block;
+		m_blockCacheLRU.splice(m_blockCacheLRU.begin(), m_blockCacheLRU, block->lruItr);
+		ReleaseReadAheadBlock(block.get());
 	}
-	// if cache already full, drop least recently accessed block and recycle FSTCachedHashedBlock object if possible
-	TrimCacheIfRequired(nullptr, &block);
-	if (!block)
-		block = new FSTCachedHashedBlock();
-	// block not cached, read new
-	block->lastAccess = ++m_cacheAccessCounter;
-	if (m_dataSource->readData(clusterIndex, clusterOffset, blockIndex * BLOCK_SIZE, block->blockData.rawData, BLOCK_SIZE) != BLOCK_SIZE)
-	{
-		cemuLog_log(LogType::Force, "Failed to read hashed FST block");
-		delete block;
-		m_detectedCorruption = true;
-		return nullptr;
+	else
+		block = CreateCachedBlock(clusterIndex, blockIndex);
+	if (block->state == FSTCachedBlock::STATE::QUEUED)
+	{
+		// not picked up by a read-ahead thread yet, decrypt it on the calling thread
+		block->state = FSTCachedBlock::STATE::DECRYPTING;
+		_l.unlock();
+		FSTCachedBlock* blockPtr = block.get();
+		bool success;
+		ReadAndDecryptBlocks({ &blockPtr, 1 }, &success);
+		_l.lock();
+		block->state = success ? FSTCachedBlock::STATE::READY : FSTCachedBlock::STATE::FAILED;
+		m_cacheBlockReadyCondVar.notify_all();
 	}
-	// decrypt hash data
-	uint8 iv[16]{};
-	AES128_CBC_decrypt(block->blockData.getHashData(), block->blockData.getHashData(), BLOCK_HASH_SIZE, m_partitionTitlekey.b, iv);
-	// decrypt file data
-	AES128_CBC_decrypt(block->blockData.getFileData(), block->blockData.getFileData(), BLOCK_FILE_SIZE, m_partitionTitlekey.b, block->blockData.getH0Hash(blockIndex%16));
-	// compare with H0 to verify data integrity
-	NCrypto::CHash160 h0;
-	SHA1(block->blockData.getFileData(), BLOCK_FILE_SIZE, h0.b);
-	uint32 h0Index = (blockIndex % 4096);
-	if (memcmp(h0.b, block->blockData.getH0Hash(h0Index & 0xF), sizeof(h0.b)) != 0)
+	else if (block->state == FSTCachedBlock::STATE::DECRYPTING)
 	{
-		cemuLog_log(LogType::Force, "FST: Hash H0 mismatch in hashed block (section {} index {})", clusterIndex, blockIndex);
-		delete block;
+		m_cacheBlockReadyCondVar.wait(_l, [&block]() { return block->state != FSTCachedBlock::STATE::DECRYPTING; });
+	}
+	if (block->state == FSTCachedBlock::STATE::READY && !block->isHashed && !VerifyRawBlockContentHash(clusterIndex, blockIndex, *block))
+		block->state = FSTCachedBlock::STATE::FAILED;
+	if (block->state == FSTCachedBlock::STATE::FAILED)
+	{
+		RemoveCachedBlock(block.get());
 		m_detectedCorruption = true;
 		return nullptr;
 	}
-	// register in cache
-	m_cacheDecryptedHashedBlocks.emplace(cacheBlockId, block);
 	return block;
 }
 
+void FSTVolume::QueueReadAhead(uint32 clusterIndex, uint32 firstBlockIndex, uint32 lastBlockIndex)
+{
+	std::unique_lock _l(m_cacheMutex);
+	// every pending read-ahead block is in the cache, if this doesn't hold then the counter leaked and read-ahead would eventually stay disabled
+	cemu_assert_debug(m_readAheadPendingSize <= m_blockCacheSize);
+	bool hasNewBlocks = false;
+	for (uint32 blockIndex = firstBlockIndex; blockIndex <= lastBlockIndex; blockIndex++)
+	{
+		// blocks which were read ahead but not consumed yet may take up at most half of the cache budget
+		// consumed blocks don't count, they are evicted in LRU order to make room for new read-ahead blocks
+		if (m_readAheadPendingSize >= m_blockCacheBudget / 2)
+			break;
+		if (m_blockCache.find(_GetCacheBlockId(clusterIndex, blockIndex)) != m_blockCache.end())
+			continue;
+		std::shared_ptr<FSTCachedBlock> block = CreateCachedBlock(clusterIndex, blockIndex);
+		block->isReadAhead = true;
+		m_readAheadPendingSize += block->data.size();
+		m_readAheadQueue.emplace_back(std::move(block));
+		hasNewBlocks = true;
+	}
+	if (!hasNewBlocks)
+		return;
+	if (m_readAheadThreads.empty())
+	{
+		uint32 numThreads = std::clamp<uint32>(std::thread::hardware_concurrency() / 2, 1, READ_AHEAD_MAX_THREADS);
+		for (uint32 i = 0; i < numThreads; i++)
+			m_readAheadThreads.emplace_back(&FSTVolume::ReadAheadThread, this);
+	}
+	m_readAheadCondVar.notify_all();
+}
+
+void FSTVolume::ReadAheadThread()
+{
+	SetThreadName("FSTReadAhead");
+	std::shared_ptr<FSTCachedBlock> batch[READ_AHEAD_BATCH_SIZE];
+	FSTCachedBlock* batchPtrs[READ_AHEAD_BATCH_SIZE];
+	bool batchResults[READ_AHEAD_BATCH_SIZE];
+	std::unique_lock _l(m_cacheMutex);
+	while (true)
+	{
+		m_readAheadCondVar.wait(_l, [this]() { return m_readAheadThreadsStop || !m_readAheadQueue.empty(); });
+		if (m_readAheadThreadsStop)
+			return;
+		// take multiple blocks at once so they can be read from the data source in one go
+		size_t batchSize = 0;
+		while (batchSize < READ_AHEAD_BATCH_SIZE && !m_readAheadQueue.empty())
+		{
+			std::shared_ptr<FSTCachedBlock> block = std::move(m_readAheadQueue.front());
+			m_readAheadQueue.pop_front();
+			if (block->state != FSTCachedBlock::STATE::QUEUED)
+				continue; // a reader got to it first
+			block->state = FSTCachedBlock::STATE::DECRYPTING;
+			batchPtrs[batchSize] = block.get();
+			batch[batchSize] = std::move(block);
+			batchSize++;
+		}
+		if (batchSize == 0)
+			continue;
+		_l.unlock();
+		ReadAndDecryptBlocks({ batchPtrs, batchSize }, batchResults);
+		_l.lock();
+		for (size_t i = 0; i < batchSize; i++)
+		{
+			batch[i]->state = batchResults[i] ? FSTCachedBlock::STATE::READY : FSTCachedBlock::STATE::FAILED;
+			batch[i].reset();
+		}
+		m_cacheBlockReadyCondVar.notify_all();
+	}
+}
+
 uint32 FSTVolume::ReadFile_HashModeRaw(uint32 clusterIndex, FSTEntry& entry, uint32 readOffset, uint32 readSize, void* dataOut)
 {
 	uint8* dataOutU8 = (uint8*)dataOut;
@@ -1086,12 +1215,12 @@ uint32 FSTVolume::ReadFile_HashModeRaw(uint32 clusterIndex, FSTEntry& entry, uin
 	uint32 remainingReadSize = readSize;
 	while (remainingReadSize > 0)
 	{
-		const FSTCachedRawBlock* rawBlock = this->GetDecryptedRawBlock(clusterIndex, absFileOffset/m_sectorSize);
+		std::shared_ptr<FSTCachedBlock> rawBlock = GetDecryptedBlock(clusterIndex, (uint32)(absFileOffset/m_sectorSize));
 		if (!rawBlock)
 			break;
 		uint32 blockOffset = (uint32)(absFileOffset % m_sectorSize);
 		uint32 bytesToRead = std::min<uint32>(remainingReadSize, m_sectorSize - blockOffset);
-		std::memcpy(dataOutU8, rawBlock->blockData.rawData.data() + blockOffset, bytesToRead);
+		std::memcpy(dataOutU8, rawBlock->data.data() + blockOffset, bytesToRead);
 		dataOutU8 += bytesToRead;
 		remainingReadSize -= bytesToRead;
 		absFileOffset += bytesToRead;
@@ -1135,11 +1264,11 @@ uint32 FSTVolume::ReadFile_HashModeHashed(uint32 clusterIndex, FSTEntry& entry,
 	uint32 offsetWithinBlock = (uint32)(fileReadOffset % BLOCK_FILE_SIZE);
 	while (bytesRemaining > 0)
 	{
-		FSTCachedHashedBlock* block = GetDecryptedHashedBlock(clusterIndex, blockIndex);
+		std::shared_ptr<FSTCachedBlock> block = GetDecryptedBlock(clusterIndex, blockIndex);
 		if (!block)
 			return 0;
 		uint32 bytesToRead = std::min(bytesRemaining, (uint32)BLOCK_FILE_SIZE - offsetWithinBlock);
-		std::memcpy(dataOut, block->blockData.getFileData() + offsetWithinBlock, bytesToRead);
+		std::memcpy(dataOut, block->GetHashedBlock()->getFileData() + offsetWithinBlock, bytesToRead);
 		dataOut = (uint8*)dataOut + bytesToRead;
 		bytesRemaining -= bytesToRead;
 		blockIndex++;
@@ -1168,6 +1297,7 @@ bool FSTVolume::Next(FSTDirectoryIterator& directoryIterator, FSTFileHandle& fil
 	if (directoryIterator.currentIndex >= directoryIterator.endIndex)
 		return false;
 	auto const& fstEntry = m_entries[directoryIterator.currentIndex];
+	fileHandleOut = {};
 	fileHandleOut.m_fstIndex = directoryIterator.currentIndex;
 	if (fstEntry.GetType() == FSTEntry::TYPE::DIRECTORY)
 	{
@@ -1181,10 +1311,16 @@ bool FSTVolume::Next(FSTDirectoryIterator& directoryIterator, FSTFileHandle& fil
 
 FSTVolume::~FSTVolume()
 {
-	for (auto& itr : m_cacheDecryptedRawBlocks)
-		delete itr.second;
-	for (auto& itr : m_cacheDecryptedHashedBlocks)
-		delete itr.second;
+	{
+		std::unique_lock _l(m_cacheMutex);
+		m_readAheadThreadsStop = true;
+		m_readAheadCondVar.notify_all();
+	}
+	for (auto& thread : m_readAheadThreads)
+		thread.join();
+	m_readAheadQueue.clear();
+	m_blockCache.clear();
+	m_blockCacheLRU.clear();
 	if (m_sourceIsOwned)
 		delete m_dataSource;
 }
@@ -1238,40 +1374,51 @@ bool FSTVerifier::VerifyHashedContentFile(FileStream* fileContent, const NCrypto
 
 	std::vector<NCrypto::CHash160> h0List(4096);
 
-	FSTHashedBlock block;
+	// blocks are read in groups of 16 (one H1 hash)
+	constexpr uint32 BLOCKS_PER_BATCH = 16;
+	std::vector<FSTHashedBlock> blocks(BLOCKS_PER_BATCH);
+	uint8 zeroIv[16]{};
 	uint32 numBlocks = contentSize / sizeof(FSTHashedBlock);
-	for (uint32 blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+	for (uint32 batchStart = 0; batchStart < numBlocks; batchStart += BLOCKS_PER_BATCH)
 	{
-		if (fileContent->readData(&block, sizeof(FSTHashedBlock)) != sizeof(FSTHashedBlock))
-			return false;
-		uint32 h0Index = (blockIndex % 4096);
-		// decrypt hash data and file data
-		uint8 iv[16]{};
-		AES128_CBC_decrypt(block.getHashData(), block.getHashData(), BLOCK_HASH_SIZE, key->b, iv);
-		AES128_CBC_decrypt(block.getFileData(), block.getFileData(), BLOCK_FILE_SIZE, key->b, block.getH0Hash(blockIndex % 16));
-
-		// generate H0 hash and compare
-		NCrypto::CHash160 h0;
-		SHA1(block.getFileData(), BLOCK_FILE_SIZE, h0.b);
-		if (memcmp(h0.b, block.getH0Hash(h0Index & 0xF), sizeof(h0.b)) != 0)
+		uint32 batchSize = std::min<uint32>(BLOCKS_PER_BATCH, numBlocks - batchStart);
+		if (fileContent->readData(blocks.data(), sizeof(FSTHashedBlock) * batchSize) != sizeof(FSTHashedBlock) * batchSize)
 			return false;
-		std::memcpy(h0List[h0Index].b, h0.b, sizeof(h0.b));
-
-		// Sixteen H0 hashes become one H1 hash
-		if (((h0Index + 1) % 16) == 0 && h0Index > 0)
+		// decrypt hash data, then file data (the IV of the file data is stored in the hash data)
+		for (uint32 i = 0; i < batchSize; i++)
 		{
-			uint32 h1Index = ((h0Index - 15) / 16);
+			AES128_CBC_decrypt(blocks[i].getHashData(), blocks[i].getHashData(), BLOCK_HASH_SIZE, key->b, zeroIv);
+			AES128_CBC_decrypt(blocks[i].getFileData(), blocks[i].getFileData(), BLOCK_FILE_SIZE, key->b, blocks[i].getH0Hash((batchStart + i) % 16));
+		}
 
-			NCrypto::CHash160 h1;
-			SHA1((unsigned char *) (h0List.data() + h1Index * 16), sizeof(NCrypto::CHash160) * 16, h1.b);
-			if (memcmp(h1.b, block.getH1Hash(h1Index&0xF), sizeof(h1.b)) != 0)
+		for (uint32 i = 0; i < batchSize; i++)
+		{
+			FSTHashedBlock& block = blocks[i];
+			uint32 blockIndex = batchStart + i;
+			uint32 h0Index = (blockIndex % 4096);
+			// generate H0 hash and compare
+			NCrypto::CHash160 h0;
+			SHA1(block.getFileData(), BLOCK_FILE_SIZE, h0.b);
+			if (memcmp(h0.b, block.getH0Hash(h0Index & 0xF), sizeof(h0.b)) != 0)
 				return false;
-		}
-		// todo - repeat same for H1 and H2
-		//        At the end all H3 hashes are hashed into a single H4 hash which is then compared with the content hash from the TMD
+			std::memcpy(h0List[h0Index].b, h0.b, sizeof(h0.b));
+
+			// Sixteen H0 hashes become one H1 hash
+			if (((h0Index + 1) % 16) == 0 && h0Index > 0)
+			{
+				uint32 h1Index = ((h0Index - 15) / 16);
 
-		// Checking only H0 and H1 is sufficient enough for verifying if the file data is intact
-		// but if we wanted to be strict and only allow correctly signed data we would have to hash all the way up to H4
+				NCrypto::CHash160 h1;
+				SHA1((unsigned char *) (h0List.data() + h1Index * 16), sizeof(NCrypto::CHash160) * 16, h1.b);
+				if (memcmp(h1.b, block.getH1Hash(h1Index&0xF), sizeof(h1.b)) != 0)
+					return false;
+			}
+			// todo - repeat same for H1 and H2
+			//        At the end all H3 hashes are hashed into a single H4 hash which is then compared with the content hash from the TMD
+
+			// Checking only H0 and H1 is sufficient enough for verifying if the file data is intact
+			// but if we wanted to be strict and only allow correctly signed data we would have to hash all the way up to H4
+		}
 	}
 	return true;
 }
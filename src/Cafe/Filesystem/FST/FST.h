@@ -7,6 +7,9 @@ struct FSTFileHandle
 	friend class FSTVolume;
 private:
 	uint32 m_fstIndex;
+	// used to detect sequential reads for read-ahead
+	uint32 m_nextReadOffset{};
+	uint32 m_sequentialReadCount{};
 };
 
 struct FSTDirectoryIterator
@@ -48,6 +51,9 @@ public:
 	uint32 GetFileCount() const;
 	bool HasCorruption() const { return m_detectedCorruption; }
 
+	// maximum amount of memory used for decrypted blocks (including blocks decrypted ahead of time)
+	void SetBlockCacheBudget(size_t budgetInBytes);
+
 	bool OpenFile(std::string_view path, FSTFileHandle& fileHandleOut, bool openOnlyFiles = false);
 
 	// file and directory functions
@@ -187,17 +193,33 @@ private:
 		return m_hashIsDisabled;
 	}
 
-	/* Cache for decrypted raw and hashed blocks */
-	std::unordered_map<uint64, struct FSTCachedRawBlock*> m_cacheDecryptedRawBlocks;
-	std::unordered_map<uint64, struct FSTCachedHashedBlock*> m_cacheDecryptedHashedBlocks;
-	uint64 m_cacheAccessCounter{};
-
-	void DetermineUnhashedBlockIV(uint32 clusterIndex, uint32 blockIndex, NCrypto::AesIv& ivOut);
-
-	struct FSTCachedRawBlock* GetDecryptedRawBlock(uint32 clusterIndex, uint32 blockIndex);
-	struct FSTCachedHashedBlock* GetDecryptedHashedBlock(uint32 clusterIndex, uint32 blockIndex);
-
-	void TrimCacheIfRequired(struct FSTCachedRawBlock** droppedRawBlock, struct FSTCachedHashedBlock** droppedHashedBlock);
+	/* Cache for decrypted raw and hashed blocks (shared LRU) */
+	std::mutex m_cacheMutex;
+	std::condition_variable m_cacheBlockReadyCondVar;
+	std::unordered_map<uint64, std::shared_ptr<struct FSTCachedBlock>> m_blockCache;
+	std::list<struct FSTCachedBlock*> m_blockCacheLRU; // most recently accessed block at the front
+	size_t m_blockCacheSize{};
+	size_t m_blockCacheBudget{16 * 1024 * 1024}; // 16MB by default
+	std::mutex m_dataSourceMutex; // data sources are not thread-safe
+
+	/* Read-ahead */
+	std::deque<std::shared_ptr<struct FSTCachedBlock>> m_readAheadQueue;
+	std::condition_variable m_readAheadCondVar;
+	size_t m_readAheadPendingSize{}; // size of read-ahead blocks which were not consumed by a reader yet
+	std::vector<std::thread> m_readAheadThreads;
+	bool m_readAheadThreadsStop{false};
+
+	void ReadAndDecryptBlocks(std::span<struct FSTCachedBlock* const> blocks, bool* successOut);
+	bool VerifyRawBlockContentHash(uint32 clusterIndex, uint32 blockIndex, const struct FSTCachedBlock& block);
+
+	std::shared_ptr<struct FSTCachedBlock> GetDecryptedBlock(uint32 clusterIndex, uint32 blockIndex);
+	std::shared_ptr<struct FSTCachedBlock> CreateCachedBlock(uint32 clusterIndex, uint32 blockIndex);
+	void RemoveCachedBlock(struct FSTCachedBlock* block);
+	void TrimCacheIfRequired();
+	void ReleaseReadAheadBlock(struct FSTCachedBlock* block);
+
+	void QueueReadAhead(uint32 clusterIndex, uint32 firstBlockIndex, uint32 lastBlockIndex);
+	void ReadAheadThread();
 
 	/* File reading */
 	uint32 ReadFile_HashModeRaw(uint32 clusterIndex, FSTEntry& entry, uint32 readOffset, uint32 readSize, void* dataOut);
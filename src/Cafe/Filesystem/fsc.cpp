@@ -4,6 +4,7 @@
 struct FSCMountPathNode
 {
 	std::string path;
+	std::string indexKey; // normalized full path of this node, see s_fscMountIndex
 	std::vector<FSCMountPathNode*> subnodes;
 	FSCMountPathNode* parent;
 	// associated device target and path
@@ -71,8 +72,49 @@ std::recursive_mutex s_fscMutex;
 #define fscEnter() s_fscMutex.lock();
 #define fscLeave() s_fscMutex.unlock();
 
+// flattened index of all nodes in the mount trees, keyed by the lower-cased path with '/' as separator (the root node uses an empty key)
+// a single probe resolves a virtual path to the nodes of all priorities, so lookups don't have to walk the subnode lists of each tree
+// protected by s_fscMutex
+struct FSCMountIndexEntry
+{
+	FSCMountPathNode* nodePerPrio[FSC_PRIORITY_COUNT]{};
+};
+
+std::unordered_map<std::string, FSCMountIndexEntry> s_fscMountIndex;
+
+// negative cache for fsc_doesFileExist. Maps the index key of a path to the highest maxPriority for which the file was found to not exist
+// any operation through fsc which can make a file appear (mount changes, file creation, rename) clears the cache
+// files created on the host filesystem outside of fsc are only picked up after the next mount change
+constexpr size_t FSC_MISSING_FILE_CACHE_SIZE = 512;
+std::unordered_map<std::string, sint32> s_fscMissingFileCache;
+
 FSCMountPathNode* fsc_lookupPathVirtualNode(const char* path, sint32 priority = FSC_PRIORITY_BASE);
 
+// append a node name to an index key using FSA case-insensitivity rules
+void fsc_appendIndexKey(std::string& key, std::string_view nodeName)
+{
+	if (!key.empty())
+		key.push_back('/');
+	for (char c : nodeName)
+	{
+		if (c >= 'A' && c <= 'Z')
+			c += ('a' - 'A');
+		key.push_back(c);
+	}
+}
+
+void fsc_buildIndexKey(const FSCPath& path, std::string& keyOut)
+{
+	keyOut.clear();
+	for (size_t i = 0; i < path.GetNodeCount(); i++)
+		fsc_appendIndexKey(keyOut, path.GetNodeName(i));
+}
+
+void fsc_invalidateMissingFileCache()
+{
+	s_fscMissingFileCache.clear();
+}
+
 void fsc_reset()
 {
 	// delete existing nodes
@@ -81,9 +123,14 @@ void fsc_reset()
 		delete itr;
 		itr = nullptr;
 	}
+	s_fscMountIndex.clear();
+	fsc_invalidateMissingFileCache();
 	// init root node for each priority
 	for (sint32 i = 0; i < FSC_PRIORITY_COUNT; i++)
+	{
 		s_fscRootNodePerPrio[i] = new FSCMountPathNode(nullptr);
+		s_fscMountIndex[""].nodePerPrio[i] = s_fscRootNodePerPrio[i];
+	}
 }
 
 /*
@@ -121,8 +168,11 @@ FSCMountPathNode* fsc_createMountPath(const FSCPath& mountPath, sint32 priority)
 		// no matching subnode, add new entry
 		nodeSub = new FSCMountPathNode(nodeParent);
 		nodeSub->path = mountPath.GetNodeName(i);
+		nodeSub->indexKey = nodeParent->indexKey;
+		fsc_appendIndexKey(nodeSub->indexKey, nodeSub->path);
 		nodeSub->priority = priority;
 		nodeParent->subnodes.emplace_back(nodeSub);
+		s_fscMountIndex[nodeSub->indexKey].nodePerPrio[priority] = nodeSub;
 		if (i == (mountPath.GetNodeCount() - 1))
 		{
 			// last node
@@ -161,6 +211,7 @@ sint32 fsc_mount(std::string_view mountPath, std::string_view targetPath, fscDev
 		return FSC_STATUS_INVALID_PATH;
 	}
     node->AssignDevice(fscDevice, ctx, targetPathWithSlash);
+	fsc_invalidateMissingFileCache();
 	fscLeave();
 	return FSC_STATUS_OK;
 }
@@ -184,9 +235,18 @@ bool fsc_unmount(std::string_view mountPath, sint32 priority)
 	{
 		FSCMountPathNode* parent = mountPathNode->parent;
         std::erase(parent->subnodes, mountPathNode);
+		auto indexItr = s_fscMountIndex.find(mountPathNode->indexKey);
+		cemu_assert_debug(indexItr != s_fscMountIndex.end() && indexItr->second.nodePerPrio[priority] == mountPathNode);
+		if (indexItr != s_fscMountIndex.end())
+		{
+			indexItr->second.nodePerPrio[priority] = nullptr;
+			if (std::all_of(std::begin(indexItr->second.nodePerPrio), std::end(indexItr->second.nodePerPrio), [](FSCMountPathNode* node) { return node == nullptr; }))
+				s_fscMountIndex.erase(indexItr);
+		}
 		delete mountPathNode;
 		mountPathNode = parent;
 	}
+	fsc_invalidateMissingFileCache();
 	fscLeave();
 	return true;
 }
@@ -198,87 +258,88 @@ void fsc_unmountAll()
 	fscLeave();
 }
 
-// lookup virtual path and find mounted device and relative device directory
-bool fsc_lookupPath(const char* path, std::string& devicePathOut, fscDeviceC** fscDeviceOut, void** ctxOut, sint32 priority = FSC_PRIORITY_BASE)
+struct FSCResolvedMount
 {
-	FSCPath parsedPath(path);
-	FSCMountPathNode* nodeParent = s_fscRootNodePerPrio[priority];
-	size_t i;
-	fscEnter();
-	for (i = 0; i < parsedPath.GetNodeCount(); i++)
+	FSCMountPathNode* node{};
+	size_t consumedNodeCount{}; // number of path nodes covered by the mount path
+};
+
+// for each priority up to maxPriority find the deepest device mount point which is a prefix of the path
+// prefixes are probed from longest to shortest, each probe resolves all priorities at once
+void fsc_resolveMounts(const FSCPath& parsedPath, sint32 maxPriority, FSCResolvedMount* resolvedPerPrio)
+{
+	cemu_assert_debug(maxPriority >= 0 && maxPriority < FSC_PRIORITY_COUNT);
+	std::string key;
+	boost::container::small_vector<size_t, 16> prefixKeyLength;
+	for (size_t i = 0; i < parsedPath.GetNodeCount(); i++)
 	{
-		// search for subdirectory
-		FSCMountPathNode* nodeSub = nullptr;
-		for(auto& nodeItr : nodeParent->subnodes)
-		{			
-			if (parsedPath.MatchNodeName(i, nodeItr->path))
-			{
-				nodeSub = nodeItr;
-				break;
-			}
-		}
-		if (nodeSub)
-		{
-			nodeParent = nodeSub;
-			continue;
-		}
-		// no matching subnode
-		break;
+		prefixKeyLength.emplace_back(key.size());
+		fsc_appendIndexKey(key, parsedPath.GetNodeName(i));
 	}
-	// if the found node is not a device mount point, then travel back towards the root until we find one
-	while (nodeParent)
+	prefixKeyLength.emplace_back(key.size());
+	sint32 unresolvedCount = maxPriority + 1;
+	for (sint32 i = (sint32)parsedPath.GetNodeCount(); i >= 0 && unresolvedCount > 0; i--)
 	{
-		if (nodeParent->device)
+		key.resize(prefixKeyLength[i]);
+		auto itr = s_fscMountIndex.find(key);
+		if (itr == s_fscMountIndex.end())
+			continue;
+		for (sint32 prio = 0; prio <= maxPriority; prio++)
 		{
-			devicePathOut = nodeParent->deviceTargetPath;
-			for (size_t f = i; f < parsedPath.GetNodeCount(); f++)
-			{
-				auto nodeName = parsedPath.GetNodeName(f);
-				devicePathOut.append(nodeName);
-				if (f < (parsedPath.GetNodeCount() - 1))
-					devicePathOut.push_back('/');
-			}
-			*fscDeviceOut = nodeParent->device;
-			*ctxOut = nodeParent->ctx;
-			fscLeave();
-			return true;
+			FSCMountPathNode* node = itr->second.nodePerPrio[prio];
+			if (resolvedPerPrio[prio].node || !node || !node->device)
+				continue;
+			resolvedPerPrio[prio].node = node;
+			resolvedPerPrio[prio].consumedNodeCount = (size_t)i;
+			unresolvedCount--;
 		}
-		nodeParent = nodeParent->parent;
-		i--;
 	}
-	fscLeave();
-	return false;
 }
 
-// lookup path and find virtual device node
-FSCMountPathNode* fsc_lookupPathVirtualNode(const char* path, sint32 priority)
+// translate a virtual path into the path relative to the device of the resolved mount point
+void fsc_getDevicePath(const FSCPath& parsedPath, const FSCResolvedMount& mount, std::string& devicePathOut)
+{
+	devicePathOut = mount.node->deviceTargetPath;
+	for (size_t f = mount.consumedNodeCount; f < parsedPath.GetNodeCount(); f++)
+	{
+		auto nodeName = parsedPath.GetNodeName(f);
+		devicePathOut.append(nodeName);
+		if (f < (parsedPath.GetNodeCount() - 1))
+			devicePathOut.push_back('/');
+	}
+}
+
+// lookup virtual path and find mounted device and relative device directory
+bool fsc_lookupPath(const char* path, std::string& devicePathOut, fscDeviceC** fscDeviceOut, void** ctxOut, sint32 priority = FSC_PRIORITY_BASE)
 {
 	FSCPath parsedPath(path);
-	FSCMountPathNode* nodeCurrentDir = s_fscRootNodePerPrio[priority];
+	FSCResolvedMount resolvedPerPrio[FSC_PRIORITY_COUNT];
 	fscEnter();
-	for (size_t i = 0; i < parsedPath.GetNodeCount(); i++)
+	fsc_resolveMounts(parsedPath, priority, resolvedPerPrio);
+	const FSCResolvedMount& mount = resolvedPerPrio[priority];
+	if (!mount.node)
 	{
-		// search for subdirectory
-		FSCMountPathNode* nodeSub = nullptr;
-		for (auto& nodeItr : nodeCurrentDir->subnodes)
-		{
-			if (parsedPath.MatchNodeName(i, nodeItr->path))
-			{
-				nodeSub = nodeItr;
-				break;
-			}
-		}
-		if (nodeSub)
-		{
-			// traverse subdirectory
-			nodeCurrentDir = nodeSub;
-			continue;
-		}
 		fscLeave();
-		return nullptr;
+		return false;
 	}
+	fsc_getDevicePath(parsedPath, mount, devicePathOut);
+	*fscDeviceOut = mount.node->device;
+	*ctxOut = mount.node->ctx;
 	fscLeave();
-	return nodeCurrentDir;
+	return true;
+}
+
+// lookup path and find virtual device node
+FSCMountPathNode* fsc_lookupPathVirtualNode(const char* path, sint32 priority)
+{
+	FSCPath parsedPath(path);
+	std::string key;
+	fsc_buildIndexKey(parsedPath, key);
+	fscEnter();
+	auto itr = s_fscMountIndex.find(key);
+	FSCMountPathNode* node = (itr != s_fscMountIndex.end()) ? itr->second.nodePerPrio[priority] : nullptr;
+	fscLeave();
+	return node;
 }
 
 // this wraps multiple iterated directories from different devices into one unified virtual representation
@@ -381,15 +442,20 @@ FSCVirtualFile* fsc_open(const char* path, FSC_ACCESS_FLAG accessFlags, sint32*
 	FSCVirtualFile* dirList[FSC_PRIORITY_COUNT];
 	uint8 dirListCount = 0;
 	std::string devicePath;
-	fscDeviceC* fscDevice = NULL;
 	*fscStatus = FSC_STATUS_UNDEFINED;
-	void* ctx;
+	FSCPath parsedPath(path);
+	FSCResolvedMount resolvedPerPrio[FSC_PRIORITY_COUNT];
 	fscEnter();
+	if (HAS_FLAG(accessFlags, FSC_ACCESS_FLAG::FILE_ALLOW_CREATE) || HAS_FLAG(accessFlags, FSC_ACCESS_FLAG::FILE_ALWAYS_CREATE))
+		fsc_invalidateMissingFileCache();
+	fsc_resolveMounts(parsedPath, maxPriority, resolvedPerPrio);
 	for (sint32 prio = maxPriority; prio >= 0; prio--)
 	{
-		if (fsc_lookupPath(path, devicePath, &fscDevice, &ctx, prio))
+		const FSCResolvedMount& mount = resolvedPerPrio[prio];
+		if (mount.node)
 		{
-			FSCVirtualFile* fscVirtualFile = fscDevice->fscDeviceOpenByPath(devicePath, accessFlags, ctx, fscStatus);
+			fsc_getDevicePath(parsedPath, mount, devicePath);
+			FSCVirtualFile* fscVirtualFile = mount.node->device->fscDeviceOpenByPath(devicePath, accessFlags, mount.node->ctx, fscStatus);
 			if (fscVirtualFile)
 			{
 				if (fscVirtualFile->fscGetType() == FSC_TYPE_DIRECTORY)
@@ -496,10 +562,17 @@ bool fsc_rename(const char* srcPath, const char* dstPath, sint32* fscStatus)
 	fscDeviceC* fscSrcDevice = NULL;
 	fscDeviceC* fscDstDevice = NULL;
 	*fscStatus = FSC_STATUS_UNDEFINED;
+	// the lock is held across the rename so that fsc_doesFileExist can't cache the destination as missing in between
+	std::unique_lock _l(s_fscMutex);
 	if( fsc_lookupPath(srcPath, srcDevicePath, &fscSrcDevice, &srcCtx) && fsc_lookupPath(dstPath, dstDevicePath, &fscDstDevice, &dstCtx) )
 	{
 		if( fscSrcDevice == fscDstDevice )
-			return fscSrcDevice->fscDeviceRename(srcDevicePath, dstDevicePath, srcCtx, fscStatus);
+		{
+			bool success = fscSrcDevice->fscDeviceRename(srcDevicePath, dstDevicePath, srcCtx, fscStatus);
+			if (success)
+				fsc_invalidateMissingFileCache();
+			return success;
+		}
 	}
 	return false;
 }
@@ -552,18 +625,21 @@ uint32 fsc_getFileSeek(FSCVirtualFile* fscFile)
  */
 void fsc_setFileSeek(FSCVirtualFile* fscFile, uint32 newSeek)
 {
-	fscEnter();
+	std::unique_lock _l(s_fscMutex, std::defer_lock);
+	if (!fscFile->fscSupportsConcurrentAccess())
+		_l.lock();
 	uint32 fileSize = fsc_getFileSize(fscFile);
 	if (fsc_isWritable(fscFile) == false)
 		newSeek = std::min(newSeek, fileSize);
 	fscFile->fscSetSeek((uint64)newSeek);
-	fscLeave();
 }
 
 // set file length
 void fsc_setFileLength(FSCVirtualFile* fscFile, uint32 newEndOffset)
 {
-	fscEnter();
+	std::unique_lock _l(s_fscMutex, std::defer_lock);
+	if (!fscFile->fscSupportsConcurrentAccess())
+		_l.lock();
 	uint32 fileSize = fsc_getFileSize(fscFile);
 	if (!fsc_isWritable(fscFile))
 	{
@@ -573,7 +649,6 @@ void fsc_setFileLength(FSCVirtualFile* fscFile, uint32 newEndOffset)
 	{
 		fscFile->fscSetFileLength((uint64)newEndOffset);
 	}
-	fscLeave();
 }
 
 /*
@@ -606,6 +681,8 @@ bool fsc_isWritable(FSCVirtualFile* fscFile)
  */
 uint32 fsc_readFile(FSCVirtualFile* fscFile, void* buffer, uint32 size)
 {
+	if (fscFile->fscSupportsConcurrentAccess())
+		return fscFile->fscReadData(buffer, size);
 	fscEnter();
 	uint32 fscStatus = fscFile->fscReadData(buffer, size);
 	fscLeave();
@@ -618,18 +695,15 @@ uint32 fsc_readFile(FSCVirtualFile* fscFile, void* buffer, uint32 size)
  */
 uint32 fsc_writeFile(FSCVirtualFile* fscFile, void* buffer, uint32 size)
 {
-	fscEnter();
+	std::unique_lock _l(s_fscMutex, std::defer_lock);
+	if (!fscFile->fscSupportsConcurrentAccess())
+		_l.lock();
 	if (fsc_isWritable(fscFile) == false)
-	{
-		fscLeave();
 		return 0;
-	}
 	if (fscFile->m_isAppend)
 		fsc_setFileSeek(fscFile, fsc_getFileSize(fscFile));
 
-	uint32 fscStatus = fscFile->fscWriteData(buffer, size);
-	fscLeave();
-	return fscStatus;
+	return fscFile->fscWriteData(buffer, size);
 }
 
 // helper function to load a file into memory
@@ -699,10 +773,22 @@ bool fsc_doesFileExist(const char* path, sint32 maxPriority)
 {
 	fscDeviceC* fscDevice = nullptr;
 	sint32 fscStatus = FSC_STATUS_UNDEFINED;
+	std::string cacheKey;
+	fsc_buildIndexKey(FSCPath(path), cacheKey);
 	fscEnter();
+	auto cacheItr = s_fscMissingFileCache.find(cacheKey);
+	if (cacheItr != s_fscMissingFileCache.end() && cacheItr->second >= maxPriority)
+	{
+		fscLeave();
+		return false;
+	}
 	FSCVirtualFile* fscFile = fsc_open(path, FSC_ACCESS_FLAG::OPEN_FILE, &fscStatus, maxPriority);
 	if (!fscFile)
 	{
+		if (s_fscMissingFileCache.size() >= FSC_MISSING_FILE_CACHE_SIZE)
+			fsc_invalidateMissingFileCache();
+		sint32& cachedPriority = s_fscMissingFileCache.try_emplace(cacheKey, maxPriority).first->second;
+		cachedPriority = std::max(cachedPriority, maxPriority);
 		fscLeave();
 		return false;
 	}
@@ -158,6 +158,13 @@ struct FSCVirtualFile
 		return false;
 	}
 
+	// returns true if reads, writes and seeks on this file don't have to be serialized with other fsc operations
+	// the caller is still responsible for not accessing the same file object from multiple threads at once
+	virtual bool fscSupportsConcurrentAccess()
+	{
+		return false;
+	}
+
 	FSCDirIteratorState* dirIterator{};
 
 	bool m_isAppend{ false };
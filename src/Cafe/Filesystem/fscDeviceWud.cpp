@@ -108,6 +108,11 @@ public:
 		return true;
 	}
 
+	bool fscSupportsConcurrentAccess() override
+	{
+		return true; // FSTVolume serializes access to the data source internally
+	}
+
 private:
 	FSTVolume* m_volume{nullptr};
 	sint32 m_fscType;
@@ -68,6 +68,7 @@ class AArch64Allocator : public Allocator
 #else
 	inline static Allocator s_allocator;
 #endif
+	inline static std::mutex s_allocatorMutex; // code is generated concurrently by multiple recompiler threads
 	Allocator* m_allocatorImpl;
 	bool m_freeDisabled = false;
 
@@ -77,6 +78,7 @@ class AArch64Allocator : public Allocator
 
 	uint32* alloc(size_t size) override
 	{
+		std::lock_guard _l(s_allocatorMutex);
 		return m_allocatorImpl->alloc(size);
 	}
 
@@ -87,8 +89,10 @@ class AArch64Allocator : public Allocator
 
 	void free(uint32* p) override
 	{
-		if (!m_freeDisabled)
-			m_allocatorImpl->free(p);
+		if (m_freeDisabled)
+			return;
+		std::lock_guard _l(s_allocatorMutex);
+		m_allocatorImpl->free(p);
 	}
 
 	[[nodiscard]] bool useProtect() const override
@@ -945,6 +949,15 @@ bool AArch64GenContext_t::macro(IMLInstruction* imlInstruction)
 		str(TEMP_GPR1.WReg, adrCycles);
 		return true;
 	}
+	else if (imlInstruction->operation == PPCREC_IML_MACRO_COUNT_ENTRY)
+	{
+		uint64 counterAddress = (uint64)imlInstruction->op_macro.param | ((uint64)imlInstruction->op_macro.param2 << 32);
+		mov(TEMP_GPR1.XReg, counterAddress);
+		ldr(TEMP_GPR2.WReg, AdrUimm(TEMP_GPR1.XReg, 0));
+		add(TEMP_GPR2.WReg, TEMP_GPR2.WReg, 1);
+		str(TEMP_GPR2.WReg, AdrUimm(TEMP_GPR1.XReg, 0));
+		return true;
+	}
 	else if (imlInstruction->operation == PPCREC_IML_MACRO_HLE)
 	{
 		uint32 ppcAddress = imlInstruction->op_macro.param;
@@ -270,6 +270,13 @@ bool PPCRecompilerX64Gen_imlInstruction_macro(PPCRecFunction_t* PPCRecFunction,
 		x64Gen_sub_mem32reg64_imm32(x64GenContext, REG_RESV_HCPU, offsetof(PPCInterpreter_t, remainingCycles), cycleCount);
 		return true;
 	}
+	else if( imlInstruction->operation == PPCREC_IML_MACRO_COUNT_ENTRY )
+	{
+		uint64 counterAddress = (uint64)imlInstruction->op_macro.param | ((uint64)imlInstruction->op_macro.param2 << 32);
+		x64GenContext->emitter->MOV_qi64(REG_RESV_TEMP, counterAddress);
+		x64GenContext->emitter->ADD_di8_l(REG_RESV_TEMP, 0, X86_REG_NONE, 0, 1);
+		return true;
+	}
 	else if( imlInstruction->operation == PPCREC_IML_MACRO_HLE )
 	{
 		uint32 ppcAddress = imlInstruction->op_macro.param;
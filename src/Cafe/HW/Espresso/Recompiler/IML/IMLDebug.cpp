@@ -406,6 +406,10 @@ void IMLDebug_DisassembleInstruction(const IMLInstruction& inst, std::string& di
 		{
 			strOutput.addFmt("MACRO COUNT_CYCLES cycles: {}", inst.op_macro.param);
 		}
+		else if (inst.operation == PPCREC_IML_MACRO_COUNT_ENTRY)
+		{
+			strOutput.addFmt("MACRO COUNT_ENTRY counter: 0x{:016x}", (uint64)inst.op_macro.param | ((uint64)inst.op_macro.param2 << 32));
+		}
 		else
 		{
 			strOutput.addFmt("MACRO ukn operation {}", inst.operation);
@@ -176,6 +176,7 @@ enum
 	PPCREC_IML_MACRO_COUNT_CYCLES,	// decrease current remaining thread cycles by a certain amount
 	PPCREC_IML_MACRO_HLE,			// HLE function call
 	PPCREC_IML_MACRO_LEAVE,			// leaves recompiler and switches to interpeter
+	PPCREC_IML_MACRO_COUNT_ENTRY,	// increments the 32bit counter at the host address param | (param2 << 32)
 	// debugging
 	PPCREC_IML_MACRO_DEBUGBREAK,	// throws a debugbreak
 };
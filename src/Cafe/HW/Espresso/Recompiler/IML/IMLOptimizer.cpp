@@ -16,6 +16,13 @@ IMLReg _FPRRegFromID(IMLRegID regId)
 	return IMLReg(IMLRegFormat::F64, IMLRegFormat::F64, 0, regId);
 }
 
+// don't scan too far (saves performance and also the chances we can merge the load+store become low at high distances)
+// for hot functions the extra compile time is worth it
+sint32 IMLOptimizer_GetCopyScanDistance(ppcImlGenContext_t* ppcImlGenContext)
+{
+	return ppcImlGenContext->isHotFunction ? 100 : 25;
+}
+
 void PPCRecompiler_optimizeDirectFloatCopiesScanForward(ppcImlGenContext_t* ppcImlGenContext, IMLSegment* imlSegment, sint32 imlIndexLoad, IMLReg fprReg)
 {
 	IMLRegID fprIndex = fprReg.GetRegID();
@@ -23,9 +30,10 @@ void PPCRecompiler_optimizeDirectFloatCopiesScanForward(ppcImlGenContext_t* ppcI
 	IMLInstruction* imlInstructionLoad = imlSegment->imlList.data() + imlIndexLoad;
 	if (imlInstructionLoad->op_storeLoad.flags2.notExpanded)
 		return;
-	boost::container::static_vector<sint32, 4> trackedMoves; // only track up to 4 copies
+	boost::container::static_vector<sint32, 8> trackedMoves;
+	const size_t maxTrackedMoves = ppcImlGenContext->isHotFunction ? 8 : 4; // only track up to 4 copies (8 for hot functions)
 	IMLUsedRegisters registersUsed;
-	sint32 scanRangeEnd = std::min<sint32>(imlIndexLoad + 25, imlSegment->imlList.size()); // don't scan too far (saves performance and also the chances we can merge the load+store become low at high distances)
+	sint32 scanRangeEnd = std::min<sint32>(imlIndexLoad + IMLOptimizer_GetCopyScanDistance(ppcImlGenContext), imlSegment->imlList.size());
 	bool foundMatch = false;
 	sint32 lastStore = -1;
 	for (sint32 i = imlIndexLoad + 1; i < scanRangeEnd; i++)
@@ -62,7 +70,7 @@ void PPCRecompiler_optimizeDirectFloatCopiesScanForward(ppcImlGenContext_t* ppcI
 				// unexpected no-op
 				break;
 			}
-			if (trackedMoves.size() >= trackedMoves.capacity())
+			if (trackedMoves.size() >= maxTrackedMoves)
 			{
 				// we cant track any more moves, expand here
 				lastStore = i;
@@ -152,7 +160,7 @@ void PPCRecompiler_optimizeDirectIntegerCopiesScanForward(ppcImlGenContext_t* pp
 		return;
 	bool foundMatch = false;
 	IMLUsedRegisters registersUsed;
-	sint32 scanRangeEnd = std::min<sint32>(imlIndexLoad + 25, imlSegment->imlList.size()); // don't scan too far (saves performance and also the chances we can merge the load+store become low at high distances)
+	sint32 scanRangeEnd = std::min<sint32>(imlIndexLoad + IMLOptimizer_GetCopyScanDistance(ppcImlGenContext), imlSegment->imlList.size());
 	sint32 i = imlIndexLoad + 1;
 	for (; i < scanRangeEnd; i++)
 	{
@@ -257,6 +265,17 @@ bool PPCRecompiler_isUGQRValueKnown(ppcImlGenContext_t* ppcImlGenContext, sint32
 	return true;
 }
 
+// for hot functions we speculate that UGQR2 to UGQR5 still hold the values coreinit initializes every thread with
+// the generated code has to compare the actual GQR value against the speculated one and fall back to the dynamic handler on mismatch
+bool PPCRecompiler_getSpeculatedUGQRValue(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, uint32& gqrValue)
+{
+	static constexpr uint32 s_osDefaultUGQR[4] = { 0x00040004, 0x00050005, 0x00060006, 0x00070007 };
+	if (!ppcImlGenContext->isHotFunction || gqrIndex < 2 || gqrIndex > 5)
+		return false;
+	gqrValue = s_osDefaultUGQR[gqrIndex - 2];
+	return true;
+}
+
 // analyses register dependencies across the entire function
 // per segment this will generate information about which registers need to be preserved and which ones don't (e.g. are overwritten)
 class IMLOptimizerRegIOAnalysis
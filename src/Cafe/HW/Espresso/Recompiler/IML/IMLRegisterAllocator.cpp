@@ -196,9 +196,9 @@ static void GetInstructionFixedRegisters(IMLInstruction* instruction, IMLFixedRe
 
 uint32 IMLRA_GetNextIterationIndex()
 {
-	static uint32 recRACurrentIterationIndex = 0;
-	recRACurrentIterationIndex++;
-	return recRACurrentIterationIndex;
+	// shared by all recompiler threads
+	static std::atomic<uint32> recRACurrentIterationIndex = 0;
+	return recRACurrentIterationIndex.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 bool _detectLoop(IMLSegment* currentSegment, sint32 depth, uint32 iterationIndex, IMLSegment* imlSegmentLoopBase)
@@ -1634,7 +1634,7 @@ void PPCRecRA_checkAndTryExtendRange(IMLRegisterAllocatorContext& ctx, IMLSegmen
 	else
 		instructionsUntilEndOfSeg = (sint32)currentSegment->imlList.size() - range->usageEnd;
 	cemu_assert_debug(instructionsUntilEndOfSeg >= 0);
-	sint32 remainingScanDist = 45 - instructionsUntilEndOfSeg;
+	sint32 remainingScanDist = ctx.raParam->rangeMergeDistance - instructionsUntilEndOfSeg;
 	if (remainingScanDist <= 0)
 		return; // can't reach end
 
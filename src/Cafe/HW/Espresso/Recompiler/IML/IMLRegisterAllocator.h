@@ -120,6 +120,7 @@ struct IMLRegisterAllocatorParameters
 
 	IMLPhysRegisterSet perTypePhysPool[stdx::to_underlying(IMLRegFormat::TYPE_COUNT)];
 	std::unordered_map<IMLRegID, IMLName> regIdToName;
+	sint32 rangeMergeDistance{45}; // maximum number of instructions between two liveness ranges of the same register for them to be merged across segments
 };
 
 void IMLRegisterAllocator_AllocateRegisters(ppcImlGenContext_t* ppcImlGenContext, IMLRegisterAllocatorParameters& raParam);
\ No newline at end of file
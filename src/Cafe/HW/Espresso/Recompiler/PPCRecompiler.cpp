@@ -10,6 +10,7 @@
 #include "Common/cpu_features.h"
 #include "util/helpers/fspinlock.h"
 #include "util/helpers/helpers.h"
+#include "util/helpers/Semaphore.h"
 #include "util/MemMapper/MemMapper.h"
 
 #include "IML/IML.h"
@@ -22,13 +23,30 @@
 
 #define PPCREC_FORCE_SYNCHRONOUS_COMPILATION	0 // if 1, then function recompilation will block and execute on the thread that called PPCRecompiler_visitAddressNoBlock
 #define PPCREC_LOG_RECOMPILATION_RESULTS		0
+#define PPCREC_MAX_WORKER_THREADS				4
+#define PPCREC_HOT_FUNCTION_THRESHOLD			50000 // number of entries after which a function is recompiled with more expensive optimizations
+#define PPCREC_HOT_FUNCTION_SCAN_INTERVAL		250 // in milliseconds. Hot functions are only collected while the recompiler threads are idle
 
 struct ppcInvalidationRange
 {
 	MPTR startAddress;
 	uint32 size;
+	uint64 sequenceId; // compilations which started before this id need to check against this range
 
-	ppcInvalidationRange(MPTR _startAddress, uint32 _size) : startAddress(_startAddress), size(_size) {};
+	ppcInvalidationRange(MPTR _startAddress, uint32 _size, uint64 _sequenceId) : startAddress(_startAddress), size(_size), sequenceId(_sequenceId) {};
+};
+
+struct ppcRecompilerQueueEntry
+{
+	MPTR enterAddress;
+	uint32 visitCount;
+
+	ppcRecompilerQueueEntry(MPTR _enterAddress, uint32 _visitCount) : enterAddress(_enterAddress), visitCount(_visitCount) {};
+
+	bool operator<(const ppcRecompilerQueueEntry& other) const
+	{
+		return visitCount < other.visitCount;
+	}
 };
 
 struct ppcRecompilerFuncRange
@@ -43,11 +61,20 @@ struct
 {
 	std::atomic_bool initialized{false};
 	FSpinlock recompilerSpinlock;
-	std::queue<MPTR> targetQueue;
+	// queued entry addresses, ordered by how often they were visited while waiting for recompilation
+	// the queue may contain stale duplicates, pendingVisitCount holds the authoritative list of addresses which still need to be compiled
+	std::priority_queue<ppcRecompilerQueueEntry> targetQueue;
+	std::unordered_map<MPTR, uint32> pendingVisitCount;
+	std::queue<PPCRecFunction_t*> hotFunctionQueue; // tier 0 functions which crossed the entry threshold
+	CounterSemaphore targetQueueSemaphore; // one count per entry in targetQueue and hotFunctionQueue
+	std::vector<PPCRecFunction_t*> tier0Functions; // active functions which are candidates for a tier 1 recompilation
+	// invalidation tracking for functions which are currently being compiled
 	std::vector<ppcInvalidationRange> invalidationRanges;
+	uint64 invalidationSequenceId{0};
+	sint32 numActiveCompilations{0};
 	std::atomic_int_fast32_t recompilerEnableCount{0};
-	// recompiler thread
-	std::thread workerThread;
+	// recompiler threads
+	std::vector<std::thread> workerThreads;
 	std::atomic_bool workerThreadStopSignal{false};
 	// function storage
 	RangeStore<PPCRecFunction_t*, uint32, 7703, 0x2000> functionStorage;
@@ -101,10 +128,34 @@ void PPCRecompiler_visitAddressNoBlock(uint32 enterAddress)
 		return;
 	}
 	// add to recompilation queue and flag as visited
-	s_ppcRecompilerState.targetQueue.emplace(enterAddress);
+	s_ppcRecompilerState.targetQueue.emplace(enterAddress, 1);
+	s_ppcRecompilerState.pendingVisitCount[enterAddress] = 1;
 	ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[enterAddress / 4] = PPCRecompiler_leaveRecompilerCode_visited;
 
 	s_ppcRecompilerState.recompilerSpinlock.unlock();
+	s_ppcRecompilerState.targetQueueSemaphore.increment();
+}
+
+// called when the interpreter passes an address which is queued for recompilation but not yet compiled
+// raises the priority of the queue entry. Like PPCRecompiler_visitAddressNoBlock this never blocks
+void PPCRecompiler_countPendingVisit(uint32 enterAddress)
+{
+	if (!s_ppcRecompilerState.recompilerSpinlock.try_lock())
+		return;
+	auto it = s_ppcRecompilerState.pendingVisitCount.find(enterAddress);
+	if (it == s_ppcRecompilerState.pendingVisitCount.end())
+	{
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return;
+	}
+	it->second++;
+	// only requeue on power-of-two counts to keep the number of stale duplicates in the queue low
+	bool requeue = std::has_single_bit(it->second);
+	if (requeue)
+		s_ppcRecompilerState.targetQueue.emplace(enterAddress, it->second);
+	s_ppcRecompilerState.recompilerSpinlock.unlock();
+	if (requeue)
+		s_ppcRecompilerState.targetQueueSemaphore.increment();
 }
 
 void PPCRecompiler_recompileIfUnvisited(uint32 enterAddress)
@@ -165,7 +216,11 @@ void PPCRecompiler_attemptEnter(PPCInterpreter_t* hCPU, uint32 enterAddress)
 	{
 		PPCRecompiler_visitAddressNoBlock(enterAddress);
 	}
-	else if (funcPtr != PPCRecompiler_leaveRecompilerCode_visited)
+	else if (funcPtr == PPCRecompiler_leaveRecompilerCode_visited)
+	{
+		PPCRecompiler_countPendingVisit(enterAddress);
+	}
+	else
 	{
 		// enter
 		cemu_assert_debug(ppcRecompilerInstanceData != nullptr);
@@ -173,8 +228,11 @@ void PPCRecompiler_attemptEnter(PPCInterpreter_t* hCPU, uint32 enterAddress)
 	}
 }
 bool PPCRecompiler_ApplyIMLPasses(ppcImlGenContext_t& ppcImlGenContext);
+void PPCRecompiler_AddEntryCounters(ppcImlGenContext_t& ppcImlGenContext);
+void PPCRecompiler_NativeRegisterAllocatorPass(ppcImlGenContext_t& ppcImlGenContext);
 
-PPCRecFunction_t* PPCRecompiler_recompileFunction(PPCFunctionBoundaryTracker::PPCRange_t range, std::set<uint32>& entryAddresses, std::vector<std::pair<MPTR, uint32>>& entryPointsOut, PPCFunctionBoundaryTracker& boundaryTracker)
+// if imlCacheDataOut is set, tier 0 functions are looked up in the function cache first. Functions which are not cached store their optimized IML in imlCacheDataOut
+PPCRecFunction_t* PPCRecompiler_recompileFunction(PPCFunctionBoundaryTracker::PPCRange_t range, std::set<uint32>& entryAddresses, std::vector<std::pair<MPTR, uint32>>& entryPointsOut, PPCFunctionBoundaryTracker& boundaryTracker, uint8 tier, std::vector<uint8>* imlCacheDataOut = nullptr)
 {
 	if (range.startAddress >= PPC_REC_CODE_AREA_END)
 	{
@@ -198,22 +256,13 @@ PPCRecFunction_t* PPCRecompiler_recompileFunction(PPCFunctionBoundaryTracker::PP
 	PPCRecFunction_t* ppcRecFunc = new PPCRecFunction_t();
 	ppcRecFunc->ppcAddress = range.startAddress;
 	ppcRecFunc->ppcSize = range.length;
+	ppcRecFunc->tier = tier;
 
 #if PPCREC_LOG_RECOMPILATION_RESULTS
 	BenchmarkTimer bt;
 	bt.Start();
 #endif
 
-	// generate intermediate code
-	ppcImlGenContext_t ppcImlGenContext = { 0 };
-	ppcImlGenContext.debug_entryPPCAddress = range.startAddress;
-	bool compiledSuccessfully = PPCRecompiler_generateIntermediateCode(ppcImlGenContext, ppcRecFunc, entryAddresses, boundaryTracker);
-	if (compiledSuccessfully == false)
-	{
-		delete ppcRecFunc;
-		return nullptr;
-	}
-
 	uint32 ppcRecLowerAddr = LaunchSettings::GetPPCRecLowerAddr();
 	uint32 ppcRecUpperAddr = LaunchSettings::GetPPCRecUpperAddr();
 
@@ -226,13 +275,36 @@ PPCRecFunction_t* PPCRecompiler_recompileFunction(PPCFunctionBoundaryTracker::PP
 		}
 	}
 
-	// apply passes
-	if (!PPCRecompiler_ApplyIMLPasses(ppcImlGenContext))
+	ppcImlGenContext_t ppcImlGenContext = { 0 };
+	ppcImlGenContext.debug_entryPPCAddress = range.startAddress;
+	ppcImlGenContext.isHotFunction = tier > 0;
+	ppcImlGenContext.entryCounter = tier == 0 ? &ppcRecFunc->entryCounter : nullptr;
+	// functions compiled in a previous session skip the frontend and the optimizer
+	bool isCached = imlCacheDataOut && tier == 0 && PPCRecompilerCache_LoadIML(ppcImlGenContext, ppcRecFunc, entryAddresses);
+	if (!isCached)
 	{
-		delete ppcRecFunc;
-		return nullptr;
+		// generate intermediate code
+		bool compiledSuccessfully = PPCRecompiler_generateIntermediateCode(ppcImlGenContext, ppcRecFunc, entryAddresses, boundaryTracker);
+		if (compiledSuccessfully == false)
+		{
+			delete ppcRecFunc;
+			return nullptr;
+		}
+
+		// apply passes
+		if (!PPCRecompiler_ApplyIMLPasses(ppcImlGenContext))
+		{
+			delete ppcRecFunc;
+			return nullptr;
+		}
+
+		if (imlCacheDataOut && tier == 0)
+			PPCRecompilerCache_SerializeIML(ppcImlGenContext, *imlCacheDataOut);
 	}
 
+	PPCRecompiler_AddEntryCounters(ppcImlGenContext);
+	PPCRecompiler_NativeRegisterAllocatorPass(ppcImlGenContext);
+
 #if defined(ARCH_X86_64)
 	// emit x64 code
 	bool x64GenerationSuccess = PPCRecompiler_generateX64Code(ppcRecFunc, &ppcImlGenContext);
@@ -337,6 +409,10 @@ void PPCRecompiler_NativeRegisterAllocatorPass(ppcImlGenContext_t& ppcImlGenCont
 		fprPhysPool.SetAvailable(i);
 #endif
 
+	// hot functions keep guest registers in host registers across more segment boundaries, at the cost of a more expensive allocation
+	if (ppcImlGenContext.isHotFunction)
+		raParam.rangeMergeDistance = 160;
+
 	IMLRegisterAllocator_AllocateRegisters(&ppcImlGenContext, raParam);
 }
 
@@ -353,40 +429,81 @@ bool PPCRecompiler_ApplyIMLPasses(ppcImlGenContext_t& ppcImlGenContext)
 
 	IMLOptimizer_StandardOptimizationPass(ppcImlGenContext);
 
-	PPCRecompiler_NativeRegisterAllocatorPass(ppcImlGenContext);
-
 	return true;
 }
 
-bool PPCRecompiler_makeRecompiledFunctionActive(uint32 initialEntryPoint, PPCFunctionBoundaryTracker::PPCRange_t& range, PPCRecFunction_t* ppcRecFunc, std::vector<std::pair<MPTR, uint32>>& entryPoints)
+// count how often the function is entered, used to detect hot functions
+// this is applied after the optimized IML was stored in the function cache, since the counter address differs for every compilation
+void PPCRecompiler_AddEntryCounters(ppcImlGenContext_t& ppcImlGenContext)
 {
-	// update jump table
-	s_ppcRecompilerState.recompilerSpinlock.lock();
-
-	// check if the initial entrypoint is still flagged for recompilation
-	// its possible that the range has been invalidated during the time it took to translate the function
-	if (ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[initialEntryPoint / 4] != PPCRecompiler_leaveRecompilerCode_visited)
+	if (!ppcImlGenContext.entryCounter)
+		return;
+	uint64 counterAddress = (uint64)ppcImlGenContext.entryCounter;
+	for (IMLSegment* imlSegment : ppcImlGenContext.segmentList2)
 	{
-		s_ppcRecompilerState.recompilerSpinlock.unlock();
-		return false;
+		if (!imlSegment->isEnterable)
+			continue;
+		PPCRecompiler_pushBackIMLInstructions(imlSegment, 0, 1);
+		imlSegment->imlList[0].make_macro(PPCREC_IML_MACRO_COUNT_ENTRY, (uint32)counterAddress, (uint32)(counterAddress >> 32), 0, IMLREG_INVALID);
 	}
+}
 
-	// check if the current range got invalidated during the time it took to recompile it
-	bool isInvalidated = false;
+// must be called with recompilerSpinlock held
+// returns the invalidation sequence id which the compilation has to check against when it finishes
+uint64 PPCRecompiler_beginCompilation()
+{
+	cemu_assert_debug(s_ppcRecompilerState.recompilerSpinlock.is_locked());
+	s_ppcRecompilerState.numActiveCompilations++;
+	return s_ppcRecompilerState.invalidationSequenceId;
+}
+
+// must be called with recompilerSpinlock held
+void PPCRecompiler_endCompilation()
+{
+	cemu_assert_debug(s_ppcRecompilerState.recompilerSpinlock.is_locked());
+	cemu_assert_debug(s_ppcRecompilerState.numActiveCompilations > 0);
+	s_ppcRecompilerState.numActiveCompilations--;
+	// invalidation ranges are only relevant while functions are being compiled
+	if (s_ppcRecompilerState.numActiveCompilations == 0)
+		s_ppcRecompilerState.invalidationRanges.clear();
+}
+
+// must be called with recompilerSpinlock held
+bool PPCRecompiler_isInvalidatedSince(PPCRecFunction_t* ppcRecFunc, uint64 compilationSequenceId)
+{
 	for (auto& invRange : s_ppcRecompilerState.invalidationRanges)
 	{
+		if (invRange.sequenceId < compilationSequenceId)
+			continue;
 		MPTR rStartAddr = invRange.startAddress;
 		MPTR rEndAddr = rStartAddr + invRange.size;
 		for (auto& recFuncRange : ppcRecFunc->list_ranges)
 		{
 			if (recFuncRange.ppcAddress < (rEndAddr) && (recFuncRange.ppcAddress + recFuncRange.ppcSize) > rStartAddr)
-			{
-				isInvalidated = true;
-				break;
-			}
+				return true;
 		}
 	}
-	s_ppcRecompilerState.invalidationRanges.clear();
+	return false;
+}
+
+bool PPCRecompiler_makeRecompiledFunctionActive(uint32 initialEntryPoint, PPCFunctionBoundaryTracker::PPCRange_t& range, PPCRecFunction_t* ppcRecFunc, std::vector<std::pair<MPTR, uint32>>& entryPoints, uint64 compilationSequenceId)
+{
+	// update jump table
+	s_ppcRecompilerState.recompilerSpinlock.lock();
+
+	// check if the initial entrypoint is still flagged for recompilation
+	// its possible that the range has been invalidated during the time it took to translate the function
+	if (ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[initialEntryPoint / 4] != PPCRecompiler_leaveRecompilerCode_visited)
+	{
+		PPCRecompiler_endCompilation();
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return false;
+	}
+
+	// check if the current range got invalidated during the time it took to recompile it
+	// this has to happen before endCompilation(), which drops the invalidation ranges once no compilation is in flight
+	bool isInvalidated = PPCRecompiler_isInvalidatedSince(ppcRecFunc, compilationSequenceId);
+	PPCRecompiler_endCompilation();
 	if (isInvalidated)
 	{
 		s_ppcRecompilerState.recompilerSpinlock.unlock();
@@ -417,6 +534,44 @@ bool PPCRecompiler_makeRecompiledFunctionActive(uint32 initialEntryPoint, PPCFun
 	{
 		r.storedRange = s_ppcRecompilerState.functionStorage.storeRange(ppcRecFunc, r.ppcAddress, r.ppcAddress + r.ppcSize);
 	}
+	if (ppcRecFunc->tier == 0)
+		s_ppcRecompilerState.tier0Functions.emplace_back(ppcRecFunc);
+	s_ppcRecompilerState.recompilerSpinlock.unlock();
+	return true;
+}
+
+void PPCRecompiler_deleteFunction(PPCRecFunction_t* func);
+
+// must be called with recompilerSpinlock held
+bool PPCRecompiler_isFunctionActive(PPCRecFunction_t* ppcRecFunc)
+{
+	return !ppcRecFunc->list_ranges.empty() && ppcRecFunc->list_ranges[0].storedRange != nullptr;
+}
+
+// replace a function with a version compiled at a higher tier
+// jump table entries are overwritten in place so that there is no window in which the entry points fall back to the interpreter
+bool PPCRecompiler_replaceRecompiledFunction(PPCRecFunction_t* oldFunc, PPCRecFunction_t* newFunc, std::vector<std::pair<MPTR, uint32>>& entryPoints, uint64 compilationSequenceId)
+{
+	s_ppcRecompilerState.recompilerSpinlock.lock();
+	bool isInvalidated = PPCRecompiler_isInvalidatedSince(newFunc, compilationSequenceId);
+	PPCRecompiler_endCompilation();
+	if (!PPCRecompiler_isFunctionActive(oldFunc) || isInvalidated)
+	{
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return false;
+	}
+	cemu_assert_debug(newFunc->jumpTableEntries.empty());
+	for (auto& itr : entryPoints)
+	{
+		PPCREC_JUMP_ENTRY hostEntrypoint = (PPCREC_JUMP_ENTRY)((uint8*)newFunc->x86Code + itr.second);
+		std::atomic_ref<PPCREC_JUMP_ENTRY>(ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[itr.first / 4]).store(hostEntrypoint, std::memory_order_release);
+		newFunc->jumpTableEntries.emplace_back(itr.first, (void*)hostEntrypoint);
+	}
+	// unlink the old function. Entry points which were not overwritten fall back to unvisited
+	// the old code is not freed since other threads may still be executing it
+	PPCRecompiler_deleteFunction(oldFunc);
+	for (auto& r : newFunc->list_ranges)
+		r.storedRange = s_ppcRecompilerState.functionStorage.storeRange(newFunc, r.ppcAddress, r.ppcAddress + r.ppcSize);
 	s_ppcRecompilerState.recompilerSpinlock.unlock();
 	return true;
 }
@@ -441,55 +596,144 @@ void PPCRecompiler_recompileAtAddress(uint32 address)
 	s_ppcRecompilerState.recompilerSpinlock.lock();
 	std::set<uint32> entryAddresses;
 	entryAddresses.emplace(address);
+	uint64 compilationSequenceId = PPCRecompiler_beginCompilation();
 	s_ppcRecompilerState.recompilerSpinlock.unlock();
 
 	std::vector<std::pair<MPTR, uint32>> functionEntryPoints;
-	PPCRecFunction_t* func = PPCRecompiler_recompileFunction(range, entryAddresses, functionEntryPoints, funcBoundaries);
+	std::vector<uint8> imlCacheData;
+	PPCRecFunction_t* func = PPCRecompiler_recompileFunction(range, entryAddresses, functionEntryPoints, funcBoundaries, 0, &imlCacheData);
 	if (!func)
-		return; // recompilation failed
-	PPCRecompiler_makeRecompiledFunctionActive(address, range, func, functionEntryPoints);
+	{
+		// recompilation failed
+		s_ppcRecompilerState.recompilerSpinlock.lock();
+		PPCRecompiler_endCompilation();
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return;
+	}
+	func->initialEntryAddress = address;
+	if (PPCRecompiler_makeRecompiledFunctionActive(address, range, func, functionEntryPoints, compilationSequenceId) && !imlCacheData.empty())
+		PPCRecompilerCache_StoreFunction(address, func, imlCacheData);
+}
+
+// recompile a frequently executed function with more expensive optimizations
+void PPCRecompiler_recompileHotFunction(PPCRecFunction_t* oldFunc)
+{
+	// collect all entry points of the currently active version
+	s_ppcRecompilerState.recompilerSpinlock.lock();
+	if (!PPCRecompiler_isFunctionActive(oldFunc))
+	{
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return;
+	}
+	std::set<uint32> entryAddresses;
+	for (auto& it : oldFunc->jumpTableEntries)
+		entryAddresses.emplace(it.ppcAddr);
+	uint64 compilationSequenceId = PPCRecompiler_beginCompilation();
+	s_ppcRecompilerState.recompilerSpinlock.unlock();
+
+	PPCFunctionBoundaryTracker funcBoundaries;
+	funcBoundaries.trackStartPoint(oldFunc->initialEntryAddress);
+	PPCFunctionBoundaryTracker::PPCRange_t range;
+	std::vector<std::pair<MPTR, uint32>> functionEntryPoints;
+	PPCRecFunction_t* newFunc = nullptr;
+	if (funcBoundaries.getRangeForAddress(oldFunc->initialEntryAddress, range))
+		newFunc = PPCRecompiler_recompileFunction(range, entryAddresses, functionEntryPoints, funcBoundaries, 1);
+	if (!newFunc)
+	{
+		s_ppcRecompilerState.recompilerSpinlock.lock();
+		PPCRecompiler_endCompilation();
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return;
+	}
+	newFunc->initialEntryAddress = oldFunc->initialEntryAddress;
+	PPCRecompiler_replaceRecompiledFunction(oldFunc, newFunc, functionEntryPoints, compilationSequenceId);
+}
+
+// move tier 0 functions which crossed the entry threshold to the hot function queue
+void PPCRecompiler_collectHotFunctions()
+{
+	uint32 numQueued = 0;
+	s_ppcRecompilerState.recompilerSpinlock.lock();
+	std::erase_if(s_ppcRecompilerState.tier0Functions, [&numQueued](PPCRecFunction_t* func)
+	{
+		if (!PPCRecompiler_isFunctionActive(func))
+			return true;
+		// the counter is incremented by generated code running on the PPC threads
+		if (std::atomic_ref<uint32>(func->entryCounter).load(std::memory_order_relaxed) < PPCREC_HOT_FUNCTION_THRESHOLD)
+			return false;
+		s_ppcRecompilerState.hotFunctionQueue.emplace(func);
+		numQueued++;
+		return true;
+	});
+	s_ppcRecompilerState.recompilerSpinlock.unlock();
+	for (uint32 i = 0; i < numQueued; i++)
+		s_ppcRecompilerState.targetQueueSemaphore.increment();
 }
 
-void PPCRecompiler_thread()
+uint32 PPCRecompiler_GetWorkerThreadCount()
 {
-	SetThreadName("PPCRecompiler");
+	// leave room for the emulated PPC cores and the GPU thread
+	sint32 hostCoreCount = (sint32)std::thread::hardware_concurrency();
+	return (uint32)std::clamp<sint32>(hostCoreCount - 4, 1, PPCREC_MAX_WORKER_THREADS);
+}
+
+void PPCRecompiler_thread(uint32 workerIndex)
+{
+	SetThreadName(fmt::format("PPCRecompiler{}", workerIndex).c_str());
 #if PPCREC_FORCE_SYNCHRONOUS_COMPILATION
 	return;
 #endif
 
+	// asynchronous recompilation:
+	// 1) take the most visited address from queue
+	// 2) check if address is still pending and marked as visited
+	// 3) if yes -> calculate size, gather all entry points, recompile and update jump table
+	// hot functions are only recompiled when there is no unvisited code left in the queue
 	while (true)
 	{
-        if(s_ppcRecompilerState.workerThreadStopSignal)
-            return;
-		std::this_thread::sleep_for(std::chrono::milliseconds(10));
-		// asynchronous recompilation:
-		// 1) take address from queue
-		// 2) check if address is still marked as visited
-		// 3) if yes -> calculate size, gather all entry points, recompile and update jump table
-		while (true)
+		if (!s_ppcRecompilerState.targetQueueSemaphore.decrementWithWaitAndTimeout(PPCREC_HOT_FUNCTION_SCAN_INTERVAL))
 		{
-			s_ppcRecompilerState.recompilerSpinlock.lock();
-			if (s_ppcRecompilerState.targetQueue.empty())
-			{
-				s_ppcRecompilerState.recompilerSpinlock.unlock();
-				break;
-			}
-			auto enterAddress = s_ppcRecompilerState.targetQueue.front();
-			s_ppcRecompilerState.targetQueue.pop();
-
-			auto funcPtr = ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[enterAddress / 4];
-			if (funcPtr != PPCRecompiler_leaveRecompilerCode_visited)
+			if (s_ppcRecompilerState.workerThreadStopSignal)
+				return;
+			if (workerIndex == 0)
+				PPCRecompiler_collectHotFunctions();
+			continue;
+		}
+		if (s_ppcRecompilerState.workerThreadStopSignal)
+			return;
+		s_ppcRecompilerState.recompilerSpinlock.lock();
+		if (s_ppcRecompilerState.targetQueue.empty())
+		{
+			cemu_assert_debug(!s_ppcRecompilerState.hotFunctionQueue.empty());
+			if (s_ppcRecompilerState.hotFunctionQueue.empty())
 			{
-				// only recompile functions if marked as visited
 				s_ppcRecompilerState.recompilerSpinlock.unlock();
 				continue;
 			}
+			PPCRecFunction_t* hotFunc = s_ppcRecompilerState.hotFunctionQueue.front();
+			s_ppcRecompilerState.hotFunctionQueue.pop();
 			s_ppcRecompilerState.recompilerSpinlock.unlock();
-
-			PPCRecompiler_recompileAtAddress(enterAddress);
-			if(s_ppcRecompilerState.workerThreadStopSignal)
-				return;
+			PPCRecompiler_recompileHotFunction(hotFunc);
+			continue;
+		}
+		MPTR enterAddress = s_ppcRecompilerState.targetQueue.top().enterAddress;
+		s_ppcRecompilerState.targetQueue.pop();
+		// the first (highest priority) entry for an address claims it, any remaining duplicates are skipped
+		if (s_ppcRecompilerState.pendingVisitCount.erase(enterAddress) == 0)
+		{
+			s_ppcRecompilerState.recompilerSpinlock.unlock();
+			continue;
+		}
+		auto funcPtr = ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[enterAddress / 4];
+		if (funcPtr != PPCRecompiler_leaveRecompilerCode_visited)
+		{
+			// only recompile functions if marked as visited
+			s_ppcRecompilerState.recompilerSpinlock.unlock();
+			continue;
 		}
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+
+		PPCRecompiler_recompileAtAddress(enterAddress);
 	}
 }
 
@@ -538,6 +782,33 @@ void PPCRecompiler_allocateRange(uint32 startAddress, uint32 size)
 	}
 }
 
+bool PPCRecompiler_isInitialized()
+{
+	return s_ppcRecompilerState.initialized;
+}
+
+// queue a function which was recompiled in a previous session, called while the function cache is loaded
+// unlike interpreter visits these entries start with a visit count of zero so that code which is actually executed takes precedence
+bool PPCRecompiler_queueFunctionFromCache(uint32 enterAddress)
+{
+	if (!s_ppcRecompilerState.initialized || enterAddress >= PPC_REC_CODE_AREA_SIZE)
+		return false;
+	if (!ppcRecompiler_reservedBlockMask[enterAddress / PPC_REC_ALLOC_BLOCK_SIZE])
+		return false; // not a code area
+	s_ppcRecompilerState.recompilerSpinlock.lock();
+	if (ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[enterAddress / 4] != PPCRecompiler_leaveRecompilerCode_unvisited)
+	{
+		s_ppcRecompilerState.recompilerSpinlock.unlock();
+		return false;
+	}
+	s_ppcRecompilerState.targetQueue.emplace(enterAddress, 0);
+	s_ppcRecompilerState.pendingVisitCount[enterAddress] = 0;
+	ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[enterAddress / 4] = PPCRecompiler_leaveRecompilerCode_visited;
+	s_ppcRecompilerState.recompilerSpinlock.unlock();
+	s_ppcRecompilerState.targetQueueSemaphore.increment();
+	return true;
+}
+
 bool PPCRecompiler_findFuncRanges(uint32 addr, ppcRecompilerFuncRange* rangesOut, size_t* countInOut)
 {
 	s_ppcRecompilerState.recompilerSpinlock.lock();
@@ -606,9 +877,13 @@ void PPCRecompiler_invalidateRange(uint32 startAddr, uint32 endAddr)
 	while (s_ppcRecompilerState.functionStorage.findFirstRange(startAddr, endAddr, rStart, rEnd, rFunc))
 		PPCRecompiler_deleteFunction(rFunc);
 	// add entry to invalidation queue, this is used to invalidate functions for which recompilation has already started
-	s_ppcRecompilerState.invalidationRanges.emplace_back(startAddr, endAddr-startAddr);
+	if (s_ppcRecompilerState.numActiveCompilations > 0)
+		s_ppcRecompilerState.invalidationRanges.emplace_back(startAddr, endAddr-startAddr, s_ppcRecompilerState.invalidationSequenceId);
+	s_ppcRecompilerState.invalidationSequenceId++;
 
 	s_ppcRecompilerState.recompilerSpinlock.unlock();
+
+	PPCRecompilerCache_InvalidateRange(startAddr, endAddr);
 }
 
 #if defined(ARCH_X86_64)
@@ -697,21 +972,35 @@ void PPCRecompiler_init()
 	s_ppcRecompilerState.initialized = true;
 	s_ppcRecompilerState.recompilerEnableCount = 1; // enabled
 
-	// launch recompilation thread
-    s_ppcRecompilerState.workerThreadStopSignal = false;
-    s_ppcRecompilerState.workerThread = std::thread(PPCRecompiler_thread);
+	// launch recompilation threads
+	s_ppcRecompilerState.workerThreadStopSignal = false;
+	s_ppcRecompilerState.targetQueueSemaphore.reset();
+	uint32 workerCount = PPCRecompiler_GetWorkerThreadCount();
+	for (uint32 i = 0; i < workerCount; i++)
+		s_ppcRecompilerState.workerThreads.emplace_back(PPCRecompiler_thread, i);
+	cemuLog_log(LogType::Force, "Recompiler using {} worker thread(s)", workerCount);
 }
 
 void PPCRecompiler_Shutdown()
 {
-    // shut down recompiler thread
+    // shut down recompiler threads
     s_ppcRecompilerState.workerThreadStopSignal = true;
-    if(s_ppcRecompilerState.workerThread.joinable())
-        s_ppcRecompilerState.workerThread.join();
+    for (size_t i = 0; i < s_ppcRecompilerState.workerThreads.size(); i++)
+        s_ppcRecompilerState.targetQueueSemaphore.increment();
+    for (auto& workerThread : s_ppcRecompilerState.workerThreads)
+        workerThread.join();
+    s_ppcRecompilerState.workerThreads.clear();
+    PPCRecompilerCache_Close();
     // clean up queues
     while(!s_ppcRecompilerState.targetQueue.empty())
         s_ppcRecompilerState.targetQueue.pop();
+    s_ppcRecompilerState.pendingVisitCount.clear();
+    while(!s_ppcRecompilerState.hotFunctionQueue.empty())
+        s_ppcRecompilerState.hotFunctionQueue.pop();
+    s_ppcRecompilerState.tier0Functions.clear();
+    s_ppcRecompilerState.targetQueueSemaphore.reset();
     s_ppcRecompilerState.invalidationRanges.clear();
+    s_ppcRecompilerState.numActiveCompilations = 0;
     // clean range store
     s_ppcRecompilerState.functionStorage.clear();
     // clean up memory
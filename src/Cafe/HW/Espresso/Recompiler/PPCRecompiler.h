@@ -32,6 +32,10 @@ struct PPCRecFunction_t
 	size_t x86Size;
 	std::vector<ppcRecRange_t> list_ranges;
 	boost::container::small_vector<JumpTableEntry, 2> jumpTableEntries;
+	// tiered compilation
+	uint32 initialEntryAddress{};
+	uint8 tier{}; // 0 -> regular compilation, 1 -> recompiled with more expensive optimizations because it is executed frequently
+	uint32 entryCounter{}; // tier 0 only. Incremented by the generated code whenever the function is entered through the jump table
 };
 
 #include "Cafe/HW/Espresso/Recompiler/IML/IMLInstruction.h"
@@ -69,6 +73,9 @@ struct ppcImlGenContext_t
 	{
 		bool modifiesGQR[8];
 	}tracking;
+	// optimization tier
+	bool isHotFunction{false}; // enables more expensive optimizations
+	uint32* entryCounter{}; // if set, enterable segments increment this counter
 	// debug helpers
 	uint32 debug_entryPPCAddress{0};
 
@@ -162,6 +169,14 @@ void PPCRecompiler_allocateRange(uint32 startAddress, uint32 size);
 
 void PPCRecompiler_invalidateRange(uint32 startAddr, uint32 endAddr);
 
+// persistent function cache
+void PPCRecompilerCache_Open(uint64 titleId);
+void PPCRecompilerCache_SerializeIML(ppcImlGenContext_t& ppcImlGenContext, std::vector<uint8>& dataOut);
+bool PPCRecompilerCache_LoadIML(ppcImlGenContext_t& ppcImlGenContext, PPCRecFunction_t* ppcRecFunc, const std::set<uint32>& entryAddresses);
+void PPCRecompilerCache_StoreFunction(uint32 enterAddress, PPCRecFunction_t* ppcRecFunc, std::span<const uint8> imlData);
+void PPCRecompilerCache_InvalidateRange(uint32 startAddr, uint32 endAddr);
+void PPCRecompilerCache_Close();
+
 extern void ATTR_MS_ABI (*PPCRecompiler_enterRecompilerCode)(uint64 codeMem, uint64 ppcInterpreterInstance);
 extern void ATTR_MS_ABI (*PPCRecompiler_leaveRecompilerCode_visited)();
 extern void ATTR_MS_ABI (*PPCRecompiler_leaveRecompilerCode_unvisited)();
@@ -0,0 +1,438 @@
+#include "Cafe/HW/Espresso/Interpreter/PPCInterpreterInternal.h"
+#include "Cafe/HW/Espresso/Recompiler/PPCRecompiler.h"
+#include "Cafe/HW/MMU/MMU.h"
+#include "Cafe/OS/libs/coreinit/coreinit_CodeGen.h"
+#include "Cemu/FileCache/FileCache.h"
+#include "config/ActiveSettings.h"
+#include "util/crypto/crc32.h"
+#include "util/helpers/Serializer.h"
+
+// Persistent per-title cache of recompiled functions
+// For every function that was successfully recompiled we store the entry address, the guest code ranges it covers and the IML
+// as it was after the optimization passes, together with a hash of the guest code. On the next boot all entries whose code is unchanged
+// are queued for recompilation immediately. Compiling them skips the frontend and the optimizer, only register allocation and the
+// backend are run again
+// The generated host code itself is not cached. It embeds absolute host pointers (recompiler instance data, memory base,
+// HLE handlers) which are different in every session. For the same reason the entry counters of tier 0 functions are only added after loading
+// Patched code (graphic packs, debugger, code generated at runtime) is rejected automatically because the hash no longer matches
+
+#define PPCREC_FUNCTION_CACHE_VERSION	3 // bump whenever the frontend, the optimization passes or the IML format change
+
+ATTR_MS_ABI uint32 PPCRecompiler_GetTBL();
+ATTR_MS_ABI uint32 PPCRecompiler_GetTBU();
+
+// host functions called by IML instructions are stored as an index into this table
+static const uintptr_t s_imlCallTargets[] =
+{
+	(uintptr_t)fres_espresso,
+	(uintptr_t)frsqrte_espresso,
+	(uintptr_t)PPCRecompiler_GetTBL,
+	(uintptr_t)PPCRecompiler_GetTBU,
+};
+
+#define IML_SEGMENT_INDEX_NONE	(0xFFFFFFFF)
+
+bool PPCRecompiler_isInitialized();
+bool PPCRecompiler_queueFunctionFromCache(uint32 enterAddress);
+
+// two independent hashes of the covered guest code. Together with the entry address they form the name of the cache entry
+struct PPCRecCodeHash
+{
+	uint32 crc;
+	uint64 mix;
+
+	bool operator==(const PPCRecCodeHash& other) const = default;
+};
+
+struct PPCRecCachedFunction
+{
+	std::pair<MPTR, MPTR> bounds; // covered guest code
+	PPCRecCodeHash codeHash;
+};
+
+struct
+{
+	std::mutex mutex;
+	FileCache* cache{};
+	std::unordered_map<uint32, PPCRecCachedFunction> storedFunctions; // entry address -> stored function
+}s_ppcRecFunctionCache;
+
+static uint32 PPCRecompilerCache_getExtraVersion(uint64 titleId)
+{
+	uint32 extraVersion = ((uint32)(titleId >> 32) + ((uint32)titleId) * 3) + PPCREC_FUNCTION_CACHE_VERSION + 0x3c81d6a5;
+	// IML instructions are stored as raw host structs
+	extraVersion += (uint32)sizeof(IMLInstruction) * 0x1000;
+#if defined(ARCH_X86_64)
+	extraVersion += 0x100;
+#elif defined(__aarch64__)
+	extraVersion += 0x200;
+#endif
+	return extraVersion;
+}
+
+// the range sizes are part of the stored header, so they don't need to be included in the hash
+static bool PPCRecompilerCache_hashCode(const std::vector<std::pair<MPTR, uint32>>& codeRanges, PPCRecCodeHash& hashOut)
+{
+	uint32 crc = 0;
+	uint64 mix = 0x2d58e7c31f96b40aull;
+	for (auto& it : codeRanges)
+	{
+		if (it.second == 0 || !memory_isAddressRangeAccessible(it.first, it.second))
+			return false;
+		const uint8* code = memory_getPointerFromVirtualOffset(it.first);
+		crc = crc32_calc(crc, code, it.second);
+		// PPC instructions are 4 bytes, ranges are always word aligned
+		cemu_assert_debug((it.second & 3) == 0);
+		for (uint32 i = 0; i < it.second / 4; i++)
+		{
+			uint32 v;
+			memcpy(&v, code + i * 4, 4);
+			mix = std::rotl<uint64>(mix ^ (uint64)v, 23) * 0x9e3779b97f4a7c15ull;
+		}
+	}
+	hashOut = { crc, mix };
+	return true;
+}
+
+static FileCache::FileName PPCRecompilerCache_getFileName(uint32 enterAddress, const PPCRecCodeHash& codeHash)
+{
+	return FileCache::FileName(((uint64)enterAddress << 32) | (uint64)codeHash.crc, codeHash.mix);
+}
+
+static std::pair<MPTR, MPTR> PPCRecompilerCache_getBounds(const std::vector<std::pair<MPTR, uint32>>& codeRanges)
+{
+	MPTR boundsStart = 0xFFFFFFFF;
+	MPTR boundsEnd = 0;
+	for (auto& it : codeRanges)
+	{
+		boundsStart = std::min(boundsStart, it.first);
+		boundsEnd = std::max(boundsEnd, it.first + it.second);
+	}
+	return { boundsStart, boundsEnd };
+}
+
+static bool PPCRecompilerCache_isCodeGenArea(MPTR address)
+{
+	uint32 codeGenRangeStart;
+	uint32 codeGenRangeSize = 0;
+	coreinit::OSGetCodegenVirtAddrRangeInternal(codeGenRangeStart, codeGenRangeSize);
+	return codeGenRangeSize != 0 && address >= codeGenRangeStart && address < (codeGenRangeStart + codeGenRangeSize);
+}
+
+// returns the entry address
+static uint32 PPCRecompilerCache_readHeader(MemStreamReader& streamReader, std::vector<std::pair<MPTR, uint32>>& codeRangesOut)
+{
+	uint32 enterAddress = streamReader.readBE<uint32>();
+	uint32 numRanges = streamReader.readBE<uint32>();
+	codeRangesOut.clear();
+	for (uint32 r = 0; r < numRanges && !streamReader.hasError(); r++)
+	{
+		MPTR rangeStart = streamReader.readBE<uint32>();
+		uint32 rangeSize = streamReader.readBE<uint32>();
+		codeRangesOut.emplace_back(rangeStart, rangeSize);
+	}
+	return enterAddress;
+}
+
+static uint32 PPCRecompilerCache_getSegmentIndex(IMLSegment* imlSegment)
+{
+	return imlSegment ? (uint32)imlSegment->momentaryIndex : IML_SEGMENT_INDEX_NONE;
+}
+
+static void PPCRecompilerCache_writeSegmentList(MemStreamWriter& memWriter, const std::vector<IMLSegment*>& segmentList)
+{
+	memWriter.writeBE<uint32>((uint32)segmentList.size());
+	for (IMLSegment* imlSegment : segmentList)
+		memWriter.writeBE<uint32>(PPCRecompilerCache_getSegmentIndex(imlSegment));
+}
+
+// serialize the IML of a function after the optimization passes. dataOut is left empty if the function can't be cached
+void PPCRecompilerCache_SerializeIML(ppcImlGenContext_t& ppcImlGenContext, std::vector<uint8>& dataOut)
+{
+	dataOut.clear();
+	ppcImlGenContext.UpdateSegmentIndices();
+	MemStreamWriter memWriter(4096);
+	memWriter.writeBE<uint8>(ppcImlGenContext.hasFPUInstruction ? 1 : 0);
+	for (bool modifiesGQR : ppcImlGenContext.tracking.modifiesGQR)
+		memWriter.writeBE<uint8>(modifiesGQR ? 1 : 0);
+	memWriter.writeBE<uint32>((uint32)ppcImlGenContext.mappedRegs.size());
+	for (auto& it : ppcImlGenContext.mappedRegs)
+	{
+		uint32 regRaw;
+		memcpy(&regRaw, &it.second, sizeof(uint32));
+		memWriter.writeBE<uint32>(it.first);
+		memWriter.writeBE<uint32>(regRaw);
+	}
+	memWriter.writeBE<uint32>((uint32)ppcImlGenContext.segmentList2.size());
+	for (IMLSegment* imlSegment : ppcImlGenContext.segmentList2)
+	{
+		memWriter.writeBE<uint32>(imlSegment->ppcAddress);
+		memWriter.writeBE<uint32>((uint32)imlSegment->loopDepth);
+		memWriter.writeBE<uint8>((imlSegment->isEnterable ? 1 : 0) | (imlSegment->nextSegmentIsUncertain ? 2 : 0));
+		memWriter.writeBE<uint32>(imlSegment->enterPPCAddress);
+		memWriter.writeBE<uint32>(PPCRecompilerCache_getSegmentIndex(imlSegment->nextSegmentBranchNotTaken));
+		memWriter.writeBE<uint32>(PPCRecompilerCache_getSegmentIndex(imlSegment->nextSegmentBranchTaken));
+		memWriter.writeBE<uint32>(PPCRecompilerCache_getSegmentIndex(imlSegment->deadCodeEliminationHintSeg));
+		PPCRecompilerCache_writeSegmentList(memWriter, imlSegment->list_prevSegments);
+		PPCRecompilerCache_writeSegmentList(memWriter, imlSegment->list_deadCodeHintBy);
+		memWriter.writeBE<uint32>((uint32)imlSegment->imlList.size());
+		for (auto& imlInstruction : imlSegment->imlList)
+		{
+			IMLInstruction storedInstruction(imlInstruction);
+			if (imlInstruction.type == PPCREC_IML_TYPE_CALL_IMM)
+			{
+				auto it = std::find(std::begin(s_imlCallTargets), std::end(s_imlCallTargets), imlInstruction.op_call_imm.callAddress);
+				if (it == std::end(s_imlCallTargets))
+					return; // unknown host function
+				storedInstruction.op_call_imm.callAddress = (uintptr_t)(it - std::begin(s_imlCallTargets));
+			}
+			memWriter.writeData(&storedInstruction, sizeof(IMLInstruction));
+		}
+	}
+	memWriter.getResultAndReset(dataOut);
+}
+
+static bool PPCRecompilerCache_readSegmentList(MemStreamReader& streamReader, std::span<IMLSegment*> segments, std::vector<IMLSegment*>& segmentListOut)
+{
+	uint32 count = streamReader.readBE<uint32>();
+	if (streamReader.hasError() || count > segments.size())
+		return false;
+	for (uint32 i = 0; i < count; i++)
+	{
+		uint32 index = streamReader.readBE<uint32>();
+		if (index >= segments.size())
+			return false;
+		segmentListOut.emplace_back(segments[index]);
+	}
+	return true;
+}
+
+static bool PPCRecompilerCache_readSegmentLink(MemStreamReader& streamReader, std::span<IMLSegment*> segments, IMLSegment*& segmentOut)
+{
+	uint32 index = streamReader.readBE<uint32>();
+	if (index == IML_SEGMENT_INDEX_NONE)
+		return true;
+	if (index >= segments.size())
+		return false;
+	segmentOut = segments[index];
+	return true;
+}
+
+static bool PPCRecompilerCache_deserializeIML(MemStreamReader& streamReader, ppcImlGenContext_t& ppcImlGenContext)
+{
+	ppcImlGenContext.hasFPUInstruction = streamReader.readBE<uint8>() != 0;
+	for (bool& modifiesGQR : ppcImlGenContext.tracking.modifiesGQR)
+		modifiesGQR = streamReader.readBE<uint8>() != 0;
+	uint32 numMappedRegs = streamReader.readBE<uint32>();
+	for (uint32 i = 0; i < numMappedRegs && !streamReader.hasError(); i++)
+	{
+		IMLName name = streamReader.readBE<uint32>();
+		uint32 regRaw = streamReader.readBE<uint32>();
+		IMLReg reg;
+		memcpy(&reg, &regRaw, sizeof(uint32));
+		ppcImlGenContext.mappedRegs.try_emplace(name, reg);
+	}
+	uint32 numSegments = streamReader.readBE<uint32>();
+	if (streamReader.hasError() || numSegments == 0 || numSegments > 0x10000)
+		return false;
+	std::span<IMLSegment*> segments = ppcImlGenContext.InsertSegments(0, numSegments);
+	for (IMLSegment* imlSegment : segments)
+	{
+		imlSegment->ppcAddress = streamReader.readBE<uint32>();
+		imlSegment->loopDepth = (sint32)streamReader.readBE<uint32>();
+		uint8 flags = streamReader.readBE<uint8>();
+		imlSegment->isEnterable = (flags & 1) != 0;
+		imlSegment->nextSegmentIsUncertain = (flags & 2) != 0;
+		imlSegment->enterPPCAddress = streamReader.readBE<uint32>();
+		if (!PPCRecompilerCache_readSegmentLink(streamReader, segments, imlSegment->nextSegmentBranchNotTaken) ||
+			!PPCRecompilerCache_readSegmentLink(streamReader, segments, imlSegment->nextSegmentBranchTaken) ||
+			!PPCRecompilerCache_readSegmentLink(streamReader, segments, imlSegment->deadCodeEliminationHintSeg))
+			return false;
+		if (!PPCRecompilerCache_readSegmentList(streamReader, segments, imlSegment->list_prevSegments) ||
+			!PPCRecompilerCache_readSegmentList(streamReader, segments, imlSegment->list_deadCodeHintBy))
+			return false;
+		uint32 numInstructions = streamReader.readBE<uint32>();
+		std::span<uint8> instructionData = streamReader.readDataNoCopy((size_t)numInstructions * sizeof(IMLInstruction));
+		if (streamReader.hasError())
+			return false;
+		imlSegment->imlList.resize(numInstructions);
+		memcpy(imlSegment->imlList.data(), instructionData.data(), instructionData.size());
+		for (auto& imlInstruction : imlSegment->imlList)
+		{
+			if (imlInstruction.type == PPCREC_IML_TYPE_CALL_IMM)
+			{
+				if (imlInstruction.op_call_imm.callAddress >= std::size(s_imlCallTargets))
+					return false;
+				imlInstruction.op_call_imm.callAddress = s_imlCallTargets[imlInstruction.op_call_imm.callAddress];
+			}
+		}
+	}
+	return !streamReader.hasError() && streamReader.isEndOfStream();
+}
+
+static void PPCRecompilerCache_resetIML(ppcImlGenContext_t& ppcImlGenContext)
+{
+	for (IMLSegment* imlSegment : ppcImlGenContext.segmentList2)
+		delete imlSegment;
+	ppcImlGenContext.segmentList2.clear();
+	ppcImlGenContext.mappedRegs.clear();
+}
+
+void PPCRecompilerCache_Open(uint64 titleId)
+{
+	if (!PPCRecompiler_isInitialized())
+		return;
+	std::unique_lock _l(s_ppcRecFunctionCache.mutex);
+	cemu_assert_debug(s_ppcRecFunctionCache.cache == nullptr);
+	std::error_code ec;
+	fs::create_directories(ActiveSettings::GetCachePath("recompiler"), ec);
+	const auto pathCacheFile = ActiveSettings::GetCachePath("recompiler/{:016x}_functions.bin", titleId);
+	s_ppcRecFunctionCache.cache = FileCache::Open(pathCacheFile, true, PPCRecompilerCache_getExtraVersion(titleId));
+	if (!s_ppcRecFunctionCache.cache)
+	{
+		cemuLog_log(LogType::Force, "Failed to open or create recompiler function cache: {}", _pathToUtf8(pathCacheFile));
+		return;
+	}
+	s_ppcRecFunctionCache.cache->UseCompression(false);
+	// queue all functions whose guest code did not change
+	uint32 numQueued = 0;
+	uint32 numRejected = 0;
+	sint32 maxFileIndex = s_ppcRecFunctionCache.cache->GetMaximumFileIndex();
+	std::vector<uint8> fileData;
+	std::vector<std::pair<MPTR, uint32>> codeRanges;
+	std::vector<std::pair<uint64, uint64>> staleEntries;
+	for (sint32 i = 0; i <= maxFileIndex; i++)
+	{
+		uint64 name1, name2;
+		if (!s_ppcRecFunctionCache.cache->GetFileByIndex(i, &name1, &name2, fileData))
+			continue;
+		MemStreamReader streamReader(fileData.data(), (sint32)fileData.size());
+		uint32 enterAddress = PPCRecompilerCache_readHeader(streamReader, codeRanges);
+		PPCRecCodeHash codeHash;
+		if (streamReader.hasError() || (uint32)(name1 >> 32) != enterAddress ||
+			!PPCRecompilerCache_hashCode(codeRanges, codeHash) || codeHash != PPCRecCodeHash{ (uint32)name1, name2 })
+		{
+			staleEntries.emplace_back(name1, name2);
+			numRejected++;
+			continue;
+		}
+		if (!PPCRecompiler_queueFunctionFromCache(enterAddress))
+			continue;
+		s_ppcRecFunctionCache.storedFunctions.try_emplace(enterAddress, PPCRecCachedFunction{ PPCRecompilerCache_getBounds(codeRanges), codeHash });
+		numQueued++;
+	}
+	for (auto& it : staleEntries)
+		s_ppcRecFunctionCache.cache->DeleteFile({ it.first, it.second });
+	cemuLog_log(LogType::Force, "Recompiler function cache: Queued {} functions, discarded {} outdated entries", numQueued, numRejected);
+}
+
+// load the optimized IML of a function which was compiled in a previous session
+// fails if the guest code changed or if the stored IML does not provide all requested entry points
+bool PPCRecompilerCache_LoadIML(ppcImlGenContext_t& ppcImlGenContext, PPCRecFunction_t* ppcRecFunc, const std::set<uint32>& entryAddresses)
+{
+	std::unique_lock _l(s_ppcRecFunctionCache.mutex);
+	if (!s_ppcRecFunctionCache.cache)
+		return false;
+	// any entry point of the function can have a stored version
+	uint32 enterAddress = 0;
+	PPCRecCodeHash codeHash{};
+	bool isStored = false;
+	for (uint32 entryAddress : entryAddresses)
+	{
+		auto it = s_ppcRecFunctionCache.storedFunctions.find(entryAddress);
+		if (it == s_ppcRecFunctionCache.storedFunctions.end())
+			continue;
+		enterAddress = entryAddress;
+		codeHash = it->second.codeHash;
+		isStored = true;
+		break;
+	}
+	if (!isStored)
+		return false;
+	std::vector<uint8> fileData;
+	if (!s_ppcRecFunctionCache.cache->GetFile(PPCRecompilerCache_getFileName(enterAddress, codeHash), fileData))
+		return false;
+	_l.unlock();
+	MemStreamReader streamReader(fileData.data(), (sint32)fileData.size());
+	std::vector<std::pair<MPTR, uint32>> codeRanges;
+	PPCRecompilerCache_readHeader(streamReader, codeRanges);
+	// the function boundaries have to match, and the code could have been modified since the cache was opened
+	PPCRecCodeHash currentCodeHash;
+	if (streamReader.hasError() || codeRanges.size() != 1 || codeRanges[0].first != ppcRecFunc->ppcAddress || codeRanges[0].second != ppcRecFunc->ppcSize ||
+		!PPCRecompilerCache_hashCode(codeRanges, currentCodeHash) || currentCodeHash != codeHash)
+		return false;
+	if (!PPCRecompilerCache_deserializeIML(streamReader, ppcImlGenContext))
+	{
+		cemuLog_log(LogType::Force, "Recompiler function cache: Entry for 0x{:08x} is corrupted", enterAddress);
+		PPCRecompilerCache_resetIML(ppcImlGenContext);
+		return false;
+	}
+	std::set<uint32> enterableAddresses;
+	for (IMLSegment* imlSegment : ppcImlGenContext.segmentList2)
+	{
+		if (imlSegment->isEnterable)
+			enterableAddresses.emplace(imlSegment->enterPPCAddress);
+	}
+	if (!std::includes(enterableAddresses.begin(), enterableAddresses.end(), entryAddresses.begin(), entryAddresses.end()))
+	{
+		PPCRecompilerCache_resetIML(ppcImlGenContext);
+		return false;
+	}
+	ppcRecRange_t recRange;
+	recRange.ppcAddress = ppcRecFunc->ppcAddress;
+	recRange.ppcSize = ppcRecFunc->ppcSize;
+	ppcRecFunc->list_ranges.push_back(recRange);
+	return true;
+}
+
+void PPCRecompilerCache_StoreFunction(uint32 enterAddress, PPCRecFunction_t* ppcRecFunc, std::span<const uint8> imlData)
+{
+	if (PPCRecompilerCache_isCodeGenArea(enterAddress))
+		return;
+	std::vector<std::pair<MPTR, uint32>> codeRanges;
+	for (auto& it : ppcRecFunc->list_ranges)
+		codeRanges.emplace_back(it.ppcAddress, it.ppcSize);
+	PPCRecCodeHash codeHash;
+	if (!PPCRecompilerCache_hashCode(codeRanges, codeHash))
+		return;
+	MemStreamWriter memWriter(64 + imlData.size());
+	memWriter.writeBE<uint32>(enterAddress);
+	memWriter.writeBE<uint32>((uint32)codeRanges.size());
+	for (auto& it : codeRanges)
+	{
+		memWriter.writeBE<uint32>(it.first);
+		memWriter.writeBE<uint32>(it.second);
+	}
+	memWriter.writeData(imlData.data(), imlData.size());
+	std::unique_lock _l(s_ppcRecFunctionCache.mutex);
+	if (!s_ppcRecFunctionCache.cache)
+		return;
+	// replace the previously stored version, e.g. if it did not provide all the entry points which are known now
+	auto it = s_ppcRecFunctionCache.storedFunctions.find(enterAddress);
+	if (it != s_ppcRecFunctionCache.storedFunctions.end())
+	{
+		s_ppcRecFunctionCache.cache->DeleteFile(PPCRecompilerCache_getFileName(enterAddress, it->second.codeHash));
+		s_ppcRecFunctionCache.storedFunctions.erase(it);
+	}
+	s_ppcRecFunctionCache.storedFunctions.try_emplace(enterAddress, PPCRecCachedFunction{ PPCRecompilerCache_getBounds(codeRanges), codeHash });
+	auto blob = memWriter.getResult();
+	s_ppcRecFunctionCache.cache->AddFile(PPCRecompilerCache_getFileName(enterAddress, codeHash), blob.data(), (sint32)blob.size());
+}
+
+// called when guest code in the given range was modified
+// functions in that range need to be stored again after they are recompiled, since their code hash changed
+void PPCRecompilerCache_InvalidateRange(uint32 startAddr, uint32 endAddr)
+{
+	std::unique_lock _l(s_ppcRecFunctionCache.mutex);
+	if (!s_ppcRecFunctionCache.cache)
+		return;
+	std::erase_if(s_ppcRecFunctionCache.storedFunctions, [startAddr, endAddr](const auto& it) { return it.second.bounds.first < endAddr && it.second.bounds.second > startAddr; });
+}
+
+void PPCRecompilerCache_Close()
+{
+	std::unique_lock _l(s_ppcRecFunctionCache.mutex);
+	delete s_ppcRecFunctionCache.cache;
+	s_ppcRecFunctionCache.cache = nullptr;
+	s_ppcRecFunctionCache.storedFunctions.clear();
+}
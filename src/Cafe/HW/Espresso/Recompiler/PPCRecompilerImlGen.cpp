@@ -3097,6 +3097,7 @@ void PPCRecompiler_SetSegmentsUncertainFlow(ppcImlGenContext_t& ppcImlGenContext
 					break;
 				case PPCREC_IML_MACRO_DEBUGBREAK:
 				case PPCREC_IML_MACRO_COUNT_CYCLES:
+				case PPCREC_IML_MACRO_COUNT_ENTRY:
 					break;
 				default:
 				cemu_assert_unimplemented();
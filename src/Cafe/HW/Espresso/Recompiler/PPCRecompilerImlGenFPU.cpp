@@ -718,6 +718,7 @@ bool PPCRecompilerImlGen_FCTIWZ(ppcImlGenContext_t* ppcImlGenContext, uint32 opc
 }
 
 bool PPCRecompiler_isUGQRValueKnown(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, uint32& gqrValue);
+bool PPCRecompiler_getSpeculatedUGQRValue(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, uint32& gqrValue);
 
 void PPCRecompilerImlGen_ClampInteger(ppcImlGenContext_t* ppcImlGenContext, IMLReg reg, sint32 clampMin, sint32 clampMax)
 {
@@ -759,7 +760,29 @@ void PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext_t* ppcImlGenContext, IMLRe
 	ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_BITCAST_INT_TO_FLOAT, fprRegScaleOut, gprTmp2);
 }
 
-void PPCRecompilerImlGen_EmitPSQLoadCase(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, Espresso::PSQ_LOAD_TYPE loadType, bool readPS1, IMLReg gprA, sint32 imm, IMLReg fprDPS0, IMLReg fprDPS1)
+// for hot functions the dynamic PSQ handler gets an extra case for the speculated GQR value, which skips the scaling
+// the extracted load/store type in loadTypeReg is replaced with PSQ_SPECULATED_GQR_CASE if the GQR holds the speculated value
+constexpr sint32 PSQ_SPECULATED_GQR_CASE = 8;
+
+bool PPCRecompilerImlGen_EmitPSQSpeculationCheck(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, IMLReg gqrRegister, IMLReg loadTypeReg, uint32& speculatedGQRValue)
+{
+	if (!PPCRecompiler_getSpeculatedUGQRValue(ppcImlGenContext, gqrIndex, speculatedGQRValue))
+		return false;
+	IMLReg regTmpCondBool = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_TEMPORARY + 1);
+	ppcImlGenContext->emitInst().make_compare_s32(gqrRegister, (sint32)speculatedGQRValue, regTmpCondBool, IMLCondition::EQ);
+	ppcImlGenContext->emitInst().make_conditional_jump(regTmpCondBool, false); // skip if the GQR holds a different value
+	PPCIMLGen_CreateSegmentBranchedPath(*ppcImlGenContext, *ppcImlGenContext->currentBasicBlock,
+		[&](ppcImlGenContext_t& genCtx)
+		{
+			/* branch not taken */
+			genCtx.emitInst().make_r_s32(PPCREC_IML_OP_ASSIGN, loadTypeReg, PSQ_SPECULATED_GQR_CASE);
+		}
+	);
+	return true;
+}
+
+// if scaleIsOne is set the caller guarantees that the scale field of the GQR is zero and the scaling is omitted
+void PPCRecompilerImlGen_EmitPSQLoadCase(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, Espresso::PSQ_LOAD_TYPE loadType, bool readPS1, IMLReg gprA, sint32 imm, IMLReg fprDPS0, IMLReg fprDPS1, bool scaleIsOne = false)
 {
 	if (loadType == Espresso::PSQ_LOAD_TYPE::TYPE_F32)
 	{
@@ -772,41 +795,51 @@ void PPCRecompilerImlGen_EmitPSQLoadCase(ppcImlGenContext_t* ppcImlGenContext, s
 	if (loadType == Espresso::PSQ_LOAD_TYPE::TYPE_U16 || loadType == Espresso::PSQ_LOAD_TYPE::TYPE_S16)
 	{
 		// get scale factor
-		IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
 		IMLReg fprScaleReg = _GetFPRTemp(ppcImlGenContext, 2);
-		PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, true);
+		if (!scaleIsOne)
+		{
+			IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
+			PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, true);
+		}
 
 		bool isSigned = (loadType == Espresso::PSQ_LOAD_TYPE::TYPE_S16);
 		IMLReg gprTmp = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_TEMPORARY + 0);
 		ppcImlGenContext->emitInst().make_r_memory(gprTmp, gprA, imm, 16, isSigned, true);
 		ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_INT_TO_FLOAT, fprDPS0, gprTmp);
 
-		ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS0, fprDPS0, fprScaleReg);
+		if (!scaleIsOne)
+			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS0, fprDPS0, fprScaleReg);
 
 		if(readPS1)
 		{
 			ppcImlGenContext->emitInst().make_r_memory(gprTmp, gprA, imm + 2, 16, isSigned, true);
 			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_INT_TO_FLOAT, fprDPS1, gprTmp);
-			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS1, fprDPS1, fprScaleReg);
+			if (!scaleIsOne)
+				ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS1, fprDPS1, fprScaleReg);
 		}
 	}
 	else if (loadType == Espresso::PSQ_LOAD_TYPE::TYPE_U8 || loadType == Espresso::PSQ_LOAD_TYPE::TYPE_S8)
 	{
 		// get scale factor
-		IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
 		IMLReg fprScaleReg = _GetFPRTemp(ppcImlGenContext, 2);
-		PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, true);
+		if (!scaleIsOne)
+		{
+			IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
+			PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, true);
+		}
 
 		bool isSigned = (loadType == Espresso::PSQ_LOAD_TYPE::TYPE_S8);
 		IMLReg gprTmp = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_TEMPORARY + 0);
 		ppcImlGenContext->emitInst().make_r_memory(gprTmp, gprA, imm, 8, isSigned, true);
 		ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_INT_TO_FLOAT, fprDPS0, gprTmp);
-		ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS0, fprDPS0, fprScaleReg);
+		if (!scaleIsOne)
+			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS0, fprDPS0, fprScaleReg);
 		if(readPS1)
 		{
 			ppcImlGenContext->emitInst().make_r_memory(gprTmp, gprA, imm + 1, 8, isSigned, true);
 			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_INT_TO_FLOAT, fprDPS1, gprTmp);
-			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS1, fprDPS1, fprScaleReg);
+			if (!scaleIsOne)
+				ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprDPS1, fprDPS1, fprScaleReg);
 		}
 	}
 }
@@ -845,13 +878,21 @@ bool PPCRecompilerImlGen_PSQ_L(ppcImlGenContext_t* ppcImlGenContext, uint32 opco
 		// extract the load type from the GQR register
 		ppcImlGenContext->emitInst().make_r_r_s32(PPCREC_IML_OP_RIGHT_SHIFT_U, loadTypeReg, gqrRegister, 16);
 		ppcImlGenContext->emitInst().make_r_r_s32(PPCREC_IML_OP_AND, loadTypeReg, loadTypeReg, 0x7);
+		uint32 speculatedGQRValue = 0;
+		bool hasSpeculatedCase = PPCRecompilerImlGen_EmitPSQSpeculationCheck(ppcImlGenContext, gqrIndex, gqrRegister, loadTypeReg, speculatedGQRValue);
 		IMLSegment* caseSegment[6];
-		sint32 compareValues[6] = {0, 4, 5, 6, 7};
-		PPCIMLGen_CreateSegmentBranchedPathMultiple(*ppcImlGenContext, *ppcImlGenContext->currentBasicBlock, caseSegment, loadTypeReg, compareValues, 5, 0);
-		for (sint32 i=0; i<5; i++)
+		sint32 compareValues[6] = {PSQ_SPECULATED_GQR_CASE, 0, 4, 5, 6, 7};
+		sint32 firstCase = hasSpeculatedCase ? 0 : 1;
+		sint32 caseCount = 6 - firstCase;
+		PPCIMLGen_CreateSegmentBranchedPathMultiple(*ppcImlGenContext, *ppcImlGenContext->currentBasicBlock, caseSegment, loadTypeReg, compareValues + firstCase, caseCount, 1 - firstCase);
+		for (sint32 i=0; i<caseCount; i++)
 		{
 			IMLRedirectInstOutput outputToCase(ppcImlGenContext, caseSegment[i]); // while this is in scope, instructions go to caseSegment[i]
-			PPCRecompilerImlGen_EmitPSQLoadCase(ppcImlGenContext, gqrIndex, static_cast<Espresso::PSQ_LOAD_TYPE>(compareValues[i]), readPS1, gprA, imm, fprDPS0, fprDPS1);
+			sint32 caseValue = compareValues[firstCase + i];
+			if (caseValue == PSQ_SPECULATED_GQR_CASE)
+				PPCRecompilerImlGen_EmitPSQLoadCase(ppcImlGenContext, gqrIndex, static_cast<Espresso::PSQ_LOAD_TYPE>((speculatedGQRValue >> 16) & 0x7), readPS1, gprA, imm, fprDPS0, fprDPS1, true);
+			else
+				PPCRecompilerImlGen_EmitPSQLoadCase(ppcImlGenContext, gqrIndex, static_cast<Espresso::PSQ_LOAD_TYPE>(caseValue), readPS1, gprA, imm, fprDPS0, fprDPS1);
 			// create the case jump instructions here because we need to add it last
 			caseSegment[i]->AppendInstruction()->make_jump();
 		}
@@ -875,7 +916,8 @@ bool PPCRecompilerImlGen_PSQ_L(ppcImlGenContext_t* ppcImlGenContext, uint32 opco
 	return true;
 }
 
-void PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, Espresso::PSQ_LOAD_TYPE storeType, bool storePS1, IMLReg gprA, sint32 imm, IMLReg fprDPS0, IMLReg fprDPS1)
+// if scaleIsOne is set the caller guarantees that the scale field of the GQR is zero and the scaling is omitted
+void PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext_t* ppcImlGenContext, sint32 gqrIndex, Espresso::PSQ_LOAD_TYPE storeType, bool storePS1, IMLReg gprA, sint32 imm, IMLReg fprDPS0, IMLReg fprDPS1, bool scaleIsOne = false)
 {
 	cemu_assert_debug(!storePS1 || fprDPS1.IsValid());
 	if (storeType == Espresso::PSQ_LOAD_TYPE::TYPE_F32)
@@ -889,16 +931,24 @@ void PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext_t* ppcImlGenContext,
 	else if (storeType == Espresso::PSQ_LOAD_TYPE::TYPE_U16 || storeType == Espresso::PSQ_LOAD_TYPE::TYPE_S16)
 	{
 		// get scale factor
-		IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
 		IMLReg fprScaleReg = _GetFPRTemp(ppcImlGenContext, 2);
-		PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, false);
+		if (!scaleIsOne)
+		{
+			IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
+			PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, false);
+		}
 
 		bool isSigned = (storeType == Espresso::PSQ_LOAD_TYPE::TYPE_S16);
 		IMLReg fprTmp = _GetFPRTemp(ppcImlGenContext, 0);
 
 		IMLReg gprTmp = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_TEMPORARY + 0);
-		ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS0, fprScaleReg);
-		ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+		if (scaleIsOne)
+			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprDPS0);
+		else
+		{
+			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS0, fprScaleReg);
+			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+		}
 
 		if (isSigned)
 			PPCRecompilerImlGen_ClampInteger(ppcImlGenContext, gprTmp, -32768, 32767);
@@ -907,8 +957,13 @@ void PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext_t* ppcImlGenContext,
 		ppcImlGenContext->emitInst().make_memory_r(gprTmp, gprA, imm, 16, true);
 		if(storePS1)
 		{
-			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS1, fprScaleReg);
-			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+			if (scaleIsOne)
+				ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprDPS1);
+			else
+			{
+				ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS1, fprScaleReg);
+				ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+			}
 			if (isSigned)
 				PPCRecompilerImlGen_ClampInteger(ppcImlGenContext, gprTmp, -32768, 32767);
 			else
@@ -919,15 +974,23 @@ void PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext_t* ppcImlGenContext,
 	else if (storeType == Espresso::PSQ_LOAD_TYPE::TYPE_U8 || storeType == Espresso::PSQ_LOAD_TYPE::TYPE_S8)
 	{
 		// get scale factor
-		IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
 		IMLReg fprScaleReg = _GetFPRTemp(ppcImlGenContext, 2);
-		PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, false);
+		if (!scaleIsOne)
+		{
+			IMLReg gqrRegister = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_SPR0 + SPR_UGQR0 + gqrIndex);
+			PPCRecompilerIMLGen_GetPSQScale(ppcImlGenContext, gqrRegister, fprScaleReg, false);
+		}
 
 		bool isSigned = (storeType == Espresso::PSQ_LOAD_TYPE::TYPE_S8);
 		IMLReg fprTmp = _GetFPRTemp(ppcImlGenContext, 0);
 		IMLReg gprTmp = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_TEMPORARY + 0);
-		ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS0, fprScaleReg);
-		ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+		if (scaleIsOne)
+			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprDPS0);
+		else
+		{
+			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS0, fprScaleReg);
+			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+		}
 		if (isSigned)
 			PPCRecompilerImlGen_ClampInteger(ppcImlGenContext, gprTmp, -128, 127);
 		else
@@ -935,8 +998,13 @@ void PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext_t* ppcImlGenContext,
 		ppcImlGenContext->emitInst().make_memory_r(gprTmp, gprA, imm, 8, true);
 		if(storePS1)
 		{
-			ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS1, fprScaleReg);
-			ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+			if (scaleIsOne)
+				ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprDPS1);
+			else
+			{
+				ppcImlGenContext->emitInst().make_fpr_r_r_r(PPCREC_IML_OP_FPR_MULTIPLY, fprTmp, fprDPS1, fprScaleReg);
+				ppcImlGenContext->emitInst().make_fpr_r_r(PPCREC_IML_OP_FPR_FLOAT_TO_INT, gprTmp, fprTmp);
+			}
 			if (isSigned)
 				PPCRecompilerImlGen_ClampInteger(ppcImlGenContext, gprTmp, -128, 127);
 			else
@@ -976,14 +1044,22 @@ bool PPCRecompilerImlGen_PSQ_ST(ppcImlGenContext_t* ppcImlGenContext, uint32 opc
 		IMLReg loadTypeReg = PPCRecompilerImlGen_loadRegister(ppcImlGenContext, PPCREC_NAME_TEMPORARY + 0);
 		// extract the load type from the GQR register
 		ppcImlGenContext->emitInst().make_r_r_s32(PPCREC_IML_OP_AND, loadTypeReg, gqrRegister, 0x7);
+		uint32 speculatedGQRValue = 0;
+		bool hasSpeculatedCase = PPCRecompilerImlGen_EmitPSQSpeculationCheck(ppcImlGenContext, gqrIndex, gqrRegister, loadTypeReg, speculatedGQRValue);
 
-		IMLSegment* caseSegment[5];
-		sint32 compareValues[5] = {0, 4, 5, 6, 7};
-		PPCIMLGen_CreateSegmentBranchedPathMultiple(*ppcImlGenContext, *ppcImlGenContext->currentBasicBlock, caseSegment, loadTypeReg, compareValues, 5, 0);
-		for (sint32 i=0; i<5; i++)
+		IMLSegment* caseSegment[6];
+		sint32 compareValues[6] = {PSQ_SPECULATED_GQR_CASE, 0, 4, 5, 6, 7};
+		sint32 firstCase = hasSpeculatedCase ? 0 : 1;
+		sint32 caseCount = 6 - firstCase;
+		PPCIMLGen_CreateSegmentBranchedPathMultiple(*ppcImlGenContext, *ppcImlGenContext->currentBasicBlock, caseSegment, loadTypeReg, compareValues + firstCase, caseCount, 1 - firstCase);
+		for (sint32 i=0; i<caseCount; i++)
 		{
 			IMLRedirectInstOutput outputToCase(ppcImlGenContext, caseSegment[i]); // while this is in scope, instructions go to caseSegment[i]
-			PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext, gqrIndex, static_cast<Espresso::PSQ_LOAD_TYPE>(compareValues[i]), storePS1, gprA, imm, fprDPS0, fprDPS1);
+			sint32 caseValue = compareValues[firstCase + i];
+			if (caseValue == PSQ_SPECULATED_GQR_CASE)
+				PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext, gqrIndex, static_cast<Espresso::PSQ_LOAD_TYPE>(speculatedGQRValue & 0x7), storePS1, gprA, imm, fprDPS0, fprDPS1, true);
+			else
+				PPCRecompilerImlGen_EmitPSQStoreCase(ppcImlGenContext, gqrIndex, static_cast<Espresso::PSQ_LOAD_TYPE>(caseValue), storePS1, gprA, imm, fprDPS0, fprDPS1);
 			ppcImlGenContext->emitInst().make_jump(); // finalize case
 		}
 		return true;
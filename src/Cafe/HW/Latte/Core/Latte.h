@@ -55,6 +55,7 @@ struct LatteGPUState_t
 	bool activeShaderHasError; // if try, at least one currently bound shader stage has an error and cannot be used for drawing
 	bool repeatTextureInitialization; // if set during rendertarget or texture initialization, repeat the process (textures likely have been invalidated)
 	bool requiresTextureBarrier; // set if glTextureBarrier should be called
+	uint32 modifiedRegisterGroups; // LATTE_REG_GROUP_* mask of register groups written since the renderer last consumed them
 	// OSScreen
 	struct  
 	{
@@ -70,6 +71,17 @@ struct LatteGPUState_t
 
 extern LatteGPUState_t LatteGPUState;
 
+// register groups for which writes are tracked in LatteGPUState.modifiedRegisterGroups
+// this allows the renderer to skip re-deriving state which cannot have changed since the previous draw sequence
+// a group is marked when any of its registers is written, regardless of whether the value actually changed
+#define LATTE_REG_GROUP_BLEND			(1 << 0) // CB_COLOR_CONTROL, CB_TARGET_MASK, CB_BLENDn_CONTROL
+#define LATTE_REG_GROUP_DEPTH			(1 << 1) // DB_DEPTH_CONTROL, DB_STENCILREFMASK, DB_STENCILREFMASK_BF
+#define LATTE_REG_GROUP_RASTERIZER		(1 << 2) // PA_SU_SC_MODE_CNTL, PA_CL_CLIP_CNTL, VGT_PRIMITIVE_TYPE, VGT_STRMOUT_EN
+#define LATTE_REG_GROUP_VERTEX_FETCH	(1 << 3) // fetch shader program and vertex attribute buffer resources
+#define LATTE_REG_GROUP_ALL				(0xFFFFFFFF)
+
+void LatteGPUState_MarkRegistersModified(uint32 registerStartIndex, uint32 registerEndIndex); // registerEndIndex is exclusive
+
 // drawcall context
 
 struct LatteDrawcallContext
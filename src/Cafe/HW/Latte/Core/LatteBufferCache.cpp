@@ -2,6 +2,8 @@
 #include "util/ChunkedHeap/ChunkedHeap.h"
 #include "util/helpers/fspinlock.h"
 #include "config/ActiveSettings.h"
+#include "Cafe/HW/Latte/Core/LatteIndices.h"
+#include "Cafe/HW/MMU/MemoryWriteTracker.h"
 
 #define CACHE_PAGE_SIZE		0x400
 #define CACHE_PAGE_SIZE_M1	(CACHE_PAGE_SIZE-1)
@@ -1063,12 +1065,28 @@ public:
 		m_hasInvalidation = false;
 	}
 
+	// same as checkAndSyncModifications() for the whole range, but with page write tracking enabled only pages which were written by the CPU since the last check are hashed
+	void checkAndSyncModificationsOfWrittenPages()
+	{
+		if (!MemoryWriteTracker_IsActive())
+		{
+			checkAndSyncModifications(m_rangeBegin, m_rangeEnd, true);
+			return;
+		}
+		size_t modifiedBegin, modifiedEnd;
+		if (!MemoryWriteTracker_CheckRange(memory_getPointerFromPhysicalOffset(m_rangeBegin), m_rangeEnd - m_rangeBegin, m_writeTrackerSequence, &modifiedBegin, &modifiedEnd))
+			return;
+		MPTR rangeBegin = m_rangeBegin + ((uint32)modifiedBegin & ~CACHE_PAGE_SIZE_M1);
+		MPTR rangeEnd = std::min(m_rangeBegin + (((uint32)modifiedEnd + CACHE_PAGE_SIZE_M1) & ~CACHE_PAGE_SIZE_M1), m_rangeEnd);
+		checkAndSyncModifications(rangeBegin, rangeEnd, true);
+	}
+
 	void checkAndSyncModificationsIfChrononChanged(MPTR reservePhysAddress, uint32 reserveSize)
 	{
 		if (m_lastModifyCheckCronon != g_currentCacheChronon)
 		{
 			m_lastModifyCheckCronon = g_currentCacheChronon;
-			checkAndSyncModifications(m_rangeBegin, m_rangeEnd, true);
+			checkAndSyncModificationsOfWrittenPages();
 			m_hasInvalidation = false;
 		}
 		if (m_hasInvalidation)
@@ -1174,6 +1192,7 @@ private:
 	uint32 m_arrayIndex;
 	// state tracking
 	uint32 m_lastModifyCheckCronon{ g_currentCacheChronon - 1 };
+	uint64 m_writeTrackerSequence{ 0 };
 	std::vector<CachePageInfo> m_pageInfo;
 	bool m_hasStreamoutData{ false };
 	// invalidation
@@ -1716,7 +1735,11 @@ void LatteBufferCache_processDCFlushQueue()
 	g_spinlockDCFlushQueue.lock();
 	std::swap(s_DCFlushQueue, s_DCFlushQueueAlternate);
 	g_spinlockDCFlushQueue.unlock();
-	s_DCFlushQueueAlternate->ForAllAndClear([](uint32 index) {LatteBufferCache_invalidatePage(index * CACHE_PAGE_SIZE); });
+	s_DCFlushQueueAlternate->ForAllAndClear([](uint32 index)
+	{
+		LatteBufferCache_invalidatePage(index * CACHE_PAGE_SIZE);
+		LatteIndices_invalidate(memory_getPointerFromVirtualOffset(index * CACHE_PAGE_SIZE), CACHE_PAGE_SIZE);
+	});
 }
 
 void LatteBufferCache_notifyDrawDone()
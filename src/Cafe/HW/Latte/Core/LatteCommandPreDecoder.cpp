@@ -0,0 +1,366 @@
+#include "Cafe/HW/Latte/ISA/RegDefines.h"
+#include "Cafe/HW/Latte/Core/Latte.h"
+#include "Cafe/HW/Latte/Core/LattePM4.h"
+#include "Cafe/HW/Latte/Core/LatteCommandPreDecoder.h"
+#include "Cafe/OS/libs/TCL/TCL.h"
+#include "util/helpers/ConcurrentQueue.h"
+#include "util/helpers/helpers.h"
+
+#define CP_DECODER_FLUSH_SIZE		(16 * 1024) // chunks are handed to the GPU thread once they reach this size (in words) or when the ringbuffer runs empty
+#define CP_DECODER_MAX_QUEUED		64 // maximum number of decoded chunks which have not been executed yet
+#define CP_DECODER_MAX_NESTING		8 // maximum nesting depth of indirect buffers
+
+static std::thread s_decoderThread;
+static std::atomic_bool s_decoderActive{ false };
+static std::atomic_bool s_decoderStopRequested{ false };
+static ConcurrentQueue<LatteCPDecodedChunk*> s_decodedChunks;
+static ConcurrentQueue<LatteCPDecodedChunk*> s_freeChunks;
+static std::atomic<uint64> s_executedChunkCount{ 0 };
+static std::atomic<uint32> s_decoderWakeSignal{ 0 }; // incremented whenever a chunk was executed or the decoder is stopped
+
+class LatteCPDecoder
+{
+public:
+	void Run()
+	{
+		while (!s_decoderStopRequested)
+		{
+			uint32 itHeader;
+			if (!TCL::TCLGPUReadRBWord(itHeader))
+			{
+				// ringbuffer ran empty, let the GPU thread execute what we have so far
+				FlushChunk();
+				WaitForRingbufferData();
+				continue;
+			}
+			if (!DecodeRingbufferPacket(itHeader))
+				break;
+			if (m_chunk && m_chunk->commandData.size() >= CP_DECODER_FLUSH_SIZE)
+				FlushChunk();
+		}
+		if (m_chunk)
+			s_freeChunks.push(m_chunk);
+		m_chunk = nullptr;
+	}
+
+private:
+	// spin briefly for low latency, then block until the CPU submits new commands
+	void WaitForRingbufferData()
+	{
+		for (sint32 busy = 0; busy < 80; busy++)
+			_mm_pause();
+		TCL::TCLGPUWaitForRBWord(s_decoderStopRequested);
+	}
+
+	// blocks until the GPU thread has executed at least executedCount chunks. Returns false if the decoder is stopped in the meantime
+	bool WaitForExecutedChunks(uint64 executedCount, uint32 spinCount)
+	{
+		for (uint32 i = 0; i < spinCount; i++)
+		{
+			if (s_executedChunkCount.load(std::memory_order::acquire) >= executedCount)
+				return true;
+			_mm_pause();
+		}
+		while (true)
+		{
+			uint32 wakeSignal = s_decoderWakeSignal.load(std::memory_order::acquire);
+			if (s_executedChunkCount.load(std::memory_order::acquire) >= executedCount)
+				return true;
+			if (s_decoderStopRequested)
+				return false;
+			s_decoderWakeSignal.wait(wakeSignal, std::memory_order::acquire);
+		}
+	}
+
+	// blocks until the requested number of words was read. Returns false if the decoder is stopped in the meantime
+	bool ReadRingbufferWords(uint32be* wordsOut, uint32 count)
+	{
+		for (uint32 i = 0; i < count; i++)
+		{
+			uint32 word;
+			while (!TCL::TCLGPUReadRBWord(word))
+			{
+				if (s_decoderStopRequested)
+					return false;
+				TCL::TCLGPUWaitForRBWord(s_decoderStopRequested);
+			}
+			wordsOut[i] = word;
+		}
+		return true;
+	}
+
+	bool DecodeRingbufferPacket(uint32 itHeader)
+	{
+		uint32be packetData[128];
+		uint32 itHeaderType = (itHeader >> 30) & 3;
+		if (itHeaderType == 3)
+		{
+			uint32 itCode = (itHeader >> 8) & 0xFF;
+			uint32 nWords = ((itHeader >> 16) & 0x3FFF) + 1;
+			cemu_assert(nWords < 128);
+			if (!ReadRingbufferWords(packetData, nWords))
+				return false;
+			if (itCode == IT_INDIRECT_BUFFER_PRIV)
+			{
+				cemu_assert_debug(nWords == 3);
+				DecodeIndirectBuffer(packetData[0], packetData[2], 0);
+				return true;
+			}
+			BeginSegment(LatteCPDecodedChunk::SEGMENT_TYPE::RINGBUFFER);
+			AppendPacket(itHeader, packetData, nWords);
+			if (IsBarrierPacket(itCode))
+				FlushChunkAndWaitForExecution();
+		}
+		else if (itHeaderType == 2)
+		{
+			// filler packet, skip this
+			cemu_assert_debug(itHeader == 0x80000000);
+		}
+		else if (itHeaderType == 0)
+		{
+			uint32 registerCount = ((itHeader >> 16) & 0x3FFF) + 1;
+			cemu_assert(registerCount < 128);
+			if (!ReadRingbufferWords(packetData, registerCount))
+				return false;
+			BeginSegment(LatteCPDecodedChunk::SEGMENT_TYPE::RINGBUFFER);
+			AppendPacket(itHeader, packetData, registerCount);
+		}
+		else
+		{
+			// invalid header, pass it through so the GPU thread reports it
+			BeginSegment(LatteCPDecodedChunk::SEGMENT_TYPE::RINGBUFFER);
+			AppendPacket(itHeader, nullptr, 0);
+		}
+		return true;
+	}
+
+	void DecodeIndirectBuffer(MPTR physicalAddress, uint32 sizeInU32s, uint32 nestingDepth)
+	{
+		if (sizeInU32s == 0)
+			return;
+		if (nestingDepth >= CP_DECODER_MAX_NESTING)
+		{
+			cemuLog_log(LogType::Force, "Latte: Indirect buffers nested too deeply, skipping buffer at 0x{:08x}", physicalAddress);
+			return;
+		}
+		uint32be* buf = MEMPTR<uint32be>(physicalAddress).GetPtr();
+		if (nestingDepth == 0)
+			BeginSegment(LatteCPDecodedChunk::SEGMENT_TYPE::COMMAND_BUFFER, true);
+		DecodeCommandBuffer(buf, buf + sizeInU32s, nestingDepth);
+	}
+
+	void DecodeCommandBuffer(uint32be* cmd, uint32be* cmdEnd, uint32 nestingDepth)
+	{
+		while (cmd < cmdEnd)
+		{
+			uint32 itHeader = *cmd;
+			cmd++;
+			uint32 itHeaderType = (itHeader >> 30) & 3;
+			if (itHeaderType == 3)
+			{
+				uint32 itCode = (itHeader >> 8) & 0xFF;
+				uint32 nWords = ((itHeader >> 16) & 0x3FFF) + 1;
+				uint32be* cmdData = cmd;
+				cmd += nWords;
+				switch (itCode)
+				{
+				case IT_INDIRECT_BUFFER_PRIV:
+					cemu_assert_debug(nWords == 3);
+					DecodeIndirectBuffer(cmdData[0], cmdData[2], nestingDepth + 1);
+					break;
+				case IT_SET_CONTEXT_REG:
+				case IT_SET_ALU_CONST:
+				case IT_SET_CTL_CONST:
+				case IT_SET_SAMPLER:
+				case IT_SET_CONFIG_REG:
+					AppendRegisterPacket(itHeader, cmdData, nWords);
+					break;
+				default:
+					AppendPacket(itHeader, cmdData, nWords);
+					if (IsBarrierPacket(itCode))
+					{
+						// the remainder of the buffer is executed with a new draw pass context. This is equivalent since a wait always ends the current draw pass
+						FlushChunkAndWaitForExecution();
+						BeginSegment(LatteCPDecodedChunk::SEGMENT_TYPE::COMMAND_BUFFER, true);
+					}
+					break;
+				}
+			}
+			else if (itHeaderType == 2)
+			{
+				// filler packet
+			}
+			else if (itHeaderType == 0)
+			{
+				uint32 registerCount = ((itHeader >> 16) & 0x3FFF) + 1;
+				AppendPacket(itHeader, cmd, registerCount);
+				cmd += registerCount;
+			}
+			else
+			{
+				AppendPacket(itHeader, nullptr, 0);
+			}
+		}
+	}
+
+	static bool IsBarrierPacket(uint32 itCode)
+	{
+		return itCode == IT_WAIT_REG_MEM || itCode == IT_MEM_SEMAPHORE;
+	}
+
+	// returns true if two adjacent register writes can be merged without changing the result of the register range callbacks in the GPU thread's draw pass handling
+	static bool CanCoalesceRegisterRanges(uint32 itCode, uint32 registerOffsetBegin, uint32 registerOffsetMid, uint32 registerOffsetEnd)
+	{
+		switch (itCode)
+		{
+		case IT_SET_CONTEXT_REG:
+		{
+			// writes to SQ_VTX_SEMANTIC_CLEAR reset the semantic registers which may be written by the other half
+			const uint32 semanticClearOffset = mmSQ_VTX_SEMANTIC_CLEAR - LATTE_REG_BASE_CONTEXT;
+			return semanticClearOffset < registerOffsetBegin || semanticClearOffset >= registerOffsetEnd;
+		}
+		case IT_SET_ALU_CONST:
+		{
+			// dirty tracking distinguishes between PS and VS constants based on the start of the range
+			const uint32 vsConstantsOffset = (mmSQ_ALU_CONSTANT0_0 + 0x400) - LATTE_REG_BASE_ALU_CONST;
+			return (registerOffsetBegin >= vsConstantsOffset) == (registerOffsetMid >= vsConstantsOffset);
+		}
+		default:
+			return true;
+		}
+	}
+
+	void AppendRegisterPacket(uint32 itHeader, const uint32be* cmdData, uint32 nWords)
+	{
+		if (m_lastRegisterPacket >= 0 && nWords >= 2)
+		{
+			uint32be* prevPacket = m_chunk->commandData.data() + m_lastRegisterPacket;
+			uint32 prevHeader = prevPacket[0];
+			uint32 prevRegisterOffset = prevPacket[1];
+			uint32 prevRegisterCount = ((prevHeader >> 16) & 0x3FFF);
+			uint32 registerOffset = cmdData[0];
+			uint32 registerCount = nWords - 1;
+			if (((prevHeader >> 8) & 0xFF) == ((itHeader >> 8) & 0xFF) &&
+				prevRegisterOffset + prevRegisterCount == registerOffset &&
+				prevRegisterCount + registerCount < 0x4000 &&
+				CanCoalesceRegisterRanges((itHeader >> 8) & 0xFF, prevRegisterOffset, registerOffset, registerOffset + registerCount))
+			{
+				prevPacket[0] = (prevHeader & ~(0x3FFF << 16)) | ((prevRegisterCount + registerCount) << 16);
+				m_chunk->commandData.insert(m_chunk->commandData.end(), cmdData + 1, cmdData + nWords);
+				m_chunk->segments.back().end = (uint32)m_chunk->commandData.size();
+				return;
+			}
+		}
+		sint32 packetOffset = (sint32)(m_chunk ? m_chunk->commandData.size() : 0);
+		AppendPacket(itHeader, cmdData, nWords);
+		m_lastRegisterPacket = packetOffset;
+	}
+
+	void AppendPacket(uint32 itHeader, const uint32be* cmdData, uint32 nWords)
+	{
+		cemu_assert_debug(m_chunk && !m_chunk->segments.empty());
+		auto& commandData = m_chunk->commandData;
+		commandData.emplace_back(itHeader);
+		if (nWords > 0)
+			commandData.insert(commandData.end(), cmdData, cmdData + nWords);
+		m_chunk->segments.back().end = (uint32)commandData.size();
+		m_lastRegisterPacket = -1;
+	}
+
+	void BeginSegment(LatteCPDecodedChunk::SEGMENT_TYPE type, bool forceNewSegment = false)
+	{
+		if (!m_chunk)
+		{
+			if (!s_freeChunks.peek2(m_chunk))
+				m_chunk = new LatteCPDecodedChunk();
+		}
+		auto& segments = m_chunk->segments;
+		if (!forceNewSegment && !segments.empty() && segments.back().type == type)
+			return;
+		uint32 offset = (uint32)m_chunk->commandData.size();
+		segments.push_back({ type, offset, offset });
+		m_lastRegisterPacket = -1;
+	}
+
+	void FlushChunk()
+	{
+		if (!m_chunk)
+			return;
+		// limit how far the decoder can run ahead of the GPU thread
+		if (m_submittedChunkCount >= CP_DECODER_MAX_QUEUED && !WaitForExecutedChunks(m_submittedChunkCount - CP_DECODER_MAX_QUEUED + 1, 0))
+			return;
+		s_decodedChunks.push(m_chunk);
+		m_submittedChunkCount++;
+		m_chunk = nullptr;
+		m_lastRegisterPacket = -1;
+	}
+
+	void FlushChunkAndWaitForExecution()
+	{
+		FlushChunk();
+		WaitForExecutedChunks(m_submittedChunkCount, 2000);
+	}
+
+	LatteCPDecodedChunk* m_chunk{};
+	uint64 m_submittedChunkCount{};
+	sint32 m_lastRegisterPacket{-1}; // offset of the last appended packet if it was a register write, candidate for coalescing
+};
+
+void LatteCPDecoder_ThreadFunc()
+{
+	SetThreadName("LatteCPDecoder");
+	LatteCPDecoder decoder;
+	decoder.Run();
+}
+
+void LatteCPDecoder_Start()
+{
+	cemu_assert_debug(!s_decoderActive);
+	s_decoderStopRequested = false;
+	s_executedChunkCount = 0;
+	s_decoderActive = true;
+	s_decoderThread = std::thread(LatteCPDecoder_ThreadFunc);
+}
+
+void LatteCPDecoder_Stop()
+{
+	if (!s_decoderActive)
+		return;
+	s_decoderStopRequested = true;
+	// wake the decoder thread in case it is blocked
+	TCL::TCLGPUCancelWaitForRBWord();
+	s_decoderWakeSignal.fetch_add(1, std::memory_order::release);
+	s_decoderWakeSignal.notify_all();
+	s_decoderThread.join();
+	s_decoderActive = false;
+	LatteCPDecodedChunk* chunk;
+	while (s_decodedChunks.peek2(chunk))
+		delete chunk;
+	while (s_freeChunks.peek2(chunk))
+		delete chunk;
+}
+
+bool LatteCPDecoder_IsActive()
+{
+	return s_decoderActive;
+}
+
+LatteCPDecodedChunk* LatteCPDecoder_GetNextChunk()
+{
+	LatteCPDecodedChunk* chunk;
+	if (!s_decodedChunks.peek2(chunk))
+		return nullptr;
+	return chunk;
+}
+
+void LatteCPDecoder_ReleaseChunk(LatteCPDecodedChunk* chunk)
+{
+	chunk->commandData.clear();
+	chunk->segments.clear();
+	if (chunk->commandData.capacity() > CP_DECODER_FLUSH_SIZE * 4)
+		chunk->commandData.shrink_to_fit(); // don't keep memory of unusually large command buffers around
+	s_freeChunks.push(chunk);
+	s_executedChunkCount.fetch_add(1, std::memory_order::release);
+	s_decoderWakeSignal.fetch_add(1, std::memory_order::release);
+	s_decoderWakeSignal.notify_one();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Optional pre-decoding of the GPU command stream
+// A separate thread consumes the TCL ringbuffer ahead of the GPU thread and resolves indirect buffers into a flat PM4 stream:
+// - nested indirect buffers are inlined and filler packets are dropped
+// - register writes to adjacent ranges are coalesced into a single packet where this does not change how the GPU thread tracks dirty state
+// The GPU thread then only executes the decoded chunks with the regular command handlers
+// Packets which wait on guest memory (WAIT_REG_MEM, MEM_SEMAPHORE) act as barriers. The decoder does not continue past them until the GPU thread has executed them,
+// because the CPU side may still modify command buffers referenced by subsequent packets until the wait is satisfied
+
+struct LatteCPDecodedChunk
+{
+	enum class SEGMENT_TYPE : uint8
+	{
+		RINGBUFFER, // packets submitted directly to the ringbuffer
+		COMMAND_BUFFER, // contents of an indirect buffer, executed with its own draw pass context
+	};
+
+	struct Segment
+	{
+		SEGMENT_TYPE type;
+		uint32 begin; // offsets into commandData, in words
+		uint32 end;
+	};
+
+	std::vector<uint32be> commandData;
+	std::vector<Segment> segments;
+};
+
+void LatteCPDecoder_Start();
+void LatteCPDecoder_Stop();
+bool LatteCPDecoder_IsActive();
+
+LatteCPDecodedChunk* LatteCPDecoder_GetNextChunk(); // returns nullptr if no decoded commands are available
+void LatteCPDecoder_ReleaseChunk(LatteCPDecodedChunk* chunk); // called by the GPU thread once all segments of the chunk were executed
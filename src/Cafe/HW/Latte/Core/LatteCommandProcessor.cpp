@@ -10,11 +10,13 @@
 #include "Cafe/HW/Latte/Core/LatteBufferCache.h"
 #include "Cafe/HW/Latte/Core/LattePM4.h"
 #include "Cafe/HW/Latte/Core/LatteSurfaceCopy.h"
+#include "Cafe/HW/Latte/Core/LatteCommandPreDecoder.h"
 
 #include "Cafe/OS/libs/coreinit/coreinit_Time.h"
 #include "Cafe/OS/libs/TCL/TCL.h" // TCL currently handles the GPU command ringbuffer
 
 #include "Cafe/CafeSystem.h"
+#include "config/ActiveSettings.h"
 
 #include <boost/container/small_vector.hpp>
 
@@ -157,8 +159,8 @@ void LatteCP_processCommandBuffer(DrawPassContext& drawPassCtx);
 void LatteCP_signalEnterWait()
 {
 	// based on the assumption that games won't do a rugpull and swap out buffer data in the middle of an uninterrupted sequence of drawcalls,
-	// we only flush caches when the GPU goes idle or has to wait for any operation
-	LatteIndices_invalidateAll();
+	// we only re-validate caches when the GPU goes idle or has to wait for any operation
+	LatteIndices_notifyGPUWait();
 }
 
 /*
@@ -197,6 +199,96 @@ uint32 LatteCP_readU32Deprc()
 	UNREACHABLE;
 }
 
+/*
+* Same as LatteCP_readU32Deprc() but reads ringbuffer packets from the chunks produced by the command pre-decoder
+* Decoded indirect buffers are executed in between ringbuffer packets, in the order in which they were submitted
+*/
+static struct
+{
+	LatteCPDecodedChunk* chunk;
+	size_t segmentIndex;
+	uint32 readOffset;
+}s_cpPreDecodedReader{};
+
+// estimates how much CP processing time has elapsed based on the executed commands, if the value exceeds CP_TIMER_RECHECK then timers are handled
+static sint32 s_cpTimerRecheck = 0;
+
+uint32 LatteCP_readU32PreDecoded()
+{
+	auto& reader = s_cpPreDecodedReader;
+	while (true)
+	{
+		if (reader.chunk)
+		{
+			while (reader.segmentIndex < reader.chunk->segments.size())
+			{
+				const auto& segment = reader.chunk->segments[reader.segmentIndex];
+				if (segment.type == LatteCPDecodedChunk::SEGMENT_TYPE::RINGBUFFER)
+				{
+					if (reader.readOffset < segment.begin)
+						reader.readOffset = segment.begin;
+					if (reader.readOffset < segment.end)
+						return reader.chunk->commandData[reader.readOffset++];
+				}
+				else if (segment.end > segment.begin)
+				{
+					DrawPassContext drawPassCtx;
+					uint32be* buf = reader.chunk->commandData.data();
+					drawPassCtx.PushCurrentCommandQueuePos(buf + segment.begin, buf + segment.begin, buf + segment.end);
+					LatteCP_processCommandBuffer(drawPassCtx);
+					if (drawPassCtx.isWithinDrawPass())
+						drawPassCtx.endDrawPass();
+					// a segment can contain many merged indirect buffers, so weight it by size instead of counting it as a single packet
+					s_cpTimerRecheck += (sint32)((segment.end - segment.begin) / 4);
+					if (s_cpTimerRecheck >= CP_TIMER_RECHECK)
+					{
+						LatteTiming_HandleTimedVsync();
+						LatteAsyncCommands_checkAndExecute();
+						s_cpTimerRecheck = 0;
+					}
+				}
+				reader.segmentIndex++;
+			}
+			LatteCPDecoder_ReleaseChunk(reader.chunk);
+			reader.chunk = nullptr;
+		}
+		reader.chunk = LatteCPDecoder_GetNextChunk();
+		if (reader.chunk)
+		{
+			reader.segmentIndex = 0;
+			reader.readOffset = 0;
+			continue;
+		}
+
+		g_renderer->NotifyLatteCommandProcessorIdle(); // let the renderer know in case it wants to flush any commands
+		performanceMonitor.gpuTime_idleTime.beginMeasuring();
+		// no command data available, spin in a busy loop for a bit then check again
+		for (sint32 busy = 0; busy < 80; busy++)
+		{
+			_mm_pause();
+		}
+		LatteThread_HandleOSScreen(); // check if new frame was presented via OSScreen API
+
+		reader.chunk = LatteCPDecoder_GetNextChunk();
+		if (reader.chunk)
+		{
+			reader.segmentIndex = 0;
+			reader.readOffset = 0;
+			performanceMonitor.gpuTime_idleTime.endMeasuring();
+			continue;
+		}
+		if (Latte_GetStopSignal())
+			LatteThread_Exit();
+
+		// still no command data available, do some other tasks
+		LatteTiming_HandleTimedVsync();
+		LatteAsyncCommands_checkAndExecute();
+		std::this_thread::yield();
+		performanceMonitor.gpuTime_idleTime.endMeasuring();
+	}
+	UNREACHABLE;
+}
+
 template<uint32 readU32()>
 void LatteCP_skipWords(uint32 wordsToSkip)
 {
@@ -313,6 +405,41 @@ void LatteCP_itSetRegistersGeneric_handleSpecialRanges(uint32 registerStartIndex
 	}
 }
 
+struct LatteRegisterGroupRange
+{
+	uint32 registerStartIndex;
+	uint32 registerEndIndex; // exclusive
+	uint32 groupMask;
+};
+
+// sorted by register index
+static constexpr LatteRegisterGroupRange s_registerGroupRanges[] =
+{
+	{ Latte::REGADDR::VGT_PRIMITIVE_TYPE, Latte::REGADDR::VGT_PRIMITIVE_TYPE + 1, LATTE_REG_GROUP_RASTERIZER },
+	{ Latte::REGADDR::CB_TARGET_MASK, Latte::REGADDR::CB_TARGET_MASK + 1, LATTE_REG_GROUP_BLEND },
+	{ Latte::REGADDR::DB_STENCILREFMASK, Latte::REGADDR::DB_STENCILREFMASK_BF + 1, LATTE_REG_GROUP_DEPTH },
+	{ Latte::REGADDR::CB_BLEND0_CONTROL, Latte::REGADDR::CB_BLEND0_CONTROL + 8, LATTE_REG_GROUP_BLEND },
+	{ Latte::REGADDR::DB_DEPTH_CONTROL, Latte::REGADDR::DB_DEPTH_CONTROL + 1, LATTE_REG_GROUP_DEPTH },
+	{ Latte::REGADDR::CB_COLOR_CONTROL, Latte::REGADDR::CB_COLOR_CONTROL + 1, LATTE_REG_GROUP_BLEND },
+	{ Latte::REGADDR::PA_CL_CLIP_CNTL, Latte::REGADDR::PA_SU_SC_MODE_CNTL + 1, LATTE_REG_GROUP_RASTERIZER },
+	{ mmSQ_PGM_START_FS, mmSQ_PGM_START_FS + 2, LATTE_REG_GROUP_VERTEX_FETCH },
+	{ mmVGT_STRMOUT_EN, mmVGT_STRMOUT_EN + 1, LATTE_REG_GROUP_RASTERIZER },
+	{ mmSQ_VTX_ATTRIBUTE_BLOCK_START, mmSQ_VTX_ATTRIBUTE_BLOCK_END, LATTE_REG_GROUP_VERTEX_FETCH },
+};
+
+void LatteGPUState_MarkRegistersModified(uint32 registerStartIndex, uint32 registerEndIndex)
+{
+	uint32 groupMask = 0;
+	for (auto& range : s_registerGroupRanges)
+	{
+		if (registerEndIndex <= range.registerStartIndex)
+			break;
+		if (registerStartIndex < range.registerEndIndex)
+			groupMask |= range.groupMask;
+	}
+	LatteGPUState.modifiedRegisterGroups |= groupMask;
+}
+
 template<uint32 TRegisterBase>
 LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords)
 {
@@ -360,6 +487,7 @@ LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords)
 	}
 	// some register writes trigger special behavior
 	LatteCP_itSetRegistersGeneric_handleSpecialRanges<TRegisterBase>(registerStartIndex, registerEndIndex);
+	LatteGPUState_MarkRegistersModified(registerStartIndex, registerEndIndex);
 	return cmd;
 }
 
@@ -416,6 +544,7 @@ bool LatteCP_itSetRegistersGeneric2(LatteCMDPtr cmd, uint32 nWords, TRegRangeCal
 	}
 	// some register writes trigger special behavior
 	LatteCP_itSetRegistersGeneric_handleSpecialRanges<TRegisterBase>(registerStartIndex, registerEndIndex);
+	LatteGPUState_MarkRegistersModified(registerStartIndex, registerEndIndex + 1);
 	// callback
 	cbRegRange(registerStartIndex, registerEndIndex, hasRegChange);
 	return hasRegChange;
@@ -674,6 +803,7 @@ LatteCMDPtr LatteCP_itLoadReg(LatteCMDPtr cmd, uint32 nWords, uint32 regBase)
 		uint32 regCount = LatteReadCMD();
 		cemu_assert_debug(regCount != 0);
 		uint32 regAddr = regBase + regOffset;
+		LatteGPUState_MarkRegistersModified(regAddr, regAddr + regCount);
 		for (uint32 f = 0; f < regCount; f++)
 		{
 			LatteGPUState.contextRegisterShadowAddr[regAddr] = regShadowMemAddr;
@@ -1448,13 +1578,15 @@ void LatteCP_processCommandBuffer(DrawPassContext& drawPassCtx)
 	}
 }
 
-void LatteCP_ProcessRingbuffer()
+template<uint32 readU32()>
+void LatteCP_ProcessRingbufferInternal()
 {
-	sint32 timerRecheck = 0; // estimates how much CP processing time has elapsed based on the executed commands, if the value exceeds CP_TIMER_RECHECK then _handleTimers() is called
+	sint32& timerRecheck = s_cpTimerRecheck;
+	timerRecheck = 0;
 	uint32be tmpBuffer[128];
 	while (true)
 	{
-		uint32 itHeader = LatteCP_readU32Deprc();
+		uint32 itHeader = readU32();
 		uint32 itHeaderType = (itHeader >> 30) & 3;
 		if (itHeaderType == 3)
 		{
@@ -1463,7 +1595,7 @@ void LatteCP_ProcessRingbuffer()
 			cemu_assert(nWords < 128);
 			for (sint32 i=0; i<nWords; i++)
 			{
-				uint32 word = LatteCP_readU32Deprc();
+				uint32 word = readU32();
 				tmpBuffer[i] = word;
 			}
 			LatteCMDPtr cmd = (LatteCMDPtr)tmpBuffer;
@@ -1710,7 +1842,7 @@ void LatteCP_ProcessRingbuffer()
 			}
 			case IT_HLE_SYNC_ASYNC_OPERATIONS:
 			{
-				//LatteCP_skipWords<LatteCP_readU32Deprc>(nWords);
+				//LatteCP_skipWords<readU32>(nWords);
 				LatteTextureReadback_UpdateFinishedTransfers(true);
 				LatteQuery_UpdateFinishedQueriesForceFinishAll();
 				break;
@@ -1731,11 +1863,11 @@ void LatteCP_ProcessRingbuffer()
 			if (registerBase == 0x304A)
 			{
 				GX2::__GX2NotifyEvent(GX2::GX2CallbackEventType::TIMESTAMP_TOP);
-				LatteCP_skipWords<LatteCP_readU32Deprc>(registerCount);
+				LatteCP_skipWords<readU32>(registerCount);
 			}
 			else if (registerBase == 0x304B)
 			{
-				LatteCP_skipWords<LatteCP_readU32Deprc>(registerCount);
+				LatteCP_skipWords<readU32>(registerCount);
 			}
 			else
 			{
@@ -1756,6 +1888,20 @@ void LatteCP_ProcessRingbuffer()
 	}
 }
 
+void LatteCP_ProcessRingbuffer()
+{
+	if (ActiveSettings::GPUCommandPreDecodingEnabled())
+	{
+		s_cpPreDecodedReader = {};
+		LatteCPDecoder_Start();
+		LatteCP_ProcessRingbufferInternal<LatteCP_readU32PreDecoded>();
+	}
+	else
+	{
+		LatteCP_ProcessRingbufferInternal<LatteCP_readU32Deprc>();
+	}
+}
+
 #ifdef LATTE_CP_LOGGING
 void LatteCP_DebugPrintCmdBuffer(uint32be* bufferPtr, uint32 size)
 {
@@ -3,6 +3,9 @@
 #include "Cafe/HW/Latte/ISA/RegDefines.h"
 #include "Cafe/HW/Latte/Core/LattePerformanceMonitor.h"
 #include "Common/cpu_features.h"
+#include "Cafe/HW/MMU/MMU.h"
+#include "util/containers/IntervalBucketContainer.h"
+#include <boost/container/small_vector.hpp>
 
 #if defined(ARCH_X86_64) && defined(__GNUC__)
 #include <immintrin.h>
@@ -10,54 +13,114 @@
 #include <arm_neon.h>
 #endif
 
+// Converted index data is cached across draws and frames
+// Entries are keyed on the guest source range and all parameters which influence the output. The converted data stays resident in the renderer's index heap until the entry is evicted
+// Entries are dropped when the source range is flushed from the CPU data cache (see LatteBufferCache_processDCFlushQueue)
+// Since not every game flushes its index data reliably, entries are additionally re-validated against a hash of the source data after the GPU waited or went idle
+
+#define INDEX_CACHE_MAX_ENTRIES			(4096)
+#define INDEX_CACHE_MAX_MEMORY			(16 * 1024 * 1024) // upper limit for converted index data kept in the index heap
+
+struct LatteIndexCacheKey
+{
+	MPTR srcAddr;
+	uint32 count;
+	LatteIndexType indexType;
+	LattePrimitiveMode primitiveMode;
+	uint32 restartIndex;
+
+	bool operator==(const LatteIndexCacheKey& other) const = default;
+};
+
+struct LatteIndexCacheKeyHash
+{
+	size_t operator()(const LatteIndexCacheKey& key) const
+	{
+		uint64 h = (uint64)key.srcAddr * 0x9E3779B97F4A7C15ull;
+		h ^= ((uint64)key.count << 16) ^ ((uint64)key.indexType << 8) ^ (uint64)key.primitiveMode;
+		h ^= (uint64)key.restartIndex * 0xC2B2AE3D27D4EB4Full;
+		return (size_t)(h ^ (h >> 29));
+	}
+};
+
+struct LatteIndexCacheEntry
+{
+	LatteIndexCacheKey key;
+	uint32 srcSize; // 0 for generated indices
+	uint64 srcHash;
+	uint32 validationEpoch;
+	// output
+	uint32 indexMax;
+	Renderer::INDEX_TYPE renderIndexType;
+	uint32 outputCount;
+	uint32 outputSize;
+	Renderer::IndexAllocation indexAllocation;
+};
+
 struct
 {
-	struct CacheEntry
-	{
-		// input data
-		const void* lastPtr;
-		uint32 lastCount;
-		LattePrimitiveMode lastPrimitiveMode;
-		LatteIndexType lastIndexType;
-		uint64 lastUsed;
-		// output
-		uint32 indexMax;
-		Renderer::INDEX_TYPE renderIndexType;
-		uint32 outputCount;
-		Renderer::IndexAllocation indexAllocation;
-	};
-	std::array<CacheEntry, 8> entry;
-	uint64 currentUsageCounter{0};
+	std::list<LatteIndexCacheEntry> entries; // most recently used first
+	std::unordered_map<LatteIndexCacheKey, std::list<LatteIndexCacheEntry>::iterator, LatteIndexCacheKeyHash> lookup;
+	IntervalBucketContainer<LatteIndexCacheEntry, MPTR, 0x1000, 1024> ranges;
+	size_t totalOutputSize{0};
+	uint32 currentEpoch{1};
 }LatteIndexCache{};
 
-void LatteIndices_invalidate(const void* memPtr, uint32 size)
+static uint64 LatteIndices_hashSourceData(const void* data, uint32 size)
 {
-	for(auto& entry : LatteIndexCache.entry)
+	const uint8* ptr = (const uint8*)data;
+	const uint8* end = ptr + size;
+	uint64 h0 = size;
+	uint64 h1 = 0;
+	while ((ptr + 16) <= end)
 	{
-		if (entry.lastPtr >= memPtr && (entry.lastPtr < ((uint8*)memPtr + size)) )
-		{
-			if(entry.lastPtr != nullptr)
-				g_renderer->indexData_releaseIndexMemory(entry.indexAllocation);
-			entry.lastPtr = nullptr;
-			entry.lastCount = 0;
-		}
+		h0 = std::rotr(h0, 7) + *(const uint64*)(ptr + 0) * 0x55F23EADull;
+		h1 = std::rotr(h1, 7) + *(const uint64*)(ptr + 8) * 0x185FDC6Dull;
+		ptr += 16;
+	}
+	while (ptr < end)
+	{
+		h0 = std::rotr(h0, 7) + (uint64)*ptr * 0xF7431F49ull;
+		ptr++;
 	}
+	return h0 + h1 * 0xA4C7AE9Dull;
 }
 
-void LatteIndices_invalidateAll()
+static void LatteIndices_removeEntry(std::list<LatteIndexCacheEntry>::iterator it)
+{
+	if (it->srcSize != 0)
+		LatteIndexCache.ranges.removeRange(it->key.srcAddr, it->key.srcAddr + it->srcSize, &*it);
+	g_renderer->indexData_releaseIndexMemory(it->indexAllocation);
+	LatteIndexCache.totalOutputSize -= it->outputSize;
+	LatteIndexCache.lookup.erase(it->key);
+	LatteIndexCache.entries.erase(it);
+}
+
+void LatteIndices_invalidate(const void* memPtr, uint32 size)
 {
-	for(auto& entry : LatteIndexCache.entry)
+	if (LatteIndexCache.entries.empty() || size == 0)
+		return;
+	MPTR rangeStart = memory_getVirtualOffsetFromPointer((void*)memPtr);
+	boost::container::small_vector<LatteIndexCacheEntry*, 8> overlappingEntries;
+	LatteIndexCache.ranges.lookupRanges(rangeStart, rangeStart + size, [&](LatteIndexCacheEntry* entry) { overlappingEntries.emplace_back(entry); });
+	for (auto& entry : overlappingEntries)
 	{
-		if (entry.lastPtr != nullptr)
-			g_renderer->indexData_releaseIndexMemory(entry.indexAllocation);
-		entry.lastPtr = nullptr;
-		entry.lastCount = 0;
+		auto it = LatteIndexCache.lookup.find(entry->key);
+		if (it != LatteIndexCache.lookup.end() && &*it->second == entry) // ranges larger than the bucket span can be reported more than once
+			LatteIndices_removeEntry(it->second);
 	}
 }
 
-uint64 LatteIndices_GetNextUsageIndex()
+void LatteIndices_invalidateAll()
 {
-	return LatteIndexCache.currentUsageCounter++;
+	while (!LatteIndexCache.entries.empty())
+		LatteIndices_removeEntry(LatteIndexCache.entries.begin());
+}
+
+// called whenever the GPU went idle or had to wait. Cached entries are re-validated on their next use
+void LatteIndices_notifyGPUWait()
+{
+	LatteIndexCache.currentEpoch++;
 }
 
 uint32 LatteIndices_calculateIndexOutputSize(LattePrimitiveMode primitiveMode, LatteIndexType indexType, uint32 count)
@@ -248,25 +311,6 @@ void LatteIndices_unpackQuadStripAndConvert(const void* indexDataInput, void* in
 	}
 }
 
-template<typename T>
-void LatteIndices_unpackLineLoopAndConvert(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
-{
-	if (count <= 0)
-		return;
-	const betype<T>* src = (betype<T>*)indexDataInput;
-	T firstIndex = *src;
-	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < (sint32)count; i++)
-	{
-		T idx = *src;
-		indexMax = std::max(indexMax, (uint32)idx);
-		*dst = idx;
-		src++;
-		dst++;
-	}
-	*dst = firstIndex;
-}
-
 template<typename T>
 void LatteIndices_generateAutoQuadStripIndices(void* indexDataOutput, uint32 count, uint32& indexMax)
 {
@@ -598,6 +642,665 @@ void LatteIndices_fastConvertU32_NEON(const void* indexDataInput, void* indexDat
 
 #endif
 
+// shuffle patterns used by the SIMD variants of the quad/quad strip/triangle fan expansion
+// a vector holding numElements indices is expanded to the output elements returned by LatteIndices_getShuffleSourceElement()
+enum class LatteIndexShuffle
+{
+	SEQUENTIAL,
+	QUADS, // numElements/4 quads
+	QUAD_STRIP, // numElements/4 quads, reading numElements/2+2 indices
+	TRIANGLE_FAN, // first half of the vector holds the indices from the front, second half the indices from the back
+};
+
+constexpr uint32 LatteIndices_getShuffleSourceElement(LatteIndexShuffle shuffle, uint32 numElements, uint32 outputElement)
+{
+	constexpr uint32 quadPattern[6] = { 0, 1, 2, 0, 2, 3 };
+	constexpr uint32 quadStripPattern[6] = { 0, 1, 2, 2, 1, 3 };
+	switch (shuffle)
+	{
+	case LatteIndexShuffle::QUADS:
+		return (outputElement / 6) * 4 + quadPattern[outputElement % 6];
+	case LatteIndexShuffle::QUAD_STRIP:
+		return (outputElement / 6) * 2 + quadStripPattern[outputElement % 6];
+	case LatteIndexShuffle::TRIANGLE_FAN:
+		return (outputElement & 1) ? (numElements - 1 - outputElement / 2) : (outputElement / 2);
+	default:
+		break;
+	}
+	return outputElement;
+}
+
+template<typename T, size_t TLength>
+constexpr std::array<T, TLength> LatteIndices_makeElementShuffleTable(LatteIndexShuffle shuffle, uint32 numElements)
+{
+	std::array<T, TLength> table{};
+	for (uint32 i = 0; i < TLength; i++)
+		table[i] = (T)LatteIndices_getShuffleSourceElement(shuffle, numElements, i);
+	return table;
+}
+
+// same as above but as a byte shuffle which also converts each element from big endian
+template<size_t TLength>
+constexpr std::array<uint8, TLength> LatteIndices_makeByteShuffleTable(LatteIndexShuffle shuffle, uint32 elementSize, uint32 numElements)
+{
+	std::array<uint8, TLength> table{};
+	for (uint32 i = 0; i < TLength; i++)
+		table[i] = (uint8)(LatteIndices_getShuffleSourceElement(shuffle, numElements, i / elementSize) * elementSize + (elementSize - 1 - (i % elementSize)));
+	return table;
+}
+
+// scalar tails shared by the SIMD variants
+template<typename T>
+void LatteIndices_unpackTriangleFanAndConvertRange(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32 first, uint32& indexMax)
+{
+	const betype<T>* src = (betype<T>*)indexDataInput;
+	T* dst = (T*)indexDataOutput;
+	for (uint32 i = first; i < count; i++)
+	{
+		T idx = src[(i % 2 == 0) ? (i / 2) : (count - 1 - i / 2)];
+		indexMax = std::max(indexMax, (uint32)idx);
+		dst[i] = idx;
+	}
+}
+
+constexpr uint32 LatteIndices_getShuffleOutputCount(LatteIndexShuffle shuffle, uint32 count)
+{
+	if (shuffle == LatteIndexShuffle::QUADS)
+		return count / 4 * 6;
+	if (shuffle == LatteIndexShuffle::QUAD_STRIP)
+		return count <= 3 ? 0 : (count - 2) / 2 * 6;
+	return count;
+}
+
+template<typename T>
+void LatteIndices_generatePatternRange(void* indexDataOutput, LatteIndexShuffle shuffle, uint32 count, uint32 firstOutput, uint32 endOutput)
+{
+	T* dst = (T*)indexDataOutput;
+	for (uint32 i = firstOutput; i < endOutput; i++)
+	{
+		if (shuffle == LatteIndexShuffle::TRIANGLE_FAN)
+			dst[i] = (T)((i % 2 == 0) ? (i / 2) : (count - 1 - i / 2));
+		else
+			dst[i] = (T)LatteIndices_getShuffleSourceElement(shuffle, 0, i);
+	}
+}
+
+#if defined(ARCH_X86_64)
+// AVX-512 variants. The quad, quad strip and triangle fan expansion is done with a single cross-lane permute (vpermw/vpermd) per output vector
+// one block is one input vector of 64 bytes. Quads and quad strips produce 1.5 output vectors per block
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+static __m512i LatteIndices_swapEndian_AVX512(__m512i v)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm512_shuffle_epi8(v, _mm512_broadcast_i32x4(_mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1)));
+	else
+		return _mm512_shuffle_epi8(v, _mm512_broadcast_i32x4(_mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3)));
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+static __m512i LatteIndices_max_AVX512(__m512i a, __m512i b)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm512_max_epu16(a, b);
+	else
+		return _mm512_max_epu32(a, b);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+static __m512i LatteIndices_add_AVX512(__m512i a, __m512i b)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm512_add_epi16(a, b);
+	else
+		return _mm512_add_epi32(a, b);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+static __m512i LatteIndices_permute_AVX512(__m512i idx, __m512i v)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm512_permutexvar_epi16(idx, v);
+	else
+		return _mm512_permutexvar_epi32(idx, v);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+static uint32 LatteIndices_reduceMax_AVX512(__m512i v)
+{
+	if constexpr (sizeof(T) == 2)
+	{
+		__m256i m256 = _mm256_max_epu16(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+		__m128i m128 = _mm_max_epu16(_mm256_castsi256_si128(m256), _mm256_extracti128_si256(m256, 1));
+		// horizontal max via minpos of the inverted values
+		m128 = _mm_xor_si128(m128, _mm_set1_epi16(-1));
+		return 0xFFFF - ((uint32)_mm_cvtsi128_si32(_mm_minpos_epu16(m128)) & 0xFFFF);
+	}
+	else
+		return _mm512_reduce_max_epu32(v);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+void LatteIndices_fastConvert_AVX512(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 64 / sizeof(T);
+	const T* src = (const T*)indexDataInput;
+	T* dst = (T*)indexDataOutput;
+	const uint32 numBlocks = count / N;
+	__m512i mMax = _mm512_setzero_si512();
+	for (uint32 i = 0; i < numBlocks; i++)
+	{
+		__m512i mIndices = LatteIndices_swapEndian_AVX512<T>(_mm512_loadu_si512(src));
+		mMax = LatteIndices_max_AVX512<T>(mMax, mIndices);
+		_mm512_storeu_si512(dst, mIndices);
+		src += N;
+		dst += N;
+	}
+	if (numBlocks)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_AVX512<T>(mMax));
+	LatteIndices_convertBE<T>(src, dst, count - numBlocks * N, indexMax);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+void LatteIndices_unpackQuadsAndConvert_AVX512(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 64 / sizeof(T);
+	static constexpr auto s_shuffle = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::QUADS, N);
+	const __m512i mShuffle0 = _mm512_loadu_si512(s_shuffle.data());
+	const __m512i mShuffle1 = _mm512_loadu_si512(s_shuffle.data() + N);
+	const T* src = (const T*)indexDataInput;
+	T* dst = (T*)indexDataOutput;
+	const uint32 numBlocks = count / N;
+	__m512i mMax = _mm512_setzero_si512();
+	for (uint32 i = 0; i < numBlocks; i++)
+	{
+		__m512i mIndices = LatteIndices_swapEndian_AVX512<T>(_mm512_loadu_si512(src));
+		mMax = LatteIndices_max_AVX512<T>(mMax, mIndices);
+		_mm512_storeu_si512(dst, LatteIndices_permute_AVX512<T>(mShuffle0, mIndices));
+		_mm256_storeu_si256((__m256i*)(dst + N), _mm512_castsi512_si256(LatteIndices_permute_AVX512<T>(mShuffle1, mIndices)));
+		src += N;
+		dst += N + N / 2;
+	}
+	if (numBlocks)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_AVX512<T>(mMax));
+	LatteIndices_unpackQuadsAndConvert<T>(src, dst, count - numBlocks * N, indexMax);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+void LatteIndices_unpackQuadStripAndConvert_AVX512(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	if (count <= 3)
+		return;
+	constexpr uint32 N = 64 / sizeof(T);
+	constexpr uint32 QUADS_PER_BLOCK = N / 4;
+	static constexpr auto s_shuffle = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::QUAD_STRIP, N);
+	const __m512i mShuffle0 = _mm512_loadu_si512(s_shuffle.data());
+	const __m512i mShuffle1 = _mm512_loadu_si512(s_shuffle.data() + N);
+	const T* src = (const T*)indexDataInput;
+	T* dst = (T*)indexDataOutput;
+	const uint32 numQuads = (count - 2) / 2;
+	const uint32 numBlocks = numQuads / QUADS_PER_BLOCK;
+	__m512i mMax = _mm512_setzero_si512();
+	for (uint32 i = 0; i < numBlocks; i++)
+	{
+		// a block only reads N/2+2 indices, masked loads make sure we never touch the memory past the end of the index data
+		__m512i mIndices;
+		if constexpr (sizeof(T) == 2)
+			mIndices = _mm512_maskz_loadu_epi16((__mmask32)((1u << (N / 2 + 2)) - 1), src);
+		else
+			mIndices = _mm512_maskz_loadu_epi32((__mmask16)((1u << (N / 2 + 2)) - 1), src);
+		mIndices = LatteIndices_swapEndian_AVX512<T>(mIndices);
+		mMax = LatteIndices_max_AVX512<T>(mMax, mIndices);
+		_mm512_storeu_si512(dst, LatteIndices_permute_AVX512<T>(mShuffle0, mIndices));
+		_mm256_storeu_si256((__m256i*)(dst + N), _mm512_castsi512_si256(LatteIndices_permute_AVX512<T>(mShuffle1, mIndices)));
+		src += N / 2;
+		dst += N + N / 2;
+	}
+	if (numBlocks)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_AVX512<T>(mMax));
+	const uint32 remainingQuads = numQuads - numBlocks * QUADS_PER_BLOCK;
+	if (remainingQuads)
+		LatteIndices_unpackQuadStripAndConvert<T>(src, dst, remainingQuads * 2 + 2, indexMax);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+void LatteIndices_unpackTriangleFanAndConvert_AVX512(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 64 / sizeof(T);
+	static constexpr auto s_shuffle = LatteIndices_makeElementShuffleTable<T, N>(LatteIndexShuffle::TRIANGLE_FAN, N);
+	const __m512i mShuffle = _mm512_loadu_si512(s_shuffle.data());
+	const T* src = (const T*)indexDataInput;
+	T* dst = (T*)indexDataOutput;
+	__m512i mMax = _mm512_setzero_si512();
+	uint32 i = 0;
+	for (; (i + N) <= count; i += N)
+	{
+		// output i+2k reads the front index i/2+k, output i+2k+1 reads the back index count-1-i/2-k
+		__m256i mFront = _mm256_loadu_si256((const __m256i*)(src + i / 2));
+		__m256i mBack = _mm256_loadu_si256((const __m256i*)(src + count - N / 2 - i / 2));
+		__m512i mIndices = LatteIndices_swapEndian_AVX512<T>(_mm512_inserti64x4(_mm512_castsi256_si512(mFront), mBack, 1));
+		mMax = LatteIndices_max_AVX512<T>(mMax, mIndices);
+		_mm512_storeu_si512(dst + i, LatteIndices_permute_AVX512<T>(mShuffle, mIndices));
+	}
+	if (i)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_AVX512<T>(mMax));
+	LatteIndices_unpackTriangleFanAndConvertRange<T>(indexDataInput, indexDataOutput, count, i, indexMax);
+}
+
+// writes numBlocks repetitions of pattern + offset, the offset advances by step after every block. Returns the number of written indices
+template<typename T>
+ATTRIBUTE_AVX512BW
+static uint32 LatteIndices_generatePattern_AVX512(T* dst, const T* pattern, uint32 patternLength, uint32 numBlocks, __m512i mOffset, __m512i mStep)
+{
+	constexpr uint32 N = 64 / sizeof(T);
+	cemu_assert_debug(patternLength == N || patternLength == N + N / 2);
+	const __m512i mPattern0 = _mm512_loadu_si512(pattern);
+	const __m512i mPattern1 = _mm512_loadu_si512(pattern + N);
+	for (uint32 i = 0; i < numBlocks; i++)
+	{
+		_mm512_storeu_si512(dst, LatteIndices_add_AVX512<T>(mPattern0, mOffset));
+		if (patternLength != N)
+			_mm256_storeu_si256((__m256i*)(dst + N), _mm512_castsi512_si256(LatteIndices_add_AVX512<T>(mPattern1, mOffset)));
+		mOffset = LatteIndices_add_AVX512<T>(mOffset, mStep);
+		dst += patternLength;
+	}
+	return numBlocks * patternLength;
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+static __m512i LatteIndices_set1_AVX512(uint32 v)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm512_set1_epi16((sint16)v);
+	else
+		return _mm512_set1_epi32((sint32)v);
+}
+
+template<typename T>
+ATTRIBUTE_AVX512BW
+void LatteIndices_generateAutoIndices_AVX512(LatteIndexShuffle shuffle, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 64 / sizeof(T);
+	T* dst = (T*)indexDataOutput;
+	uint32 numWritten;
+	if (shuffle == LatteIndexShuffle::QUADS)
+	{
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::QUADS, N);
+		numWritten = LatteIndices_generatePattern_AVX512<T>(dst, s_pattern.data(), N + N / 2, count / N, _mm512_setzero_si512(), LatteIndices_set1_AVX512<T>(N));
+	}
+	else if (shuffle == LatteIndexShuffle::QUAD_STRIP)
+	{
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::QUAD_STRIP, N);
+		numWritten = LatteIndices_generatePattern_AVX512<T>(dst, s_pattern.data(), N + N / 2, LatteIndices_getShuffleOutputCount(shuffle, count) / (N + N / 2), _mm512_setzero_si512(), LatteIndices_set1_AVX512<T>(N / 2));
+	}
+	else if (shuffle == LatteIndexShuffle::TRIANGLE_FAN)
+	{
+		// the shuffle table addresses the back half of the vector as N/2..N-1, so the back indices get an offset of count-N-i/2
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::TRIANGLE_FAN, N);
+		const uint32 numBlocks = count / N;
+		T offset[N];
+		T step[N];
+		for (uint32 k = 0; k < N; k++)
+		{
+			offset[k] = (k & 1) ? (T)(count - N) : 0;
+			step[k] = (k & 1) ? (T)(0 - N / 2) : (T)(N / 2);
+		}
+		numWritten = LatteIndices_generatePattern_AVX512<T>(dst, s_pattern.data(), N, numBlocks, _mm512_loadu_si512(offset), _mm512_loadu_si512(step));
+	}
+	else
+	{
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::SEQUENTIAL, N);
+		numWritten = LatteIndices_generatePattern_AVX512<T>(dst, s_pattern.data(), N, count / N, _mm512_setzero_si512(), LatteIndices_set1_AVX512<T>(N));
+	}
+	LatteIndices_generatePatternRange<T>(dst, shuffle, count, numWritten, LatteIndices_getShuffleOutputCount(shuffle, count));
+	indexMax = std::max(count, 1u) - 1;
+}
+#elif defined(__aarch64__)
+// NEON variants of the quad, quad strip and triangle fan expansion
+// one block is one 16 byte input vector. The table lookup (tbl) does the shuffle and the endian swap in one step
+
+template<typename T>
+static uint8x16_t LatteIndices_swapEndian_NEON(uint8x16_t v)
+{
+	if constexpr (sizeof(T) == 2)
+		return vrev16q_u8(v);
+	else
+		return vrev32q_u8(v);
+}
+
+template<typename T>
+static uint8x16_t LatteIndices_max_NEON(uint8x16_t a, uint8x16_t b)
+{
+	if constexpr (sizeof(T) == 2)
+		return vreinterpretq_u8_u16(vmaxq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+	else
+		return vreinterpretq_u8_u32(vmaxq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+template<typename T>
+static uint8x16_t LatteIndices_add_NEON(uint8x16_t a, uint8x16_t b)
+{
+	if constexpr (sizeof(T) == 2)
+		return vreinterpretq_u8_u16(vaddq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+	else
+		return vreinterpretq_u8_u32(vaddq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+template<typename T>
+static uint8x16_t LatteIndices_set1_NEON(uint32 v)
+{
+	if constexpr (sizeof(T) == 2)
+		return vreinterpretq_u8_u16(vdupq_n_u16((uint16)v));
+	else
+		return vreinterpretq_u8_u32(vdupq_n_u32(v));
+}
+
+template<typename T>
+static uint32 LatteIndices_reduceMax_NEON(uint8x16_t v)
+{
+	if constexpr (sizeof(T) == 2)
+		return vmaxvq_u16(vreinterpretq_u16_u8(v));
+	else
+		return vmaxvq_u32(vreinterpretq_u32_u8(v));
+}
+
+template<typename T>
+void LatteIndices_unpackQuadsAndConvert_NEON(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 16 / sizeof(T);
+	static constexpr auto s_shuffle = LatteIndices_makeByteShuffleTable<24>(LatteIndexShuffle::QUADS, sizeof(T), N);
+	const uint8x16_t mShuffle0 = vld1q_u8(s_shuffle.data());
+	const uint8x8_t mShuffle1 = vld1_u8(s_shuffle.data() + 16);
+	const uint8* src = (const uint8*)indexDataInput;
+	uint8* dst = (uint8*)indexDataOutput;
+	const uint32 numBlocks = count / N;
+	uint8x16_t mMax = vdupq_n_u8(0);
+	for (uint32 i = 0; i < numBlocks; i++)
+	{
+		uint8x16_t mIndices = vld1q_u8(src);
+		mMax = LatteIndices_max_NEON<T>(mMax, LatteIndices_swapEndian_NEON<T>(mIndices));
+		vst1q_u8(dst, vqtbl1q_u8(mIndices, mShuffle0));
+		vst1_u8(dst + 16, vqtbl1_u8(mIndices, mShuffle1));
+		src += 16;
+		dst += 24;
+	}
+	if (numBlocks)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_NEON<T>(mMax));
+	LatteIndices_unpackQuadsAndConvert<T>(src, dst, count - numBlocks * N, indexMax);
+}
+
+template<typename T>
+void LatteIndices_unpackQuadStripAndConvert_NEON(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	if (count <= 3)
+		return;
+	constexpr uint32 N = 16 / sizeof(T);
+	constexpr uint32 QUADS_PER_BLOCK = N / 4;
+	static constexpr auto s_shuffle = LatteIndices_makeByteShuffleTable<24>(LatteIndexShuffle::QUAD_STRIP, sizeof(T), N);
+	const uint8x16_t mShuffle0 = vld1q_u8(s_shuffle.data());
+	const uint8x8_t mShuffle1 = vld1_u8(s_shuffle.data() + 16);
+	const uint8* src = (const uint8*)indexDataInput;
+	uint8* dst = (uint8*)indexDataOutput;
+	const uint32 numQuads = (count - 2) / 2;
+	uint32 quadIndex = 0;
+	uint8x16_t mMax = vdupq_n_u8(0);
+	// a block reads a full vector of indices but only uses the first N/2+2, stop early enough to not read past the end of the index data
+	for (; (quadIndex + QUADS_PER_BLOCK) <= numQuads && (quadIndex * 2 + N) <= count; quadIndex += QUADS_PER_BLOCK)
+	{
+		uint8x16_t mIndices = vld1q_u8(src);
+		uint8x16_t mOutput0 = vqtbl1q_u8(mIndices, mShuffle0);
+		uint8x8_t mOutput1 = vqtbl1_u8(mIndices, mShuffle1);
+		// both outputs together hold every index that is used, so they are used for the max instead of the input
+		mMax = LatteIndices_max_NEON<T>(mMax, LatteIndices_max_NEON<T>(mOutput0, vcombine_u8(mOutput1, mOutput1)));
+		vst1q_u8(dst, mOutput0);
+		vst1_u8(dst + 16, mOutput1);
+		src += 16 / 2;
+		dst += 24;
+	}
+	if (quadIndex)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_NEON<T>(mMax));
+	const uint32 remainingQuads = numQuads - quadIndex;
+	if (remainingQuads)
+		LatteIndices_unpackQuadStripAndConvert<T>(src, dst, remainingQuads * 2 + 2, indexMax);
+}
+
+template<typename T>
+void LatteIndices_unpackTriangleFanAndConvert_NEON(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 16 / sizeof(T);
+	static constexpr auto s_shuffle = LatteIndices_makeByteShuffleTable<16>(LatteIndexShuffle::TRIANGLE_FAN, sizeof(T), N);
+	const uint8x16_t mShuffle = vld1q_u8(s_shuffle.data());
+	const T* src = (const T*)indexDataInput;
+	T* dst = (T*)indexDataOutput;
+	uint8x16_t mMax = vdupq_n_u8(0);
+	uint32 i = 0;
+	for (; (i + N) <= count; i += N)
+	{
+		// output i+2k reads the front index i/2+k, output i+2k+1 reads the back index count-1-i/2-k
+		uint8x8_t mFront = vld1_u8((const uint8*)(src + i / 2));
+		uint8x8_t mBack = vld1_u8((const uint8*)(src + count - N / 2 - i / 2));
+		uint8x16_t mIndices = vcombine_u8(mFront, mBack);
+		mMax = LatteIndices_max_NEON<T>(mMax, LatteIndices_swapEndian_NEON<T>(mIndices));
+		vst1q_u8((uint8*)(dst + i), vqtbl1q_u8(mIndices, mShuffle));
+	}
+	if (i)
+		indexMax = std::max(indexMax, LatteIndices_reduceMax_NEON<T>(mMax));
+	LatteIndices_unpackTriangleFanAndConvertRange<T>(indexDataInput, indexDataOutput, count, i, indexMax);
+}
+
+// writes numBlocks repetitions of pattern + offset, the offset advances by step after every block. Returns the number of written indices
+template<typename T>
+static uint32 LatteIndices_generatePattern_NEON(T* dst, const T* pattern, uint32 patternLength, uint32 numBlocks, uint8x16_t mOffset, uint8x16_t mStep)
+{
+	constexpr uint32 N = 16 / sizeof(T);
+	cemu_assert_debug(patternLength == N || patternLength == N + N / 2);
+	const uint8x16_t mPattern0 = vld1q_u8((const uint8*)pattern);
+	const uint8x16_t mPattern1 = vld1q_u8((const uint8*)(pattern + N));
+	for (uint32 i = 0; i < numBlocks; i++)
+	{
+		vst1q_u8((uint8*)dst, LatteIndices_add_NEON<T>(mPattern0, mOffset));
+		if (patternLength != N)
+			vst1_u8((uint8*)(dst + N), vget_low_u8(LatteIndices_add_NEON<T>(mPattern1, mOffset)));
+		mOffset = LatteIndices_add_NEON<T>(mOffset, mStep);
+		dst += patternLength;
+	}
+	return numBlocks * patternLength;
+}
+
+template<typename T>
+void LatteIndices_generateAutoIndices_NEON(LatteIndexShuffle shuffle, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	constexpr uint32 N = 16 / sizeof(T);
+	T* dst = (T*)indexDataOutput;
+	uint32 numWritten;
+	if (shuffle == LatteIndexShuffle::QUADS)
+	{
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::QUADS, N);
+		numWritten = LatteIndices_generatePattern_NEON<T>(dst, s_pattern.data(), N + N / 2, count / N, vdupq_n_u8(0), LatteIndices_set1_NEON<T>(N));
+	}
+	else if (shuffle == LatteIndexShuffle::QUAD_STRIP)
+	{
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::QUAD_STRIP, N);
+		numWritten = LatteIndices_generatePattern_NEON<T>(dst, s_pattern.data(), N + N / 2, LatteIndices_getShuffleOutputCount(shuffle, count) / (N + N / 2), vdupq_n_u8(0), LatteIndices_set1_NEON<T>(N / 2));
+	}
+	else if (shuffle == LatteIndexShuffle::TRIANGLE_FAN)
+	{
+		// the shuffle table addresses the back half of the vector as N/2..N-1, so the back indices get an offset of count-N-i/2
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::TRIANGLE_FAN, N);
+		const uint32 numBlocks = count / N;
+		T offset[N];
+		T step[N];
+		for (uint32 k = 0; k < N; k++)
+		{
+			offset[k] = (k & 1) ? (T)(count - N) : 0;
+			step[k] = (k & 1) ? (T)(0 - N / 2) : (T)(N / 2);
+		}
+		numWritten = LatteIndices_generatePattern_NEON<T>(dst, s_pattern.data(), N, numBlocks, vld1q_u8((const uint8*)offset), vld1q_u8((const uint8*)step));
+	}
+	else
+	{
+		static constexpr auto s_pattern = LatteIndices_makeElementShuffleTable<T, N * 2>(LatteIndexShuffle::SEQUENTIAL, N);
+		numWritten = LatteIndices_generatePattern_NEON<T>(dst, s_pattern.data(), N, count / N, vdupq_n_u8(0), LatteIndices_set1_NEON<T>(N));
+	}
+	LatteIndices_generatePatternRange<T>(dst, shuffle, count, numWritten, LatteIndices_getShuffleOutputCount(shuffle, count));
+	indexMax = std::max(count, 1u) - 1;
+}
+#endif
+
+// pick the fastest available implementation
+template<typename T>
+void LatteIndices_fastConvert(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx512bw)
+		LatteIndices_fastConvert_AVX512<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else if constexpr (sizeof(T) == 2)
+	{
+		if (g_CPUFeatures.x86.avx2)
+			LatteIndices_fastConvertU16_AVX2(indexDataInput, indexDataOutput, count, indexMax);
+		else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+			LatteIndices_fastConvertU16_SSE41(indexDataInput, indexDataOutput, count, indexMax);
+		else
+			LatteIndices_convertBE<uint16>(indexDataInput, indexDataOutput, count, indexMax);
+	}
+	else
+	{
+		if (g_CPUFeatures.x86.avx2)
+			LatteIndices_fastConvertU32_AVX2(indexDataInput, indexDataOutput, count, indexMax);
+		else
+			LatteIndices_convertBE<uint32>(indexDataInput, indexDataOutput, count, indexMax);
+	}
+#elif defined(__aarch64__)
+	if constexpr (sizeof(T) == 2)
+		LatteIndices_fastConvertU16_NEON(indexDataInput, indexDataOutput, count, indexMax);
+	else
+		LatteIndices_fastConvertU32_NEON(indexDataInput, indexDataOutput, count, indexMax);
+#else
+	LatteIndices_convertBE<T>(indexDataInput, indexDataOutput, count, indexMax);
+#endif
+}
+
+template<typename T>
+void LatteIndices_fastUnpackQuads(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx512bw)
+		LatteIndices_unpackQuadsAndConvert_AVX512<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else
+		LatteIndices_unpackQuadsAndConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+#elif defined(__aarch64__)
+	LatteIndices_unpackQuadsAndConvert_NEON<T>(indexDataInput, indexDataOutput, count, indexMax);
+#else
+	LatteIndices_unpackQuadsAndConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+#endif
+}
+
+template<typename T>
+void LatteIndices_fastUnpackQuadStrip(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx512bw)
+		LatteIndices_unpackQuadStripAndConvert_AVX512<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else
+		LatteIndices_unpackQuadStripAndConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+#elif defined(__aarch64__)
+	LatteIndices_unpackQuadStripAndConvert_NEON<T>(indexDataInput, indexDataOutput, count, indexMax);
+#else
+	LatteIndices_unpackQuadStripAndConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+#endif
+}
+
+template<typename T>
+void LatteIndices_fastUnpackLineLoop(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	if (count == 0)
+		return;
+	// a line loop is a line strip with one extra index which reconnects to the first vertex
+	LatteIndices_fastConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+	((T*)indexDataOutput)[count] = *(const betype<T>*)indexDataInput;
+}
+
+template<typename T>
+void LatteIndices_fastUnpackTriangleFan(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx512bw)
+		LatteIndices_unpackTriangleFanAndConvert_AVX512<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else
+		LatteIndices_unpackTriangleFanAndConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+#elif defined(__aarch64__)
+	LatteIndices_unpackTriangleFanAndConvert_NEON<T>(indexDataInput, indexDataOutput, count, indexMax);
+#else
+	LatteIndices_unpackTriangleFanAndConvert<T>(indexDataInput, indexDataOutput, count, indexMax);
+#endif
+}
+
+// unpacks quads, quad strips, line loops and triangle fans
+template<typename T>
+void LatteIndices_fastUnpack(LattePrimitiveMode primitiveMode, const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+	if (primitiveMode == LattePrimitiveMode::QUADS)
+		LatteIndices_fastUnpackQuads<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else if (primitiveMode == LattePrimitiveMode::QUAD_STRIP)
+		LatteIndices_fastUnpackQuadStrip<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else if (primitiveMode == LattePrimitiveMode::LINE_LOOP)
+		LatteIndices_fastUnpackLineLoop<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else if (primitiveMode == LattePrimitiveMode::TRIANGLE_FAN)
+		LatteIndices_fastUnpackTriangleFan<T>(indexDataInput, indexDataOutput, count, indexMax);
+	else
+		cemu_assert_debug(false);
+}
+
+// generates the indices for non-indexed quads, quad strips, line loops and triangle fans
+template<typename T>
+void LatteIndices_fastGenerateAutoIndices(LattePrimitiveMode primitiveMode, void* indexDataOutput, uint32 count, uint32& indexMax)
+{
+#if defined(ARCH_X86_64) || defined(__aarch64__)
+	LatteIndexShuffle shuffle = LatteIndexShuffle::SEQUENTIAL;
+	if (primitiveMode == LattePrimitiveMode::QUADS)
+		shuffle = LatteIndexShuffle::QUADS;
+	else if (primitiveMode == LattePrimitiveMode::QUAD_STRIP)
+		shuffle = LatteIndexShuffle::QUAD_STRIP;
+	else if (primitiveMode == LattePrimitiveMode::TRIANGLE_FAN)
+		shuffle = LatteIndexShuffle::TRIANGLE_FAN;
+	else
+		cemu_assert_debug(primitiveMode == LattePrimitiveMode::LINE_LOOP);
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx512bw)
+#endif
+	{
+		if (shuffle == LatteIndexShuffle::SEQUENTIAL && count == 0)
+			return;
+#if defined(ARCH_X86_64)
+		LatteIndices_generateAutoIndices_AVX512<T>(shuffle, indexDataOutput, count, indexMax);
+#else
+		LatteIndices_generateAutoIndices_NEON<T>(shuffle, indexDataOutput, count, indexMax);
+#endif
+		if (shuffle == LatteIndexShuffle::SEQUENTIAL)
+			((T*)indexDataOutput)[count] = 0; // reconnect line loop
+		return;
+	}
+#endif
+	if (primitiveMode == LattePrimitiveMode::QUADS)
+		LatteIndices_generateAutoQuadIndices<T>(nullptr, indexDataOutput, count, indexMax);
+	else if (primitiveMode == LattePrimitiveMode::QUAD_STRIP)
+		LatteIndices_generateAutoQuadStripIndices<T>(indexDataOutput, count, indexMax);
+	else if (primitiveMode == LattePrimitiveMode::TRIANGLE_FAN)
+		LatteIndices_generateAutoTriangleFanIndices<T>(nullptr, indexDataOutput, count, indexMax);
+	else
+		LatteIndices_generateAutoLineLoopIndices<T>(indexDataOutput, count, indexMax);
+}
+
 template<typename T>
 void _LatteIndices_alternativeCalculateIndexMax(const void* indexData, uint32 count, uint32 primitiveRestartIndex, uint32& indexMax)
 {
@@ -651,21 +1354,37 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 	// [x] unpack QUAD indices to triangle indices
 	// [x] calculate min and max index, be careful about primitive restart index
 	// [x] decode data directly into coherent memory buffer?
-	// [ ] better cache implementation, allow to cache across frames
+	// [x] better cache implementation, allow to cache across frames
+
+	uint32 primitiveRestartIndex = LatteGPUState.contextNew.VGT_MULTI_PRIM_IB_RESET_INDX.get_RESTART_INDEX();
+	uint32 srcSize = 0;
+	if (indexType == LatteIndexType::U16_BE || indexType == LatteIndexType::U16_LE)
+		srcSize = count * sizeof(uint16);
+	else if (indexType == LatteIndexType::U32_BE || indexType == LatteIndexType::U32_LE)
+		srcSize = count * sizeof(uint32);
+	LatteIndexCacheKey cacheKey{ srcSize != 0 ? memory_getVirtualOffsetFromPointer((void*)indexData) : MPTR_NULL, count, indexType, primitiveMode, primitiveRestartIndex };
 
 	// reuse from cache if data didn't change
-	auto cacheEntry = std::find_if(LatteIndexCache.entry.begin(), LatteIndexCache.entry.end(), [indexData, count, primitiveMode, indexType](const auto& entry)
-	{
-		return entry.lastPtr == indexData && entry.lastCount == count && entry.lastPrimitiveMode == primitiveMode && entry.lastIndexType == indexType;
-	});
-	if (cacheEntry != LatteIndexCache.entry.end())
+	auto cacheLookup = LatteIndexCache.lookup.find(cacheKey);
+	if (cacheLookup != LatteIndexCache.lookup.end())
 	{
-		indexMax = cacheEntry->indexMax;
-		renderIndexType = cacheEntry->renderIndexType;
-		outputCount = cacheEntry->outputCount;
-		indexAllocation = cacheEntry->indexAllocation;
-		cacheEntry->lastUsed = LatteIndices_GetNextUsageIndex();
-		return;
+		auto cacheEntry = cacheLookup->second;
+		bool isValid = true;
+		if (cacheEntry->validationEpoch != LatteIndexCache.currentEpoch)
+		{
+			isValid = cacheEntry->srcSize == 0 || LatteIndices_hashSourceData(indexData, cacheEntry->srcSize) == cacheEntry->srcHash;
+			cacheEntry->validationEpoch = LatteIndexCache.currentEpoch;
+		}
+		if (isValid)
+		{
+			indexMax = cacheEntry->indexMax;
+			renderIndexType = cacheEntry->renderIndexType;
+			outputCount = cacheEntry->outputCount;
+			indexAllocation = cacheEntry->indexAllocation;
+			LatteIndexCache.entries.splice(LatteIndexCache.entries.begin(), LatteIndexCache.entries, cacheEntry);
+			return;
+		}
+		LatteIndices_removeEntry(cacheEntry);
 	}
 
 	outputCount = 0;
@@ -678,8 +1397,6 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 	else
 		cemu_assert_debug(false);
 
-	uint32 primitiveRestartIndex = LatteGPUState.contextNew.VGT_MULTI_PRIM_IB_RESET_INDX.get_RESTART_INDEX();
-
 	// calculate index output size
 	uint32 indexOutputSize = LatteIndices_calculateIndexOutputSize(primitiveMode, indexType, count);
 	if (indexOutputSize == 0)
@@ -696,134 +1413,44 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 
 	// decode indices
 	indexMax = std::numeric_limits<uint32>::min();
-	if (primitiveMode == LattePrimitiveMode::QUADS)
+	if (primitiveMode == LattePrimitiveMode::QUADS || primitiveMode == LattePrimitiveMode::QUAD_STRIP || primitiveMode == LattePrimitiveMode::LINE_LOOP ||
+		(primitiveMode == LattePrimitiveMode::TRIANGLE_FAN && g_renderer->GetType() == RendererAPI::Metal))
 	{
-		// unpack quads into triangles
+		// unpack quads and quad strips into triangles, line loops into line strips with an extra reconnecting vertex and triangle fans into triangle strips
 		if (indexType == LatteIndexType::AUTO)
 		{
 			if (count <= 0xFFFF)
 			{
-				LatteIndices_generateAutoQuadIndices<uint16>(indexData, indexOutputPtr, count, indexMax);
+				LatteIndices_fastGenerateAutoIndices<uint16>(primitiveMode, indexOutputPtr, count, indexMax);
 				renderIndexType = Renderer::INDEX_TYPE::U16;
 			}
 			else
 			{
-				LatteIndices_generateAutoQuadIndices<uint32>(indexData, indexOutputPtr, count, indexMax);
+				LatteIndices_fastGenerateAutoIndices<uint32>(primitiveMode, indexOutputPtr, count, indexMax);
 				renderIndexType = Renderer::INDEX_TYPE::U32;
 			}
 		}
 		else if (indexType == LatteIndexType::U16_BE)
-			LatteIndices_unpackQuadsAndConvert<uint16>(indexData, indexOutputPtr, count, indexMax);
+			LatteIndices_fastUnpack<uint16>(primitiveMode, indexData, indexOutputPtr, count, indexMax);
 		else if (indexType == LatteIndexType::U32_BE)
-			LatteIndices_unpackQuadsAndConvert<uint32>(indexData, indexOutputPtr, count, indexMax);
+			LatteIndices_fastUnpack<uint32>(primitiveMode, indexData, indexOutputPtr, count, indexMax);
 		else
 			cemu_assert_debug(false);
-		outputCount = count / 4 * 6;
-	}
-	else if (primitiveMode == LattePrimitiveMode::QUAD_STRIP)
-	{
-		// unpack quad strip into triangles
-		if (indexType == LatteIndexType::AUTO)
-		{
-			if (count <= 0xFFFF)
-			{
-				LatteIndices_generateAutoQuadStripIndices<uint16>(indexOutputPtr, count, indexMax);
-				renderIndexType = Renderer::INDEX_TYPE::U16;
-			}
-			else
-			{
-				LatteIndices_generateAutoQuadStripIndices<uint32>(indexOutputPtr, count, indexMax);
-				renderIndexType = Renderer::INDEX_TYPE::U32;
-			}
-		}
-		else if (indexType == LatteIndexType::U16_BE)
-			LatteIndices_unpackQuadStripAndConvert<uint16>(indexData, indexOutputPtr, count, indexMax);
-		else if (indexType == LatteIndexType::U32_BE)
-			LatteIndices_unpackQuadStripAndConvert<uint32>(indexData, indexOutputPtr, count, indexMax);
-		else
-			cemu_assert_debug(false);
-		if (count >= 2)
-			outputCount = (count - 2) / 2 * 6;
-		else
-			outputCount = 0;
-	}
-	else if (primitiveMode == LattePrimitiveMode::LINE_LOOP)
-	{
-		// unpack line loop into line strip with extra reconnecting vertex
-		if (indexType == LatteIndexType::AUTO)
-		{
-			if (count <= 0xFFFF)
-			{
-				LatteIndices_generateAutoLineLoopIndices<uint16>(indexOutputPtr, count, indexMax);
-				renderIndexType = Renderer::INDEX_TYPE::U16;
-			}
-			else
-			{
-				LatteIndices_generateAutoLineLoopIndices<uint32>(indexOutputPtr, count, indexMax);
-				renderIndexType = Renderer::INDEX_TYPE::U32;
-			}
-		}
-		else if (indexType == LatteIndexType::U16_BE)
-			LatteIndices_unpackLineLoopAndConvert<uint16>(indexData, indexOutputPtr, count, indexMax);
-		else if (indexType == LatteIndexType::U32_BE)
-			LatteIndices_unpackLineLoopAndConvert<uint32>(indexData, indexOutputPtr, count, indexMax);
+		if (primitiveMode == LattePrimitiveMode::QUADS)
+			outputCount = count / 4 * 6;
+		else if (primitiveMode == LattePrimitiveMode::QUAD_STRIP)
+			outputCount = count >= 2 ? (count - 2) / 2 * 6 : 0;
+		else if (primitiveMode == LattePrimitiveMode::LINE_LOOP)
+			outputCount = count + 1;
 		else
-			cemu_assert_debug(false);
-		outputCount = count + 1;
-	}
-	else if (primitiveMode == LattePrimitiveMode::TRIANGLE_FAN && g_renderer->GetType() == RendererAPI::Metal)
-	{
-        if (indexType == LatteIndexType::AUTO)
-    	{
-    		if (count <= 0xFFFF)
-    		{
-    			LatteIndices_generateAutoTriangleFanIndices<uint16>(indexData, indexOutputPtr, count, indexMax);
-    			renderIndexType = Renderer::INDEX_TYPE::U16;
-    		}
-    		else
-    		{
-    			LatteIndices_generateAutoTriangleFanIndices<uint32>(indexData, indexOutputPtr, count, indexMax);
-    			renderIndexType = Renderer::INDEX_TYPE::U32;
-    		}
-    	}
-    	else if (indexType == LatteIndexType::U16_BE)
-    		LatteIndices_unpackTriangleFanAndConvert<uint16>(indexData, indexOutputPtr, count, indexMax);
-    	else if (indexType == LatteIndexType::U32_BE)
-    		LatteIndices_unpackTriangleFanAndConvert<uint32>(indexData, indexOutputPtr, count, indexMax);
-    	else
-    		cemu_assert_debug(false);
-    	outputCount = count;
+			outputCount = count;
 	}
 	else
 	{
 		if (indexType == LatteIndexType::U16_BE)
-		{
-#if defined(ARCH_X86_64)
-			if (g_CPUFeatures.x86.avx2)
-				LatteIndices_fastConvertU16_AVX2(indexData, indexOutputPtr, count, indexMax);
-			else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
-				LatteIndices_fastConvertU16_SSE41(indexData, indexOutputPtr, count, indexMax);
-			else
-				LatteIndices_convertBE<uint16>(indexData, indexOutputPtr, count, indexMax);
-#elif defined(__aarch64__)
-			LatteIndices_fastConvertU16_NEON(indexData, indexOutputPtr, count, indexMax);
-#else
-			LatteIndices_convertBE<uint16>(indexData, indexOutputPtr, count, indexMax);
-#endif
-		}
+			LatteIndices_fastConvert<uint16>(indexData, indexOutputPtr, count, indexMax);
 		else if (indexType == LatteIndexType::U32_BE)
-		{
-#if defined(ARCH_X86_64)
-			if (g_CPUFeatures.x86.avx2)
-				LatteIndices_fastConvertU32_AVX2(indexData, indexOutputPtr, count, indexMax);
-			else
-				LatteIndices_convertBE<uint32>(indexData, indexOutputPtr, count, indexMax);
-#elif defined(__aarch64__)
-			LatteIndices_fastConvertU32_NEON(indexData, indexOutputPtr, count, indexMax);
-#else
-			LatteIndices_convertBE<uint32>(indexData, indexOutputPtr, count, indexMax);
-#endif
-		}
+			LatteIndices_fastConvert<uint32>(indexData, indexOutputPtr, count, indexMax);
 		else if (indexType == LatteIndexType::U16_LE)
 		{
 			LatteIndices_convertLE<uint16>(indexData, indexOutputPtr, count, indexMax);
@@ -845,22 +1472,22 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 	}
 	g_renderer->indexData_uploadIndexMemory(indexAllocation);
 	performanceMonitor.cycle[performanceMonitor.cycleIndex].indexDataUploaded += indexOutputSize;
-	// get least recently used cache entry
-	auto lruEntry = std::min_element(LatteIndexCache.entry.begin(), LatteIndexCache.entry.end(), [](const auto& a, const auto& b)
-	{
-		return a.lastUsed < b.lastUsed;
-	});
-	// invalidate previous allocation
-	if(lruEntry->lastPtr != nullptr)
-		g_renderer->indexData_releaseIndexMemory(lruEntry->indexAllocation);
+	// evict least recently used entries
+	while (!LatteIndexCache.entries.empty() && (LatteIndexCache.entries.size() >= INDEX_CACHE_MAX_ENTRIES || (LatteIndexCache.totalOutputSize + indexOutputSize) > INDEX_CACHE_MAX_MEMORY))
+		LatteIndices_removeEntry(std::prev(LatteIndexCache.entries.end()));
 	// update cache
-	lruEntry->lastPtr = indexData;
-	lruEntry->lastCount = count;
-	lruEntry->lastPrimitiveMode = primitiveMode;
-	lruEntry->lastIndexType = indexType;
-	lruEntry->indexMax = indexMax;
-	lruEntry->renderIndexType = renderIndexType;
-	lruEntry->outputCount = outputCount;
-	lruEntry->indexAllocation = indexAllocation;
-	lruEntry->lastUsed = LatteIndices_GetNextUsageIndex();
+	LatteIndexCacheEntry& newEntry = LatteIndexCache.entries.emplace_front();
+	newEntry.key = cacheKey;
+	newEntry.srcSize = srcSize;
+	newEntry.srcHash = srcSize != 0 ? LatteIndices_hashSourceData(indexData, srcSize) : 0;
+	newEntry.validationEpoch = LatteIndexCache.currentEpoch;
+	newEntry.indexMax = indexMax;
+	newEntry.renderIndexType = renderIndexType;
+	newEntry.outputCount = outputCount;
+	newEntry.outputSize = indexOutputSize;
+	newEntry.indexAllocation = indexAllocation;
+	LatteIndexCache.lookup.emplace(cacheKey, LatteIndexCache.entries.begin());
+	if (srcSize != 0)
+		LatteIndexCache.ranges.addRange(cacheKey.srcAddr, cacheKey.srcAddr + srcSize, &newEntry);
+	LatteIndexCache.totalOutputSize += indexOutputSize;
 }
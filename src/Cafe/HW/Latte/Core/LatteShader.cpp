@@ -147,12 +147,21 @@ void LatteSHRC_ResetCachedShaderHash()
 }
 
 LatteShaderPSInputTable _activePSImportTable;
+thread_local LatteShaderPSInputTable* s_threadPSImportTable = nullptr; // set by threads which decompile shaders independently of the GPU state (shader cache loading)
 
 LatteShaderPSInputTable* LatteSHRC_GetPSInputTable()
 {
+	if (s_threadPSImportTable)
+		return s_threadPSImportTable;
 	return &_activePSImportTable;
 }
 
+// use a separate PS input table for the calling thread. Pass nullptr to switch back to the shared table
+void LatteSHRC_SetThreadPSInputTable(LatteShaderPSInputTable* psInputTable)
+{
+	s_threadPSImportTable = psInputTable;
+}
+
 void LatteSHRC_RemoveFromCaches(LatteDecompilerShader* shader)
 {
 	bool removed = false;
@@ -317,7 +326,7 @@ void LatteShader_CreatePSInputTable(LatteShaderPSInputTable* psInputTable, uint3
 // we prepare the PS import info in advance
 void LatteShader_UpdatePSInputs(uint32* contextRegisters)
 {
-	LatteShader_CreatePSInputTable(&_activePSImportTable, contextRegisters);
+	LatteShader_CreatePSInputTable(LatteSHRC_GetPSInputTable(), contextRegisters);
 }
 
 void LatteShader_CreateRendererShader(LatteDecompilerShader* shader, bool compileAsync)
@@ -88,6 +88,7 @@ struct LatteShaderPSInputTable
 void LatteShader_CreatePSInputTable(LatteShaderPSInputTable* psInputTable, uint32* contextRegisters);
 void LatteShader_UpdatePSInputs(uint32* contextRegisters);
 LatteShaderPSInputTable* LatteSHRC_GetPSInputTable();
+void LatteSHRC_SetThreadPSInputTable(LatteShaderPSInputTable* psInputTable);
 
 void LatteShader_free(LatteDecompilerShader* shader);
 void LatteSHRC_RemoveFromCacheByHash(uint64 shader_base_hash, uint64 shader_aux_hash, LatteConst::ShaderType type);
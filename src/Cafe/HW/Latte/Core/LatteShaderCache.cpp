@@ -31,6 +31,7 @@
 #include "Cafe/HW/Latte/Common/RegisterSerializer.h"
 #include "Cafe/HW/Latte/Common/ShaderSerializer.h"
 #include "util/helpers/Serializer.h"
+#include "util/helpers/helpers.h"
 
 #include <audio/IAudioAPI.h>
 #include <util/bootSound/BootSoundReader.h>
@@ -71,7 +72,8 @@ FileCache* s_shaderCacheGeneric = nullptr;	// contains hardware and version inde
 #define SHADER_CACHE_TYPE_GEOMETRY				(1)
 #define SHADER_CACHE_TYPE_PIXEL					(2)
 
-bool LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderInfoSize);
+LatteDecompilerShader* LatteShaderCache_decompileSeparableShader(const uint8* shaderInfoData, sint32 shaderInfoSize);
+void LatteShaderCache_loadOrCompileSeparableShader(LatteDecompilerShader* shader, uint64 shaderBaseHash, uint64 shaderAuxHash);
 void LatteShaderCache_LoadPipelineCache(uint64 cacheTitleId);
 bool LatteShaderCache_updatePipelineLoadingProgress();
 void LatteShaderCache_ShowProgress(const std::function <bool(void)>& loadUpdateFunc, bool isPipelines);
@@ -121,6 +123,156 @@ void LatteShaderCache_updateCompileQueue(sint32 maxRemainingEntries)
 	}
 }
 
+/*
+ * Shader cache loading is split into three stages:
+ * - A reader thread streams the entries from a read-only mapping of the cache file
+ * - Worker threads deserialize and decompile them. Each worker uses its own PS input table
+ * - The thread which owns the renderer creates the renderer shaders in batches and registers them
+ * The number of entries in flight is limited so that memory usage stays low for large caches
+ */
+#define SHADER_CACHE_LOAD_MAX_WORKERS		(8)
+#define SHADER_CACHE_LOAD_MAX_IN_FLIGHT		(256)
+#define SHADER_CACHE_LOAD_BATCH_SIZE		(16)
+
+struct LatteShaderCacheLoadEntry
+{
+	uint64 name1;
+	uint64 name2;
+	std::span<const uint8> fileData; // points into the mapped cache file or into fileDataStorage
+	std::vector<uint8> fileDataStorage; // only used for entries which can't be accessed in place
+	LatteDecompilerShader* shader{}; // nullptr if the entry is invalid
+};
+
+struct
+{
+	std::mutex mutex;
+	std::condition_variable readerCondVar; // signaled when an in-flight slot becomes free
+	std::condition_variable workerCondVar; // signaled when an entry was read
+	std::condition_variable resultCondVar; // signaled when an entry was decompiled
+	std::deque<std::unique_ptr<LatteShaderCacheLoadEntry>> readQueue;
+	std::deque<std::unique_ptr<LatteShaderCacheLoadEntry>> resultQueue;
+	sint32 numInFlight;
+	sint32 numActiveWorkers;
+	bool readerFinished;
+	bool stopRequested;
+	FileCache* cacheView; // read-only mapping of the transferable cache, only open while loading. nullptr if the file could not be mapped
+	std::thread readerThread;
+	std::vector<std::thread> workerThreads;
+}s_shaderCacheLoader;
+
+void LatteShaderCache_loaderReaderThread()
+{
+	SetThreadName("ShaderCacheRead");
+	FileCache* cache = s_shaderCacheLoader.cacheView ? s_shaderCacheLoader.cacheView : s_shaderCacheGeneric;
+	sint32 maxFileIndex = cache->GetMaximumFileIndex();
+	for (sint32 i = 0; i < maxFileIndex; i++)
+	{
+		auto entry = std::make_unique<LatteShaderCacheLoadEntry>();
+		// uncompressed entries are decompiled straight from the mapped file without copying them
+		if (!cache->IsReadOnly() || !cache->GetFileViewByIndex(i, &entry->name1, &entry->name2, entry->fileData))
+		{
+			if (!cache->GetFileByIndex(i, &entry->name1, &entry->name2, entry->fileDataStorage))
+				continue;
+			entry->fileData = entry->fileDataStorage;
+		}
+		std::unique_lock _l(s_shaderCacheLoader.mutex);
+		s_shaderCacheLoader.readerCondVar.wait(_l, [] { return s_shaderCacheLoader.numInFlight < SHADER_CACHE_LOAD_MAX_IN_FLIGHT || s_shaderCacheLoader.stopRequested; });
+		if (s_shaderCacheLoader.stopRequested)
+			break;
+		s_shaderCacheLoader.numInFlight++;
+		s_shaderCacheLoader.readQueue.emplace_back(std::move(entry));
+		s_shaderCacheLoader.workerCondVar.notify_one();
+	}
+	std::unique_lock _l(s_shaderCacheLoader.mutex);
+	s_shaderCacheLoader.readerFinished = true;
+	s_shaderCacheLoader.workerCondVar.notify_all();
+	s_shaderCacheLoader.resultCondVar.notify_all();
+}
+
+void LatteShaderCache_loaderWorkerThread()
+{
+	SetThreadName("ShaderCacheLoad");
+	LatteShaderPSInputTable psInputTable{};
+	LatteSHRC_SetThreadPSInputTable(&psInputTable);
+	std::unique_lock _l(s_shaderCacheLoader.mutex);
+	while (true)
+	{
+		s_shaderCacheLoader.workerCondVar.wait(_l, [] { return !s_shaderCacheLoader.readQueue.empty() || s_shaderCacheLoader.readerFinished || s_shaderCacheLoader.stopRequested; });
+		if (s_shaderCacheLoader.stopRequested || s_shaderCacheLoader.readQueue.empty())
+			break;
+		auto entry = std::move(s_shaderCacheLoader.readQueue.front());
+		s_shaderCacheLoader.readQueue.pop_front();
+		_l.unlock();
+		entry->shader = LatteShaderCache_decompileSeparableShader(entry->fileData.data(), (sint32)entry->fileData.size());
+		entry->fileData = {};
+		entry->fileDataStorage = {};
+		_l.lock();
+		s_shaderCacheLoader.resultQueue.emplace_back(std::move(entry));
+		s_shaderCacheLoader.resultCondVar.notify_one();
+	}
+	s_shaderCacheLoader.numActiveWorkers--;
+	s_shaderCacheLoader.resultCondVar.notify_all();
+	_l.unlock();
+	LatteSHRC_SetThreadPSInputTable(nullptr);
+}
+
+void LatteShaderCache_startLoader(const fs::path& cachePath, uint32 extraVersion)
+{
+	s_shaderCacheLoader.cacheView = FileCache::OpenReadOnly(cachePath, extraVersion);
+	s_shaderCacheLoader.readQueue.clear();
+	s_shaderCacheLoader.resultQueue.clear();
+	s_shaderCacheLoader.numInFlight = 0;
+	s_shaderCacheLoader.readerFinished = false;
+	s_shaderCacheLoader.stopRequested = false;
+	uint32 numWorkers = std::clamp<uint32>(GetPhysicalCoreCount(), 1, SHADER_CACHE_LOAD_MAX_WORKERS);
+	s_shaderCacheLoader.numActiveWorkers = (sint32)numWorkers;
+	s_shaderCacheLoader.readerThread = std::thread(LatteShaderCache_loaderReaderThread);
+	for (uint32 i = 0; i < numWorkers; i++)
+		s_shaderCacheLoader.workerThreads.emplace_back(LatteShaderCache_loaderWorkerThread);
+}
+
+// take up to maxCount decompiled entries. Waits briefly if none are ready yet
+// returns false once all entries have been handed out
+bool LatteShaderCache_getLoadedEntries(std::vector<std::unique_ptr<LatteShaderCacheLoadEntry>>& entriesOut, sint32 maxCount)
+{
+	std::unique_lock _l(s_shaderCacheLoader.mutex);
+	auto isDone = [] { return s_shaderCacheLoader.readerFinished && s_shaderCacheLoader.numActiveWorkers == 0 && s_shaderCacheLoader.resultQueue.empty(); };
+	s_shaderCacheLoader.resultCondVar.wait_for(_l, std::chrono::milliseconds(10), [&] { return !s_shaderCacheLoader.resultQueue.empty() || isDone(); });
+	while (!s_shaderCacheLoader.resultQueue.empty() && (sint32)entriesOut.size() < maxCount)
+	{
+		entriesOut.emplace_back(std::move(s_shaderCacheLoader.resultQueue.front()));
+		s_shaderCacheLoader.resultQueue.pop_front();
+		s_shaderCacheLoader.numInFlight--;
+	}
+	if (!entriesOut.empty())
+		s_shaderCacheLoader.readerCondVar.notify_one();
+	return !entriesOut.empty() || !isDone();
+}
+
+// shut down the loader threads. Shaders which were decompiled but not yet consumed are still registered, without creating renderer shaders
+void LatteShaderCache_stopLoader()
+{
+	{
+		std::unique_lock _l(s_shaderCacheLoader.mutex);
+		s_shaderCacheLoader.stopRequested = true;
+		s_shaderCacheLoader.readerCondVar.notify_all();
+		s_shaderCacheLoader.workerCondVar.notify_all();
+	}
+	s_shaderCacheLoader.readerThread.join();
+	for (auto& it : s_shaderCacheLoader.workerThreads)
+		it.join();
+	s_shaderCacheLoader.workerThreads.clear();
+	for (auto& it : s_shaderCacheLoader.resultQueue)
+	{
+		if (it->shader)
+			LatteSHRC_RegisterShader(it->shader, it->shader->baseHash, it->shader->auxHash);
+	}
+	s_shaderCacheLoader.readQueue.clear();
+	s_shaderCacheLoader.resultQueue.clear();
+	delete s_shaderCacheLoader.cacheView;
+	s_shaderCacheLoader.cacheView = nullptr;
+}
+
 typedef struct
 {
 	unsigned char imageTypeCode;
@@ -408,7 +560,10 @@ void LatteShaderCache_Load()
 	uint32 transferableExtraVersion = SHADER_CACHE_GENERIC_EXTRA_VERSION;
     s_shaderCacheGeneric = FileCache::Open(pathGeneric, false, transferableExtraVersion); // legacy extra version (1.25.0 - 1.25.1b)
 	if(!s_shaderCacheGeneric)
-        s_shaderCacheGeneric = FileCache::Open(pathGeneric, true, LatteShaderCache_getShaderCacheExtraVersion(cacheTitleId));
+	{
+		transferableExtraVersion = LatteShaderCache_getShaderCacheExtraVersion(cacheTitleId);
+		s_shaderCacheGeneric = FileCache::Open(pathGeneric, true, transferableExtraVersion);
+	}
 	if(!s_shaderCacheGeneric)
 	{
 		// no shader cache available yet
@@ -458,34 +613,41 @@ void LatteShaderCache_Load()
 		g_bootSndPlayer.StartSound();
 
 	sint32 numLoadedShaders = 0;
-	uint32 loadIndex = 0;
+	std::vector<std::unique_ptr<LatteShaderCacheLoadEntry>> loadedEntries;
+	std::vector<std::pair<uint64, uint64>> invalidEntries;
 
 	auto LoadShadersUpdate = [&]() -> bool
 	{
-		if (loadIndex >= (uint32)s_shaderCacheGeneric->GetMaximumFileIndex())
+		loadedEntries.clear();
+		if (!LatteShaderCache_getLoadedEntries(loadedEntries, SHADER_CACHE_LOAD_BATCH_SIZE))
 			return false;
-		LatteShaderCache_updateCompileQueue(SHADER_CACHE_COMPILE_QUEUE_SIZE - 2);
-		uint64 name1;
-		uint64 name2;
-		std::vector<uint8> fileData;
-		if (!s_shaderCacheGeneric->GetFileByIndex(loadIndex, &name1, &name2, fileData))
+		// make room in the compile queue for the whole batch
+		LatteShaderCache_updateCompileQueue(SHADER_CACHE_COMPILE_QUEUE_SIZE - (sint32)loadedEntries.size());
+		for (auto& entry : loadedEntries)
 		{
-			loadIndex++;
-			return true;
-		}
-		g_shaderCacheLoaderState.loadedShaderFiles++;
-		if (LatteShaderCache_readSeparableShader(fileData.data(), fileData.size()) == false)
-		{
-			// something is wrong with the stored shader, remove entry from shader cache files
-			cemuLog_log(LogType::Force, "Shader cache entry {} invalid, deleting...", loadIndex);
-			s_shaderCacheGeneric->DeleteFile({name1, name2 });
+			g_shaderCacheLoaderState.loadedShaderFiles++;
+			LatteDecompilerShader* shader = entry->shader;
+			if (!shader)
+			{
+				// something is wrong with the stored shader, remove entry from shader cache files once loading is done
+				invalidEntries.emplace_back(entry->name1, entry->name2);
+				continue;
+			}
+			LatteShaderCache_loadOrCompileSeparableShader(shader, shader->baseHash, shader->auxHash);
+			LatteSHRC_RegisterShader(shader, shader->baseHash, shader->auxHash);
+			numLoadedShaders++;
 		}
-		numLoadedShaders++;
-		loadIndex++;
 		return true;
 	};
 
+	LatteShaderCache_startLoader(pathGeneric, transferableExtraVersion);
 	LatteShaderCache_ShowProgress(LoadShadersUpdate, false);
+	LatteShaderCache_stopLoader();
+	for (auto& it : invalidEntries)
+	{
+		cemuLog_log(LogType::Force, "Shader cache entry {:016x}_{:016x} invalid, deleting...", it.first, it.second);
+		s_shaderCacheGeneric->DeleteFile({ it.first, it.second });
+	}
 
 	LatteShaderCache_updateCompileQueue(0);
 	// write load time and RAM usage to log file (in dev build)
@@ -818,33 +980,33 @@ void LatteShaderCache_loadOrCompileSeparableShader(LatteDecompilerShader* shader
 	LatteShaderCache_addToCompileQueue(shader);
 }
 
-bool LatteShaderCache_readSeparableVertexShader(MemStreamReader& streamReader, uint8 version)
+LatteDecompilerShader* LatteShaderCache_decompileSeparableVertexShader(MemStreamReader& streamReader, uint8 version)
 {
 	auto lcr = std::make_unique<LatteContextRegister>();
 	if (version != 1)
-		return false;
+		return nullptr;
 	uint64 shaderBaseHash = streamReader.readBE<uint64>();
 	uint64 shaderAuxHash = streamReader.readBE<uint64>();
 	bool usesGeometryShader = streamReader.readBE<uint8>() != 0;
 	// context registers
 	Latte::GPUCompactedRegisterState regState;
 	if (!Latte::DeserializeRegisterState(regState, streamReader))
-		return false;
+		return nullptr;
 	Latte::LoadGPURegisterState(*lcr, regState);
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// fetch shader
 	std::vector<uint8> fetchShaderData;
 	if (!Latte::DeserializeShaderProgram(fetchShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// vertex shader
 	std::vector<uint8> vertexShaderData;
 	if (!Latte::DeserializeShaderProgram(vertexShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError() || !streamReader.isEndOfStream())
-		return false;
+		return nullptr;
 	// update PS inputs (affects VS shader outputs)
 	LatteShader_UpdatePSInputs(lcr->GetRawView());
 	// get fetch shader
@@ -857,18 +1019,15 @@ bool LatteShaderCache_readSeparableVertexShader(MemStreamReader& streamReader, u
 	LatteDecompilerOutput_t decompilerOutput{};
 	LatteDecompiler_DecompileVertexShader(shaderBaseHash, lcr->GetRawView(), vertexShaderData.data(), vertexShaderData.size(), fetchShader, options, &decompilerOutput);
 	LatteDecompilerShader* vertexShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, shaderBaseHash, false, shaderAuxHash, lcr->GetRawView());
-	// compile
 	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, vertexShader);
 	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, SHADER_DUMP_TYPE_VERTEX, vertexShaderData.data(), vertexShaderData.size());
-	LatteShaderCache_loadOrCompileSeparableShader(vertexShader, shaderBaseHash, shaderAuxHash);
-	LatteSHRC_RegisterShader(vertexShader, shaderBaseHash, shaderAuxHash);
-	return true;
+	return vertexShader;
 }
 
-bool LatteShaderCache_readSeparableGeometryShader(MemStreamReader& streamReader, uint8 version)
+LatteDecompilerShader* LatteShaderCache_decompileSeparableGeometryShader(MemStreamReader& streamReader, uint8 version)
 {
 	if (version != 1)
-		return false;
+		return nullptr;
 	auto lcr = std::make_unique<LatteContextRegister>();
 	uint64 shaderBaseHash = streamReader.readBE<uint64>();
 	uint64 shaderAuxHash = streamReader.readBE<uint64>();
@@ -876,20 +1035,20 @@ bool LatteShaderCache_readSeparableGeometryShader(MemStreamReader& streamReader,
 	// context registers
 	Latte::GPUCompactedRegisterState regState;
 	if (!Latte::DeserializeRegisterState(regState, streamReader))
-		return false;
+		return nullptr;
 	Latte::LoadGPURegisterState(*lcr, regState);
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// geometry copy shader
 	std::vector<uint8> geometryCopyShaderData;
 	if (!Latte::DeserializeShaderProgram(geometryCopyShaderData, streamReader))
-		return false;
+		return nullptr;
 	// geometry shader
 	std::vector<uint8> geometryShaderData;
 	if (!Latte::DeserializeShaderProgram(geometryShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError() || !streamReader.isEndOfStream())
-		return false;
+		return nullptr;
 	// update PS inputs
 	LatteShader_UpdatePSInputs(lcr->GetRawView());
 	// determine decompiler options
@@ -899,18 +1058,15 @@ bool LatteShaderCache_readSeparableGeometryShader(MemStreamReader& streamReader,
 	LatteDecompilerOutput_t decompilerOutput{};
 	LatteDecompiler_DecompileGeometryShader(shaderBaseHash, lcr->GetRawView(), geometryShaderData.data(), geometryShaderData.size(), geometryCopyShaderData.data(), geometryCopyShaderData.size(), vsRingParameterCount, options, &decompilerOutput);
 	LatteDecompilerShader* geometryShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, shaderBaseHash, false, shaderAuxHash, lcr->GetRawView());
-	// compile
 	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, geometryShader);
 	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, SHADER_DUMP_TYPE_GEOMETRY, geometryShaderData.data(), geometryShaderData.size());
-	LatteShaderCache_loadOrCompileSeparableShader(geometryShader, shaderBaseHash, shaderAuxHash);
-	LatteSHRC_RegisterShader(geometryShader, shaderBaseHash, shaderAuxHash);
-	return true;
+	return geometryShader;
 }
 
-bool LatteShaderCache_readSeparablePixelShader(MemStreamReader& streamReader, uint8 version)
+LatteDecompilerShader* LatteShaderCache_decompileSeparablePixelShader(MemStreamReader& streamReader, uint8 version)
 {
 	if (version != 1)
-		return false;
+		return nullptr;
 	auto lcr = std::make_unique<LatteContextRegister>();
 	uint64 shaderBaseHash = streamReader.readBE<uint64>();
 	uint64 shaderAuxHash = streamReader.readBE<uint64>();
@@ -918,16 +1074,16 @@ bool LatteShaderCache_readSeparablePixelShader(MemStreamReader& streamReader, ui
 	// context registers
 	Latte::GPUCompactedRegisterState regState;
 	if (!Latte::DeserializeRegisterState(regState, streamReader))
-		return false;
+		return nullptr;
 	Latte::LoadGPURegisterState(*lcr, regState);
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// pixel shader
 	std::vector<uint8> pixelShaderData;
 	if (!Latte::DeserializeShaderProgram(pixelShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError() || !streamReader.isEndOfStream())
-		return false;
+		return nullptr;
 	// update PS inputs
 	LatteShader_UpdatePSInputs(lcr->GetRawView());
 	// determine decompiler options
@@ -937,30 +1093,29 @@ bool LatteShaderCache_readSeparablePixelShader(MemStreamReader& streamReader, ui
 	LatteDecompilerOutput_t decompilerOutput{};
 	LatteDecompiler_DecompilePixelShader(shaderBaseHash, lcr->GetRawView(), pixelShaderData.data(), pixelShaderData.size(), options, &decompilerOutput);
 	LatteDecompilerShader* pixelShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, shaderBaseHash, false, shaderAuxHash, lcr->GetRawView());
-	// compile
 	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, pixelShader);
 	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, SHADER_DUMP_TYPE_PIXEL, pixelShaderData.data(), pixelShaderData.size());
-	LatteShaderCache_loadOrCompileSeparableShader(pixelShader, shaderBaseHash, shaderAuxHash);
-	LatteSHRC_RegisterShader(pixelShader, shaderBaseHash, shaderAuxHash);
-	return true;
+	return pixelShader;
 }
 
-// read shader info from shader cache
-bool LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderInfoSize)
+// read shader info from shader cache and decompile it
+// does not touch the GPU state or the renderer and can be called from any thread, as long as it has its own PS input table set
+// returns nullptr if the entry is invalid
+LatteDecompilerShader* LatteShaderCache_decompileSeparableShader(const uint8* shaderInfoData, sint32 shaderInfoSize)
 {
 	if (shaderInfoSize < 8)
-		return false;
+		return nullptr;
 	MemStreamReader streamReader(shaderInfoData, shaderInfoSize);
 	uint8 versionAndType = streamReader.readBE<uint8>();
 	uint8 version = versionAndType & 0xF;
 	uint8 type = (versionAndType >> 4) & 0xF;
 	if (type == SHADER_CACHE_TYPE_VERTEX)
-		return LatteShaderCache_readSeparableVertexShader(streamReader, version);
+		return LatteShaderCache_decompileSeparableVertexShader(streamReader, version);
 	else if (type == SHADER_CACHE_TYPE_GEOMETRY)
-		return LatteShaderCache_readSeparableGeometryShader(streamReader, version);
+		return LatteShaderCache_decompileSeparableGeometryShader(streamReader, version);
 	else if (type == SHADER_CACHE_TYPE_PIXEL)
-		return LatteShaderCache_readSeparablePixelShader(streamReader, version);
-	return false;
+		return LatteShaderCache_decompileSeparablePixelShader(streamReader, version);
+	return nullptr;
 }
 
 void LatteShaderCache_Close()
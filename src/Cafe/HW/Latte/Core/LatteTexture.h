@@ -163,6 +163,7 @@ public:
 	uint32 reloadCount{};
 	// last update (from RAM data)
 	uint32 lastDataUpdateFrameCounter{};
+	uint64 writeTrackerSequence{}; // used instead of hashing when page write tracking is enabled
 	// optimization
 	bool useLightHash{};
 	// overwrite info
@@ -2,6 +2,7 @@
 #include "Cafe/HW/Latte/Core/LatteDraw.h"
 #include "Cafe/HW/Latte/Core/LatteTexture.h"
 #include "Cafe/HW/Latte/Renderer/Renderer.h"
+#include "Cafe/HW/MMU/MemoryWriteTracker.h"
 #include "Common/cpu_features.h"
 
 std::unordered_set<LatteTexture*> g_allTextures;
@@ -224,9 +225,16 @@ bool LatteTC_HasTextureChanged(LatteTexture* hostTexture, bool force)
 		// todo - remove this or find a better way to handle excluded texture invalidation checks (maybe via game profile?)
 		return false;
 	}
+	uint32 texDataHash;
+	// with page write tracking we only need to hash the data if the CPU wrote to one of its pages
+	// pages are shared with unrelated data, so a write alone does not mean the texture changed. The hash still decides
+	if (MemoryWriteTracker_IsActive() && hostTexture->texDataPtrHigh != hostTexture->texDataPtrLow &&
+		!MemoryWriteTracker_CheckRange(memory_getPointerFromPhysicalOffset(hostTexture->texDataPtrLow), hostTexture->texDataPtrHigh - hostTexture->texDataPtrLow, hostTexture->writeTrackerSequence))
+		texDataHash = hostTexture->texDataHash2;
+	else
+		texDataHash = LatteTexture_CalculateTextureDataHash(hostTexture);
 	// workaround for corrupted terrain texture in BotW after video playback
 	// probably would be fixed if we added support for invalidating individual slices/mips of a texture
-	uint32 texDataHash = LatteTexture_CalculateTextureDataHash(hostTexture);
 	if( texDataHash != hostTexture->texDataHash2 )
 	{
 		hostTexture->texDataHash2 = texDataHash;
@@ -0,0 +1,910 @@
+#include "Cafe/HW/Latte/Core/LatteTextureLoader.h"
+#include "Common/cpu_features.h"
+
+#if defined(ARCH_X86_64) && defined(__GNUC__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// BC1-BC5 decoders with 8-bit integer output, used when the host cannot sample the compressed format directly
+// Endpoints are expanded by bit replication and interpolated values are rounded to nearest
+// For SNORM channels -128 is treated as -127, same as on real hardware
+// All implementations (scalar, SSE4.1, AVX2, NEON) produce bit-identical output
+
+enum class BCAlphaMode
+{
+	NONE, // BC1
+	EXPLICIT, // BC2, 4 bit per texel
+	INTERPOLATED, // BC3, same encoding as a BC4 channel
+};
+
+static uint32 _BCExpand565(uint16 c)
+{
+	uint32 r = (c >> 11) & 0x1F;
+	uint32 g = (c >> 5) & 0x3F;
+	uint32 b = (c >> 0) & 0x1F;
+	r = (r << 3) | (r >> 2);
+	g = (g << 2) | (g >> 4);
+	b = (b << 3) | (b >> 2);
+	return r | (g << 8) | (b << 16) | 0xFF000000;
+}
+
+// palette entries are RGBA8 with red in the lowest byte
+static void _BCColorPalette(uint16 c0, uint16 c1, bool allowPunchThrough, uint32 palette[4])
+{
+	uint32 e0 = _BCExpand565(c0);
+	uint32 e1 = _BCExpand565(c1);
+	uint32 p2 = 0;
+	uint32 p3 = 0;
+	for (uint32 shift = 0; shift < 32; shift += 8)
+	{
+		uint32 a = (e0 >> shift) & 0xFF;
+		uint32 b = (e1 >> shift) & 0xFF;
+		if (c0 > c1 || !allowPunchThrough)
+		{
+			p2 |= ((a * 2 + b + 1) / 3) << shift;
+			p3 |= ((a + b * 2 + 1) / 3) << shift;
+		}
+		else
+			p2 |= ((a + b + 1) / 2) << shift; // p3 is transparent black
+	}
+	palette[0] = e0;
+	palette[1] = e1;
+	palette[2] = p2;
+	palette[3] = p3;
+}
+
+// a channel is two 8-bit endpoints followed by 16 3-bit indices
+// signed endpoints are remapped to 0..254 for interpolation and the offset is removed again afterwards
+template<bool isSigned>
+static void _BCChannelPalette(uint8 rawA, uint8 rawB, uint8 palette[8])
+{
+	uint32 keyA = isSigned ? (rawA ^ 0x80) : rawA;
+	uint32 keyB = isSigned ? (rawB ^ 0x80) : rawB;
+	uint32 a = isSigned ? std::max<uint32>(keyA, 1) - 1 : keyA;
+	uint32 b = isSigned ? std::max<uint32>(keyB, 1) - 1 : keyB;
+	uint32 p[8];
+	p[0] = a;
+	p[1] = b;
+	if (keyA > keyB)
+	{
+		for (uint32 i = 1; i <= 6; i++)
+			p[1 + i] = ((7 - i) * a + i * b + 3) / 7;
+	}
+	else
+	{
+		for (uint32 i = 1; i <= 4; i++)
+			p[1 + i] = ((5 - i) * a + i * b + 2) / 5;
+		p[6] = 0;
+		p[7] = isSigned ? 254 : 255;
+	}
+	for (sint32 i = 0; i < 8; i++)
+		palette[i] = isSigned ? (uint8)(p[i] + 0x81) : (uint8)p[i];
+}
+
+template<bool isSigned>
+static void _BCDecodeChannel(const uint8* blockData, uint8 output[16])
+{
+	uint8 palette[8];
+	_BCChannelPalette<isSigned>(blockData[0], blockData[1], palette);
+	uint64 indices = 0;
+	for (sint32 i = 0; i < 6; i++)
+		indices |= (uint64)blockData[2 + i] << (i * 8);
+	for (sint32 i = 0; i < 16; i++)
+		output[i] = palette[(indices >> (i * 3)) & 7];
+}
+
+static void _BCDecodeExplicitAlpha(const uint8* blockData, uint8 output[16])
+{
+	for (sint32 i = 0; i < 16; i++)
+		output[i] = ((blockData[i / 2] >> ((i & 1) * 4)) & 0xF) * 0x11;
+}
+
+template<uint32 colorOffset, bool allowPunchThrough, BCAlphaMode alphaMode>
+static void _decodeBCColorBlock(const uint8* blockData, uint8* output, sint32 outputPitch)
+{
+	uint32 palette[4];
+	_BCColorPalette(*(uint16*)(blockData + colorOffset + 0), *(uint16*)(blockData + colorOffset + 2), allowPunchThrough, palette);
+	uint32 colorIndices = *(uint32*)(blockData + colorOffset + 4);
+	uint8 alpha[16];
+	if constexpr (alphaMode == BCAlphaMode::EXPLICIT)
+		_BCDecodeExplicitAlpha(blockData, alpha);
+	else if constexpr (alphaMode == BCAlphaMode::INTERPOLATED)
+		_BCDecodeChannel<false>(blockData, alpha);
+	for (sint32 py = 0; py < 4; py++)
+	{
+		uint32* rowOutput = (uint32*)(output + py * outputPitch);
+		for (sint32 px = 0; px < 4; px++)
+		{
+			uint32 texelIndex = px + py * 4;
+			uint32 color = palette[(colorIndices >> (texelIndex * 2)) & 3];
+			if constexpr (alphaMode != BCAlphaMode::NONE)
+				color = (color & 0x00FFFFFF) | ((uint32)alpha[texelIndex] << 24);
+			rowOutput[px] = color;
+		}
+	}
+}
+
+template<uint32 colorOffset, bool allowPunchThrough, BCAlphaMode alphaMode>
+static void _decodeBCColorBlocks_scalar(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	for (sint32 b = 0; b < blockCount; b++)
+		_decodeBCColorBlock<colorOffset, allowPunchThrough, alphaMode>(blockPtrs[b], output + b * 16, outputPitch);
+}
+
+template<bool isSigned>
+static void _decodeBC4Blocks_scalar(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	for (sint32 b = 0; b < blockCount; b++)
+	{
+		uint8 r[16];
+		_BCDecodeChannel<isSigned>(blockPtrs[b], r);
+		for (sint32 py = 0; py < 4; py++)
+			memcpy(output + py * outputPitch + b * 4, r + py * 4, 4);
+	}
+}
+
+template<bool isSigned>
+static void _decodeBC5Blocks_scalar(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	for (sint32 b = 0; b < blockCount; b++)
+	{
+		uint8 r[16];
+		uint8 g[16];
+		_BCDecodeChannel<isSigned>(blockPtrs[b] + 0, r);
+		_BCDecodeChannel<isSigned>(blockPtrs[b] + 8, g);
+		for (sint32 py = 0; py < 4; py++)
+		{
+			uint8* rowOutput = output + py * outputPitch + b * 8;
+			for (sint32 px = 0; px < 4; px++)
+			{
+				rowOutput[px * 2 + 0] = r[px + py * 4];
+				rowOutput[px * 2 + 1] = g[px + py * 4];
+			}
+		}
+	}
+}
+
+#if defined(ARCH_X86_64) || defined(__aarch64__)
+// byte shuffle masks which expand one row of 2-bit color indices into four RGBA8 palette lookups
+struct BCColorRowShuffleTable
+{
+	BCColorRowShuffleTable()
+	{
+		for (uint32 indexByte = 0; indexByte < 256; indexByte++)
+		{
+			for (uint32 px = 0; px < 4; px++)
+			{
+				uint32 colorIndex = (indexByte >> (px * 2)) & 3;
+				for (uint32 c = 0; c < 4; c++)
+					mask[indexByte][px * 4 + c] = (uint8)(colorIndex * 4 + c);
+			}
+		}
+	}
+	alignas(16) uint8 mask[256][16];
+};
+
+static const BCColorRowShuffleTable s_bcColorRowShuffle;
+
+// moves the alpha values of one texel row (bytes 4*row...4*row+3) to the alpha byte of each RGBA8 texel
+alignas(16) static const uint8 s_bcAlphaRowShuffle[4][16] =
+{
+	{ 0x80, 0x80, 0x80, 0, 0x80, 0x80, 0x80, 1, 0x80, 0x80, 0x80, 2, 0x80, 0x80, 0x80, 3 },
+	{ 0x80, 0x80, 0x80, 4, 0x80, 0x80, 0x80, 5, 0x80, 0x80, 0x80, 6, 0x80, 0x80, 0x80, 7 },
+	{ 0x80, 0x80, 0x80, 8, 0x80, 0x80, 0x80, 9, 0x80, 0x80, 0x80, 10, 0x80, 0x80, 0x80, 11 },
+	{ 0x80, 0x80, 0x80, 12, 0x80, 0x80, 0x80, 13, 0x80, 0x80, 0x80, 14, 0x80, 0x80, 0x80, 15 },
+};
+
+// each 3-bit channel index is gathered into a 16-bit lane, then shifted to the top via a multiplication and extracted with a right shift by 13
+alignas(16) static const uint8 s_bcChannelIndexGather[2][16] =
+{
+	{ 2, 3, 2, 3, 2, 3, 3, 4, 3, 4, 3, 4, 4, 5, 4, 5 },
+	{ 5, 6, 5, 6, 5, 6, 6, 7, 6, 7, 6, 7, 7, 0x80, 7, 0x80 },
+};
+alignas(16) static const uint16 s_bcChannelIndexMultiplier[8] = { 1 << 13, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8 };
+
+// interpolation weights of the two channel palette modes (endpoint A, endpoint B)
+alignas(16) static const uint16 s_bcChannelWeights7[2][8] = { { 7, 0, 6, 5, 4, 3, 2, 1 }, { 0, 7, 1, 2, 3, 4, 5, 6 } };
+alignas(16) static const uint16 s_bcChannelWeights5[2][8] = { { 5, 0, 4, 3, 2, 1, 0, 0 }, { 0, 5, 1, 2, 3, 4, 0, 0 } };
+// fixed point reciprocals, exact for the value ranges that occur here
+constexpr uint16 BC_RECIPROCAL_3 = 0xAAAB; // (x * 0xAAAB) >> 17 == x / 3
+constexpr uint16 BC_RECIPROCAL_5 = 13108; // (x * 13108) >> 16 == x / 5
+constexpr uint16 BC_RECIPROCAL_7 = 9363; // (x * 9363) >> 16 == x / 7
+#endif
+
+#if defined(ARCH_X86_64)
+// SSE4.1 variants. Color blocks are decoded four at a time, the palettes are computed with one lane per block and then transposed
+// Channels (BC3 alpha, BC4, BC5) use one vector per block, with the four blocks of a group transposed into contiguous output rows
+
+ATTRIBUTE_SSE41
+static __m128i _BCExpand565_SSE41(__m128i c)
+{
+	__m128i r = _mm_and_si128(_mm_srli_epi32(c, 11), _mm_set1_epi32(0x1F));
+	__m128i g = _mm_and_si128(_mm_srli_epi32(c, 5), _mm_set1_epi32(0x3F));
+	__m128i b = _mm_and_si128(c, _mm_set1_epi32(0x1F));
+	r = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+	g = _mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4));
+	b = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+	__m128i rgba = _mm_or_si128(r, _mm_slli_epi32(g, 8));
+	rgba = _mm_or_si128(rgba, _mm_slli_epi32(b, 16));
+	return _mm_or_si128(rgba, _mm_set1_epi32((int)0xFF000000));
+}
+
+// (a * 2 + b + 1) / 3 per byte
+ATTRIBUTE_SSE41
+static __m128i _BCInterpolateThird_SSE41(__m128i a, __m128i b)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i reciprocal = _mm_set1_epi16((sint16)BC_RECIPROCAL_3);
+	__m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(_mm_unpacklo_epi8(a, zero), 1), _mm_unpacklo_epi8(b, zero)), one);
+	__m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(_mm_unpackhi_epi8(a, zero), 1), _mm_unpackhi_epi8(b, zero)), one);
+	lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, reciprocal), 1);
+	hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, reciprocal), 1);
+	return _mm_packus_epi16(lo, hi);
+}
+
+// returns the 16 decoded values of a channel in texel order
+template<bool isSigned>
+ATTRIBUTE_SSE41
+static __m128i _BCDecodeChannel_SSE41(const uint8* blockData)
+{
+	__m128i block = _mm_loadl_epi64((const __m128i*)blockData);
+	__m128i keyA = _mm_shuffle_epi8(block, _mm_set1_epi16((sint16)0x8000));
+	__m128i keyB = _mm_shuffle_epi8(block, _mm_set1_epi16((sint16)0x8001));
+	if constexpr (isSigned)
+	{
+		keyA = _mm_xor_si128(keyA, _mm_set1_epi16(0x80));
+		keyB = _mm_xor_si128(keyB, _mm_set1_epi16(0x80));
+	}
+	__m128i a = keyA;
+	__m128i b = keyB;
+	if constexpr (isSigned)
+	{
+		a = _mm_sub_epi16(_mm_max_epi16(a, _mm_set1_epi16(1)), _mm_set1_epi16(1));
+		b = _mm_sub_epi16(_mm_max_epi16(b, _mm_set1_epi16(1)), _mm_set1_epi16(1));
+	}
+	// palette
+	__m128i p7 = _mm_add_epi16(_mm_mullo_epi16(a, _mm_load_si128((const __m128i*)s_bcChannelWeights7[0])), _mm_mullo_epi16(b, _mm_load_si128((const __m128i*)s_bcChannelWeights7[1])));
+	p7 = _mm_mulhi_epu16(_mm_add_epi16(p7, _mm_set1_epi16(3)), _mm_set1_epi16((sint16)BC_RECIPROCAL_7));
+	__m128i p5 = _mm_add_epi16(_mm_mullo_epi16(a, _mm_load_si128((const __m128i*)s_bcChannelWeights5[0])), _mm_mullo_epi16(b, _mm_load_si128((const __m128i*)s_bcChannelWeights5[1])));
+	p5 = _mm_mulhi_epu16(_mm_add_epi16(p5, _mm_set1_epi16(2)), _mm_set1_epi16((sint16)BC_RECIPROCAL_5));
+	p5 = _mm_blend_epi16(p5, _mm_setr_epi16(0, 0, 0, 0, 0, 0, 0, isSigned ? 254 : 255), 0xC0);
+	__m128i palette = _mm_blendv_epi8(p5, p7, _mm_cmpgt_epi16(keyA, keyB));
+	palette = _mm_packus_epi16(palette, palette);
+	if constexpr (isSigned)
+		palette = _mm_add_epi8(palette, _mm_set1_epi8((sint8)0x81));
+	// indices
+	const __m128i multiplier = _mm_load_si128((const __m128i*)s_bcChannelIndexMultiplier);
+	__m128i indicesLo = _mm_shuffle_epi8(block, _mm_load_si128((const __m128i*)s_bcChannelIndexGather[0]));
+	__m128i indicesHi = _mm_shuffle_epi8(block, _mm_load_si128((const __m128i*)s_bcChannelIndexGather[1]));
+	indicesLo = _mm_srli_epi16(_mm_mullo_epi16(indicesLo, multiplier), 13);
+	indicesHi = _mm_srli_epi16(_mm_mullo_epi16(indicesHi, multiplier), 13);
+	return _mm_shuffle_epi8(palette, _mm_packus_epi16(indicesLo, indicesHi));
+}
+
+ATTRIBUTE_SSE41
+static __m128i _BCDecodeExplicitAlpha_SSE41(const uint8* blockData)
+{
+	__m128i block = _mm_loadl_epi64((const __m128i*)blockData);
+	__m128i lo = _mm_and_si128(block, _mm_set1_epi8(0x0F));
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x0F));
+	__m128i alpha = _mm_unpacklo_epi8(lo, hi);
+	return _mm_or_si128(alpha, _mm_slli_epi16(alpha, 4));
+}
+
+template<BCAlphaMode alphaMode>
+ATTRIBUTE_SSE41
+static __m128i _BCDecodeAlpha_SSE41(const uint8* blockData)
+{
+	if constexpr (alphaMode == BCAlphaMode::EXPLICIT)
+		return _BCDecodeExplicitAlpha_SSE41(blockData);
+	else
+		return _BCDecodeChannel_SSE41<false>(blockData);
+}
+
+// 4x4 transpose of 32-bit elements
+ATTRIBUTE_SSE41
+static void _BCTranspose4x4_SSE41(__m128i& v0, __m128i& v1, __m128i& v2, __m128i& v3)
+{
+	__m128i t0 = _mm_unpacklo_epi32(v0, v1);
+	__m128i t1 = _mm_unpacklo_epi32(v2, v3);
+	__m128i t2 = _mm_unpackhi_epi32(v0, v1);
+	__m128i t3 = _mm_unpackhi_epi32(v2, v3);
+	v0 = _mm_unpacklo_epi64(t0, t1);
+	v1 = _mm_unpackhi_epi64(t0, t1);
+	v2 = _mm_unpacklo_epi64(t2, t3);
+	v3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+template<uint32 colorOffset, bool allowPunchThrough, BCAlphaMode alphaMode>
+ATTRIBUTE_SSE41
+static void _decodeBCColorBlocks_SSE41(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 4) <= blockCount; b += 4)
+	{
+		const uint8* blocks[4] = { blockPtrs[b + 0], blockPtrs[b + 1], blockPtrs[b + 2], blockPtrs[b + 3] };
+		__m128i endpoints = _mm_setr_epi32(*(sint32*)(blocks[0] + colorOffset), *(sint32*)(blocks[1] + colorOffset), *(sint32*)(blocks[2] + colorOffset), *(sint32*)(blocks[3] + colorOffset));
+		__m128i c0 = _mm_and_si128(endpoints, _mm_set1_epi32(0xFFFF));
+		__m128i c1 = _mm_srli_epi32(endpoints, 16);
+		__m128i e0 = _BCExpand565_SSE41(c0);
+		__m128i e1 = _BCExpand565_SSE41(c1);
+		__m128i p2 = _BCInterpolateThird_SSE41(e0, e1);
+		__m128i p3 = _BCInterpolateThird_SSE41(e1, e0);
+		if constexpr (allowPunchThrough)
+		{
+			__m128i fourColorMode = _mm_cmpgt_epi32(c0, c1);
+			p2 = _mm_blendv_epi8(_mm_avg_epu8(e0, e1), p2, fourColorMode);
+			p3 = _mm_and_si128(p3, fourColorMode);
+		}
+		// afterwards each vector holds the palette of one block
+		_BCTranspose4x4_SSE41(e0, e1, p2, p3);
+		const __m128i palettes[4] = { e0, e1, p2, p3 };
+		for (sint32 i = 0; i < 4; i++)
+		{
+			uint32 colorIndices = *(uint32*)(blocks[i] + colorOffset + 4);
+			__m128i alpha;
+			if constexpr (alphaMode != BCAlphaMode::NONE)
+				alpha = _BCDecodeAlpha_SSE41<alphaMode>(blocks[i]);
+			uint8* blockOutput = output + (b + i) * 16;
+			for (sint32 py = 0; py < 4; py++)
+			{
+				__m128i row = _mm_shuffle_epi8(palettes[i], _mm_load_si128((const __m128i*)s_bcColorRowShuffle.mask[(colorIndices >> (py * 8)) & 0xFF]));
+				if constexpr (alphaMode != BCAlphaMode::NONE)
+					row = _mm_or_si128(_mm_and_si128(row, _mm_set1_epi32(0x00FFFFFF)), _mm_shuffle_epi8(alpha, _mm_load_si128((const __m128i*)s_bcAlphaRowShuffle[py])));
+				_mm_storeu_si128((__m128i*)(blockOutput + py * outputPitch), row);
+			}
+		}
+	}
+	_decodeBCColorBlocks_scalar<colorOffset, allowPunchThrough, alphaMode>(blockPtrs + b, blockCount - b, output + b * 16, outputPitch);
+}
+
+template<bool isSigned>
+ATTRIBUTE_SSE41
+static void _decodeBC4Blocks_SSE41(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 4) <= blockCount; b += 4)
+	{
+		// after the transpose each vector is one texel row of all four blocks
+		__m128i r0 = _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 0]);
+		__m128i r1 = _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 1]);
+		__m128i r2 = _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 2]);
+		__m128i r3 = _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 3]);
+		_BCTranspose4x4_SSE41(r0, r1, r2, r3);
+		uint8* blockOutput = output + b * 4;
+		_mm_storeu_si128((__m128i*)(blockOutput + 0 * outputPitch), r0);
+		_mm_storeu_si128((__m128i*)(blockOutput + 1 * outputPitch), r1);
+		_mm_storeu_si128((__m128i*)(blockOutput + 2 * outputPitch), r2);
+		_mm_storeu_si128((__m128i*)(blockOutput + 3 * outputPitch), r3);
+	}
+	_decodeBC4Blocks_scalar<isSigned>(blockPtrs + b, blockCount - b, output + b * 4, outputPitch);
+}
+
+template<bool isSigned>
+ATTRIBUTE_SSE41
+static void _decodeBC5Blocks_SSE41(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 2) <= blockCount; b += 2)
+	{
+		// interleaved RG of rows 0-1 and rows 2-3 of each block
+		__m128i rg0A = _mm_unpacklo_epi8(_BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 0] + 0), _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 0] + 8));
+		__m128i rg0B = _mm_unpackhi_epi8(_BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 0] + 0), _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 0] + 8));
+		__m128i rg1A = _mm_unpacklo_epi8(_BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 1] + 0), _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 1] + 8));
+		__m128i rg1B = _mm_unpackhi_epi8(_BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 1] + 0), _BCDecodeChannel_SSE41<isSigned>(blockPtrs[b + 1] + 8));
+		uint8* blockOutput = output + b * 8;
+		_mm_storeu_si128((__m128i*)(blockOutput + 0 * outputPitch), _mm_unpacklo_epi64(rg0A, rg1A));
+		_mm_storeu_si128((__m128i*)(blockOutput + 1 * outputPitch), _mm_unpackhi_epi64(rg0A, rg1A));
+		_mm_storeu_si128((__m128i*)(blockOutput + 2 * outputPitch), _mm_unpacklo_epi64(rg0B, rg1B));
+		_mm_storeu_si128((__m128i*)(blockOutput + 3 * outputPitch), _mm_unpackhi_epi64(rg0B, rg1B));
+	}
+	_decodeBC5Blocks_scalar<isSigned>(blockPtrs + b, blockCount - b, output + b * 8, outputPitch);
+}
+
+// AVX2 variants. Same algorithms as above with two blocks per vector, one in each 128-bit lane
+// Color blocks are decoded eight at a time, lane 0 holds blocks 0-3 and lane 1 blocks 4-7
+
+ATTRIBUTE_AVX2
+static __m256i _BCLoadPair_AVX2(const uint8* blockA, const uint8* blockB)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)blockA)), _mm_loadl_epi64((const __m128i*)blockB), 1);
+}
+
+ATTRIBUTE_AVX2
+static __m256i _BCLoadPair128_AVX2(const void* a, const void* b)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_load_si128((const __m128i*)a)), _mm_load_si128((const __m128i*)b), 1);
+}
+
+ATTRIBUTE_AVX2
+static __m256i _BCExpand565_AVX2(__m256i c)
+{
+	__m256i r = _mm256_and_si256(_mm256_srli_epi32(c, 11), _mm256_set1_epi32(0x1F));
+	__m256i g = _mm256_and_si256(_mm256_srli_epi32(c, 5), _mm256_set1_epi32(0x3F));
+	__m256i b = _mm256_and_si256(c, _mm256_set1_epi32(0x1F));
+	r = _mm256_or_si256(_mm256_slli_epi32(r, 3), _mm256_srli_epi32(r, 2));
+	g = _mm256_or_si256(_mm256_slli_epi32(g, 2), _mm256_srli_epi32(g, 4));
+	b = _mm256_or_si256(_mm256_slli_epi32(b, 3), _mm256_srli_epi32(b, 2));
+	__m256i rgba = _mm256_or_si256(r, _mm256_slli_epi32(g, 8));
+	rgba = _mm256_or_si256(rgba, _mm256_slli_epi32(b, 16));
+	return _mm256_or_si256(rgba, _mm256_set1_epi32((int)0xFF000000));
+}
+
+ATTRIBUTE_AVX2
+static __m256i _BCInterpolateThird_AVX2(__m256i a, __m256i b)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi16(1);
+	const __m256i reciprocal = _mm256_set1_epi16((sint16)BC_RECIPROCAL_3);
+	__m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(_mm256_unpacklo_epi8(a, zero), 1), _mm256_unpacklo_epi8(b, zero)), one);
+	__m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(_mm256_unpackhi_epi8(a, zero), 1), _mm256_unpackhi_epi8(b, zero)), one);
+	lo = _mm256_srli_epi16(_mm256_mulhi_epu16(lo, reciprocal), 1);
+	hi = _mm256_srli_epi16(_mm256_mulhi_epu16(hi, reciprocal), 1);
+	return _mm256_packus_epi16(lo, hi);
+}
+
+template<bool isSigned>
+ATTRIBUTE_AVX2
+static __m256i _BCDecodeChannelPair_AVX2(const uint8* blockA, const uint8* blockB)
+{
+	__m256i block = _BCLoadPair_AVX2(blockA, blockB);
+	__m256i keyA = _mm256_shuffle_epi8(block, _mm256_set1_epi16((sint16)0x8000));
+	__m256i keyB = _mm256_shuffle_epi8(block, _mm256_set1_epi16((sint16)0x8001));
+	if constexpr (isSigned)
+	{
+		keyA = _mm256_xor_si256(keyA, _mm256_set1_epi16(0x80));
+		keyB = _mm256_xor_si256(keyB, _mm256_set1_epi16(0x80));
+	}
+	__m256i a = keyA;
+	__m256i b = keyB;
+	if constexpr (isSigned)
+	{
+		a = _mm256_sub_epi16(_mm256_max_epi16(a, _mm256_set1_epi16(1)), _mm256_set1_epi16(1));
+		b = _mm256_sub_epi16(_mm256_max_epi16(b, _mm256_set1_epi16(1)), _mm256_set1_epi16(1));
+	}
+	__m256i p7 = _mm256_add_epi16(_mm256_mullo_epi16(a, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelWeights7[0]))), _mm256_mullo_epi16(b, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelWeights7[1]))));
+	p7 = _mm256_mulhi_epu16(_mm256_add_epi16(p7, _mm256_set1_epi16(3)), _mm256_set1_epi16((sint16)BC_RECIPROCAL_7));
+	__m256i p5 = _mm256_add_epi16(_mm256_mullo_epi16(a, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelWeights5[0]))), _mm256_mullo_epi16(b, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelWeights5[1]))));
+	p5 = _mm256_mulhi_epu16(_mm256_add_epi16(p5, _mm256_set1_epi16(2)), _mm256_set1_epi16((sint16)BC_RECIPROCAL_5));
+	p5 = _mm256_blend_epi16(p5, _mm256_setr_epi16(0, 0, 0, 0, 0, 0, 0, isSigned ? 254 : 255, 0, 0, 0, 0, 0, 0, 0, isSigned ? 254 : 255), 0xC0);
+	__m256i palette = _mm256_blendv_epi8(p5, p7, _mm256_cmpgt_epi16(keyA, keyB));
+	palette = _mm256_packus_epi16(palette, palette);
+	if constexpr (isSigned)
+		palette = _mm256_add_epi8(palette, _mm256_set1_epi8((sint8)0x81));
+	const __m256i multiplier = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelIndexMultiplier));
+	__m256i indicesLo = _mm256_shuffle_epi8(block, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelIndexGather[0])));
+	__m256i indicesHi = _mm256_shuffle_epi8(block, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcChannelIndexGather[1])));
+	indicesLo = _mm256_srli_epi16(_mm256_mullo_epi16(indicesLo, multiplier), 13);
+	indicesHi = _mm256_srli_epi16(_mm256_mullo_epi16(indicesHi, multiplier), 13);
+	return _mm256_shuffle_epi8(palette, _mm256_packus_epi16(indicesLo, indicesHi));
+}
+
+template<BCAlphaMode alphaMode>
+ATTRIBUTE_AVX2
+static __m256i _BCDecodeAlphaPair_AVX2(const uint8* blockA, const uint8* blockB)
+{
+	if constexpr (alphaMode == BCAlphaMode::EXPLICIT)
+	{
+		__m256i block = _BCLoadPair_AVX2(blockA, blockB);
+		__m256i lo = _mm256_and_si256(block, _mm256_set1_epi8(0x0F));
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x0F));
+		__m256i alpha = _mm256_unpacklo_epi8(lo, hi);
+		return _mm256_or_si256(alpha, _mm256_slli_epi16(alpha, 4));
+	}
+	else
+		return _BCDecodeChannelPair_AVX2<false>(blockA, blockB);
+}
+
+ATTRIBUTE_AVX2
+static void _BCTranspose4x4_AVX2(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3)
+{
+	__m256i t0 = _mm256_unpacklo_epi32(v0, v1);
+	__m256i t1 = _mm256_unpacklo_epi32(v2, v3);
+	__m256i t2 = _mm256_unpackhi_epi32(v0, v1);
+	__m256i t3 = _mm256_unpackhi_epi32(v2, v3);
+	v0 = _mm256_unpacklo_epi64(t0, t1);
+	v1 = _mm256_unpackhi_epi64(t0, t1);
+	v2 = _mm256_unpacklo_epi64(t2, t3);
+	v3 = _mm256_unpackhi_epi64(t2, t3);
+}
+
+template<uint32 colorOffset, bool allowPunchThrough, BCAlphaMode alphaMode>
+ATTRIBUTE_AVX2
+static void _decodeBCColorBlocks_AVX2(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 8) <= blockCount; b += 8)
+	{
+		const uint8* blocks[8];
+		for (sint32 i = 0; i < 8; i++)
+			blocks[i] = blockPtrs[b + i];
+		__m256i endpoints = _mm256_setr_epi32(*(sint32*)(blocks[0] + colorOffset), *(sint32*)(blocks[1] + colorOffset), *(sint32*)(blocks[2] + colorOffset), *(sint32*)(blocks[3] + colorOffset),
+			*(sint32*)(blocks[4] + colorOffset), *(sint32*)(blocks[5] + colorOffset), *(sint32*)(blocks[6] + colorOffset), *(sint32*)(blocks[7] + colorOffset));
+		__m256i c0 = _mm256_and_si256(endpoints, _mm256_set1_epi32(0xFFFF));
+		__m256i c1 = _mm256_srli_epi32(endpoints, 16);
+		__m256i e0 = _BCExpand565_AVX2(c0);
+		__m256i e1 = _BCExpand565_AVX2(c1);
+		__m256i p2 = _BCInterpolateThird_AVX2(e0, e1);
+		__m256i p3 = _BCInterpolateThird_AVX2(e1, e0);
+		if constexpr (allowPunchThrough)
+		{
+			__m256i fourColorMode = _mm256_cmpgt_epi32(c0, c1);
+			p2 = _mm256_blendv_epi8(_mm256_avg_epu8(e0, e1), p2, fourColorMode);
+			p3 = _mm256_and_si256(p3, fourColorMode);
+		}
+		// vector i holds the palette of block i in lane 0 and of block i+4 in lane 1
+		_BCTranspose4x4_AVX2(e0, e1, p2, p3);
+		const __m256i palettes[4] = { e0, e1, p2, p3 };
+		for (sint32 i = 0; i < 4; i++)
+		{
+			const uint8* blockA = blocks[i];
+			const uint8* blockB = blocks[i + 4];
+			uint32 colorIndicesA = *(uint32*)(blockA + colorOffset + 4);
+			uint32 colorIndicesB = *(uint32*)(blockB + colorOffset + 4);
+			__m256i alpha;
+			if constexpr (alphaMode != BCAlphaMode::NONE)
+				alpha = _BCDecodeAlphaPair_AVX2<alphaMode>(blockA, blockB);
+			uint8* blockOutputA = output + (b + i) * 16;
+			uint8* blockOutputB = output + (b + i + 4) * 16;
+			for (sint32 py = 0; py < 4; py++)
+			{
+				__m256i shuffle = _BCLoadPair128_AVX2(s_bcColorRowShuffle.mask[(colorIndicesA >> (py * 8)) & 0xFF], s_bcColorRowShuffle.mask[(colorIndicesB >> (py * 8)) & 0xFF]);
+				__m256i row = _mm256_shuffle_epi8(palettes[i], shuffle);
+				if constexpr (alphaMode != BCAlphaMode::NONE)
+					row = _mm256_or_si256(_mm256_and_si256(row, _mm256_set1_epi32(0x00FFFFFF)), _mm256_shuffle_epi8(alpha, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_bcAlphaRowShuffle[py]))));
+				_mm_storeu_si128((__m128i*)(blockOutputA + py * outputPitch), _mm256_castsi256_si128(row));
+				_mm_storeu_si128((__m128i*)(blockOutputB + py * outputPitch), _mm256_extracti128_si256(row, 1));
+			}
+		}
+	}
+	_decodeBCColorBlocks_SSE41<colorOffset, allowPunchThrough, alphaMode>(blockPtrs + b, blockCount - b, output + b * 16, outputPitch);
+}
+
+template<bool isSigned>
+ATTRIBUTE_AVX2
+static void _decodeBC4Blocks_AVX2(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 8) <= blockCount; b += 8)
+	{
+		// pair i is block i and block i+4, after the transpose each vector holds one full texel row of all eight blocks
+		__m256i r0 = _BCDecodeChannelPair_AVX2<isSigned>(blockPtrs[b + 0], blockPtrs[b + 4]);
+		__m256i r1 = _BCDecodeChannelPair_AVX2<isSigned>(blockPtrs[b + 1], blockPtrs[b + 5]);
+		__m256i r2 = _BCDecodeChannelPair_AVX2<isSigned>(blockPtrs[b + 2], blockPtrs[b + 6]);
+		__m256i r3 = _BCDecodeChannelPair_AVX2<isSigned>(blockPtrs[b + 3], blockPtrs[b + 7]);
+		_BCTranspose4x4_AVX2(r0, r1, r2, r3);
+		uint8* blockOutput = output + b * 4;
+		_mm256_storeu_si256((__m256i*)(blockOutput + 0 * outputPitch), r0);
+		_mm256_storeu_si256((__m256i*)(blockOutput + 1 * outputPitch), r1);
+		_mm256_storeu_si256((__m256i*)(blockOutput + 2 * outputPitch), r2);
+		_mm256_storeu_si256((__m256i*)(blockOutput + 3 * outputPitch), r3);
+	}
+	_decodeBC4Blocks_SSE41<isSigned>(blockPtrs + b, blockCount - b, output + b * 4, outputPitch);
+}
+
+template<bool isSigned>
+ATTRIBUTE_AVX2
+static void _decodeBC5Blocks_AVX2(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 2) <= blockCount; b += 2)
+	{
+		__m256i r = _BCDecodeChannelPair_AVX2<isSigned>(blockPtrs[b + 0] + 0, blockPtrs[b + 1] + 0);
+		__m256i g = _BCDecodeChannelPair_AVX2<isSigned>(blockPtrs[b + 0] + 8, blockPtrs[b + 1] + 8);
+		// reorder the 8 byte rows from (A0 A1 | B0 B1) to (A0 B0 | A1 B1)
+		__m256i rows01 = _mm256_permute4x64_epi64(_mm256_unpacklo_epi8(r, g), 0xD8);
+		__m256i rows23 = _mm256_permute4x64_epi64(_mm256_unpackhi_epi8(r, g), 0xD8);
+		uint8* blockOutput = output + b * 8;
+		_mm_storeu_si128((__m128i*)(blockOutput + 0 * outputPitch), _mm256_castsi256_si128(rows01));
+		_mm_storeu_si128((__m128i*)(blockOutput + 1 * outputPitch), _mm256_extracti128_si256(rows01, 1));
+		_mm_storeu_si128((__m128i*)(blockOutput + 2 * outputPitch), _mm256_castsi256_si128(rows23));
+		_mm_storeu_si128((__m128i*)(blockOutput + 3 * outputPitch), _mm256_extracti128_si256(rows23, 1));
+	}
+	_decodeBC5Blocks_scalar<isSigned>(blockPtrs + b, blockCount - b, output + b * 8, outputPitch);
+}
+#endif
+
+#if defined(__aarch64__)
+// NEON variants, structured like the SSE4.1 ones
+
+static uint32x4_t _BCExpand565_NEON(uint32x4_t c)
+{
+	uint32x4_t r = vandq_u32(vshrq_n_u32(c, 11), vdupq_n_u32(0x1F));
+	uint32x4_t g = vandq_u32(vshrq_n_u32(c, 5), vdupq_n_u32(0x3F));
+	uint32x4_t b = vandq_u32(c, vdupq_n_u32(0x1F));
+	r = vorrq_u32(vshlq_n_u32(r, 3), vshrq_n_u32(r, 2));
+	g = vorrq_u32(vshlq_n_u32(g, 2), vshrq_n_u32(g, 4));
+	b = vorrq_u32(vshlq_n_u32(b, 3), vshrq_n_u32(b, 2));
+	uint32x4_t rgba = vorrq_u32(r, vshlq_n_u32(g, 8));
+	rgba = vorrq_u32(rgba, vshlq_n_u32(b, 16));
+	return vorrq_u32(rgba, vdupq_n_u32(0xFF000000));
+}
+
+// (x * m) >> 16
+static uint16x8_t _BCMulHi_NEON(uint16x8_t x, uint16 m)
+{
+	uint16x4_t m4 = vdup_n_u16(m);
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x), m4), 16), vshrn_n_u32(vmull_high_u16(x, vdupq_n_u16(m)), 16));
+}
+
+static uint8x16_t _BCInterpolateThird_NEON(uint8x16_t a, uint8x16_t b)
+{
+	uint16x8_t lo = vaddq_u16(vaddq_u16(vshll_n_u8(vget_low_u8(a), 1), vmovl_u8(vget_low_u8(b))), vdupq_n_u16(1));
+	uint16x8_t hi = vaddq_u16(vaddq_u16(vshll_n_u8(vget_high_u8(a), 1), vmovl_u8(vget_high_u8(b))), vdupq_n_u16(1));
+	lo = vshrq_n_u16(_BCMulHi_NEON(lo, BC_RECIPROCAL_3), 1);
+	hi = vshrq_n_u16(_BCMulHi_NEON(hi, BC_RECIPROCAL_3), 1);
+	return vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+}
+
+template<bool isSigned>
+static uint8x16_t _BCDecodeChannel_NEON(const uint8* blockData)
+{
+	uint8x16_t block = vcombine_u8(vld1_u8(blockData), vdup_n_u8(0));
+	uint16 keyA = isSigned ? (blockData[0] ^ 0x80) : blockData[0];
+	uint16 keyB = isSigned ? (blockData[1] ^ 0x80) : blockData[1];
+	uint16x8_t a = vdupq_n_u16(isSigned ? std::max<uint16>(keyA, 1) - 1 : keyA);
+	uint16x8_t b = vdupq_n_u16(isSigned ? std::max<uint16>(keyB, 1) - 1 : keyB);
+	uint16x8_t palette16;
+	if (keyA > keyB)
+	{
+		uint16x8_t p7 = vmlaq_u16(vmulq_u16(a, vld1q_u16(s_bcChannelWeights7[0])), b, vld1q_u16(s_bcChannelWeights7[1]));
+		palette16 = _BCMulHi_NEON(vaddq_u16(p7, vdupq_n_u16(3)), BC_RECIPROCAL_7);
+	}
+	else
+	{
+		uint16x8_t p5 = vmlaq_u16(vmulq_u16(a, vld1q_u16(s_bcChannelWeights5[0])), b, vld1q_u16(s_bcChannelWeights5[1]));
+		palette16 = _BCMulHi_NEON(vaddq_u16(p5, vdupq_n_u16(2)), BC_RECIPROCAL_5);
+		palette16 = vsetq_lane_u16(0, palette16, 6);
+		palette16 = vsetq_lane_u16(isSigned ? 254 : 255, palette16, 7);
+	}
+	uint8x8_t palette = vmovn_u16(palette16);
+	if constexpr (isSigned)
+		palette = vadd_u8(palette, vdup_n_u8(0x81));
+	const uint16x8_t multiplier = vld1q_u16(s_bcChannelIndexMultiplier);
+	uint16x8_t indicesLo = vreinterpretq_u16_u8(vqtbl1q_u8(block, vld1q_u8(s_bcChannelIndexGather[0])));
+	uint16x8_t indicesHi = vreinterpretq_u16_u8(vqtbl1q_u8(block, vld1q_u8(s_bcChannelIndexGather[1])));
+	indicesLo = vshrq_n_u16(vmulq_u16(indicesLo, multiplier), 13);
+	indicesHi = vshrq_n_u16(vmulq_u16(indicesHi, multiplier), 13);
+	return vqtbl1q_u8(vcombine_u8(palette, palette), vcombine_u8(vmovn_u16(indicesLo), vmovn_u16(indicesHi)));
+}
+
+template<BCAlphaMode alphaMode>
+static uint8x16_t _BCDecodeAlpha_NEON(const uint8* blockData)
+{
+	if constexpr (alphaMode == BCAlphaMode::EXPLICIT)
+	{
+		uint8x8_t block = vld1_u8(blockData);
+		uint8x8_t lo = vand_u8(block, vdup_n_u8(0x0F));
+		uint8x8_t hi = vshr_n_u8(block, 4);
+		uint8x16_t alpha = vcombine_u8(vzip1_u8(lo, hi), vzip2_u8(lo, hi));
+		return vmulq_u8(alpha, vdupq_n_u8(0x11));
+	}
+	else
+		return _BCDecodeChannel_NEON<false>(blockData);
+}
+
+static void _BCTranspose4x4_NEON(uint32x4_t& v0, uint32x4_t& v1, uint32x4_t& v2, uint32x4_t& v3)
+{
+	uint64x2_t t0 = vreinterpretq_u64_u32(vzip1q_u32(v0, v1));
+	uint64x2_t t1 = vreinterpretq_u64_u32(vzip1q_u32(v2, v3));
+	uint64x2_t t2 = vreinterpretq_u64_u32(vzip2q_u32(v0, v1));
+	uint64x2_t t3 = vreinterpretq_u64_u32(vzip2q_u32(v2, v3));
+	v0 = vreinterpretq_u32_u64(vzip1q_u64(t0, t1));
+	v1 = vreinterpretq_u32_u64(vzip2q_u64(t0, t1));
+	v2 = vreinterpretq_u32_u64(vzip1q_u64(t2, t3));
+	v3 = vreinterpretq_u32_u64(vzip2q_u64(t2, t3));
+}
+
+template<uint32 colorOffset, bool allowPunchThrough, BCAlphaMode alphaMode>
+static void _decodeBCColorBlocks_NEON(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 4) <= blockCount; b += 4)
+	{
+		const uint8* blocks[4] = { blockPtrs[b + 0], blockPtrs[b + 1], blockPtrs[b + 2], blockPtrs[b + 3] };
+		uint32 endpointsArray[4];
+		for (sint32 i = 0; i < 4; i++)
+			endpointsArray[i] = *(uint32*)(blocks[i] + colorOffset);
+		uint32x4_t endpoints = vld1q_u32(endpointsArray);
+		uint32x4_t c0 = vandq_u32(endpoints, vdupq_n_u32(0xFFFF));
+		uint32x4_t c1 = vshrq_n_u32(endpoints, 16);
+		uint8x16_t e0 = vreinterpretq_u8_u32(_BCExpand565_NEON(c0));
+		uint8x16_t e1 = vreinterpretq_u8_u32(_BCExpand565_NEON(c1));
+		uint8x16_t p2 = _BCInterpolateThird_NEON(e0, e1);
+		uint8x16_t p3 = _BCInterpolateThird_NEON(e1, e0);
+		if constexpr (allowPunchThrough)
+		{
+			uint8x16_t fourColorMode = vreinterpretq_u8_u32(vcgtq_u32(c0, c1));
+			p2 = vbslq_u8(fourColorMode, p2, vrhaddq_u8(e0, e1));
+			p3 = vandq_u8(p3, fourColorMode);
+		}
+		uint32x4_t palettes[4] = { vreinterpretq_u32_u8(e0), vreinterpretq_u32_u8(e1), vreinterpretq_u32_u8(p2), vreinterpretq_u32_u8(p3) };
+		_BCTranspose4x4_NEON(palettes[0], palettes[1], palettes[2], palettes[3]);
+		for (sint32 i = 0; i < 4; i++)
+		{
+			uint32 colorIndices = *(uint32*)(blocks[i] + colorOffset + 4);
+			uint8x16_t palette = vreinterpretq_u8_u32(palettes[i]);
+			uint8x16_t alpha;
+			if constexpr (alphaMode != BCAlphaMode::NONE)
+				alpha = _BCDecodeAlpha_NEON<alphaMode>(blocks[i]);
+			uint8* blockOutput = output + (b + i) * 16;
+			for (sint32 py = 0; py < 4; py++)
+			{
+				uint8x16_t row = vqtbl1q_u8(palette, vld1q_u8(s_bcColorRowShuffle.mask[(colorIndices >> (py * 8)) & 0xFF]));
+				if constexpr (alphaMode != BCAlphaMode::NONE)
+					row = vorrq_u8(vandq_u8(row, vreinterpretq_u8_u32(vdupq_n_u32(0x00FFFFFF))), vqtbl1q_u8(alpha, vld1q_u8(s_bcAlphaRowShuffle[py])));
+				vst1q_u8(blockOutput + py * outputPitch, row);
+			}
+		}
+	}
+	_decodeBCColorBlocks_scalar<colorOffset, allowPunchThrough, alphaMode>(blockPtrs + b, blockCount - b, output + b * 16, outputPitch);
+}
+
+template<bool isSigned>
+static void _decodeBC4Blocks_NEON(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 4) <= blockCount; b += 4)
+	{
+		uint32x4_t r0 = vreinterpretq_u32_u8(_BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 0]));
+		uint32x4_t r1 = vreinterpretq_u32_u8(_BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 1]));
+		uint32x4_t r2 = vreinterpretq_u32_u8(_BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 2]));
+		uint32x4_t r3 = vreinterpretq_u32_u8(_BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 3]));
+		_BCTranspose4x4_NEON(r0, r1, r2, r3);
+		uint8* blockOutput = output + b * 4;
+		vst1q_u32((uint32*)(blockOutput + 0 * outputPitch), r0);
+		vst1q_u32((uint32*)(blockOutput + 1 * outputPitch), r1);
+		vst1q_u32((uint32*)(blockOutput + 2 * outputPitch), r2);
+		vst1q_u32((uint32*)(blockOutput + 3 * outputPitch), r3);
+	}
+	_decodeBC4Blocks_scalar<isSigned>(blockPtrs + b, blockCount - b, output + b * 4, outputPitch);
+}
+
+template<bool isSigned>
+static void _decodeBC5Blocks_NEON(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	sint32 b = 0;
+	for (; (b + 2) <= blockCount; b += 2)
+	{
+		uint8x16_t r0 = _BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 0] + 0);
+		uint8x16_t g0 = _BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 0] + 8);
+		uint8x16_t r1 = _BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 1] + 0);
+		uint8x16_t g1 = _BCDecodeChannel_NEON<isSigned>(blockPtrs[b + 1] + 8);
+		uint64x2_t rg0A = vreinterpretq_u64_u8(vzip1q_u8(r0, g0));
+		uint64x2_t rg0B = vreinterpretq_u64_u8(vzip2q_u8(r0, g0));
+		uint64x2_t rg1A = vreinterpretq_u64_u8(vzip1q_u8(r1, g1));
+		uint64x2_t rg1B = vreinterpretq_u64_u8(vzip2q_u8(r1, g1));
+		uint8* blockOutput = output + b * 8;
+		vst1q_u64((uint64*)(blockOutput + 0 * outputPitch), vzip1q_u64(rg0A, rg1A));
+		vst1q_u64((uint64*)(blockOutput + 1 * outputPitch), vzip2q_u64(rg0A, rg1A));
+		vst1q_u64((uint64*)(blockOutput + 2 * outputPitch), vzip1q_u64(rg0B, rg1B));
+		vst1q_u64((uint64*)(blockOutput + 3 * outputPitch), vzip2q_u64(rg0B, rg1B));
+	}
+	_decodeBC5Blocks_scalar<isSigned>(blockPtrs + b, blockCount - b, output + b * 8, outputPitch);
+}
+#endif
+
+// pick the fastest available implementation
+template<uint32 colorOffset, bool allowPunchThrough, BCAlphaMode alphaMode>
+static void _decodeBCColorBlocks(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx2)
+		_decodeBCColorBlocks_AVX2<colorOffset, allowPunchThrough, alphaMode>(blockPtrs, blockCount, output, outputPitch);
+	else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+		_decodeBCColorBlocks_SSE41<colorOffset, allowPunchThrough, alphaMode>(blockPtrs, blockCount, output, outputPitch);
+	else
+		_decodeBCColorBlocks_scalar<colorOffset, allowPunchThrough, alphaMode>(blockPtrs, blockCount, output, outputPitch);
+#elif defined(__aarch64__)
+	_decodeBCColorBlocks_NEON<colorOffset, allowPunchThrough, alphaMode>(blockPtrs, blockCount, output, outputPitch);
+#else
+	_decodeBCColorBlocks_scalar<colorOffset, allowPunchThrough, alphaMode>(blockPtrs, blockCount, output, outputPitch);
+#endif
+}
+
+template<bool isSigned>
+static void _decodeBC4Blocks(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx2)
+		_decodeBC4Blocks_AVX2<isSigned>(blockPtrs, blockCount, output, outputPitch);
+	else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+		_decodeBC4Blocks_SSE41<isSigned>(blockPtrs, blockCount, output, outputPitch);
+	else
+		_decodeBC4Blocks_scalar<isSigned>(blockPtrs, blockCount, output, outputPitch);
+#elif defined(__aarch64__)
+	_decodeBC4Blocks_NEON<isSigned>(blockPtrs, blockCount, output, outputPitch);
+#else
+	_decodeBC4Blocks_scalar<isSigned>(blockPtrs, blockCount, output, outputPitch);
+#endif
+}
+
+template<bool isSigned>
+static void _decodeBC5Blocks(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx2)
+		_decodeBC5Blocks_AVX2<isSigned>(blockPtrs, blockCount, output, outputPitch);
+	else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+		_decodeBC5Blocks_SSE41<isSigned>(blockPtrs, blockCount, output, outputPitch);
+	else
+		_decodeBC5Blocks_scalar<isSigned>(blockPtrs, blockCount, output, outputPitch);
+#elif defined(__aarch64__)
+	_decodeBC5Blocks_NEON<isSigned>(blockPtrs, blockCount, output, outputPitch);
+#else
+	_decodeBC5Blocks_scalar<isSigned>(blockPtrs, blockCount, output, outputPitch);
+#endif
+}
+
+void decodeBC1Blocks_RGBA8(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBCColorBlocks<0, true, BCAlphaMode::NONE>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void decodeBC2Blocks_RGBA8(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBCColorBlocks<8, false, BCAlphaMode::EXPLICIT>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void decodeBC3Blocks_RGBA8(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBCColorBlocks<8, false, BCAlphaMode::INTERPOLATED>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void decodeBC4Blocks_R8_UNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBC4Blocks<false>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void decodeBC4Blocks_R8_SNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBC4Blocks<true>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void decodeBC5Blocks_RG8_UNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBC5Blocks<false>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void decodeBC5Blocks_RG8_SNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch)
+{
+	_decodeBC5Blocks<true>(blockPtrs, blockCount, output, outputPitch);
+}
+
+void LatteTextureLoader_decodeBCUncompressed(LatteTextureLoaderCtx* textureLoader, uint8* outputData, sint32 bytesPerTexel, BCBlocksDecodeFunc decodeBlocks)
+{
+	const sint32 width = textureLoader->width;
+	const sint32 height = textureLoader->height;
+	const sint32 outputPitch = width * bytesPerTexel;
+	const sint32 blockCountX = (width + 3) / 4;
+	AddrLibFastDecode_forEachRowBand(height, 4, (uint64)outputPitch * height, [&](sint32 rowBegin, sint32 rowEnd)
+	{
+		constexpr sint32 BATCH_SIZE = 32; // blocks per decoder call
+		uint8* blockPtrs[BATCH_SIZE];
+		uint8 partialOutput[4 * BATCH_SIZE * 4 * 4]; // for batches that extend past the image edge
+		for (sint32 y = rowBegin; y < rowEnd; y += 4)
+		{
+			const sint32 rowCount = std::min(4, height - y);
+			for (sint32 bx = 0; bx < blockCountX; bx += BATCH_SIZE)
+			{
+				const sint32 blockCount = std::min(BATCH_SIZE, blockCountX - bx);
+				for (sint32 i = 0; i < blockCount; i++)
+					blockPtrs[i] = LatteTextureLoader_GetInput(textureLoader, (bx + i) * 4, y);
+				const sint32 texelCountX = std::min(blockCount * 4, width - bx * 4);
+				uint8* batchOutput = outputData + (y * width + bx * 4) * bytesPerTexel;
+				if (rowCount == 4 && texelCountX == blockCount * 4)
+				{
+					decodeBlocks(blockPtrs, blockCount, batchOutput, outputPitch);
+					continue;
+				}
+				const sint32 partialPitch = blockCount * 4 * bytesPerTexel;
+				decodeBlocks(blockPtrs, blockCount, partialOutput, partialPitch);
+				for (sint32 py = 0; py < rowCount; py++)
+					memcpy(batchOutput + py * outputPitch, partialOutput + py * partialPitch, texelCountX * bytesPerTexel);
+			}
+		}
+	});
+}
@@ -35,10 +35,14 @@ void LatteTexture_setEffectiveTextureScale(LatteConst::ShaderType shaderType, si
 }
 
 void LatteTextureLoader_UpdateTextureSliceData(LatteTexture* tex, uint32 sliceIndex, uint32 mipIndex, MPTR physImagePtr, MPTR physMipPtr, Latte::E_DIM dim, uint32 width, uint32 height, uint32 depth, uint32 mipLevels, uint32 pitch, Latte::E_HWTILEMODE tileMode, uint32 swizzle, bool dumpTex);
+void LatteTextureLoader_BeginSliceUploadBatch();
+void LatteTextureLoader_EndSliceUploadBatch();
 
 void LatteTexture_ReloadData(LatteTexture* tex)
 {
 	tex->reloadCount++;
+	// all slices and mips are decoded in parallel and uploaded together
+	LatteTextureLoader_BeginSliceUploadBatch();
 	for(sint32 mip=0; mip<tex->mipLevels; mip++)
 	{
 		if(tex->dim == Latte::E_DIM::DIM_2D_ARRAY ||
@@ -69,6 +73,7 @@ void LatteTexture_ReloadData(LatteTexture* tex)
 			LatteTextureLoader_UpdateTextureSliceData(tex, 0, mip, tex->physAddress, tex->physMipAddress, tex->dim, tex->width, tex->height, tex->depth, tex->mipLevels, tex->pitch, tex->tileMode, tex->swizzle, true);
 		}
 	}
+	LatteTextureLoader_EndSliceUploadBatch();
 	tex->lastUpdateEventCounter = LatteTexture_getNextUpdateEventCounter();
 }
 
@@ -6,7 +6,9 @@
 //#define BENCHMARK_TEXTURE_DECODING		// if defined, time it takes to decode textures will be measured and logged to log.txt
 
 #ifdef BENCHMARK_TEXTURE_DECODING
+#include "util/highresolutiontimer/HighResolutionTimer.h"
 uint64 textureDecodeBenchmark_perFormatSum[0x40] = { 0 }; // duration sum per texture format (hw format) - in microseconds
+uint64 textureDecodeBenchmark_perFormatBytes[0x40] = { 0 }; // sum of decoded bytes per texture format
 uint64 textureDecodeBenchmark_totalSum = 0;
 #endif
 
@@ -569,24 +571,26 @@ void decodeBC5Block_SNORM(uint8* blockStorage, float* rgOutput) // todo - can me
 	}
 }
 
-void LatteTextureLoader_loadTextureDataIntoSlice(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, sint32 mipLevels, void* pixelData, sint32 sliceIndex, sint32 mipIndex, uint32 compressedImageSize)
+// slice uploads of a texture reload are decoded in parallel on the thread pool, directly into the upload memory provided by the renderer
+// all slices of the batch are transferred together once it ends
+static struct
 {
-	if (mipIndex == 0)
-	{
-		cemu_assert_debug(width == hostTexture->width);
-		cemu_assert_debug(height == hostTexture->height);
-		cemu_assert_debug(depth == hostTexture->depth);
-	}
-	cemu_assert_debug(mipLevels == hostTexture->mipLevels);
-	if (hostTexture->overwriteInfo.hasResolutionOverwrite || hostTexture->overwriteInfo.hasFormatOverwrite)
-	{
-		// todo - ideally, we should scale/convert the data to the new format and resolution
-		g_renderer->texture_clearSlice(hostTexture, sliceIndex, mipIndex);
-	}
-	else
-	{
-		g_renderer->texture_loadSlice(hostTexture, width, height, depth, pixelData, sliceIndex, mipIndex, compressedImageSize);
-	}
+	bool isActive{false};
+	ThreadPool::TaskGroup decodeTasks;
+}s_sliceUploadBatch;
+
+void LatteTextureLoader_BeginSliceUploadBatch()
+{
+	cemu_assert_debug(!s_sliceUploadBatch.isActive);
+	s_sliceUploadBatch.isActive = true;
+}
+
+void LatteTextureLoader_EndSliceUploadBatch()
+{
+	cemu_assert_debug(s_sliceUploadBatch.isActive);
+	s_sliceUploadBatch.decodeTasks.Wait();
+	g_renderer->texture_submitSliceUploads();
+	s_sliceUploadBatch.isActive = false;
 }
 
 void LatteTextureLoader_UpdateTextureSliceData(LatteTexture* tex, uint32 sliceIndex, uint32 mipIndex, MPTR physImagePtr, MPTR physMipPtr, Latte::E_DIM dim, uint32 width, uint32 height, uint32 depth, uint32 mipLevels, uint32 pitch, Latte::E_HWTILEMODE tileMode, uint32 swizzle, bool dumpTex)
@@ -630,29 +634,66 @@ void LatteTextureLoader_UpdateTextureSliceData(LatteTexture* tex, uint32 sliceIn
 	textureLoader.decodedTexelCountX = texDecoder->getTexelCountX(&textureLoader);
 	textureLoader.decodedTexelCountY = texDecoder->getTexelCountY(&textureLoader);
 
-	// allocate memory for decoded texture
 	uint32 imageSize = texDecoder->calculateImageSize(&textureLoader);
 
-	uint8* pixelData = (uint8*)g_renderer->texture_acquireTextureUploadBuffer(imageSize);
-	// decode texture (if data is required)
-#ifdef BENCHMARK_TEXTURE_DECODING
-	LARGE_INTEGER benchmark_begin;
-	LARGE_INTEGER benchmark_end;
-	LARGE_INTEGER benchmark_freq;
-	QueryPerformanceCounter(&benchmark_begin);
-#endif
-	if (tex->overwriteInfo.hasFormatOverwrite == false && tex->overwriteInfo.hasResolutionOverwrite == false)
+	// update texture data offsets and hashes
+	// this has to be done before the texture data is decoded & uploaded to prevent a race condition where updates during upload are missed
+	if (mipIndex == 0 || (tex->texDataPtrLow == 0 && tex->texDataPtrHigh == 0))
+	{
+		tex->texDataPtrLow = physImagePtr + textureLoader.minOffsetOutdated; // always zero
+		tex->texDataPtrHigh = physImagePtr + textureLoader.maxOffsetOutdated; // currently set to surface size
+		LatteTC_ResetTextureChangeTracker(tex, true);
+	}
+
+	// load slice
+	//debug_printf("[Load Slice] Addr: %08x MIP: %02d Slice: %02d Res %04x/%04x Texel Res %04x/%04x Fmt %04x Tm %d\n", textureLoader.physAddress, mipIndex, sliceIndex, textureLoader.width, textureLoader.height, textureLoader.texelCountX, textureLoader.texelCountY, (int)format, tileMode);
+	if (mipIndex == 0)
 	{
-		texDecoder->decode(&textureLoader, pixelData);
+		cemu_assert_debug(textureLoader.width == tex->width);
+		cemu_assert_debug(textureLoader.height == tex->height);
+		cemu_assert_debug(depth == tex->depth);
 	}
+	cemu_assert_debug(mipLevels == tex->mipLevels);
+	if (tex->overwriteInfo.hasResolutionOverwrite || tex->overwriteInfo.hasFormatOverwrite)
+	{
+		// todo - ideally, we should scale/convert the data to the new format and resolution
+		g_renderer->texture_clearSlice(tex, sliceIndex, mipIndex);
+	}
+	else
+	{
+		uint8* pixelData = g_renderer->texture_reserveSliceUpload(tex, textureLoader.width, textureLoader.height, depth, sliceIndex, mipIndex, imageSize);
+#ifndef BENCHMARK_TEXTURE_DECODING
+		if (s_sliceUploadBatch.isActive)
+		{
+			// the task owns a copy of the loader context
+			LatteTextureLoaderCtx* decodeCtx = new LatteTextureLoaderCtx(textureLoader);
+			s_sliceUploadBatch.decodeTasks.Run([texDecoder, decodeCtx, pixelData]()
+			{
+				texDecoder->decode(decodeCtx, pixelData);
+				delete decodeCtx;
+			}, ThreadPool::Priority::High);
+		}
+		else
+#endif
+		{
 #ifdef BENCHMARK_TEXTURE_DECODING
-	QueryPerformanceCounter(&benchmark_end);
-	QueryPerformanceFrequency(&benchmark_freq);
-	uint64 benchmarkResultMicroSeconds = (benchmark_end.QuadPart - benchmark_begin.QuadPart) * 1000000ULL / benchmark_freq.QuadPart;
-	textureDecodeBenchmark_perFormatSum[(int)tex->format & 0x3F] += benchmarkResultMicroSeconds;
-	textureDecodeBenchmark_totalSum += benchmarkResultMicroSeconds;
-	cemuLog_log(LogType::Force, "TexDecode {:04}x{:04}x{:04} Fmt {:04x} Dim {} TileMode {:02x} Took {:03}.{:03}ms Sum(format) {:06}ms Sum(total) {:06}ms", textureLoader.width, textureLoader.height, textureLoader.surfaceInfoDepth, (int)tex->format, (int)tex->dim, textureLoader.tileMode, (uint32)(benchmarkResultMicroSeconds / 1000ULL), (uint32)(benchmarkResultMicroSeconds % 1000ULL), (uint32)(textureDecodeBenchmark_perFormatSum[tex->gx2Format & 0x3F] / 1000ULL), (uint32)(textureDecodeBenchmark_totalSum / 1000ULL));
+			HRTick benchmarkBegin = HighResolutionTimer::now().getTick();
 #endif
+			texDecoder->decode(&textureLoader, pixelData);
+#ifdef BENCHMARK_TEXTURE_DECODING
+			uint64 benchmarkResultMicroSeconds = HighResolutionTimer::ticksToMicroseconds(HighResolutionTimer::now().getTick() - benchmarkBegin);
+			const uint32 benchmarkFormatIndex = (uint32)tex->format & 0x3F;
+			textureDecodeBenchmark_perFormatSum[benchmarkFormatIndex] += benchmarkResultMicroSeconds;
+			textureDecodeBenchmark_perFormatBytes[benchmarkFormatIndex] += imageSize;
+			textureDecodeBenchmark_totalSum += benchmarkResultMicroSeconds;
+			// throughput in MB/s of decoded output, averaged over all textures of this format
+			uint64 formatThroughput = textureDecodeBenchmark_perFormatBytes[benchmarkFormatIndex] / std::max<uint64>(textureDecodeBenchmark_perFormatSum[benchmarkFormatIndex], 1);
+			cemuLog_log(LogType::Force, "TexDecode {:04}x{:04}x{:04} Fmt {:04x} Dim {} TileMode {:02x} Took {:03}.{:03}ms Sum(format) {:06}ms {:05}MB/s Sum(total) {:06}ms", textureLoader.width, textureLoader.height, textureLoader.surfaceInfoDepth, (int)tex->format, (int)tex->dim, textureLoader.tileMode, (uint32)(benchmarkResultMicroSeconds / 1000ULL), (uint32)(benchmarkResultMicroSeconds % 1000ULL), (uint32)(textureDecodeBenchmark_perFormatSum[benchmarkFormatIndex] / 1000ULL), formatThroughput, (uint32)(textureDecodeBenchmark_totalSum / 1000ULL));
+#endif
+		}
+		if (!s_sliceUploadBatch.isActive)
+			g_renderer->texture_submitSliceUploads();
+	}
 
 	// convert texture to RGBA when dumping is enabled
 	if (textureLoader.dump)
@@ -668,29 +709,11 @@ void LatteTextureLoader_UpdateTextureSliceData(LatteTexture* tex, uint32 sliceIn
 				pixelOutput += 4;
 			}
 		}
-	}
-
-	// update texture data offsets and hashes
-	// this has to be done before the texture data is decoded & uploaded to prevent a race condition where updates during upload are missed
-	if (mipIndex == 0 || (tex->texDataPtrLow == 0 && tex->texDataPtrHigh == 0))
-	{
-		tex->texDataPtrLow = physImagePtr + textureLoader.minOffsetOutdated; // always zero
-		tex->texDataPtrHigh = physImagePtr + textureLoader.maxOffsetOutdated; // currently set to surface size
-		LatteTC_ResetTextureChangeTracker(tex, true);
-	}
-	// load slice
-	//debug_printf("[Load Slice] Addr: %08x MIP: %02d Slice: %02d Res %04x/%04x Texel Res %04x/%04x Fmt %04x Tm %d\n", textureLoader.physAddress, mipIndex, sliceIndex, textureLoader.width, textureLoader.height, textureLoader.texelCountX, textureLoader.texelCountY, (int)format, tileMode);
-	LatteTextureLoader_loadTextureDataIntoSlice(tex, textureLoader.width, textureLoader.height, depth, mipLevels, pixelData, sliceIndex, mipIndex, imageSize);
-	// write texture dump
-	if (textureLoader.dump)
-	{
 		fs::path path = ActiveSettings::GetUserDataPath("dump/textures");
 		path /= fmt::format("{:08x}_fmt{:04x}_slice{:d}_mip{:02d}_{:d}x{:d}_tm{:02d}.tga", physImagePtr, (uint32)tex->format, sliceIndex, mipIndex, tex->width, tex->height, tileMode);
 		tga_write_rgba(path, textureLoader.width, textureLoader.height, textureLoader.dumpRGBA);
 		free(textureLoader.dumpRGBA);
 	}
-	// clean up
-	g_renderer->texture_releaseTextureUploadBuffer(pixelData);
 	catchOpenGLError();
 }
 
@@ -47,6 +47,20 @@ void decodeBC4Block_UNORM(uint8* blockStorage, float* rOutput);
 void decodeBC5Block_UNORM(uint8* blockStorage, float* rgOutput);
 void decodeBC5Block_SNORM(uint8* blockStorage, float* rgOutput);
 
+// integer decoders, see LatteTextureDecodeBC.cpp
+// decode a horizontal run of 4x4 blocks into four rows of texels. blockPtrs holds the address of each block, outputPitch is the distance between texel rows in bytes
+using BCBlocksDecodeFunc = void(*)(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC1Blocks_RGBA8(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC2Blocks_RGBA8(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC3Blocks_RGBA8(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC4Blocks_R8_UNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC4Blocks_R8_SNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC5Blocks_RG8_UNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+void decodeBC5Blocks_RG8_SNORM(uint8* const* blockPtrs, sint32 blockCount, uint8* output, sint32 outputPitch);
+
+// decodes the whole slice into a linear uncompressed image
+void LatteTextureLoader_decodeBCUncompressed(LatteTextureLoaderCtx* textureLoader, uint8* outputData, sint32 bytesPerTexel, BCBlocksDecodeFunc decodeBlocks);
+
 inline void BC1_GetPixel(uint8* inputData, sint32 x, sint32 y, uint8 rgba[4])
 {
 	// read colors
@@ -1603,39 +1617,12 @@ class TextureDecoder_BC1_UNORM_uncompress_generic : public TextureDecoder
 public:
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 4 * 4;
+		return 4;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rgbaBlock[4 * 4 * 4];
-				decodeBC1Block(blockData, rgbaBlock);
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 16; // write to target buffer
-						float red = rgbaBlock[(px + py * 4) * 4 + 0];
-						float green = rgbaBlock[(px + py * 4) * 4 + 1];
-						float blue = rgbaBlock[(px + py * 4) * 4 + 2];
-						float alpha = rgbaBlock[(px + py * 4) * 4 + 3];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = green;
-						*(float*)(outputData + pixelOffset + 8) = blue;
-						*(float*)(outputData + pixelOffset + 12) = alpha;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 4, decodeBC1Blocks_RGBA8);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
@@ -1729,39 +1716,12 @@ public:
 
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 4 * 4;
+		return 4;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rgbaBlock[4 * 4 * 4];
-				decodeBC2Block_UNORM(blockData, rgbaBlock);
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 16; // write to target buffer
-						float red = rgbaBlock[(px + py * 4) * 4 + 0];
-						float green = rgbaBlock[(px + py * 4) * 4 + 1];
-						float blue = rgbaBlock[(px + py * 4) * 4 + 2];
-						float alpha = rgbaBlock[(px + py * 4) * 4 + 3];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = green;
-						*(float*)(outputData + pixelOffset + 8) = blue;
-						*(float*)(outputData + pixelOffset + 12) = alpha;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 4, decodeBC2Blocks_RGBA8);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
@@ -1785,40 +1745,12 @@ public:
 
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 4 * 4;
+		return 4;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		// todo - apply srgb conversion
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rgbaBlock[4 * 4 * 4];
-				decodeBC2Block_UNORM(blockData, rgbaBlock);
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 16; // write to target buffer
-						float red = rgbaBlock[(px + py * 4) * 4 + 0];
-						float green = rgbaBlock[(px + py * 4) * 4 + 1];
-						float blue = rgbaBlock[(px + py * 4) * 4 + 2];
-						float alpha = rgbaBlock[(px + py * 4) * 4 + 3];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = green;
-						*(float*)(outputData + pixelOffset + 8) = blue;
-						*(float*)(outputData + pixelOffset + 12) = alpha;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 4, decodeBC2Blocks_RGBA8);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
@@ -1843,39 +1775,12 @@ public:
 
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 4 * 4;
+		return 4;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rgbaBlock[4 * 4 * 4];
-				decodeBC3Block_UNORM(blockData, rgbaBlock);
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 16; // write to target buffer
-						float red = rgbaBlock[(px + py * 4) * 4 + 0];
-						float green = rgbaBlock[(px + py * 4) * 4 + 1];
-						float blue = rgbaBlock[(px + py * 4) * 4 + 2];
-						float alpha = rgbaBlock[(px + py * 4) * 4 + 3];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = green;
-						*(float*)(outputData + pixelOffset + 8) = blue;
-						*(float*)(outputData + pixelOffset + 12) = alpha;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 4, decodeBC3Blocks_RGBA8);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
@@ -1948,35 +1853,12 @@ public:
 
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 2 * 4;
+		return 1;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rBlock[4 * 4 * 1];
-				decodeBC4Block_UNORM(blockData, rBlock);
-
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 8; // write to target buffer
-						float red = rBlock[(px + py * 4) * 1 + 0];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = 0.0f;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 1, decodeBC4Blocks_R8_UNORM);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
@@ -1991,6 +1873,31 @@ public:
 	}
 };
 
+class TextureDecoder_BC4_SNORM_uncompress : public TextureDecoder, public SingletonClass<TextureDecoder_BC4_SNORM_uncompress>
+{
+public:
+
+	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
+	{
+		return 1;
+	}
+
+	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
+	{
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 1, decodeBC4Blocks_R8_SNORM);
+	}
+
+	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
+	{
+		uint8 rBlock[4 * 4];
+		decodeBC4Blocks_R8_SNORM(&blockData, 1, rBlock, 4);
+		*(outputPixel + 0) = (uint8)((sint32)(sint8)rBlock[blockOffsetX + blockOffsetY * 4] + 128);
+		*(outputPixel + 1) = 0;
+		*(outputPixel + 2) = 0;
+		*(outputPixel + 3) = 255;
+	}
+};
+
 class TextureDecoder_BC4 : public TextureDecoder, public SingletonClass<TextureDecoder_BC4>
 {
 public:
@@ -2033,36 +1940,12 @@ public:
 
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 2 * 4;
+		return 2;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rgBlock[4 * 4 * 2];
-				decodeBC5Block_UNORM(blockData, rgBlock);
-
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 8; // write to target buffer
-						float red = rgBlock[(px + py * 4) * 2 + 0];
-						float green = rgBlock[(px + py * 4) * 2 + 1];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = green;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 2, decodeBC5Blocks_RG8_UNORM);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
@@ -2084,36 +1967,12 @@ public:
 
 	sint32 getBytesPerTexel(LatteTextureLoaderCtx* textureLoader) override
 	{
-		return 2 * 4;
+		return 2;
 	}
 
 	void decode(LatteTextureLoaderCtx* textureLoader, uint8* outputData) override
 	{
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
-		{
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
-			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				sint32 blockSizeX = (std::min)(4, textureLoader->width - x);
-				sint32 blockSizeY = (std::min)(4, textureLoader->height - y);
-				// decode 4x4 pixels at once
-				float rgBlock[4 * 4 * 2];
-				decodeBC5Block_SNORM(blockData, rgBlock);
-
-				for (sint32 py = 0; py < blockSizeY; py++)
-				{
-					sint32 yc = y + py;
-					for (sint32 px = 0; px < blockSizeX; px++)
-					{
-						sint32 pixelOffset = (x + px + yc * textureLoader->width) * 8; // write to target buffer
-						float red = rgBlock[(px + py * 4) * 2 + 0];
-						float green = rgBlock[(px + py * 4) * 2 + 1];
-						*(float*)(outputData + pixelOffset + 0) = red;
-						*(float*)(outputData + pixelOffset + 4) = green;
-					}
-				}
-			}
-		}
+		LatteTextureLoader_decodeBCUncompressed(textureLoader, outputData, 2, decodeBC5Blocks_RG8_SNORM);
 	}
 
 	void decodePixelToRGBA(uint8* blockData, uint8* outputPixel, uint8 blockOffsetX, uint8 blockOffsetY) override
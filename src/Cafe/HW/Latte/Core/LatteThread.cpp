@@ -9,8 +9,10 @@
 #include "WindowSystem.h"
 
 #include "Cafe/HW/Latte/Core/LatteBufferCache.h"
+#include "Cafe/HW/Latte/Core/LatteCommandPreDecoder.h"
 
 #include "Cafe/HW/Latte/Renderer/Renderer.h"
+#include "Cafe/HW/Latte/Core/LatteIndices.h"
 #include "Cafe/HW/Latte/Core/LatteTexture.h"
 #include "util/helpers/helpers.h"
 
@@ -33,6 +35,7 @@ void Latte_LoadInitialRegisters()
 	LatteGPUState.contextNew.VGT_DMA_NUM_INSTANCES.set_NUM_INSTANCES(1);
 	LatteGPUState.contextRegister[Latte::REGADDR::PA_CL_CLIP_CNTL] = 0;
 	*(float*)&LatteGPUState.contextRegister[mmDB_DEPTH_CLEAR] = 1.0f;
+	LatteGPUState.modifiedRegisterGroups = LATTE_REG_GROUP_ALL;
 }
 
 extern bool gx2WriteGatherInited;
@@ -248,10 +251,13 @@ bool Latte_GetStopSignal()
 
 void LatteThread_Exit()
 {
+	LatteCPDecoder_Stop();
 	if (g_renderer)
 		g_renderer->Shutdown();
     // clean up vertex/uniform cache
     LatteBufferCache_UnloadAll();
+	// release cached index data, the allocations live in the renderer's index heap
+	LatteIndices_invalidateAll();
 	// clean up texture cache
 	LatteTC_UnloadAllTextures();
 	// clean up runtime shader cache
@@ -1,11 +1,42 @@
 #pragma once
 #include "Cafe/HW/Latte/LatteAddrLib/LatteAddrLib.h"
+#include "util/ThreadPool/ThreadPool.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// surfaces with at least this many bytes of texel data are split into bands of macro tile rows which are processed in parallel
+#define ADDRLIB_PARALLEL_DECODE_MIN_SIZE	(1024 * 1024)
+
+// calls func(rowBegin, rowEnd) for all rows in [0, rowCount). Large surfaces are split into bands which run on the thread pool
+// bands are a multiple of rowAlignment rows. Every band writes a disjoint set of output rows and tiled addresses, so no synchronization is needed
+template<typename TFunc>
+void AddrLibFastDecode_forEachRowBand(sint32 rowCount, sint32 rowAlignment, uint64 totalSize, TFunc&& func)
+{
+	if (totalSize < ADDRLIB_PARALLEL_DECODE_MIN_SIZE || rowCount <= rowAlignment)
+	{
+		func(0, rowCount);
+		return;
+	}
+	// a few bands per worker so that threads which start late can still pick up work
+	sint32 rowsPerBand = rowCount / (sint32)(ThreadPool::GetWorkerCount() * 4);
+	rowsPerBand = std::max((rowsPerBand + rowAlignment - 1) / rowAlignment * rowAlignment, rowAlignment);
+	ThreadPool::TaskGroup taskGroup;
+	for (sint32 rowBegin = rowsPerBand; rowBegin < rowCount; rowBegin += rowsPerBand)
+	{
+		sint32 rowEnd = std::min(rowBegin + rowsPerBand, rowCount);
+		taskGroup.Run([&func, rowBegin, rowEnd]() { func(rowBegin, rowEnd); }, ThreadPool::Priority::High);
+	}
+	func(0, std::min(rowsPerBand, rowCount));
+	taskGroup.Wait();
+}
 
 template<typename texelBaseType, int texelBaseTypeCount, bool isEncodeDirection, bool isCompressed>
-void optimizedDecodeLoop_tm04_numSamples1_8x8(LatteTextureLoaderCtx* textureLoader, uint8* outputData, sint32 texelCountX, sint32 texelCountY)
+void optimizedDecodeLoop_tm04_numSamples1_8x8(LatteTextureLoaderCtx* textureLoader, uint8* outputData, sint32 texelCountX, sint32 texelRowBegin, sint32 texelRowEnd)
 {
 	uint16* tableBase = textureLoader->computeAddrInfo.microTilePixelIndexTable + ((textureLoader->computeAddrInfo.slice & 7) << 6);
-	for (sint32 yt = 0; yt < texelCountY; yt += 8)
+	for (sint32 yt = texelRowBegin; yt < texelRowEnd; yt += 8)
 	{
 		for (sint32 xt = 0; xt < texelCountX; xt += 8)
 		{
@@ -63,131 +94,104 @@ void optimizedDecodeLoop_tm04_numSamples1_8x8(LatteTextureLoaderCtx* textureLoad
 	}
 }
 
-template<typename texelBaseType, int texelBaseTypeCount, bool isEncodeDirection, bool isCompressed>
-void optimizedDecodeLoop_tm04_numSamples1_8x8_optimizedRowCopy(LatteTextureLoaderCtx* textureLoader, uint8* outputData, sint32 texelCountX, sint32 texelCountY)
+// layout of the rows of an 8x8 micro tile within the tiled data (2D_TILED_THIN1, single sample)
+// each row is split into chunks which are contiguous in the tiled data. For example with 32bpp non-depth tiles a row consists of two 16 byte chunks (x0-3 and x4-7) and the chunks of rows 2n and 2n+1 are interleaved
+// the offsets are relative to the address of the micro tile
+struct AddrLibMicroTileRowLayout
 {
-	uint16* tableBase = textureLoader->computeAddrInfo.microTilePixelIndexTable + ((textureLoader->computeAddrInfo.slice & 7) << 6);
-	for (sint32 yt = 0; yt < texelCountY; yt += 8)
+	uint32 chunkSize; // 8 or 16
+	uint32 chunksPerRow;
+	uint16 chunkOffset[8][8]; // [row][chunk]
+};
+
+// returns false if the rows of the micro tile are not made of contiguous runs of at least 8 bytes (e.g. 8bpp and 16bpp depth surfaces)
+template<uint32 bytesPerTexel>
+bool AddrLibFastDecode_getMicroTileRowLayout(LatteTextureLoaderCtx* textureLoader, AddrLibMicroTileRowLayout& layout)
+{
+	const uint16* tableBase = textureLoader->computeAddrInfo.microTilePixelIndexTable + ((textureLoader->computeAddrInfo.slice & 7) << 6);
+	auto getElementOffset = [tableBase](sint32 x, sint32 y) -> uint32
 	{
-		for (sint32 xt = 0; xt < texelCountX; xt += 8)
+		uint32 elemOffset = tableBase[x + y * 8] * bytesPerTexel;
+		// separate group bytes, same as in optimizedDecodeLoop_tm04_numSamples1_8x8
+		if ((bytesPerTexel * 8 * 8) > 256)
+			elemOffset = (elemOffset & 0xFF) | ((elemOffset & ~0xFF) << 3);
+		return elemOffset;
+	};
+	constexpr uint32 rowSize = bytesPerTexel * 8;
+	// use the largest chunk size for which all chunks are contiguous
+	for (uint32 chunkSize = std::min<uint32>(rowSize, 16); chunkSize >= 8; chunkSize >>= 1)
+	{
+		const sint32 texelsPerChunk = (sint32)(chunkSize / bytesPerTexel);
+		bool isContiguous = true;
+		for (sint32 y = 0; y < 8 && isContiguous; y++)
 		{
-			sint32 baseOffset = ComputeSurfaceAddrFromCoordMacroTiledCached_tm04_sample1(xt, yt, &textureLoader->computeAddrInfo); // this is only 10-20% of execution time
-			for (sint32 ry = 0; ry < 8; ry++)
+			for (sint32 x = 0; x < 8; x++)
 			{
-				sint32 pixelOffset = ((yt + ry)*textureLoader->decodedTexelCountX + (xt)) * (sizeof(texelBaseType)*texelBaseTypeCount);
-				texelBaseType* blockOutput = (texelBaseType*)(outputData + pixelOffset);
-
-				uint16* pixelOffsets = tableBase + (ry << 3);
-
-				uint32 pixelIndex = *pixelOffsets;
-				pixelOffsets++;
-				uint32 elemOffset = pixelIndex * sizeof(texelBaseType)*texelBaseTypeCount;
-				if ((sizeof(texelBaseType)*texelBaseTypeCount * 8 * 8) > 256)
+				sint32 chunkStartX = x - (x % texelsPerChunk);
+				if (getElementOffset(x, y) != getElementOffset(chunkStartX, y) + (uint32)(x - chunkStartX) * bytesPerTexel)
 				{
-					// separate group bytes, for small formats this step is not necessary since elemOffset is never over 0xFF (maximum is 8*8*bpp)
-					elemOffset = (elemOffset & 0xFF) | ((elemOffset&~0xFF) << 3);
+					isContiguous = false;
+					break;
 				}
+			}
+		}
+		if (!isContiguous)
+			continue;
+		layout.chunkSize = chunkSize;
+		layout.chunksPerRow = rowSize / chunkSize;
+		for (sint32 y = 0; y < 8; y++)
+		{
+			for (uint32 c = 0; c < layout.chunksPerRow; c++)
+				layout.chunkOffset[y][c] = (uint16)getElementOffset((sint32)(c * texelsPerChunk), y);
+		}
+		return true;
+	}
+	return false;
+}
 
-				sint32 offset = baseOffset + elemOffset;
-
-				texelBaseType* blockData = (texelBaseType*)(textureLoader->inputData + offset);
-				// x-to-offset translation table (for bpp = 64)
-				// 0	->	0
-				// 1	->	1
-				// 2	->	4
-				// 3	->	5
-				// 4	->	8
-				// 5	->	9
-				// 6	->	12
-				// 7	->	13
-
-				// x-to-offset translation table (for bpp = 32)
-				// 0	->	0
-				// 1	->	1
-				// 2	->	2
-				// 3	->	3
-				// 4	->	8
-				// 5	->	9
-				// 6	->	10
-				// 7	->	11
-
+template<uint32 chunkSize, bool isEncodeDirection>
+inline void AddrLibFastDecode_copyChunk(uint8* tiledData, uint8* linearData)
+{
+	uint8* src = isEncodeDirection ? linearData : tiledData;
+	uint8* dst = isEncodeDirection ? tiledData : linearData;
+	if constexpr (chunkSize == 16)
+	{
+#if defined(ARCH_X86_64)
+		_mm_storeu_si128((__m128i*)dst, _mm_loadu_si128((const __m128i*)src));
+#elif defined(__aarch64__)
+		vst1q_u8(dst, vld1q_u8(src));
+#else
+		memcpy(dst, src, 16);
+#endif
+	}
+	else
+	{
+		static_assert(chunkSize == 8);
+		uint64 v;
+		memcpy(&v, src, sizeof(uint64));
+		memcpy(dst, &v, sizeof(uint64));
+	}
+}
 
-				if ((sizeof(texelBaseType)*texelBaseTypeCount) == 8)
-				{
-					// bpp = 64
-					if (texelBaseTypeCount == 1)
-					{
-						if (isEncodeDirection)
-						{
-							blockData[0] = blockOutput[0];
-							blockData[1] = blockOutput[1];
-							blockData[4] = blockOutput[2];
-							blockData[5] = blockOutput[3];
-							blockData[8] = blockOutput[4];
-							blockData[9] = blockOutput[5];
-							blockData[12] = blockOutput[6];
-							blockData[13] = blockOutput[7];
-						}
-						else
-						{
-							blockOutput[0] = blockData[0];
-							blockOutput[1] = blockData[1];
-							blockOutput[2] = blockData[4];
-							blockOutput[3] = blockData[5];
-							blockOutput[4] = blockData[8];
-							blockOutput[5] = blockData[9];
-							blockOutput[6] = blockData[12];
-							blockOutput[7] = blockData[13];
-						}
-						blockOutput += 8;
-					}
-					else
-						assert_dbg();
-				}
-				else if ((sizeof(texelBaseType)*texelBaseTypeCount) == 4)
-				{
-					// bpp = 32
-					if (texelBaseTypeCount == 1)
-					{
-						uint64* blockOutput64 = (uint64*)blockOutput;
-						uint64* blockData64 = (uint64*)blockData;
-						if (isEncodeDirection)
-						{
-							blockData64[0] = blockOutput64[0];
-							blockData64[1] = blockOutput64[1];
-							blockData64[4] = blockOutput64[2];
-							blockData64[5] = blockOutput64[3];
-						}
-						else
-						{
-							blockOutput64[0] = blockData64[0];
-							blockOutput64[1] = blockData64[1];
-							blockOutput64[2] = blockData64[4];
-							blockOutput64[3] = blockData64[5];
-						}
-						blockOutput += 8;
-					}
-					else
-						cemu_assert_unimplemented();
-				}
-				else if ((sizeof(texelBaseType)*texelBaseTypeCount) == 1)
-				{
-					// bpp = 8
-					if (texelBaseTypeCount == 1)
-					{
-						uint64* blockOutput64 = (uint64*)blockOutput;
-						uint64* blockData64 = (uint64*)blockData;
-						if (isEncodeDirection)
-							blockData64[0] = blockOutput64[0];
-						else
-							blockOutput64[0] = blockData64[0];
-						blockOutput += 8;
-					}
-					else
-						cemu_assert_unimplemented();
-				}
-				else
-					cemu_assert_unimplemented();
+// copies whole micro tiles using the precomputed row layout. Only the address of each micro tile is calculated, the rows are moved as 8 or 16 byte vectors
+template<uint32 bytesPerTexel, uint32 chunkSize, bool isEncodeDirection>
+void optimizedDecodeLoop_tm04_numSamples1_8x8_chunked(LatteTextureLoaderCtx* textureLoader, const AddrLibMicroTileRowLayout& layout, uint8* outputData, sint32 texelCountX, sint32 texelRowBegin, sint32 texelRowEnd)
+{
+	const sint32 outputPitch = textureLoader->decodedTexelCountX * (sint32)bytesPerTexel;
+	const uint32 chunksPerRow = layout.chunksPerRow;
+	for (sint32 yt = texelRowBegin; yt < texelRowEnd; yt += 8)
+	{
+		uint8* outputTileRow = outputData + yt * outputPitch;
+		for (sint32 xt = 0; xt < texelCountX; xt += 8)
+		{
+			uint8* tiledData = textureLoader->inputData + LatteAddrLib::ComputeSurfaceAddrFromCoordMacroTiledCached_tm04_sample1(xt, yt, &textureLoader->computeAddrInfo);
+			uint8* linearData = outputTileRow + xt * (sint32)bytesPerTexel;
+			for (sint32 ry = 0; ry < 8; ry++)
+			{
+				const uint16* chunkOffset = layout.chunkOffset[ry];
+				for (uint32 c = 0; c < chunksPerRow; c++)
+					AddrLibFastDecode_copyChunk<chunkSize, isEncodeDirection>(tiledData + chunkOffset[c], linearData + c * chunkSize);
+				linearData += outputPitch;
 			}
 		}
 	}
@@ -217,25 +221,20 @@ void optimizedDecodeLoops(LatteTextureLoaderCtx* textureLoader, uint8* outputDat
 		texelCountY &= ~7;
 		// full tiles (assuming tileMode=4 and numSamples=1)
 		// only recalculate tile related offset at the beginning of each block
-		// calculate offsets in loop
-
-		// unsure if this variant is faster:
-		if (textureLoader->computeAddrInfo.microTileType == 0 && (sizeof(texelBaseType)*texelBaseTypeCount) == 8)
+		constexpr uint32 bytesPerTexel = sizeof(texelBaseType) * texelBaseTypeCount;
+		AddrLibMicroTileRowLayout rowLayout;
+		if (!AddrLibFastDecode_getMicroTileRowLayout<bytesPerTexel>(textureLoader, rowLayout))
+			rowLayout.chunkSize = 0;
+		sint32 bandAlignment = std::max<sint32>(textureLoader->computeAddrInfo.macroTileHeight, 8);
+		AddrLibFastDecode_forEachRowBand(texelCountY, bandAlignment, (uint64)texelCountX * texelCountY * bytesPerTexel, [&](sint32 rowBegin, sint32 rowEnd)
 		{
-			optimizedDecodeLoop_tm04_numSamples1_8x8_optimizedRowCopy<texelBaseType, texelBaseTypeCount, isEncodeDirection, isCompressed>(textureLoader, outputData, texelCountX, texelCountY);
-		}
-		else if (textureLoader->computeAddrInfo.microTileType == 0 && (sizeof(texelBaseType)*texelBaseTypeCount) == 4)
-		{
-			optimizedDecodeLoop_tm04_numSamples1_8x8_optimizedRowCopy<texelBaseType, texelBaseTypeCount, isEncodeDirection, isCompressed>(textureLoader, outputData, texelCountX, texelCountY);
-		}
-		else if (textureLoader->computeAddrInfo.microTileType == 0 && (sizeof(texelBaseType)*texelBaseTypeCount) == 1)
-		{
-			optimizedDecodeLoop_tm04_numSamples1_8x8_optimizedRowCopy<texelBaseType, texelBaseTypeCount, isEncodeDirection, isCompressed>(textureLoader, outputData, texelCountX, texelCountY);
-		}
-		else
-		{
-			optimizedDecodeLoop_tm04_numSamples1_8x8<texelBaseType, texelBaseTypeCount, isEncodeDirection, isCompressed>(textureLoader, outputData, texelCountX, texelCountY);
-		}
+			if (rowLayout.chunkSize == 16)
+				optimizedDecodeLoop_tm04_numSamples1_8x8_chunked<bytesPerTexel, 16, isEncodeDirection>(textureLoader, rowLayout, outputData, texelCountX, rowBegin, rowEnd);
+			else if (rowLayout.chunkSize == 8)
+				optimizedDecodeLoop_tm04_numSamples1_8x8_chunked<bytesPerTexel, 8, isEncodeDirection>(textureLoader, rowLayout, outputData, texelCountX, rowBegin, rowEnd);
+			else
+				optimizedDecodeLoop_tm04_numSamples1_8x8<texelBaseType, texelBaseTypeCount, isEncodeDirection, isCompressed>(textureLoader, outputData, texelCountX, rowBegin, rowEnd);
+		});
 		// the above code only handles full 8x8 pixel blocks, for uneven sizes we need to process the remaining pixels here
 		// right border
 		for (sint32 yt = 0; yt < texelCountY; yt++)
@@ -348,37 +347,41 @@ void optimizedDecodeLoops(LatteTextureLoaderCtx* textureLoader, uint8* outputDat
 	else
 	{
 		// generic handler
-		for (sint32 y = 0; y < textureLoader->height; y += textureLoader->stepY)
+		sint32 texelRowCount = (textureLoader->height + textureLoader->stepY - 1) / textureLoader->stepY;
+		AddrLibFastDecode_forEachRowBand(texelRowCount, 8, (uint64)texelCountX * texelRowCount * (sizeof(texelBaseType) * texelBaseTypeCount), [&](sint32 rowBegin, sint32 rowEnd)
 		{
-			sint32 pixelOffset = ((y / textureLoader->stepY)*textureLoader->decodedTexelCountX) * (sizeof(texelBaseType)*texelBaseTypeCount);
-			texelBaseType* blockOutput = (texelBaseType*)(outputData + pixelOffset);
-			for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
+			for (sint32 y = rowBegin * textureLoader->stepY; y < std::min(rowEnd * textureLoader->stepY, textureLoader->height); y += textureLoader->stepY)
 			{
-				uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
-				// copy as-is
-				if (texelBaseTypeCount == 1)
-				{
-					if (isEncodeDirection)
-						*(texelBaseType*)blockData = *blockOutput;
-					else
-						*blockOutput = *(texelBaseType*)blockData;
-					blockOutput++;
-				}
-				else if (texelBaseTypeCount == 2)
+				sint32 pixelOffset = ((y / textureLoader->stepY)*textureLoader->decodedTexelCountX) * (sizeof(texelBaseType)*texelBaseTypeCount);
+				texelBaseType* blockOutput = (texelBaseType*)(outputData + pixelOffset);
+				for (sint32 x = 0; x < textureLoader->width; x += textureLoader->stepX)
 				{
-					if (isEncodeDirection)
+					uint8* blockData = LatteTextureLoader_GetInput(textureLoader, x, y);
+					// copy as-is
+					if (texelBaseTypeCount == 1)
 					{
-						((texelBaseType*)blockData)[0] = blockOutput[0];
-						((texelBaseType*)blockData)[1] = blockOutput[1];
+						if (isEncodeDirection)
+							*(texelBaseType*)blockData = *blockOutput;
+						else
+							*blockOutput = *(texelBaseType*)blockData;
+						blockOutput++;
 					}
-					else
+					else if (texelBaseTypeCount == 2)
 					{
-						blockOutput[0] = ((texelBaseType*)blockData)[0];
-						blockOutput[1] = ((texelBaseType*)blockData)[1];
+						if (isEncodeDirection)
+						{
+							((texelBaseType*)blockData)[0] = blockOutput[0];
+							((texelBaseType*)blockData)[1] = blockOutput[1];
+						}
+						else
+						{
+							blockOutput[0] = ((texelBaseType*)blockData)[0];
+							blockOutput[1] = ((texelBaseType*)blockData)[1];
+						}
+						blockOutput += 2;
 					}
-					blockOutput += 2;
 				}
 			}
-		}
+		});
 	}
 }
@@ -302,6 +302,8 @@ uint32 MetalPipelineCache::BeginLoading(uint64 cacheTitleId)
 	{
 		s_cache->UseCompression(false);
 		g_mtlCacheState.pipelineMaxFileIndex = s_cache->GetMaximumFileIndex();
+		// while loading, entries are read from a read-only mapping of the file which does not need to take the cache lock
+		m_loadCacheView = FileCache::OpenReadOnly(pathCacheFile, LatteShaderCache_getPipelineCacheExtraVersion(cacheTitleId));
 	}
 	return s_cache->GetFileCount();
 }
@@ -310,29 +312,33 @@ bool MetalPipelineCache::UpdateLoading(uint32& pipelinesLoadedTotal, uint32& pip
 {
 	pipelinesLoadedTotal = g_mtlCacheState.pipelinesLoaded;
 	pipelinesMissingShaders = 0;
+	// top up the compilation queue in one go instead of queuing a single entry per call
+	uint32 numQueued = 0;
+	FileCache* cache = m_loadCacheView ? m_loadCacheView : s_cache;
 	while (g_mtlCacheState.pipelineLoadIndex <= g_mtlCacheState.pipelineMaxFileIndex)
 	{
 		if (m_compilationQueue.size() >= 50)
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			if (numQueued == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
 			return true; // queue up to 50 entries at a time
 		}
 
 		uint64 fileNameA, fileNameB;
 		std::vector<uint8> fileData;
-		if (s_cache->GetFileByIndex(g_mtlCacheState.pipelineLoadIndex, &fileNameA, &fileNameB, fileData))
+		if (cache->GetFileByIndex(g_mtlCacheState.pipelineLoadIndex, &fileNameA, &fileNameB, fileData))
 		{
 			// queue for async compilation
 			g_mtlCacheState.pipelinesQueued++;
 			m_compilationQueue.push(std::move(fileData));
-			g_mtlCacheState.pipelineLoadIndex++;
-			return true;
+			numQueued++;
 		}
 		g_mtlCacheState.pipelineLoadIndex++;
 	}
 	if (g_mtlCacheState.pipelinesLoaded != g_mtlCacheState.pipelinesQueued)
 	{
-		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		if (numQueued == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
 		return true; // pipelines still compiling
 	}
 	return false; // done
@@ -347,6 +353,8 @@ void MetalPipelineCache::EndLoading()
 	{
 		m_compilationQueue.push({}); // push empty workload for every thread. Threads then will shutdown after checking for m_numCompilationThreads == 0
 	}
+	delete m_loadCacheView;
+	m_loadCacheView = nullptr;
 	// keep cache file open for writing of new pipelines
 }
 
@@ -34,6 +34,7 @@ private:
 	std::thread* m_pipelineCacheStoreThread;
 
 	class FileCache* s_cache;
+	class FileCache* m_loadCacheView{}; // read-only mapping of the cache file, only open during loading
 
 	std::atomic_uint32_t m_numCompilationThreads{ 0 };
 	ConcurrentQueue<std::vector<uint8>> m_compilationQueue;
@@ -924,9 +924,9 @@ TextureDecoder* OpenGLRenderer::texture_chooseDecodedFormat(Latte::E_GX2SURFFMT
 	else if (format == Latte::E_GX2SURFFMT::BC4_SNORM)
 	{
 		if (dim != Latte::E_DIM::DIM_2D && dim != Latte::E_DIM::DIM_2D_ARRAY)
-			texDecoder = TextureDecoder_BC4::getInstance();
+			texDecoder = TextureDecoder_BC4_SNORM_uncompress::getInstance();
 		else
-			texDecoder = TextureDecoder_BC4_UNORM_uncompress::getInstance();
+			texDecoder = TextureDecoder_BC4::getInstance();
 	}
 	else if (format == Latte::E_GX2SURFFMT::BC5_UNORM)
 		texDecoder = TextureDecoder_BC5::getInstance();
@@ -1365,8 +1365,6 @@ void OpenGLRenderer::shader_unbind(RendererShader::ShaderType shaderType)
 	}
 }
 
-void decodeBC4Block_UNORM(uint8* blockStorage, float* rOutput);
-
 void OpenGLRenderer::texture_syncSliceSpecialBC4(LatteTexture* srcTexture, sint32 srcSliceIndex, sint32 srcMipIndex, LatteTexture* dstTexture, sint32 dstSliceIndex, sint32 dstMipIndex)
 {
 	auto srcTextureGL = (LatteTextureGL*)srcTexture;
@@ -1380,33 +1378,25 @@ void OpenGLRenderer::texture_syncSliceSpecialBC4(LatteTexture* srcTexture, sint3
 	sint32 compressedCopyWidth = std::min(sourceTexWidth, std::max(1, destTexWidth / 4));
 	sint32 compressedCopyHeight = std::min(sourceTexHeight, std::max(1, destTexHeight / 4));
 
-	uint8* texelData = (uint8*)malloc(compressedCopyWidth*compressedCopyHeight * 8);
-	float* pixelRGBA16fData = (float*)malloc(destTexWidth*destTexHeight * sizeof(float) * 2);
+	std::vector<uint8> texelData(compressedCopyWidth * compressedCopyHeight * 8);
+	std::vector<uint8> pixelR8Data(destTexWidth * destTexHeight);
+	std::vector<uint8> blockRowR8Data(compressedCopyWidth * 4 * 4);
+	std::vector<uint8*> blockPtrs(compressedCopyWidth);
 	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 	if (glGetTextureSubImage)
-		glGetTextureSubImage(srcTextureGL->glId_texture, 0, 0, 0, srcSliceIndex, compressedCopyWidth, compressedCopyHeight, 1, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, compressedCopyWidth * compressedCopyHeight * 8, texelData);
-	for (sint32 bx = 0; bx < compressedCopyWidth; bx++)
+		glGetTextureSubImage(srcTextureGL->glId_texture, 0, 0, 0, srcSliceIndex, compressedCopyWidth, compressedCopyHeight, 1, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, compressedCopyWidth * compressedCopyHeight * 8, texelData.data());
+	const sint32 copyWidth = std::min(compressedCopyWidth * 4, destTexWidth);
+	for (sint32 by = 0; by < compressedCopyHeight; by++)
 	{
-		for (sint32 by = 0; by < compressedCopyHeight; by++)
-		{
-			float rBlock[4 * 4];
-			decodeBC4Block_UNORM(texelData + (bx + by * compressedCopyWidth) * 8, rBlock);
-			for (sint32 sy = 0; sy < std::min(4, destTexHeight - by * 4); sy++)
-			{
-				for (sint32 sx = 0; sx < std::min(4, destTexWidth - bx * 4); sx++)
-				{
-					sint32 pixelIndex = (bx * 4 + sx) + (by * 4 + sy)*destTexWidth;
-					pixelRGBA16fData[pixelIndex * 2] = rBlock[sx + sy * 4];
-					pixelRGBA16fData[pixelIndex * 2 + 1] = rBlock[sx + sy * 4];
-				}
-			}
-		}
+		for (sint32 bx = 0; bx < compressedCopyWidth; bx++)
+			blockPtrs[bx] = texelData.data() + (bx + by * compressedCopyWidth) * 8;
+		decodeBC4Blocks_R8_UNORM(blockPtrs.data(), compressedCopyWidth, blockRowR8Data.data(), compressedCopyWidth * 4);
+		for (sint32 sy = 0; sy < std::min(4, destTexHeight - by * 4); sy++)
+			memcpy(pixelR8Data.data() + (by * 4 + sy) * destTexWidth, blockRowR8Data.data() + sy * compressedCopyWidth * 4, copyWidth);
 	}
 	// upload mip
 	if (glGetTextureSubImage && glTextureSubImage3D)
-		glTextureSubImage3D(dstTextureGL->glId_texture, dstMipIndex, 0, 0, dstSliceIndex, destTexWidth, destTexHeight, 1, GL_RG, GL_FLOAT, pixelRGBA16fData);
-	free(pixelRGBA16fData);
-	free(texelData);
+		glTextureSubImage3D(dstTextureGL->glId_texture, dstMipIndex, 0, 0, dstSliceIndex, destTexWidth, destTexHeight, 1, GL_RED, GL_UNSIGNED_BYTE, pixelR8Data.data());
 	catchOpenGLError();
 }
 
@@ -109,6 +109,39 @@ uint8 Renderer::RGBComponentToSRGB(uint8 cli)
 	return (uint8)(cs * 255.0f);
 }
 
+uint8* Renderer::texture_reserveSliceUpload(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, sint32 sliceIndex, sint32 mipIndex, uint32 imageSize)
+{
+	PendingSliceUpload& upload = m_pendingSliceUploads.emplace_back();
+	upload.hostTexture = hostTexture;
+	upload.width = width;
+	upload.height = height;
+	upload.depth = depth;
+	upload.sliceIndex = sliceIndex;
+	upload.mipIndex = mipIndex;
+	upload.imageSize = imageSize;
+	// staging buffers are kept across batches and only reallocated when a slice doesn't fit
+	// buffers are never moved while a batch is pending since decode tasks may still be writing to them
+	size_t stagingIndex = m_pendingSliceUploads.size() - 1;
+	if (stagingIndex >= m_sliceUploadStaging.size())
+		m_sliceUploadStaging.emplace_back();
+	SliceUploadStagingBuffer& staging = m_sliceUploadStaging[stagingIndex];
+	if (staging.size < imageSize)
+	{
+		staging.data.reset(new uint8[imageSize]);
+		staging.size = imageSize;
+	}
+	upload.data = staging.data.get();
+	return upload.data;
+}
+
+void Renderer::texture_submitSliceUploads()
+{
+	// the decoded data is passed straight to texture_loadSlice, no intermediate copy into the upload buffer
+	for (auto& upload : m_pendingSliceUploads)
+		texture_loadSlice(upload.hostTexture, upload.width, upload.height, upload.depth, upload.data, upload.sliceIndex, upload.mipIndex, upload.imageSize);
+	m_pendingSliceUploads.clear();
+}
+
 void Renderer::RequestScreenshot(ScreenshotSaveFunction onSaveScreenshot)
 {
 	m_screenshot_requested = true;
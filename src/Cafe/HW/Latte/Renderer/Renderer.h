@@ -109,6 +109,11 @@ public:
 
 	virtual void texture_clearSlice(LatteTexture* hostTexture, sint32 sliceIndex, sint32 mipIndex) = 0;
 	virtual void texture_loadSlice(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, void* pixelData, sint32 sliceIndex, sint32 mipIndex, uint32 compressedImageSize) = 0;
+	// batched slice uploads. Memory returned by texture_reserveSliceUpload can be written from any thread and stays valid until texture_submitSliceUploads() is called
+	// all reserved slices are then transferred together. The default implementation decodes into reusable host staging buffers and passes them directly to texture_loadSlice
+	// renderers whose texture_loadSlice only accepts memory from texture_acquireTextureUploadBuffer need to override both
+	virtual uint8* texture_reserveSliceUpload(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, sint32 sliceIndex, sint32 mipIndex, uint32 imageSize);
+	virtual void texture_submitSliceUploads();
 	virtual void texture_clearColorSlice(LatteTexture* hostTexture, sint32 sliceIndex, sint32 mipIndex, float r, float g, float b, float a) = 0;
 	virtual void texture_clearDepthSlice(LatteTexture* hostTexture, uint32 sliceIndex, sint32 mipIndex, bool clearDepth, bool clearStencil, float depthValue, uint32 stencilValue) = 0;
 
@@ -163,6 +168,26 @@ public:
 
 protected:
 	virtual void GetVendorInformation() { }
+
+	struct PendingSliceUpload
+	{
+		LatteTexture* hostTexture;
+		sint32 width;
+		sint32 height;
+		sint32 depth;
+		sint32 sliceIndex;
+		sint32 mipIndex;
+		uint32 imageSize;
+		uint8* data;
+	};
+	std::vector<PendingSliceUpload> m_pendingSliceUploads;
+	struct SliceUploadStagingBuffer
+	{
+		std::unique_ptr<uint8[]> data;
+		uint32 size{};
+	};
+	std::vector<SliceUploadStagingBuffer> m_sliceUploadStaging;
+
 	RendererAPI m_rendererAPI;
 	GfxVendor m_vendor = GfxVendor::Generic;
 
@@ -1,8 +1,9 @@
 #include "Cafe/HW/Latte/Renderer/RendererShader.h"
 #include "Cafe/GameProfile/GameProfile.h"
 
-// generate a Cemu version and setting dependent id
-uint32 RendererShader::GeneratePrecompiledCacheId()
+// generate a Cemu version dependent id
+// for caches that are keyed by the shader source, where settings which affect the generated source don't need to be considered
+uint32 RendererShader::GenerateSharedPrecompiledCacheId()
 {
 	uint32 v = 0;
 	const char* s = EMULATOR_VERSION_SUFFIX;
@@ -16,11 +17,19 @@ uint32 RendererShader::GeneratePrecompiledCacheId()
 	v += (EMULATOR_VERSION_MINOR * 10000u);
 	v += (EMULATOR_VERSION_PATCH * 100u);
 
+	v += 0x820a5277; // change this value for manual invalidation
+
+	return v;
+}
+
+// generate a Cemu version and setting dependent id
+uint32 RendererShader::GeneratePrecompiledCacheId()
+{
+	uint32 v = GenerateSharedPrecompiledCacheId();
+
 	// settings that can influence shaders
 	v += (uint32)g_current_game_profile->GetAccurateShaderMul() * 133;
 
-	v += 0x820a5277; // change this value for manual invalidation
-
 	return v;
 }
 
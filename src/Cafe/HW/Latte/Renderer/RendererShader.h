@@ -25,6 +25,7 @@ protected:
 		: m_type(type), m_baseHash(baseHash), m_auxHash(auxHash), m_isGameShader(isGameShader), m_isGfxPackShader(isGfxPackShader) {}
 
 	static uint32 GeneratePrecompiledCacheId();
+	static uint32 GenerateSharedPrecompiledCacheId();
 	static void GenerateShaderPrecompiledCacheFilename(ShaderType type, uint64 baseHash, uint64 auxHash, uint64& h1, uint64& h2);
 
 protected:
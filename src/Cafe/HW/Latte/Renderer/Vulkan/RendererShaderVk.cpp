@@ -5,13 +5,16 @@
 #include "config/CemuConfig.h"
 #include "util/helpers/ConcurrentQueue.h"
 #include "Cemu/FileCache/FileCache.h"
+#include "util/ThreadPool/ThreadPool.h"
 
 #include <glslang/Public/ShaderLang.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
 #include "util/helpers/helpers.h"
+#include <openssl/sha.h>
 
 bool s_isLoadingShadersVk{ false };
 class FileCache* s_spirvCache{nullptr};
+class FileCache* s_sharedSpirvCache{nullptr}; // content addressed by the GLSL source, shared by all titles
 
 extern std::atomic_int g_compiled_shaders_total;
 extern std::atomic_int g_compiled_shaders_async;
@@ -125,86 +128,60 @@ consteval TBuiltInResource GetDefaultBuiltInResource()
 	return defaultResource;
 };
 
-class _ShaderVkThreadPool
+// asynchronous compilation runs on the shared thread pool
+// compiling a shader can take a long time, so only a limited number of low priority tasks is active at once. This leaves the remaining workers for short tasks like texture decoding and audio mixing
+// each task compiles shaders from the front of the queue until it is empty
+// shaders compiled synchronously via PreponeCompilation() are removed from the queue
+struct
 {
-public:
-	void StartThreads()
-	{
-		if (m_threadsActive.exchange(true))
-			return;
-		// create thread pool
-		const uint32 threadCount = 2;
-		for (uint32 i = 0; i < threadCount; ++i)
-			s_threads.emplace_back(&_ShaderVkThreadPool::CompilerThreadFunc, this);
-	}
-
-	void StopThreads()
-	{
-		if (!m_threadsActive.exchange(false))
-			return;
-		for (uint32 i = 0; i < s_threads.size(); ++i)
-			s_compilationQueueCount.increment();
-		for (auto& it : s_threads)
-			it.join();
-		s_threads.clear();
-	}
-
-	~_ShaderVkThreadPool()
-	{
-		StopThreads();
-	}
-
-	void CompilerThreadFunc()
+	std::deque<RendererShaderVk*> compilationQueue;
+	std::mutex compilationQueueMutex;
+	ThreadPool::TaskGroup compilationTasks;
+	uint32 activeTaskCount{0}; // protected by compilationQueueMutex
+	uint32 maxActiveTaskCount{1};
+	std::atomic_bool isActive{false};
+}s_shaderVkCompilation;
+
+void RendererShaderVk::CompileQueuedShaders()
+{
+	while (true)
 	{
-		SetThreadName("vkShaderComp");
-		while (m_threadsActive.load(std::memory_order::relaxed))
+		s_shaderVkCompilation.compilationQueueMutex.lock();
+		if (s_shaderVkCompilation.compilationQueue.empty())
 		{
-			s_compilationQueueCount.decrementWithWait();
-			s_compilationQueueMutex.lock();
-			if (s_compilationQueue.empty())
-			{
-				// queue empty again, shaders compiled synchronously via PreponeCompilation()
-				s_compilationQueueMutex.unlock();
-				continue;
-			}
-			RendererShaderVk* job = s_compilationQueue.front();
-			s_compilationQueue.pop_front();
-			// set compilation state
-			cemu_assert_debug(job->m_compilationState.getValue() == RendererShaderVk::COMPILATION_STATE::QUEUED);
-			job->m_compilationState.setValue(RendererShaderVk::COMPILATION_STATE::COMPILING);
-			s_compilationQueueMutex.unlock();
-			// compile
-			job->CompileInternal(false);
-			++g_compiled_shaders_async;
-			// mark as compiled
-			cemu_assert_debug(job->m_compilationState.getValue() == RendererShaderVk::COMPILATION_STATE::COMPILING);
-			job->m_compilationState.setValue(RendererShaderVk::COMPILATION_STATE::DONE);
+			s_shaderVkCompilation.activeTaskCount--;
+			s_shaderVkCompilation.compilationQueueMutex.unlock();
+			return;
 		}
+		RendererShaderVk* job = s_shaderVkCompilation.compilationQueue.front();
+		s_shaderVkCompilation.compilationQueue.pop_front();
+		// set compilation state
+		cemu_assert_debug(job->m_compilationState.getValue() == RendererShaderVk::COMPILATION_STATE::QUEUED);
+		job->m_compilationState.setValue(RendererShaderVk::COMPILATION_STATE::COMPILING);
+		s_shaderVkCompilation.compilationQueueMutex.unlock();
+		// compile
+		job->CompileInternal(false);
+		++g_compiled_shaders_async;
+		// mark as compiled
+		cemu_assert_debug(job->m_compilationState.getValue() == RendererShaderVk::COMPILATION_STATE::COMPILING);
+		job->m_compilationState.setValue(RendererShaderVk::COMPILATION_STATE::DONE);
 	}
-
-	bool HasThreadsRunning() const { return m_threadsActive; }
-
-public:
-	std::vector<std::thread> s_threads;
-
-	std::deque<RendererShaderVk*> s_compilationQueue;
-	CounterSemaphore s_compilationQueueCount;
-	std::mutex s_compilationQueueMutex;
-
-private:
-	std::atomic<bool> m_threadsActive;
-}ShaderVkThreadPool;
+}
 
 RendererShaderVk::RendererShaderVk(ShaderType type, uint64 baseHash, uint64 auxHash, bool isGameShader, bool isGfxPackShader, const std::string& glslCode)
 	: RendererShader(type, baseHash, auxHash, isGameShader, isGfxPackShader), m_glslCode(glslCode)
 {
 	// start async compilation
-	ShaderVkThreadPool.s_compilationQueueMutex.lock();
+	cemu_assert_debug(s_shaderVkCompilation.isActive); // make sure Init() was called
+	s_shaderVkCompilation.compilationQueueMutex.lock();
 	m_compilationState.setValue(COMPILATION_STATE::QUEUED);
-	ShaderVkThreadPool.s_compilationQueue.push_back(this);
-	ShaderVkThreadPool.s_compilationQueueCount.increment();
-	ShaderVkThreadPool.s_compilationQueueMutex.unlock();
-	cemu_assert_debug(ShaderVkThreadPool.HasThreadsRunning()); // make sure .StartThreads() was called
+	s_shaderVkCompilation.compilationQueue.push_back(this);
+	bool startTask = s_shaderVkCompilation.activeTaskCount < s_shaderVkCompilation.maxActiveTaskCount;
+	if (startTask)
+		s_shaderVkCompilation.activeTaskCount++;
+	s_shaderVkCompilation.compilationQueueMutex.unlock();
+	if (startTask)
+		s_shaderVkCompilation.compilationTasks.Run(&RendererShaderVk::CompileQueuedShaders, ThreadPool::Priority::Low);
 }
 
 RendererShaderVk::~RendererShaderVk()
@@ -218,12 +195,23 @@ RendererShaderVk::~RendererShaderVk()
 
 void RendererShaderVk::Init()
 {
-	ShaderVkThreadPool.StartThreads();
+	s_shaderVkCompilation.maxActiveTaskCount = std::max<uint32>(ThreadPool::GetWorkerCount() / 2, 1);
+	s_shaderVkCompilation.isActive = true;
+	// open shared SPIR-V cache
+	cemu_assert_debug(!s_sharedSpirvCache);
+	const fs::path cachePath = ActiveSettings::GetCachePath("shaderCache/precompiled/shared_spirv.bin");
+	s_sharedSpirvCache = FileCache::Open(cachePath, true, GenerateSharedPrecompiledCacheId());
+	if (!s_sharedSpirvCache)
+		cemuLog_log(LogType::Force, "Unable to open shared SPIR-V cache");
 }
 
 void RendererShaderVk::Shutdown()
 {
-	ShaderVkThreadPool.StopThreads();
+	if (!s_shaderVkCompilation.isActive.exchange(false))
+		return;
+	s_shaderVkCompilation.compilationTasks.Wait();
+	delete s_sharedSpirvCache;
+	s_sharedSpirvCache = nullptr;
 }
 
 void RendererShaderVk::CreateVkShaderModule(std::span<uint32> spirvBuffer)
@@ -264,6 +252,17 @@ void RendererShaderVk::FinishCompilation()
 	m_glslCode.shrink_to_fit();
 }
 
+// name of the shader in the shared SPIR-V cache, derived from the GLSL source
+// unlike baseHash/auxHash this also identifies shaders across titles and game updates
+void RendererShaderVk::GetSharedCacheName(uint64& h1, uint64& h2)
+{
+	uint8 hash[SHA256_DIGEST_LENGTH];
+	SHA256((const uint8*)m_glslCode.data(), m_glslCode.size(), hash);
+	uint64 nameA = *(uint64be*)(hash + 0);
+	uint64 nameB = *(uint64be*)(hash + 8);
+	GenerateShaderPrecompiledCacheFilename(m_type, nameA, nameB, h1, h2);
+}
+
 void RendererShaderVk::CompileInternal(bool isRenderThread)
 {
 	const bool compileWithDebugInfo = ((VulkanRenderer*)g_renderer.get())->IsTracingToolEnabled();
@@ -284,6 +283,20 @@ void RendererShaderVk::CompileInternal(bool isRenderThread)
 		}
 	}
 
+	// try the shared cache. Unlike the per-title cache this is also checked for shaders compiled at runtime
+	uint64 sharedCacheH1 = 0, sharedCacheH2 = 0;
+	if (s_sharedSpirvCache && !compileWithDebugInfo)
+	{
+		GetSharedCacheName(sharedCacheH1, sharedCacheH2);
+		std::vector<uint8> cacheFileData;
+		if (s_sharedSpirvCache->GetFile({ sharedCacheH1, sharedCacheH2 }, cacheFileData))
+		{
+			CreateVkShaderModule(std::span<uint32>((uint32*)cacheFileData.data(), cacheFileData.size() / sizeof(uint32)));
+			FinishCompilation();
+			return;
+		}
+	}
+
 	EShLanguage state;
 	switch (GetType())
 	{
@@ -380,6 +393,9 @@ void RendererShaderVk::CompileInternal(bool isRenderThread)
 		GenerateShaderPrecompiledCacheFilename(m_type, m_baseHash, m_auxHash, h1, h2);
 		s_spirvCache->AddFile({ h1, h2 }, (const uint8*)spirvBuffer.data(), spirvBuffer.size() * sizeof(uint32));
 	}
+	// since the shared cache is keyed by the source, modified shaders from gfx packs can be stored too
+	if (s_sharedSpirvCache && !compileWithDebugInfo)
+		s_sharedSpirvCache->AddFileAsync({ sharedCacheH1, sharedCacheH2 }, (const uint8*)spirvBuffer.data(), spirvBuffer.size() * sizeof(uint32));
 
 	CreateVkShaderModule(spirvBuffer);
 
@@ -395,15 +411,15 @@ void RendererShaderVk::CompileInternal(bool isRenderThread)
 
 void RendererShaderVk::PreponeCompilation(bool isRenderThread)
 {
-	ShaderVkThreadPool.s_compilationQueueMutex.lock();
+	s_shaderVkCompilation.compilationQueueMutex.lock();
 	bool isStillQueued = m_compilationState.hasState(COMPILATION_STATE::QUEUED);
 	if (isStillQueued)
 	{
 		// remove from queue
-		ShaderVkThreadPool.s_compilationQueue.erase(std::remove(ShaderVkThreadPool.s_compilationQueue.begin(), ShaderVkThreadPool.s_compilationQueue.end(), this), ShaderVkThreadPool.s_compilationQueue.end());
+		s_shaderVkCompilation.compilationQueue.erase(std::remove(s_shaderVkCompilation.compilationQueue.begin(), s_shaderVkCompilation.compilationQueue.end(), this), s_shaderVkCompilation.compilationQueue.end());
 		m_compilationState.setValue(COMPILATION_STATE::COMPILING);
 	}
-	ShaderVkThreadPool.s_compilationQueueMutex.unlock();
+	s_shaderVkCompilation.compilationQueueMutex.unlock();
 	if (!isStillQueued)
 	{
 		m_compilationState.waitUntilValue(COMPILATION_STATE::DONE);
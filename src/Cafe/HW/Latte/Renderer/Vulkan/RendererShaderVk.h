@@ -10,7 +10,6 @@
 class RendererShaderVk : public RendererShader
 {
 	friend class VulkanRenderer;
-	friend class _ShaderVkThreadPool;
 
 	enum class COMPILATION_STATE : uint32
 	{
@@ -54,7 +53,9 @@ public:
 	bool WaitForCompiled() override;
 
 private:
+	static void CompileQueuedShaders();
 	void CompileInternal(bool isRenderThread);
+	void GetSharedCacheName(uint64& h1, uint64& h2);
 
 	void FinishCompilation();
 
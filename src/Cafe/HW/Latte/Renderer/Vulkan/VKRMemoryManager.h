@@ -243,8 +243,6 @@ class VKRSynchronizedHeapAllocator
 	std::unordered_map<uint64, std::vector<CHAddr>> m_releaseQueue;
 };
 
-void LatteIndices_invalidateAll();
-
 class VKRMemoryManager
 {
 	friend class VKRSynchronizedRingAllocator;
@@ -282,7 +280,6 @@ public:
 
 	void cleanupBuffers(uint64 latestFinishedCommandBufferId)
 	{
-		LatteIndices_invalidateAll();
 		m_stagingBuffer.CleanupBuffer(latestFinishedCommandBufferId);
 		m_indexBuffer.CleanupBuffer(latestFinishedCommandBufferId);
 		m_vertexStrideMetalBuffer.CleanupBuffer(latestFinishedCommandBufferId);
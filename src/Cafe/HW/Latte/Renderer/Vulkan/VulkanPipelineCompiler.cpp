@@ -1076,6 +1076,7 @@ bool PipelineCompiler::CalcRobustBufferAccessRequirement(LatteDecompilerShader*
 static std::vector<std::thread> s_compileThreads;
 static std::atomic_bool s_compileThreadsShutdownSignal{};
 static ConcurrentQueue<PipelineCompiler*> s_pipelineCompileRequests;
+static ConcurrentQueue<std::function<void()>> s_speculativeCompileJobs;
 
 static void compilePipeline_thread(sint32 threadIndex)
 {
@@ -1090,7 +1091,13 @@ static void compilePipeline_thread(sint32 threadIndex)
 	{
 		PipelineCompiler* request = s_pipelineCompileRequests.pop();
 		if (!request)
+		{
+			// empty requests are either a shutdown signal or a wakeup for a speculative job
+			std::function<void()> speculativeJob;
+			if (!s_compileThreadsShutdownSignal && s_speculativeCompileJobs.peek2(speculativeJob))
+				speculativeJob();
 			continue;
+		}
 		request->Compile(true, false, true);
 		delete request;
 	}
@@ -1134,9 +1141,16 @@ void PipelineCompiler::CompileThreadPool_Stop()
 			delete pipelineCompiler;
 	}
 	s_compileThreads.clear();
+	s_speculativeCompileJobs.clear();
 }
 
 void PipelineCompiler::CompileThreadPool_QueueCompilation(PipelineCompiler* v)
 {
 	s_pipelineCompileRequests.push(v);
 }
+
+void PipelineCompiler::CompileThreadPool_QueueSpeculativeJob(std::function<void()> job)
+{
+	s_speculativeCompileJobs.push(std::move(job));
+	s_pipelineCompileRequests.push(nullptr); // wake up a compile thread
+}
@@ -49,6 +49,7 @@ public:
 	static void CompileThreadPool_Start();
 	static void CompileThreadPool_Stop();
 	static void CompileThreadPool_QueueCompilation(PipelineCompiler* v);
+	static void CompileThreadPool_QueueSpeculativeJob(std::function<void()> job); // queued behind pipelines which are already waiting for compilation
 
 	VkPipelineLayout m_pipelineLayout;
 	VKRObjectRenderPass* m_renderPassObj{};
@@ -40,6 +40,7 @@ uint32 VulkanPipelineStableCache::BeginLoading(uint64 cacheTitleId)
 	g_vkCacheState.pipelineMaxFileIndex = 0;
 	g_vkCacheState.pipelinesLoaded = 0;
 	g_vkCacheState.pipelinesQueued = 0;
+	m_variantPrediction.pendingCompilations = 0;
 	
 	// start async compilation threads
 	m_compilationCount.store(0);	
@@ -69,6 +70,8 @@ uint32 VulkanPipelineStableCache::BeginLoading(uint64 cacheTitleId)
 	{
 		s_cache->UseCompression(false);
 		g_vkCacheState.pipelineMaxFileIndex = s_cache->GetMaximumFileIndex();
+		// while loading, entries are read from a read-only mapping of the file which does not need to take the cache lock
+		m_loadCacheView = FileCache::OpenReadOnly(pathCacheFile, LatteShaderCache_getPipelineCacheExtraVersion(cacheTitleId));
 	}
 	return s_cache->GetFileCount();
 }
@@ -77,29 +80,33 @@ bool VulkanPipelineStableCache::UpdateLoading(uint32& pipelinesLoadedTotal, uint
 {
 	pipelinesLoadedTotal = g_vkCacheState.pipelinesLoaded;
 	pipelinesMissingShaders = 0;
+	// top up the compilation queue in one go instead of queuing a single entry per call
+	uint32 numQueued = 0;
+	FileCache* cache = m_loadCacheView ? m_loadCacheView : s_cache;
 	while (g_vkCacheState.pipelineLoadIndex <= g_vkCacheState.pipelineMaxFileIndex)
 	{
 		if (m_compilationQueue.size() >= 50)
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			if (numQueued == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
 			return true; // queue up to 50 entries at a time
 		}
 
 		uint64 fileNameA, fileNameB;
 		std::vector<uint8> fileData;
-		if (s_cache->GetFileByIndex(g_vkCacheState.pipelineLoadIndex, &fileNameA, &fileNameB, fileData))
+		if (cache->GetFileByIndex(g_vkCacheState.pipelineLoadIndex, &fileNameA, &fileNameB, fileData))
 		{
 			// queue for async compilation
 			g_vkCacheState.pipelinesQueued++;
 			m_compilationQueue.push(std::move(fileData));
-			g_vkCacheState.pipelineLoadIndex++;
-			return true;
+			numQueued++;
 		}
 		g_vkCacheState.pipelineLoadIndex++;
 	}
 	if (g_vkCacheState.pipelinesLoaded != g_vkCacheState.pipelinesQueued)
 	{
-		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		if (numQueued == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
 		return true; // pipelines still compiling
 	}
 	return false; // done
@@ -114,6 +121,8 @@ void VulkanPipelineStableCache::EndLoading()
 	{
 		m_compilationQueue.push({}); // push empty workload for every thread. Threads then will shutdown after checking for m_numCompilationThreads == 0
 	}
+	delete m_loadCacheView;
+	m_loadCacheView = nullptr;
 	// keep cache file open for writing of new pipelines
 }
 
@@ -124,6 +133,12 @@ void VulkanPipelineStableCache::Close()
         delete s_cache;
         s_cache = nullptr;
     }
+	std::unique_lock _l(m_variantPrediction.mutex);
+	m_variantPrediction.states.clear();
+	m_variantPrediction.stateIndexByKey.clear();
+	m_variantPrediction.statesPerVertexShader.clear();
+	m_variantPrediction.statesPerPixelShader.clear();
+	m_variantPrediction.compiledPipelines.clear();
 }
 
 struct CachedPipeline
@@ -264,44 +279,194 @@ void VulkanPipelineStableCache::LoadPipelineFromCache(std::span<uint8> fileData)
 			return;
 		}
 	}
-	// create temporary renderpass
 	if (!pixelShader)
 	{
 		cemu_assert_debug(false);
 		return;
 	}
-	auto renderPass = __CreateTemporaryRenderPass(pixelShader, *lcr);
+	uint64 pipelineStateHash = CompilePipelineForState(vertexShader, geometryShader, pixelShader, *lcr, false);
+	if (pipelineStateHash != 0)
+	{
+		// on success, flag as present in cache
+		m_pipelineIsCachedLock.lock();
+		m_pipelineIsCached.emplace(vertexShader->baseHash, pipelineStateHash);
+		m_pipelineIsCachedLock.unlock();
+		RecordPipelineVariant(vertexShader, pixelShader, *lcr);
+	}
+	// clean up
+	s_spinlockSharedInternal.lock();
+	delete lcr;
+	delete cachedPipeline;
+	s_spinlockSharedInternal.unlock();
+}
+
+// compiles the pipeline for the given shaders and register state with a placeholder renderpass. This populates the driver's pipeline cache, the pipeline object itself is discarded
+// speculative compilations skip pipelines which are already cached or were predicted before
+// returns the pipeline state hash or zero if nothing was compiled
+uint64 VulkanPipelineStableCache::CompilePipelineForState(LatteDecompilerShader* vertexShader, LatteDecompilerShader* geometryShader, LatteDecompilerShader* pixelShader, const LatteContextRegister& lcr, bool isSpeculative)
+{
+	// create temporary renderpass
+	auto renderPass = __CreateTemporaryRenderPass(pixelShader, lcr);
+	uint64 pipelineBaseHash = vertexShader->baseHash;
+	uint64 pipelineStateHash = VulkanRenderer::draw_calculateGraphicsPipelineHash(vertexShader->compatibleFetchShader, vertexShader, geometryShader, pixelShader, renderPass, lcr);
+	if (isSpeculative)
+	{
+		m_pipelineIsCachedLock.lock();
+		bool isKnown = m_pipelineIsCached.find(PipelineHash(pipelineBaseHash, pipelineStateHash)) != m_pipelineIsCached.end();
+		m_pipelineIsCachedLock.unlock();
+		if (!isKnown)
+		{
+			std::unique_lock _l(m_variantPrediction.mutex);
+			isKnown = !m_variantPrediction.compiledPipelines.emplace(pipelineBaseHash, pipelineStateHash).second;
+		}
+		if (isKnown)
+		{
+			VulkanRenderer::GetInstance()->ReleaseDestructibleObject(renderPass);
+			return 0;
+		}
+	}
 	// create pipeline info
 	m_pipelineIsCachedLock.lock();
 	PipelineInfo* pipelineInfo = new PipelineInfo(0, 0, vertexShader->compatibleFetchShader, vertexShader, pixelShader, geometryShader);
 	m_pipelineIsCachedLock.unlock();
 	// compile
+	bool isCompiled = false;
 	{
 		PipelineCompiler pipelineCompiler;
 		bool requiresRobustBufferAccess = PipelineCompiler::CalcRobustBufferAccessRequirement(vertexShader, pixelShader, geometryShader);
-		if (!pipelineCompiler.InitFromCurrentGPUState(pipelineInfo, *lcr, renderPass, requiresRobustBufferAccess))
+		if (pipelineCompiler.InitFromCurrentGPUState(pipelineInfo, lcr, renderPass, requiresRobustBufferAccess))
 		{
-			s_spinlockSharedInternal.lock();
-			delete lcr;
-			delete cachedPipeline;
-			s_spinlockSharedInternal.unlock();
-			return;
+			pipelineCompiler.Compile(true, !isSpeculative, false);
+			isCompiled = true;
 		}
-		pipelineCompiler.Compile(true, true, false);
 	}
-	// on success, calculate pipeline hash and flag as present in cache
-	uint64 pipelineBaseHash = vertexShader->baseHash;
-	uint64 pipelineStateHash = VulkanRenderer::draw_calculateGraphicsPipelineHash(vertexShader->compatibleFetchShader, vertexShader, geometryShader, pixelShader, renderPass, *lcr);
-	m_pipelineIsCachedLock.lock();
-	m_pipelineIsCached.emplace(pipelineBaseHash, pipelineStateHash);
-	m_pipelineIsCachedLock.unlock();
 	// clean up
-	s_spinlockSharedInternal.lock();
+	m_pipelineIsCachedLock.lock();
 	delete pipelineInfo;
-	delete lcr;
-	delete cachedPipeline;
+	m_pipelineIsCachedLock.unlock();
 	VulkanRenderer::GetInstance()->ReleaseDestructibleObject(renderPass);
-	s_spinlockSharedInternal.unlock();
+	return isCompiled ? pipelineStateHash : 0;
+}
+
+// hash of the registers which determine render target formats, blend state and vertex layout
+static uint64 _CalcPipelineVariantKey(const LatteContextRegister& lcr)
+{
+	const uint32* ctxRegister = lcr.GetRawView();
+	uint64 key = 0;
+	auto addRegister = [&](uint32 regIndex)
+	{
+		key = std::rotl<uint64>(key, 7);
+		key += ctxRegister[regIndex] * 0x9E3779B97F4A7C15ull;
+	};
+	for (uint32 i = 0; i < 8; i++)
+	{
+		addRegister(mmCB_COLOR0_INFO + i);
+		addRegister(Latte::REGADDR::CB_BLEND0_CONTROL + i);
+	}
+	addRegister(Latte::REGADDR::CB_COLOR_CONTROL);
+	addRegister(Latte::REGADDR::CB_TARGET_MASK);
+	addRegister(mmDB_DEPTH_INFO);
+	addRegister(Latte::REGADDR::DB_DEPTH_CONTROL);
+	addRegister(Latte::REGADDR::PA_SU_SC_MODE_CNTL);
+	addRegister(Latte::REGADDR::PA_CL_CLIP_CNTL);
+	addRegister(Latte::REGADDR::VGT_PRIMITIVE_TYPE);
+	addRegister(mmVGT_STRMOUT_EN);
+	// vertex buffer strides
+	for (uint32 regIndex = mmSQ_VTX_ATTRIBUTE_BLOCK_START + 2; regIndex < mmSQ_VTX_ATTRIBUTE_BLOCK_END; regIndex += 7)
+		addRegister(regIndex);
+	return key;
+}
+
+void VulkanPipelineStableCache::RecordPipelineVariant(const LatteDecompilerShader* vertexShader, const LatteDecompilerShader* pixelShader, const LatteContextRegister& lcr)
+{
+	if (!vertexShader || !pixelShader)
+		return;
+	uint64 variantKey = _CalcPipelineVariantKey(lcr);
+	std::unique_lock _l(m_variantPrediction.mutex);
+	uint32 stateIndex;
+	auto it = m_variantPrediction.stateIndexByKey.find(variantKey);
+	if (it != m_variantPrediction.stateIndexByKey.end())
+	{
+		stateIndex = it->second;
+	}
+	else
+	{
+		if (m_variantPrediction.states.size() >= VARIANT_MAX_STATES)
+			return;
+		stateIndex = (uint32)m_variantPrediction.states.size();
+		auto& state = m_variantPrediction.states.emplace_back(std::make_unique<Latte::GPUCompactedRegisterState>());
+		Latte::StoreGPURegisterState(lcr, *state);
+		m_variantPrediction.stateIndexByKey.emplace(variantKey, stateIndex);
+	}
+	auto addToShader = [stateIndex](std::vector<uint32>& shaderStates)
+	{
+		if (shaderStates.size() >= VARIANT_MAX_STATES_PER_SHADER)
+			return;
+		if (std::find(shaderStates.begin(), shaderStates.end(), stateIndex) == shaderStates.end())
+			shaderStates.emplace_back(stateIndex);
+	};
+	addToShader(m_variantPrediction.statesPerVertexShader[PipelineHash(vertexShader->baseHash, vertexShader->auxHash)]);
+	addToShader(m_variantPrediction.statesPerPixelShader[PipelineHash(pixelShader->baseHash, pixelShader->auxHash)]);
+}
+
+// called from the render thread when a pipeline is seen for the first time
+void VulkanPipelineStableCache::PredictPipelineVariants(LatteDecompilerShader* vertexShader, LatteDecompilerShader* geometryShader, LatteDecompilerShader* pixelShader, const LatteContextRegister& lcr)
+{
+	if (!vertexShader || !pixelShader)
+		return;
+	uint64 currentVariantKey = _CalcPipelineVariantKey(lcr);
+	std::vector<std::pair<uint32, uint32>> registerOverrides;
+	std::vector<uint32> predictedStates;
+	{
+		std::unique_lock _l(m_variantPrediction.mutex);
+		auto vsIt = m_variantPrediction.statesPerVertexShader.find(PipelineHash(vertexShader->baseHash, vertexShader->auxHash));
+		auto psIt = m_variantPrediction.statesPerPixelShader.find(PipelineHash(pixelShader->baseHash, pixelShader->auxHash));
+		bool isNewVertexShader = vsIt == m_variantPrediction.statesPerVertexShader.end();
+		bool isNewPixelShader = psIt == m_variantPrediction.statesPerPixelShader.end();
+		if (isNewPixelShader && !isNewVertexShader)
+		{
+			// the new pixel shader likely renders with the same targets, blend states and vertex layouts as the other pixel shaders used with this vertex shader
+			predictedStates = vsIt->second;
+		}
+		else if (isNewVertexShader && !isNewPixelShader)
+		{
+			// reuse the output states of the pixel shader. The vertex layout of those states belongs to other vertex shaders, so keep the current one
+			predictedStates = psIt->second;
+			const uint32* ctxRegister = lcr.GetRawView();
+			for (uint32 regIndex = mmSQ_VTX_ATTRIBUTE_BLOCK_START; regIndex < mmSQ_VTX_ATTRIBUTE_BLOCK_END; regIndex++)
+				registerOverrides.emplace_back(regIndex, ctxRegister[regIndex]);
+			registerOverrides.emplace_back(Latte::REGADDR::VGT_PRIMITIVE_TYPE, ctxRegister[Latte::REGADDR::VGT_PRIMITIVE_TYPE]);
+			registerOverrides.emplace_back(mmVGT_STRMOUT_EN, ctxRegister[mmVGT_STRMOUT_EN]);
+		}
+		// skip the state which is currently being compiled anyway
+		auto currentIt = m_variantPrediction.stateIndexByKey.find(currentVariantKey);
+		if (currentIt != m_variantPrediction.stateIndexByKey.end())
+			std::erase(predictedStates, currentIt->second);
+		for (uint32 stateIndex : predictedStates)
+		{
+			if (m_variantPrediction.pendingCompilations >= VARIANT_MAX_PENDING_COMPILATIONS)
+				break;
+			m_variantPrediction.pendingCompilations++;
+			auto registerState = std::make_shared<Latte::GPUCompactedRegisterState>(*m_variantPrediction.states[stateIndex]);
+			PipelineCompiler::CompileThreadPool_QueueSpeculativeJob([this, vertexShader, geometryShader, pixelShader, registerState, registerOverrides]()
+			{
+				CompileSpeculativePipeline(vertexShader, geometryShader, pixelShader, *registerState, registerOverrides);
+				m_variantPrediction.pendingCompilations--;
+			});
+		}
+	}
+	RecordPipelineVariant(vertexShader, pixelShader, lcr);
+}
+
+void VulkanPipelineStableCache::CompileSpeculativePipeline(LatteDecompilerShader* vertexShader, LatteDecompilerShader* geometryShader, LatteDecompilerShader* pixelShader, const Latte::GPUCompactedRegisterState& registerState, const std::vector<std::pair<uint32, uint32>>& registerOverrides)
+{
+	LatteContextRegister* lcr = new LatteContextRegister();
+	Latte::LoadGPURegisterState(*lcr, registerState);
+	uint32* ctxRegister = lcr->GetRawView();
+	for (auto& [regIndex, value] : registerOverrides)
+		ctxRegister[regIndex] = value;
+	CompilePipelineForState(vertexShader, geometryShader, pixelShader, *lcr, true);
+	delete lcr;
 }
 
 bool VulkanPipelineStableCache::HasPipelineCached(uint64 baseHash, uint64 pipelineStateHash)
@@ -314,7 +479,9 @@ ConcurrentQueue<CachedPipeline*> g_pipelineCachingQueue;
 
 void VulkanPipelineStableCache::AddCurrentStateToCache(uint64 baseHash, uint64 pipelineStateHash)
 {
+	m_pipelineIsCachedLock.lock();
 	m_pipelineIsCached.emplace(baseHash, pipelineStateHash);
+	m_pipelineIsCachedLock.unlock();
 	if (!m_pipelineCacheStoreThread)
 	{
 		m_pipelineCacheStoreThread = new std::thread(&VulkanPipelineStableCache::WorkerThread, this);
@@ -337,6 +504,8 @@ void VulkanPipelineStableCache::AddCurrentStateToCache(uint64 baseHash, uint64 p
 	Latte::StoreGPURegisterState(LatteGPUState.contextNew, job->gpuState);
 	// queue job
 	g_pipelineCachingQueue.push(job);
+	// speculatively compile likely variants if one of the shaders is new
+	PredictPipelineVariants(vs, gs, ps, LatteGPUState.contextNew);
 }
 
 bool VulkanPipelineStableCache::SerializePipeline(MemStreamWriter& memWriter, CachedPipeline& cachedPipeline)
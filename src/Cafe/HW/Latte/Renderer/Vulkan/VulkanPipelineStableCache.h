@@ -1,5 +1,6 @@
 #pragma once
 #include "util/helpers/fspinlock.h"
+#include "Cafe/HW/Latte/Common/RegisterSerializer.h"
 
 struct VulkanPipelineHash
 {
@@ -54,11 +55,36 @@ private:
 	int CompilerThread();
 	void WorkerThread();
 
+	uint64 CompilePipelineForState(struct LatteDecompilerShader* vertexShader, struct LatteDecompilerShader* geometryShader, struct LatteDecompilerShader* pixelShader, const struct LatteContextRegister& lcr, bool isSpeculative);
+
+	// pipeline variant prediction
+	// the register states of all known pipelines are indexed by the vertex and pixel shader they were used with
+	// when a new shader shows up together with an already known partner shader, the render target formats, blend states and vertex layouts that co-occurred with the partner are compiled speculatively
+	void RecordPipelineVariant(const struct LatteDecompilerShader* vertexShader, const struct LatteDecompilerShader* pixelShader, const struct LatteContextRegister& lcr);
+	void PredictPipelineVariants(struct LatteDecompilerShader* vertexShader, struct LatteDecompilerShader* geometryShader, struct LatteDecompilerShader* pixelShader, const struct LatteContextRegister& lcr);
+	void CompileSpeculativePipeline(struct LatteDecompilerShader* vertexShader, struct LatteDecompilerShader* geometryShader, struct LatteDecompilerShader* pixelShader, const Latte::GPUCompactedRegisterState& registerState, const std::vector<std::pair<uint32, uint32>>& registerOverrides);
+
+	static constexpr size_t VARIANT_MAX_STATES = 2048; // each state takes ~7KB
+	static constexpr size_t VARIANT_MAX_STATES_PER_SHADER = 16;
+	static constexpr uint32 VARIANT_MAX_PENDING_COMPILATIONS = 32;
+
+	struct
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Latte::GPUCompactedRegisterState>> states;
+		std::unordered_map<uint64, uint32> stateIndexByKey; // key covers only the registers which affect render targets, blending and vertex layout
+		std::unordered_map<PipelineHash, std::vector<uint32>, PipelineHash::HashFunc> statesPerVertexShader;
+		std::unordered_map<PipelineHash, std::vector<uint32>, PipelineHash::HashFunc> statesPerPixelShader;
+		std::unordered_set<PipelineHash, PipelineHash::HashFunc> compiledPipelines;
+		std::atomic_uint32_t pendingCompilations{0};
+	}m_variantPrediction;
+
 	std::thread* m_pipelineCacheStoreThread;
 
 	std::unordered_set<PipelineHash, PipelineHash::HashFunc> m_pipelineIsCached;
 	FSpinlock m_pipelineIsCachedLock;
 	class FileCache* s_cache;
+	class FileCache* m_loadCacheView{}; // read-only mapping of the cache file, only open during loading
 
 	std::atomic_uint32_t m_numCompilationThreads{ 0 };
 	ConcurrentQueue<std::vector<uint8>> m_compilationQueue;
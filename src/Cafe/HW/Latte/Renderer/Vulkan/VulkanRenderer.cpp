@@ -3500,105 +3500,145 @@ void VulkanRenderer::texture_clearDepthSlice(LatteTexture* hostTexture, uint32 s
 
 void VulkanRenderer::texture_loadSlice(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, void* pixelData, sint32 sliceIndex, sint32 mipIndex, uint32 compressedImageSize)
 {
-	auto vkTexture = (LatteTextureVk*)hostTexture;
-	auto vkImageObj = vkTexture->GetImageObj();
-	vkImageObj->flagForCurrentCommandBuffer();
+	uint8* uploadData = texture_reserveSliceUpload(hostTexture, width, height, depth, sliceIndex, mipIndex, compressedImageSize);
+	memcpy(uploadData, pixelData, compressedImageSize);
+	texture_submitSliceUploads();
+}
 
-	draw_endRenderPass();
+uint8* VulkanRenderer::texture_reserveSliceUpload(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, sint32 sliceIndex, sint32 mipIndex, uint32 imageSize)
+{
+	auto vkTexture = (LatteTextureVk*)hostTexture;
 
 	VkMemoryRequirements memRequirements;
-	vkGetImageMemoryRequirements(m_logicalDevice, vkImageObj->m_image, &memRequirements);
-
-	uint32 uploadSize = compressedImageSize;// memRequirements.size;
-	uint32 uploadAlignment = memRequirements.alignment;
-
-	VKRSynchronizedRingAllocator& vkMemAllocator = memoryManager->getStagingAllocator();
-
-	auto uploadResv = vkMemAllocator.AllocateBufferMemory(uploadSize, uploadAlignment);
-	memcpy(uploadResv.memPtr, pixelData, compressedImageSize);
-	vkMemAllocator.FlushReservation(uploadResv);
+	vkGetImageMemoryRequirements(m_logicalDevice, vkTexture->GetImageObj()->m_image, &memRequirements);
 
 	FormatInfoVK texFormatInfo;
 	GetTextureFormatInfoVK(hostTexture->format, hostTexture->isDepth, hostTexture->dim, 0, 0, &texFormatInfo);
+	cemu_assert_debug(texFormatInfo.vkImageAspect == VK_IMAGE_ASPECT_COLOR_BIT || texFormatInfo.vkImageAspect == VK_IMAGE_ASPECT_DEPTH_BIT || texFormatInfo.vkImageAspect == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT));
 
-	bool is3DTexture = hostTexture->Is3DTexture();
-
-	VkImageSubresourceLayers barrierSubresourceRange{};
-	barrierSubresourceRange.aspectMask = texFormatInfo.vkImageAspect;
-	barrierSubresourceRange.mipLevel = mipIndex;
-	barrierSubresourceRange.baseArrayLayer = is3DTexture ? 0 : sliceIndex;
-	barrierSubresourceRange.layerCount = 1;
-	barrier_image<ANY_TRANSFER | IMAGE_READ | IMAGE_WRITE | HOST_WRITE, ANY_TRANSFER>(vkTexture, barrierSubresourceRange, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-	VkBufferImageCopy imageRegion[2]{};
-	sint32 imageRegionCount = 0;
-	if (texFormatInfo.vkImageAspect == VK_IMAGE_ASPECT_COLOR_BIT || texFormatInfo.vkImageAspect == VK_IMAGE_ASPECT_DEPTH_BIT)
-	{
-		imageRegion[0].bufferOffset = uploadResv.bufferOffset;
-		imageRegion[0].imageExtent.width = width;
-		imageRegion[0].imageExtent.height = height;
-		imageRegion[0].imageExtent.depth = 1;
-		imageRegion[0].imageOffset.z = is3DTexture ? sliceIndex : 0;
-
-		imageRegion[0].imageSubresource.mipLevel = mipIndex;
-		imageRegion[0].imageSubresource.aspectMask = texFormatInfo.vkImageAspect;
-		imageRegion[0].imageSubresource.baseArrayLayer = is3DTexture ? 0 : sliceIndex;
-		imageRegion[0].imageSubresource.layerCount = 1;
-		imageRegionCount = 1;
-	}
-	else if (texFormatInfo.vkImageAspect == VK_IMAGE_ASPECT_DEPTH_BIT)
-	{
-		if (is3DTexture)
-			cemu_assert_debug(false);
+	auto& upload = m_sliceUploads.list_pendingUploads.emplace_back();
+	upload.texture = vkTexture;
+	upload.uploadResv = memoryManager->getStagingAllocator().AllocateBufferMemory(imageSize, memRequirements.alignment);
+	upload.aspectMask = texFormatInfo.vkImageAspect;
+	upload.width = width;
+	upload.height = height;
+	upload.sliceIndex = sliceIndex;
+	upload.mipIndex = mipIndex;
+	return upload.uploadResv.memPtr;
+}
 
-		// depth only copy
-		imageRegion[0].bufferOffset = uploadResv.bufferOffset;
-		imageRegion[0].imageExtent.width = width;
-		imageRegion[0].imageExtent.height = height;
-		imageRegion[0].imageExtent.depth = 1;
+void VulkanRenderer::texture_submitSliceUploads()
+{
+	auto& pendingUploads = m_sliceUploads.list_pendingUploads;
+	if (pendingUploads.empty())
+		return;
 
-		imageRegion[0].imageSubresource.mipLevel = mipIndex;
-		imageRegion[0].imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-		imageRegion[0].imageSubresource.baseArrayLayer = sliceIndex;
-		imageRegion[0].imageSubresource.layerCount = 1;
+	draw_endRenderPass();
 
-		imageRegionCount = 1;
-	}
-	else if (texFormatInfo.vkImageAspect == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+	VKRSynchronizedRingAllocator& vkMemAllocator = memoryManager->getStagingAllocator();
+	for (auto& upload : pendingUploads)
 	{
-		if (is3DTexture)
-			cemu_assert_debug(false);
-
-		// depth copy
-		imageRegion[0].bufferOffset = uploadResv.bufferOffset;
-		imageRegion[0].imageExtent.width = width;
-		imageRegion[0].imageExtent.height = height;
-		imageRegion[0].imageExtent.depth = 1;
-
-		imageRegion[0].imageSubresource.mipLevel = mipIndex;
-		imageRegion[0].imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-		imageRegion[0].imageSubresource.baseArrayLayer = sliceIndex;
-		imageRegion[0].imageSubresource.layerCount = 1;
-
-		// stencil copy
-		imageRegion[1].bufferOffset = uploadResv.bufferOffset;
-		imageRegion[1].imageExtent.width = width;
-		imageRegion[1].imageExtent.height = height;
-		imageRegion[1].imageExtent.depth = 1;
-
-		imageRegion[1].imageSubresource.mipLevel = mipIndex;
-		imageRegion[1].imageSubresource.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT;
-		imageRegion[1].imageSubresource.baseArrayLayer = sliceIndex;
-		imageRegion[1].imageSubresource.layerCount = 1;
-
-		imageRegionCount = 2;
+		vkMemAllocator.FlushReservation(upload.uploadResv);
+		upload.texture->GetImageObj()->flagForCurrentCommandBuffer();
 	}
-	else
-		cemu_assert_debug(false);
 
-	vkCmdCopyBufferToImage(m_state.currentCommandBuffer, uploadResv.vkBuffer, vkImageObj->m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, imageRegionCount, imageRegion);
+	// calls func for every destination subresource. All slices of a 3D texture mip share a single subresource
+	auto forEachSubresource = [&](auto&& func)
+	{
+		for (size_t i = 0; i < pendingUploads.size(); i++)
+		{
+			auto& upload = pendingUploads[i];
+			bool is3DTexture = upload.texture->Is3DTexture();
+			if (is3DTexture && i > 0 && pendingUploads[i - 1].texture == upload.texture && pendingUploads[i - 1].mipIndex == upload.mipIndex)
+				continue;
+			VkImageSubresourceRange subresourceRange{};
+			subresourceRange.aspectMask = upload.aspectMask;
+			subresourceRange.baseMipLevel = upload.mipIndex;
+			subresourceRange.levelCount = 1;
+			subresourceRange.baseArrayLayer = is3DTexture ? 0 : upload.sliceIndex;
+			subresourceRange.layerCount = 1;
+			func(upload.texture, subresourceRange);
+		}
+	};
 
-	barrier_image<ANY_TRANSFER, ANY_TRANSFER | IMAGE_READ | IMAGE_WRITE>(vkTexture, barrierSubresourceRange, vkTexture->GetDefaultLayout());
+	// transition all destination subresources with a single barrier
+	auto& barriers = m_sliceUploads.list_barriers;
+	VkPipelineStageFlags srcStages, dstStages;
+	VkAccessFlags srcAccessMask, dstAccessMask;
+	barrier_calcStageAndMask<ANY_TRANSFER | IMAGE_READ | IMAGE_WRITE | HOST_WRITE>(srcStages, srcAccessMask);
+	barrier_calcStageAndMask<ANY_TRANSFER>(dstStages, dstAccessMask);
+	barriers.clear();
+	forEachSubresource([&](LatteTextureVk* vkTexture, VkImageSubresourceRange& subresourceRange)
+	{
+		VkImageMemoryBarrier& imageMemBarrier = barriers.emplace_back();
+		imageMemBarrier = {};
+		imageMemBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imageMemBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageMemBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageMemBarrier.srcAccessMask = srcAccessMask;
+		imageMemBarrier.dstAccessMask = dstAccessMask;
+		imageMemBarrier.image = vkTexture->GetImageObj()->m_image;
+		imageMemBarrier.subresourceRange = subresourceRange;
+		imageMemBarrier.oldLayout = vkTexture->GetImageLayout(subresourceRange);
+		imageMemBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		vkTexture->SetImageLayout(subresourceRange, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	});
+	vkCmdPipelineBarrier(m_state.currentCommandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, (uint32)barriers.size(), barriers.data());
+
+	// consecutive slices of the same texture which are located in the same staging buffer are copied with a single command
+	auto& regions = m_sliceUploads.list_regions;
+	size_t runBegin = 0;
+	while (runBegin < pendingUploads.size())
+	{
+		LatteTextureVk* vkTexture = pendingUploads[runBegin].texture;
+		VkBuffer srcBuffer = pendingUploads[runBegin].uploadResv.vkBuffer;
+		bool is3DTexture = vkTexture->Is3DTexture();
+		regions.clear();
+		size_t runEnd = runBegin;
+		for (; runEnd < pendingUploads.size() && pendingUploads[runEnd].texture == vkTexture && pendingUploads[runEnd].uploadResv.vkBuffer == srcBuffer; runEnd++)
+		{
+			auto& upload = pendingUploads[runEnd];
+			VkBufferImageCopy imageRegion{};
+			imageRegion.bufferOffset = upload.uploadResv.bufferOffset;
+			imageRegion.imageExtent.width = upload.width;
+			imageRegion.imageExtent.height = upload.height;
+			imageRegion.imageExtent.depth = 1;
+			imageRegion.imageOffset.z = is3DTexture ? upload.sliceIndex : 0;
+			imageRegion.imageSubresource.mipLevel = upload.mipIndex;
+			imageRegion.imageSubresource.baseArrayLayer = is3DTexture ? 0 : upload.sliceIndex;
+			imageRegion.imageSubresource.layerCount = 1;
+			if (upload.aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+			{
+				cemu_assert_debug(!is3DTexture);
+				// depth and stencil are copied separately
+				imageRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+				regions.emplace_back(imageRegion);
+				imageRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT;
+			}
+			else
+				imageRegion.imageSubresource.aspectMask = upload.aspectMask;
+			regions.emplace_back(imageRegion);
+		}
+		vkCmdCopyBufferToImage(m_state.currentCommandBuffer, srcBuffer, vkTexture->GetImageObj()->m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32)regions.size(), regions.data());
+		runBegin = runEnd;
+	}
+
+	// transition back to the default layouts
+	barrier_calcStageAndMask<ANY_TRANSFER>(srcStages, srcAccessMask);
+	barrier_calcStageAndMask<ANY_TRANSFER | IMAGE_READ | IMAGE_WRITE>(dstStages, dstAccessMask);
+	size_t barrierIndex = 0;
+	forEachSubresource([&](LatteTextureVk* vkTexture, VkImageSubresourceRange& subresourceRange)
+	{
+		VkImageMemoryBarrier& imageMemBarrier = barriers[barrierIndex++];
+		imageMemBarrier.srcAccessMask = srcAccessMask;
+		imageMemBarrier.dstAccessMask = dstAccessMask;
+		imageMemBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		imageMemBarrier.newLayout = vkTexture->GetDefaultLayout();
+		vkTexture->SetImageLayout(subresourceRange, vkTexture->GetDefaultLayout());
+	});
+	vkCmdPipelineBarrier(m_state.currentCommandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, (uint32)barriers.size(), barriers.data());
+
+	pendingUploads.clear();
 }
 
 LatteTexture* VulkanRenderer::texture_createTextureEx(Latte::E_DIM dim, MPTR physAddress, MPTR physMipAddress, Latte::E_GX2SURFFMT format, uint32 width, uint32 height, uint32 depth, uint32 pitch, uint32 mipLevels,
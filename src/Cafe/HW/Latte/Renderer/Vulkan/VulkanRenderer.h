@@ -300,6 +300,8 @@ public:
 	void texture_clearDepthSlice(LatteTexture* hostTexture, uint32 sliceIndex, sint32 mipIndex, bool clearDepth, bool clearStencil, float depthValue, uint32 stencilValue) override;
 
 	void texture_loadSlice(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, void* pixelData, sint32 sliceIndex, sint32 mipIndex, uint32 compressedImageSize) override;
+	uint8* texture_reserveSliceUpload(LatteTexture* hostTexture, sint32 width, sint32 height, sint32 depth, sint32 sliceIndex, sint32 mipIndex, uint32 imageSize) override;
+	void texture_submitSliceUploads() override;
 
 	LatteTexture* texture_createTextureEx(Latte::E_DIM dim, MPTR physAddress, MPTR physMipAddress, Latte::E_GX2SURFFMT format, uint32 width, uint32 height, uint32 depth, uint32 pitch, uint32 mipLevels, uint32 swizzle, Latte::E_HWTILEMODE tileMode, bool isDepth) override;
 
@@ -374,6 +376,14 @@ private:
 
 		// drawcall state
 		PipelineInfo* activePipelineInfo{ nullptr };
+		// result of the last full pipeline lookup. Reused by the next draw sequence if none of the inputs to the pipeline hash were modified
+		struct
+		{
+			PipelineInfo* pipelineInfo{ nullptr };
+			const LatteFetchShader* fetchShader{ nullptr };
+			uint64 fetchShaderKey{};
+			uint64 renderPassHash{};
+		}lastPipelineLookup;
 		VkDescriptorSetInfo* activeVertexDS{ nullptr };
 		VkDescriptorSetInfo* activePixelDS{ nullptr };
 		VkDescriptorSetInfo* activeGeometryDS{ nullptr };
@@ -534,6 +544,7 @@ private:
 	// drawcall emulation
 	PipelineInfo* draw_createGraphicsPipeline(uint32 indexCount);
 	PipelineInfo* draw_getOrCreateGraphicsPipeline(uint32 indexCount);
+	PipelineInfo* draw_getPipelineForDrawSequence(uint32 indexCount);
 
 	void draw_updateVkBlendConstants();
 	void draw_updateDepthBias(bool forceUpdate);
@@ -715,6 +726,25 @@ private:
 		std::vector<uint16> list_availableQueryIndices;
 	}m_occlusionQueries;
 
+	// texture slices which are decoded directly into the staging buffer and copied to their images by the next texture_submitSliceUploads()
+	struct
+	{
+		struct PendingUpload
+		{
+			LatteTextureVk* texture;
+			VKRSynchronizedRingAllocator::AllocatorReservation_t uploadResv;
+			VkImageAspectFlags aspectMask;
+			sint32 width;
+			sint32 height;
+			sint32 sliceIndex;
+			sint32 mipIndex;
+		};
+		std::vector<PendingUpload> list_pendingUploads;
+		// reused to avoid allocations
+		std::vector<VkImageMemoryBarrier> list_barriers;
+		std::vector<VkBufferImageCopy> list_regions;
+	}m_sliceUploads;
+
 	// barrier
 
 	enum SYNC_OP : uint32
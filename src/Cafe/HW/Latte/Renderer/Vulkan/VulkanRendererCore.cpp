@@ -164,6 +164,8 @@ PipelineInfo* VulkanRenderer::draw_getCachedPipeline()
 
 void VulkanRenderer::unregisterGraphicsPipeline(PipelineInfo* pipelineInfo)
 {
+	if (m_state.lastPipelineLookup.pipelineInfo == pipelineInfo)
+		m_state.lastPipelineLookup.pipelineInfo = nullptr;
 	bool removedFromCache = false;
 	for (auto& topMapItr : m_pipeline_info_cache)
 	{
@@ -295,6 +297,33 @@ PipelineInfo* VulkanRenderer::draw_getOrCreateGraphicsPipeline(uint32 indexCount
 	return draw_createGraphicsPipeline(indexCount);
 }
 
+// same as draw_getOrCreateGraphicsPipeline() but skips the lookup if the active shaders, the render pass and the pipeline related register groups are unchanged since the previous lookup
+PipelineInfo* VulkanRenderer::draw_getPipelineForDrawSequence(uint32 indexCount)
+{
+	constexpr uint32 PIPELINE_REG_GROUPS = LATTE_REG_GROUP_BLEND | LATTE_REG_GROUP_DEPTH | LATTE_REG_GROUP_RASTERIZER | LATTE_REG_GROUP_VERTEX_FETCH;
+	const auto fetchShader = LatteSHRC_GetActiveFetchShader();
+	const uint64 renderPassHash = m_state.activeFBO->GetRenderPassObj()->m_hashForPipeline;
+	auto& lastLookup = m_state.lastPipelineLookup;
+	PipelineInfo* pipelineInfo = lastLookup.pipelineInfo;
+	if (pipelineInfo &&
+		(LatteGPUState.modifiedRegisterGroups & PIPELINE_REG_GROUPS) == 0 &&
+		lastLookup.fetchShader == fetchShader && lastLookup.fetchShaderKey == fetchShader->key &&
+		lastLookup.renderPassHash == renderPassHash &&
+		pipelineInfo->vertexShader == LatteSHRC_GetActiveVertexShader() &&
+		pipelineInfo->geometryShader == LatteSHRC_GetActiveGeometryShader() &&
+		pipelineInfo->pixelShader == LatteSHRC_GetActivePixelShader())
+	{
+		return pipelineInfo;
+	}
+	pipelineInfo = draw_getOrCreateGraphicsPipeline(indexCount);
+	LatteGPUState.modifiedRegisterGroups &= ~PIPELINE_REG_GROUPS;
+	lastLookup.pipelineInfo = pipelineInfo;
+	lastLookup.fetchShader = fetchShader;
+	lastLookup.fetchShaderKey = fetchShader->key;
+	lastLookup.renderPassHash = renderPassHash;
+	return pipelineInfo;
+}
+
 Renderer::IndexAllocation VulkanRenderer::indexData_reserveIndexMemory(uint32 size)
 {
 	VKRSynchronizedHeapAllocator::AllocatorReservation* resv = memoryManager->GetIndexAllocator().AllocateBufferMemory(size, 32);
@@ -1436,7 +1465,7 @@ void VulkanRenderer::draw_execute_first(uint32 baseVertex, uint32 baseInstance,
 		LatteBufferCache_Sync(indexMax + baseVertex, baseInstance, instanceCount, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, stageUniformModifiedMask);
 	}
 
-	PipelineInfo* pipeline_info = draw_getOrCreateGraphicsPipeline(count);
+	PipelineInfo* pipeline_info = draw_getPipelineForDrawSequence(count);
 	m_state.activePipelineInfo = pipeline_info;
 
 	auto vkObjPipeline = pipeline_info->m_vkrObjPipeline;
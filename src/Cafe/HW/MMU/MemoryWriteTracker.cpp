@@ -0,0 +1,376 @@
+#include "Cafe/HW/MMU/MMU.h"
+#include "Cafe/HW/MMU/MemoryWriteTracker.h"
+#include "util/MemMapper/MemMapper.h"
+#include "util/helpers/fspinlock.h"
+
+#if BOOST_OS_WINDOWS
+#include <Windows.h>
+#else
+#include <signal.h>
+#endif
+
+enum class WriteTrackerPageMode : uint8
+{
+	UNWATCHED = 0,
+	WRITABLE = 1, // watched, but not write-protected (written since the last check or inside a host write scope)
+	PROTECTED = 2,
+	TRANSITION = 3, // protection is being changed by another thread
+};
+
+struct WriteTrackerPageState
+{
+	std::atomic<uint64> writeSequence; // sequence number of the most recent write
+	std::atomic<WriteTrackerPageMode> mode;
+	// the following fields are guarded by the lock
+	uint16 hostWriteCount; // number of active host write scopes. The page stays writable while this is non-zero
+	bool isListed; // page is in touchedPages
+};
+
+static struct
+{
+	std::atomic_bool isActive{false};
+	bool isHandlerInstalled{false};
+	// serializes all changes to the page state outside of the fault handler
+	// the fault handler does not take it, it only moves pages from PROTECTED to WRITABLE through the TRANSITION mode
+	FSpinlock lock;
+	WriteTrackerPageState* pageState{nullptr};
+	size_t pageSize{0};
+	uint32 pageShift{0};
+	size_t pageCount{0};
+	std::atomic<uint64> currentSequence{1};
+	std::vector<size_t> touchedPages; // all pages which are watched or had a host write scope, so they can be reset without walking the whole page table
+}s_writeTracker;
+
+static bool MemoryWriteTracker_protectPages(size_t firstPage, size_t count, bool writeProtect)
+{
+	uint8* ptr = memory_base + (firstPage << s_writeTracker.pageShift);
+	return MemMapper::ProtectMemory(ptr, count << s_writeTracker.pageShift, writeProtect ? MemMapper::PAGE_PERMISSION::P_READ : MemMapper::PAGE_PERMISSION::P_RW);
+}
+
+// must be called with the lock held. All pages of the range have to be in TRANSITION mode and are moved to newMode afterwards
+static void MemoryWriteTracker_setPageProtection(size_t firstPage, size_t count, bool writeProtect, WriteTrackerPageMode newMode)
+{
+	if (count == 0)
+		return;
+	if (!MemoryWriteTracker_protectPages(firstPage, count, writeProtect))
+	{
+		cemuLog_log(LogType::Force, "MemoryWriteTracker: Failed to change protection of 0x{:08x} (size 0x{:x})", (uint32)(firstPage << s_writeTracker.pageShift), count << s_writeTracker.pageShift);
+		if (writeProtect)
+			newMode = WriteTrackerPageMode::WRITABLE;
+	}
+	for (size_t p = firstPage; p < firstPage + count; p++)
+		s_writeTracker.pageState[p].mode.store(newMode, std::memory_order_release);
+}
+
+// waits until no other thread is changing the protection of the page
+static WriteTrackerPageMode MemoryWriteTracker_getStablePageMode(WriteTrackerPageState& page)
+{
+	WriteTrackerPageMode mode;
+	while ((mode = page.mode.load(std::memory_order_acquire)) == WriteTrackerPageMode::TRANSITION)
+		_mm_pause();
+	return mode;
+}
+
+// must be called with the lock held
+static void MemoryWriteTracker_listPage(size_t pageIndex)
+{
+	WriteTrackerPageState& page = s_writeTracker.pageState[pageIndex];
+	if (page.isListed)
+		return;
+	page.isListed = true;
+	s_writeTracker.touchedPages.emplace_back(pageIndex);
+}
+
+static void MemoryWriteTracker_getPageRange(const void* ptr, size_t size, size_t& firstPage, size_t& lastPage)
+{
+	cemu_assert_debug(MMU_IsInPPCMemorySpace(ptr));
+	size_t offset = (const uint8*)ptr - memory_base;
+	firstPage = offset >> s_writeTracker.pageShift;
+	lastPage = std::min((offset + size - 1) >> s_writeTracker.pageShift, s_writeTracker.pageCount - 1);
+}
+
+// returns true if the fault was caused by a write to a watched page. Execution can then resume at the faulting instruction
+// this runs inside a signal handler, so it must not take locks, allocate or log
+// the only wait is on pages in TRANSITION mode. Threads which put a page into that mode never access guest memory until they leave it again, so they cannot be the faulting thread
+static bool MemoryWriteTracker_handleFault(const void* faultAddress)
+{
+	if (!s_writeTracker.pageState || !MMU_IsInPPCMemorySpace(faultAddress))
+		return false;
+	size_t pageIndex = ((const uint8*)faultAddress - memory_base) >> s_writeTracker.pageShift;
+	WriteTrackerPageState& page = s_writeTracker.pageState[pageIndex];
+	bool wasWatched = false;
+	while (true)
+	{
+		WriteTrackerPageMode mode = page.mode.load(std::memory_order_acquire);
+		if (mode == WriteTrackerPageMode::UNWATCHED)
+			return wasWatched; // if the page was watched at the time of the fault then it was unprotected by MemoryWriteTracker_Disable() in the meantime
+		wasWatched = true;
+		if (mode == WriteTrackerPageMode::TRANSITION)
+		{
+			_mm_pause();
+			continue;
+		}
+		if (mode == WriteTrackerPageMode::WRITABLE)
+			return true; // another thread handled a fault on the same page in the meantime
+		if (!page.mode.compare_exchange_weak(mode, WriteTrackerPageMode::TRANSITION, std::memory_order_acquire))
+			continue;
+		page.writeSequence.store(s_writeTracker.currentSequence.fetch_add(1) + 1, std::memory_order_relaxed);
+		bool success = MemoryWriteTracker_protectPages(pageIndex, 1, false);
+		page.mode.store(success ? WriteTrackerPageMode::WRITABLE : WriteTrackerPageMode::PROTECTED, std::memory_order_release);
+		return success;
+	}
+}
+
+#if BOOST_OS_WINDOWS
+
+static LONG WINAPI MemoryWriteTracker_exceptionHandler(PEXCEPTION_POINTERS pExceptionInfo)
+{
+	PEXCEPTION_RECORD record = pExceptionInfo->ExceptionRecord;
+	if (record->ExceptionCode != EXCEPTION_ACCESS_VIOLATION || record->NumberParameters < 2)
+		return EXCEPTION_CONTINUE_SEARCH;
+	if (record->ExceptionInformation[0] != 1) // only write accesses
+		return EXCEPTION_CONTINUE_SEARCH;
+	if (!MemoryWriteTracker_handleFault((const void*)record->ExceptionInformation[1]))
+		return EXCEPTION_CONTINUE_SEARCH;
+	return EXCEPTION_CONTINUE_EXECUTION;
+}
+
+static void MemoryWriteTracker_installFaultHandler()
+{
+	// registered as first handler so we run before the crash handler
+	AddVectoredExceptionHandler(1, MemoryWriteTracker_exceptionHandler);
+}
+
+#else
+
+// write faults raise SIGSEGV on Linux and SIGBUS on macOS
+static struct sigaction s_prevActionSIGSEGV;
+static struct sigaction s_prevActionSIGBUS;
+
+static void MemoryWriteTracker_signalHandler(int sig, siginfo_t* info, void* context)
+{
+	if (MemoryWriteTracker_handleFault(info->si_addr))
+		return;
+	// not ours, forward to the previously installed handler (usually the crash handler)
+	const struct sigaction& prevAction = sig == SIGBUS ? s_prevActionSIGBUS : s_prevActionSIGSEGV;
+	if (prevAction.sa_flags & SA_SIGINFO)
+	{
+		prevAction.sa_sigaction(sig, info, context);
+		return;
+	}
+	if (prevAction.sa_handler == SIG_DFL || prevAction.sa_handler == SIG_IGN)
+	{
+		// restore default action, the faulting instruction will be executed again and terminate the process
+		signal(sig, SIG_DFL);
+		return;
+	}
+	prevAction.sa_handler(sig);
+}
+
+static void MemoryWriteTracker_installFaultHandler()
+{
+	struct sigaction action{};
+	action.sa_flags = SA_SIGINFO;
+	sigfillset(&action.sa_mask);
+	action.sa_sigaction = MemoryWriteTracker_signalHandler;
+	sigaction(SIGSEGV, &action, &s_prevActionSIGSEGV);
+	sigaction(SIGBUS, &action, &s_prevActionSIGBUS);
+}
+
+#endif
+
+void MemoryWriteTracker_Enable()
+{
+	if (s_writeTracker.isActive)
+		return;
+	if (!s_writeTracker.pageState)
+	{
+		s_writeTracker.pageSize = MemMapper::GetPageSize();
+		cemu_assert(std::has_single_bit(s_writeTracker.pageSize));
+		s_writeTracker.pageShift = std::countr_zero(s_writeTracker.pageSize);
+		s_writeTracker.pageCount = (size_t)(0x100000000ull >> s_writeTracker.pageShift);
+		// freshly mapped memory is zero-initialized and only committed when touched
+		s_writeTracker.pageState = (WriteTrackerPageState*)MemMapper::AllocateMemory(nullptr, s_writeTracker.pageCount * sizeof(WriteTrackerPageState), MemMapper::PAGE_PERMISSION::P_RW);
+		if (!s_writeTracker.pageState)
+		{
+			cemuLog_log(LogType::Force, "MemoryWriteTracker: Failed to allocate page table. Write tracking is disabled");
+			return;
+		}
+	}
+	if (!s_writeTracker.isHandlerInstalled)
+	{
+		MemoryWriteTracker_installFaultHandler();
+		s_writeTracker.isHandlerInstalled = true;
+	}
+	s_writeTracker.isActive = true;
+	cemuLog_log(LogType::Force, "Page write tracking enabled (page size: 0x{:x})", s_writeTracker.pageSize);
+}
+
+void MemoryWriteTracker_Disable()
+{
+	if (!s_writeTracker.isActive)
+		return;
+	s_writeTracker.isActive = false;
+	s_writeTracker.lock.lock();
+	std::sort(s_writeTracker.touchedPages.begin(), s_writeTracker.touchedPages.end());
+	size_t runBegin = SIZE_MAX;
+	size_t runEnd = 0;
+	for (size_t p : s_writeTracker.touchedPages)
+	{
+		WriteTrackerPageState& page = s_writeTracker.pageState[p];
+		WriteTrackerPageMode mode;
+		do
+		{
+			mode = MemoryWriteTracker_getStablePageMode(page);
+		} while (!page.mode.compare_exchange_weak(mode, WriteTrackerPageMode::TRANSITION, std::memory_order_acquire));
+		if (mode == WriteTrackerPageMode::PROTECTED)
+		{
+			if (runBegin != SIZE_MAX && p != runEnd)
+			{
+				MemoryWriteTracker_setPageProtection(runBegin, runEnd - runBegin, false, WriteTrackerPageMode::UNWATCHED);
+				runBegin = SIZE_MAX;
+			}
+			if (runBegin == SIZE_MAX)
+				runBegin = p;
+			runEnd = p + 1;
+		}
+		else
+			page.mode.store(WriteTrackerPageMode::UNWATCHED, std::memory_order_release);
+		page.writeSequence.store(0, std::memory_order_relaxed);
+		page.hostWriteCount = 0;
+		page.isListed = false;
+	}
+	if (runBegin != SIZE_MAX)
+		MemoryWriteTracker_setPageProtection(runBegin, runEnd - runBegin, false, WriteTrackerPageMode::UNWATCHED);
+	s_writeTracker.touchedPages.clear();
+	s_writeTracker.touchedPages.shrink_to_fit();
+	s_writeTracker.lock.unlock();
+}
+
+bool MemoryWriteTracker_IsActive()
+{
+	return s_writeTracker.isActive.load(std::memory_order_relaxed);
+}
+
+bool MemoryWriteTracker_CheckRange(const void* ptr, size_t size, uint64& sequence, size_t* modifiedBeginOut, size_t* modifiedEndOut)
+{
+	if (!s_writeTracker.isActive || size == 0)
+	{
+		if (modifiedBeginOut)
+			*modifiedBeginOut = 0;
+		if (modifiedEndOut)
+			*modifiedEndOut = size;
+		return true;
+	}
+	size_t firstPage, lastPage;
+	MemoryWriteTracker_getPageRange(ptr, size, firstPage, lastPage);
+	size_t modifiedFirstPage = SIZE_MAX;
+	size_t modifiedLastPage = 0;
+	size_t protectRunBegin = SIZE_MAX;
+	s_writeTracker.lock.lock();
+	// the new sequence has to be read before any page is protected again. Writes which fault after that get a higher sequence number
+	uint64 newSequence = s_writeTracker.currentSequence.load();
+	for (size_t p = firstPage; p <= lastPage; p++)
+	{
+		WriteTrackerPageState& page = s_writeTracker.pageState[p];
+		WriteTrackerPageMode mode = MemoryWriteTracker_getStablePageMode(page);
+		if (mode == WriteTrackerPageMode::UNWATCHED || page.writeSequence.load(std::memory_order_relaxed) > sequence || sequence == 0)
+		{
+			modifiedFirstPage = std::min(modifiedFirstPage, p);
+			modifiedLastPage = p;
+		}
+		if (mode == WriteTrackerPageMode::UNWATCHED)
+		{
+			MemoryWriteTracker_listPage(p);
+			mode = WriteTrackerPageMode::WRITABLE;
+			page.mode.store(mode, std::memory_order_release);
+		}
+		// pages which were written since the last check (or are not watched yet) get write-protected again
+		// the fault handler never changes WRITABLE pages, so no compare-exchange is needed here
+		if (mode == WriteTrackerPageMode::WRITABLE && page.hostWriteCount == 0)
+		{
+			page.mode.store(WriteTrackerPageMode::TRANSITION, std::memory_order_relaxed);
+			if (protectRunBegin == SIZE_MAX)
+				protectRunBegin = p;
+		}
+		else if (protectRunBegin != SIZE_MAX)
+		{
+			MemoryWriteTracker_setPageProtection(protectRunBegin, p - protectRunBegin, true, WriteTrackerPageMode::PROTECTED);
+			protectRunBegin = SIZE_MAX;
+		}
+	}
+	if (protectRunBegin != SIZE_MAX)
+		MemoryWriteTracker_setPageProtection(protectRunBegin, lastPage + 1 - protectRunBegin, true, WriteTrackerPageMode::PROTECTED);
+	s_writeTracker.lock.unlock();
+	sequence = newSequence;
+	if (modifiedFirstPage == SIZE_MAX)
+		return false;
+	if (modifiedBeginOut || modifiedEndOut)
+	{
+		size_t offset = (const uint8*)ptr - memory_base;
+		size_t modifiedBegin = modifiedFirstPage << s_writeTracker.pageShift;
+		size_t modifiedEnd = (modifiedLastPage + 1) << s_writeTracker.pageShift;
+		if (modifiedBeginOut)
+			*modifiedBeginOut = modifiedBegin > offset ? (modifiedBegin - offset) : 0;
+		if (modifiedEndOut)
+			*modifiedEndOut = std::min(modifiedEnd - offset, size);
+	}
+	return true;
+}
+
+void MemoryWriteTracker_BeginHostWrite(const void* ptr, size_t size)
+{
+	if (!s_writeTracker.isActive || size == 0)
+		return;
+	size_t firstPage, lastPage;
+	MemoryWriteTracker_getPageRange(ptr, size, firstPage, lastPage);
+	size_t unprotectRunBegin = SIZE_MAX;
+	s_writeTracker.lock.lock();
+	uint64 writeSequence = s_writeTracker.currentSequence.fetch_add(1) + 1;
+	for (size_t p = firstPage; p <= lastPage; p++)
+	{
+		WriteTrackerPageState& page = s_writeTracker.pageState[p];
+		MemoryWriteTracker_listPage(p);
+		page.hostWriteCount++;
+		page.writeSequence.store(writeSequence, std::memory_order_relaxed);
+		// the fault handler may unprotect the page concurrently
+		WriteTrackerPageMode mode;
+		do
+		{
+			mode = MemoryWriteTracker_getStablePageMode(page);
+		} while (mode == WriteTrackerPageMode::PROTECTED && !page.mode.compare_exchange_weak(mode, WriteTrackerPageMode::TRANSITION, std::memory_order_acquire));
+		if (mode == WriteTrackerPageMode::PROTECTED)
+		{
+			if (unprotectRunBegin == SIZE_MAX)
+				unprotectRunBegin = p;
+		}
+		else if (unprotectRunBegin != SIZE_MAX)
+		{
+			MemoryWriteTracker_setPageProtection(unprotectRunBegin, p - unprotectRunBegin, false, WriteTrackerPageMode::WRITABLE);
+			unprotectRunBegin = SIZE_MAX;
+		}
+	}
+	if (unprotectRunBegin != SIZE_MAX)
+		MemoryWriteTracker_setPageProtection(unprotectRunBegin, lastPage + 1 - unprotectRunBegin, false, WriteTrackerPageMode::WRITABLE);
+	s_writeTracker.lock.unlock();
+}
+
+void MemoryWriteTracker_EndHostWrite(const void* ptr, size_t size)
+{
+	if (!s_writeTracker.isActive || size == 0)
+		return;
+	size_t firstPage, lastPage;
+	MemoryWriteTracker_getPageRange(ptr, size, firstPage, lastPage);
+	s_writeTracker.lock.lock();
+	// consumers which checked the range while the write was in progress may have seen partial data, so the pages are marked as modified again
+	uint64 writeSequence = s_writeTracker.currentSequence.fetch_add(1) + 1;
+	for (size_t p = firstPage; p <= lastPage; p++)
+	{
+		WriteTrackerPageState& page = s_writeTracker.pageState[p];
+		if (page.hostWriteCount == 0)
+			continue; // tracker was re-enabled while the write was in progress
+		page.hostWriteCount--;
+		page.writeSequence.store(writeSequence, std::memory_order_relaxed);
+	}
+	s_writeTracker.lock.unlock();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Optional tracking of CPU writes to guest memory via page protection
+// Consumers (texture cache, buffer cache) watch a range of guest memory and later query whether any of its pages were written since their last check
+// Watched pages are write-protected. The first write to such a page raises an access fault, the fault handler unprotects the page and stamps it with a new write sequence number
+// The granularity is the host page size
+
+void MemoryWriteTracker_Enable();
+void MemoryWriteTracker_Disable(); // unprotects all watched pages. Has to be called before guest memory is unmapped
+bool MemoryWriteTracker_IsActive();
+
+// returns true if any page intersecting the range was written since the check which returned sequence. Always returns true if sequence is zero (first check)
+// afterwards all pages of the range are watched and sequence is updated
+// optionally returns the bounds of the modified area relative to ptr
+bool MemoryWriteTracker_CheckRange(const void* ptr, size_t size, uint64& sequence, size_t* modifiedBeginOut = nullptr, size_t* modifiedEndOut = nullptr);
+
+// writes to guest memory done by the OS (file reads, socket receives) fail with an error instead of raising a fault
+// such calls have to be wrapped in a host write scope, which keeps the pages writable and marks them as modified
+void MemoryWriteTracker_BeginHostWrite(const void* ptr, size_t size);
+void MemoryWriteTracker_EndHostWrite(const void* ptr, size_t size);
+
+class MemoryWriteTrackerHostWriteScope
+{
+public:
+	MemoryWriteTrackerHostWriteScope(const void* ptr, size_t size) : m_ptr(ptr), m_size(size)
+	{
+		MemoryWriteTracker_BeginHostWrite(m_ptr, m_size);
+	}
+
+	~MemoryWriteTrackerHostWriteScope()
+	{
+		MemoryWriteTracker_EndHostWrite(m_ptr, m_size);
+	}
+
+	MemoryWriteTrackerHostWriteScope(const MemoryWriteTrackerHostWriteScope&) = delete;
+	MemoryWriteTrackerHostWriteScope& operator=(const MemoryWriteTrackerHostWriteScope&) = delete;
+
+private:
+	const void* m_ptr;
+	size_t m_size;
+};
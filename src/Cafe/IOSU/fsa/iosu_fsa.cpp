@@ -8,6 +8,7 @@
 #include "Cafe/HW/Latte/Core/LatteBufferCache.h" // also remove this dependency
 
 #include "Cafe/HW/MMU/MMU.h"
+#include "Cafe/HW/MMU/MemoryWriteTracker.h"
 
 using namespace iosu::kernel;
 
@@ -19,10 +20,19 @@ namespace iosu
 		SysAllocator<iosu::kernel::IOSMessage, 352> _m_sFSAIoMsgQueueMsgBuffer;
 		std::thread sFSAIoThread;
 
+		struct FSAPendingRequest
+		{
+			IPCCommandBody* cmd;
+			std::chrono::steady_clock::time_point submitTime;
+		};
+
 		struct FSAClient // IOSU's counterpart to the coreinit FSClient struct
 		{
 			std::string workingDirectory;
 			bool isAllocated{false};
+			// requests which were received but not yet processed. Protected by sFSARequestMutex
+			std::deque<FSAPendingRequest> pendingRequests;
+			bool isScheduled{false}; // set while the client is in the ready list or one of its requests is being processed
 
 			void AllocateAndInitialize()
 			{
@@ -38,6 +48,26 @@ namespace iosu
 
 		std::array<FSAClient, 624> sFSAClientArray;
 
+		// requests are processed on a pool of worker threads while sFSAIoThread only receives and dispatches them
+		// the requests of a single client are processed one at a time and in the order they were received, which also keeps the order of operations on the files it opened
+		// requests of different clients can run concurrently
+		std::mutex sFSARequestMutex;
+		std::condition_variable sFSARequestCV;
+		std::deque<FSAClient*> sFSAReadyClients; // clients with pending requests which are not currently processed by any worker
+		std::vector<std::thread> sFSAWorkerThreads;
+		bool sFSAWorkerStop{false};
+
+		// per-operation latency from receiving a request until the reply is sent, in power-of-two microsecond buckets
+		constexpr size_t FSA_LATENCY_BUCKET_COUNT = 24;
+
+		struct FSARequestLatencyHistogram
+		{
+			std::atomic<uint64> bucket[FSA_LATENCY_BUCKET_COUNT]{};
+		};
+
+		std::array<FSARequestLatencyHistogram, 0x20> sFSARequestLatency; // indexed by FSA_CMD_OPERATION_TYPE
+
+		// sFSARequestMutex must be held
 		IOS_ERROR FSAAllocateClient(sint32& indexOut)
 		{
 			for (size_t i = 0; i < sFSAClientArray.size(); i++)
@@ -168,17 +198,47 @@ namespace iosu
 			return fsc_open(translatedPath.c_str(), accessFlags, &fscStatus);
 		}
 
+		// an open file or directory. Handles are global and can be used by any client, so operations on the same node are serialized through its mutex
+		struct _FSANode
+		{
+			std::mutex mutex;
+			FSCVirtualFile* fscFile; // set to nullptr once the node is closed
+		};
+
+		// keeps a node alive and locked for the duration of an operation
+		class _FSALockedNode {
+		public:
+			_FSALockedNode() = default;
+			_FSALockedNode(std::shared_ptr<_FSANode> node) : m_node(std::move(node)), m_lock(m_node->mutex) {}
+
+			FSCVirtualFile* GetFile() const
+			{
+				return m_node ? m_node->fscFile : nullptr;
+			}
+
+			// the caller closes the file
+			void MarkClosed()
+			{
+				m_node->fscFile = nullptr;
+			}
+
+		private:
+			std::shared_ptr<_FSANode> m_node;
+			std::unique_lock<std::mutex> m_lock;
+		};
+
 		class _FSAHandleTable {
 			struct _FSAHandleResource
 			{
 				bool isAllocated{false};
-				FSCVirtualFile* fscFile;
+				std::shared_ptr<_FSANode> node;
 				uint16 handleCheckValue;
 			};
 
 		public:
 			FSA_RESULT AllocateHandle(FSResHandle& handleOut, FSCVirtualFile* fscFile)
 			{
+				std::unique_lock _l(m_mutex);
 				for (size_t i = 0; i < m_handleTable.size(); i++)
 				{
 					auto& it = m_handleTable.at(i);
@@ -187,7 +247,8 @@ namespace iosu
 					uint16 checkValue = (uint16)m_currentCounter;
 					m_currentCounter++;
 					it.handleCheckValue = checkValue;
-					it.fscFile = fscFile;
+					it.node = std::make_shared<_FSANode>();
+					it.node->fscFile = fscFile;
 					it.isAllocated = true;
 					uint32 handleVal = ((uint32)i << 16) | (uint32)checkValue;
 					handleOut = (FSResHandle)handleVal;
@@ -199,21 +260,36 @@ namespace iosu
 
 			FSA_RESULT ReleaseHandle(FSResHandle handle)
 			{
-				uint16 index = (uint16)((uint32)handle >> 16);
-				uint16 checkValue = (uint16)(handle & 0xFFFF);
-				if (index >= m_handleTable.size())
-					return FSA_RESULT::INVALID_FILE_HANDLE;
-				auto& it = m_handleTable.at(index);
-				if (!it.isAllocated)
-					return FSA_RESULT::INVALID_FILE_HANDLE;
-				if (it.handleCheckValue != checkValue)
+				std::unique_lock _l(m_mutex);
+				_FSAHandleResource* it = FindResource(handle);
+				if (!it)
 					return FSA_RESULT::INVALID_FILE_HANDLE;
-				it.fscFile = nullptr;
-				it.isAllocated = false;
+				it->node.reset(); // the node stays alive until the last operation holding it finishes
+				it->isAllocated = false;
 				return FSA_RESULT::OK;
 			}
 
-			FSCVirtualFile* GetByHandle(FSResHandle handle)
+			// blocks until other operations on the same node are done. Returns an empty lock if the handle is invalid or the node was closed in the meantime
+			_FSALockedNode LockByHandle(FSResHandle handle)
+			{
+				std::shared_ptr<_FSANode> node;
+				{
+					std::unique_lock _l(m_mutex);
+					_FSAHandleResource* it = FindResource(handle);
+					if (!it)
+						return {};
+					node = it->node;
+				}
+				// the table lock is not held while waiting for the node
+				_FSALockedNode lockedNode(std::move(node));
+				if (!lockedNode.GetFile())
+					return {};
+				return lockedNode;
+			}
+
+		private:
+			// m_mutex must be held
+			_FSAHandleResource* FindResource(FSResHandle handle)
 			{
 				uint16 index = (uint16)((uint32)handle >> 16);
 				uint16 checkValue = (uint16)(handle & 0xFFFF);
@@ -224,10 +300,10 @@ namespace iosu
 					return nullptr;
 				if (it.handleCheckValue != checkValue)
 					return nullptr;
-				return it.fscFile;
+				return &it;
 			}
 
-		private:
+			std::mutex m_mutex; // handles are shared by all clients, which may be processed on different worker threads
 			uint32 m_currentCounter = 1;
 			std::array<_FSAHandleResource, 0x3C0> m_handleTable;
 		};
@@ -330,7 +406,8 @@ namespace iosu
 		FSA_RESULT __FSACloseFile(uint32 fileHandle)
 		{
 			uint8 handleType = 0;
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 			{
 				cemuLog_logDebug(LogType::Force, "__FSACloseFile(): Invalid handle (0x{:08x})", fileHandle);
@@ -338,6 +415,7 @@ namespace iosu
 			}
 			// unregister file
 			sFileHandleTable.ReleaseHandle(fileHandle); // todo - use the error code of this
+			fileLock.MarkClosed();
 			fsc_close(fscFile);
 			return FSA_RESULT::OK;
 		}
@@ -445,7 +523,8 @@ namespace iosu
 		{
 			FSFileHandle2 fileHandle = shimBuffer->request.cmdGetStatFile.fileHandle;
 			FSStat_t* statOut = &shimBuffer->response.cmdStatFile.statOut;
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::NOT_FOUND;
 			cemu_assert_debug(fsc_isFile(fscFile));
@@ -460,7 +539,8 @@ namespace iosu
 			uint32 fileHandle = shimBuffer->request.cmdReadFile.fileHandle;
 			uint32 flags = shimBuffer->request.cmdReadFile.flag;
 
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 
@@ -469,7 +549,12 @@ namespace iosu
 			if ((flags & FSA_CMD_FLAG_SET_POS) != 0)
 				fsc_setFileSeek(fscFile, filePos);
 			// todo: File permissions
-			uint32 bytesSuccessfullyRead = fsc_readFile(fscFile, destPtr, bytesToRead);
+			uint32 bytesSuccessfullyRead;
+			{
+				// host file reads write directly into guest memory
+				MemoryWriteTrackerHostWriteScope hostWriteScope(destPtr.GetPtr(), bytesToRead);
+				bytesSuccessfullyRead = fsc_readFile(fscFile, destPtr, bytesToRead);
+			}
 			if (transferElementSize == 0)
 				return FSA_RESULT::OK;
 
@@ -485,7 +570,8 @@ namespace iosu
 			uint32 fileHandle = shimBuffer->request.cmdWriteFile.fileHandle;
 			uint32 flags = shimBuffer->request.cmdWriteFile.flag;
 
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 			cemu_assert_debug((transferSize % transferElementSize) == 0);
@@ -508,7 +594,8 @@ namespace iosu
 		{
 			uint32 fileHandle = shimBuffer->request.cmdSetPosFile.fileHandle;
 			uint32 filePos = shimBuffer->request.cmdSetPosFile.filePos;
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 			fsc_setFileSeek(fscFile, filePos);
@@ -518,7 +605,8 @@ namespace iosu
 		FSA_RESULT FSAProcessCmd_getPos(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
 			uint32 fileHandle = shimBuffer->request.cmdGetPosFile.fileHandle;
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 			uint32 filePos = fsc_getFileSeek(fscFile);
@@ -549,7 +637,8 @@ namespace iosu
 
 		FSA_RESULT FSAProcessCmd_readDir(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
-			FSCVirtualFile* fscFile = sDirHandleTable.GetByHandle((sint32)shimBuffer->request.cmdReadDir.dirHandle);
+			_FSALockedNode dirLock = sDirHandleTable.LockByHandle((sint32)shimBuffer->request.cmdReadDir.dirHandle);
+			FSCVirtualFile* fscFile = dirLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_DIR_HANDLE;
 			FSDirEntry_t* dirEntryOut = &shimBuffer->response.cmdReadDir.dirEntry;
@@ -575,13 +664,15 @@ namespace iosu
 
 		FSA_RESULT FSAProcessCmd_closeDir(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
-			FSCVirtualFile* fscFile = sDirHandleTable.GetByHandle((sint32)shimBuffer->request.cmdReadDir.dirHandle);
+			_FSALockedNode dirLock = sDirHandleTable.LockByHandle((sint32)shimBuffer->request.cmdReadDir.dirHandle);
+			FSCVirtualFile* fscFile = dirLock.GetFile();
 			if (!fscFile)
 			{
 				cemuLog_logDebug(LogType::Force, "CloseDir: Invalid handle (0x{:08x})", (sint32)shimBuffer->request.cmdReadDir.dirHandle);
 				return FSA_RESULT::INVALID_DIR_HANDLE;
 			}
 			sDirHandleTable.ReleaseHandle(shimBuffer->request.cmdReadDir.dirHandle);
+			dirLock.MarkClosed();
 			fsc_close(fscFile);
 			return FSA_RESULT::OK;
 		}
@@ -593,7 +684,8 @@ namespace iosu
 
 		FSA_RESULT FSAProcessCmd_rewindDir(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
-			FSCVirtualFile* fscFile = sDirHandleTable.GetByHandle((sint32)shimBuffer->request.cmdRewindDir.dirHandle);
+			_FSALockedNode dirLock = sDirHandleTable.LockByHandle((sint32)shimBuffer->request.cmdRewindDir.dirHandle);
+			FSCVirtualFile* fscFile = dirLock.GetFile();
 			if (!fscFile)
 			{
 				cemuLog_logDebug(LogType::Force, "RewindDir: Invalid handle (0x{:08x})", (sint32)shimBuffer->request.cmdRewindDir.dirHandle);
@@ -612,7 +704,8 @@ namespace iosu
 
 		FSA_RESULT FSAProcessCmd_appendFile(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(shimBuffer->request.cmdAppendFile.fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(shimBuffer->request.cmdAppendFile.fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 #ifdef CEMU_DEBUG_ASSERT
@@ -624,7 +717,8 @@ namespace iosu
 		FSA_RESULT FSAProcessCmd_truncateFile(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
 			FSFileHandle2 fileHandle = shimBuffer->request.cmdTruncateFile.fileHandle;
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 			fsc_setFileLength(fscFile, fsc_getFileSeek(fscFile));
@@ -634,7 +728,8 @@ namespace iosu
 		FSA_RESULT FSAProcessCmd_isEof(FSAClient* client, FSAShimBuffer* shimBuffer)
 		{
 			uint32 fileHandle = shimBuffer->request.cmdIsEof.fileHandle;
-			FSCVirtualFile* fscFile = sFileHandleTable.GetByHandle(fileHandle);
+			_FSALockedNode fileLock = sFileHandleTable.LockByHandle(fileHandle);
+			FSCVirtualFile* fscFile = fileLock.GetFile();
 			if (!fscFile)
 				return FSA_RESULT::INVALID_FILE_HANDLE;
 			uint32 filePos = fsc_getFileSeek(fscFile);
@@ -830,22 +925,145 @@ namespace iosu
 			IOS_ResourceReply(cmd, (IOS_ERROR)fsaResult);
 		}
 
+		void FSARecordRequestLatency(FSA_CMD_OPERATION_TYPE operationId, std::chrono::steady_clock::time_point submitTime)
+		{
+			uint32 operationIndex = (uint32)operationId;
+			if (operationIndex >= sFSARequestLatency.size())
+				return;
+			uint64 latencyUs = (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submitTime).count();
+			size_t bucketIndex = std::min<size_t>(std::bit_width(latencyUs), FSA_LATENCY_BUCKET_COUNT - 1);
+			sFSARequestLatency[operationIndex].bucket[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void FSALogRequestLatency()
+		{
+			for (uint32 operationIndex = 0; operationIndex < sFSARequestLatency.size(); operationIndex++)
+			{
+				auto& histogram = sFSARequestLatency[operationIndex];
+				uint64 bucketCount[FSA_LATENCY_BUCKET_COUNT];
+				uint64 totalCount = 0;
+				for (size_t i = 0; i < FSA_LATENCY_BUCKET_COUNT; i++)
+				{
+					bucketCount[i] = histogram.bucket[i].exchange(0, std::memory_order_relaxed);
+					totalCount += bucketCount[i];
+				}
+				if (totalCount == 0)
+					continue;
+				// upper bound of the bucket which contains the given percentile
+				auto getPercentileUs = [&](uint64 percentile) -> uint64 {
+					uint64 threshold = (totalCount * percentile + 99) / 100;
+					uint64 accumulatedCount = 0;
+					for (size_t i = 0; i < FSA_LATENCY_BUCKET_COUNT; i++)
+					{
+						accumulatedCount += bucketCount[i];
+						if (accumulatedCount >= threshold)
+							return 1ull << i;
+					}
+					return 1ull << (FSA_LATENCY_BUCKET_COUNT - 1);
+				};
+				cemuLog_log(LogType::CoreinitFile, "FSA operation 0x{:02x}: {} requests, latency p50 < {}us p90 < {}us p99 < {}us", operationIndex, totalCount, getPercentileUs(50), getPercentileUs(90), getPercentileUs(99));
+			}
+		}
+
+		void FSAProcessRequest(FSAClient* client, IPCCommandBody* cmd, std::chrono::steady_clock::time_point submitTime)
+		{
+			if (cmd->cmdId == IPCCommandId::IOS_CLOSE)
+			{
+				{
+					std::unique_lock _l(sFSARequestMutex);
+					cemu_assert_debug(client->pendingRequests.empty());
+					client->ReleaseAndCleanup();
+				}
+				IOS_ResourceReply(cmd, IOS_ERROR_OK);
+			}
+			else if (cmd->cmdId == IPCCommandId::IOS_IOCTL)
+			{
+				cemu_assert(client->isAllocated);
+				FSA_CMD_OPERATION_TYPE requestId = (FSA_CMD_OPERATION_TYPE)cmd->args[0].value();
+				FSAHandleCommandIoctl(client, cmd, requestId, MEMPTR<void>(cmd->args[1]), MEMPTR<void>(cmd->args[3]));
+				FSARecordRequestLatency(requestId, submitTime);
+			}
+			else if (cmd->cmdId == IPCCommandId::IOS_IOCTLV)
+			{
+				cemu_assert(client->isAllocated);
+				FSA_CMD_OPERATION_TYPE requestId = (FSA_CMD_OPERATION_TYPE)cmd->args[0].value();
+				uint32 numIn = cmd->args[1];
+				uint32 numOut = cmd->args[2];
+				IPCIoctlVector* vec = MEMPTR<IPCIoctlVector>{cmd->args[3]}.GetPtr();
+				FSAHandleCommandIoctlv(client, cmd, requestId, numIn, numOut, vec);
+				FSARecordRequestLatency(requestId, submitTime);
+			}
+			else
+			{
+				cemuLog_log(LogType::Force, "/dev/fsa: Unsupported IPC cmdId");
+				cemu_assert_suspicious();
+				IOS_ResourceReply(cmd, IOS_ERROR_INVALID);
+			}
+		}
+
+		void FSAWorkerThread()
+		{
+			SetThreadName("IOSU-FSA-Worker");
+			std::unique_lock _l(sFSARequestMutex);
+			while (true)
+			{
+				sFSARequestCV.wait(_l, [] { return sFSAWorkerStop || !sFSAReadyClients.empty(); });
+				if (sFSAReadyClients.empty())
+					return; // shutdown signaled and all requests were processed
+				FSAClient* client = sFSAReadyClients.front();
+				sFSAReadyClients.pop_front();
+				cemu_assert_debug(client->isScheduled && !client->pendingRequests.empty());
+				FSAPendingRequest request = client->pendingRequests.front();
+				client->pendingRequests.pop_front();
+				_l.unlock();
+				FSAProcessRequest(client, request.cmd, request.submitTime);
+				_l.lock();
+				if (client->pendingRequests.empty())
+				{
+					client->isScheduled = false;
+					continue;
+				}
+				// requeue at the end so other clients get a turn
+				sFSAReadyClients.emplace_back(client);
+				sFSARequestCV.notify_one();
+			}
+		}
+
+		void FSASubmitRequest(FSAClient* client, IPCCommandBody* cmd)
+		{
+			std::unique_lock _l(sFSARequestMutex);
+			client->pendingRequests.push_back({cmd, std::chrono::steady_clock::now()});
+			if (client->isScheduled)
+				return; // the next request is picked up once the current one is done
+			client->isScheduled = true;
+			sFSAReadyClients.emplace_back(client);
+			sFSARequestCV.notify_one();
+		}
+
 		void FSAIoThread()
 		{
 			SetThreadName("IOSU-FSA");
+			// requests mostly wait on host file IO, so a few workers are enough to keep independent clients from blocking each other
+			uint32 workerCount = std::clamp(std::thread::hardware_concurrency() / 2, 2u, 4u);
+			sFSAWorkerStop = false;
+			for (uint32 i = 0; i < workerCount; i++)
+				sFSAWorkerThreads.emplace_back(FSAWorkerThread);
 			IOSMessage msg;
 			while (true)
 			{
 				IOS_ERROR r = IOS_ReceiveMessage(sFSAIoMsgQueue, &msg, 0);
 				cemu_assert(!IOS_ResultIsError(r));
 				if (msg == 0)
-					return; // shutdown signaled
+					break; // shutdown signaled
 				IPCCommandBody* cmd = MEMPTR<IPCCommandBody>(msg).GetPtr();
 				uint32 clientHandle = (uint32)cmd->devHandle;
 				if (cmd->cmdId == IPCCommandId::IOS_OPEN)
 				{
 					sint32 clientIndex = 0;
-					r = FSAAllocateClient(clientIndex);
+					{
+						std::unique_lock _l(sFSARequestMutex);
+						r = FSAAllocateClient(clientIndex);
+					}
 					if (r != IOS_ERROR_OK)
 					{
 						IOS_ResourceReply(cmd, r);
@@ -854,42 +1072,30 @@ namespace iosu
 					IOS_ResourceReply(cmd, (IOS_ERROR)clientIndex);
 					continue;
 				}
-				else if (cmd->cmdId == IPCCommandId::IOS_CLOSE)
-				{
-					cemu_assert(clientHandle < sFSAClientArray.size());
-					sFSAClientArray[clientHandle].ReleaseAndCleanup();
-					IOS_ResourceReply(cmd, IOS_ERROR_OK);
-					continue;
-				}
-				else if (cmd->cmdId == IPCCommandId::IOS_IOCTL)
-				{
-					cemu_assert(clientHandle < sFSAClientArray.size());
-					cemu_assert(sFSAClientArray[clientHandle].isAllocated);
-					FSAHandleCommandIoctl(sFSAClientArray.data() + clientHandle, cmd, (FSA_CMD_OPERATION_TYPE)cmd->args[0].value(), MEMPTR<void>(cmd->args[1]), MEMPTR<void>(cmd->args[3]));
-				}
-				else if (cmd->cmdId == IPCCommandId::IOS_IOCTLV)
-				{
-					cemu_assert(clientHandle < sFSAClientArray.size());
-					cemu_assert(sFSAClientArray[clientHandle].isAllocated);
-					FSA_CMD_OPERATION_TYPE requestId = (FSA_CMD_OPERATION_TYPE)cmd->args[0].value();
-					uint32 numIn = cmd->args[1];
-					uint32 numOut = cmd->args[2];
-					IPCIoctlVector* vec = MEMPTR<IPCIoctlVector>{cmd->args[3]}.GetPtr();
-					FSAHandleCommandIoctlv(sFSAClientArray.data() + clientHandle, cmd, requestId, numIn, numOut, vec);
-				}
-				else
-				{
-					cemuLog_log(LogType::Force, "/dev/fsa: Unsupported IPC cmdId");
-					cemu_assert_suspicious();
-					IOS_ResourceReply(cmd, IOS_ERROR_INVALID);
-				}
+				cemu_assert(clientHandle < sFSAClientArray.size());
+				FSASubmitRequest(sFSAClientArray.data() + clientHandle, cmd);
+			}
+			// let the workers finish all queued requests
+			{
+				std::unique_lock _l(sFSARequestMutex);
+				sFSAWorkerStop = true;
 			}
+			sFSARequestCV.notify_all();
+			for (auto& it : sFSAWorkerThreads)
+				it.join();
+			sFSAWorkerThreads.clear();
+			FSALogRequestLatency();
 		}
 
 		void Initialize()
 		{
 			for (auto& it : sFSAClientArray)
+			{
 				it.ReleaseAndCleanup();
+				it.pendingRequests.clear();
+				it.isScheduled = false;
+			}
+			sFSAReadyClients.clear();
 			sFSAIoMsgQueue = (IOSMsgQueueId)IOS_CreateMessageQueue(_m_sFSAIoMsgQueueMsgBuffer.GetPtr(), _m_sFSAIoMsgQueueMsgBuffer.GetCount());
 			IOS_ERROR r = IOS_RegisterResourceManager("/dev/fsa", sFSAIoMsgQueue);
 			IOS_DeviceAssociateId("/dev/fsa", 11);
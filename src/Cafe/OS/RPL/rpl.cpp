@@ -11,6 +11,10 @@
 #include "util/ChunkedHeap/ChunkedHeap.h"
 
 #include "util/crypto/crc32.h"
+#include "util/helpers/Serializer.h"
+#include "Cemu/FileCache/FileCache.h"
+#include "util/ThreadPool/ThreadPool.h"
+#include "util/highresolutiontimer/HighResolutionTimer.h"
 #include "config/ActiveSettings.h"
 #include "Cafe/OS/libs/coreinit/coreinit_DynLoad.h"
 #include "COSModule.h"
@@ -328,6 +332,27 @@ public:
 	std::vector<uint8> sectionData;
 };
 
+// decompress the zlib stream of a compressed section. The output buffer must match the uncompressed size exactly
+// the stream is decoded with a single Z_FINISH call, which allows zlib to write directly to the output without maintaining a sliding window
+bool RPLLoader_InflateSectionData(const uint8* compressedData, uint32 compressedSize, uint8* dataOut, uint32 uncompressedSize)
+{
+	z_stream strm{};
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	if (inflateInit(&strm) != Z_OK)
+		return false;
+	strm.avail_in = compressedSize;
+	strm.next_in = (Bytef*)compressedData;
+	strm.avail_out = uncompressedSize;
+	strm.next_out = dataOut;
+	int ret = inflate(&strm, Z_FINISH);
+	inflateEnd(&strm);
+	if (ret != Z_STREAM_END && ret != Z_OK && ret != Z_BUF_ERROR)
+		return false;
+	return strm.avail_in == 0 && strm.avail_out == 0;
+}
+
 rplSectionEntryNew_t* RPLLoader_GetSection(RPLModule* rplLoaderContext, sint32 sectionIndex)
 {
 	sint32 sectionCount = rplLoaderContext->rplHeader.sectionTableEntryCount;
@@ -385,28 +410,13 @@ RPLUncompressedSection* RPLLoader_LoadUncompressedSection(RPLModule* rplLoaderCo
 			delete uSection;
 			return nullptr;
 		}
-		int ret;
-		z_stream strm;
-		strm.zalloc = Z_NULL;
-		strm.zfree = Z_NULL;
-		strm.opaque = Z_NULL;
-		ret = inflateInit(&strm);
-		if (ret == Z_OK)
+		uSection->sectionData.resize(uncompressedSize);
+		if (!RPLLoader_InflateSectionData(rplLoaderContext->RPLRawData.data() + (uint32)section->fileOffset + 4, (uint32)section->sectionSize - 4, uSection->sectionData.data(), uncompressedSize))
 		{
-			strm.avail_in = (uint32)section->sectionSize - 4;
-			strm.next_in = rplLoaderContext->RPLRawData.data() + (uint32)section->fileOffset + 4;
-			strm.avail_out = uncompressedSize;
-			uSection->sectionData.resize(uncompressedSize);
-			strm.next_out = uSection->sectionData.data();
-			ret = inflate(&strm, Z_FULL_FLUSH);
-			inflateEnd(&strm);
-			if ((ret != Z_OK && ret != Z_STREAM_END) || strm.avail_in != 0 || strm.avail_out != 0)
-			{
-				cemuLog_log(LogType::Force, "RPLLoader: Error while inflating data for section {}", sectionIndex);
-				rplLoaderContext->hasError = true;
-				delete uSection;
-				return nullptr;
-			}
+			cemuLog_log(LogType::Force, "RPLLoader: Error while inflating data for section {}", sectionIndex);
+			rplLoaderContext->hasError = true;
+			delete uSection;
+			return nullptr;
 		}
 	}
 	else
@@ -419,7 +429,46 @@ RPLUncompressedSection* RPLLoader_LoadUncompressedSection(RPLModule* rplLoaderCo
 	return uSection;
 }
 
-bool RPLLoader_LoadSingleSection(RPLModule* rplLoaderContext, sint32 sectionIndex, RPLMappingRegion* regionMappingInfo, MPTR mappedAddress)
+// decompress all compressed sections which are mapped into memory on the thread pool
+// returns a list indexed by section. Entries are null for sections which are not compressed, or which failed to decompress. Those are handled by RPLLoader_LoadUncompressedSection, which also reports any errors
+std::vector<RPLUncompressedSection*> RPLLoader_InflateMappedSections(RPLModule* rplLoaderContext)
+{
+	sint32 sectionCount = rplLoaderContext->rplHeader.sectionTableEntryCount;
+	std::vector<RPLUncompressedSection*> inflatedSections(sectionCount, nullptr);
+	ThreadPool::TaskGroup taskGroup;
+	for (sint32 i = 0; i < sectionCount; i++)
+	{
+		rplSectionEntryNew_t* section = rplLoaderContext->sectionTablePtr + i;
+		uint32 sectionFlags = section->flags;
+		uint32 compressedSize = section->sectionSize;
+		if ((sectionFlags & 2) == 0 || (sectionFlags & SHF_RPL_COMPRESSED) == 0 || (uint32)section->type == 0x8)
+			continue;
+		if (compressedSize < sizeof(uint32be) || rplLoaderContext->sectionAddressTable2[i].ptr != nullptr)
+			continue;
+		if (!RPLLoader_CheckBounds(rplLoaderContext, section->fileOffset, compressedSize))
+			continue;
+		const uint8* compressedData = rplLoaderContext->RPLRawData.data() + (uint32)section->fileOffset;
+		uint32 uncompressedSize = *(uint32be*)compressedData;
+		if (uncompressedSize >= 1*1024*1024*1024)
+			continue;
+		taskGroup.Run([&inflatedSection = inflatedSections[i], compressedData, compressedSize, uncompressedSize]()
+		{
+			RPLUncompressedSection* uSection = new RPLUncompressedSection();
+			uSection->sectionData.resize(uncompressedSize);
+			if (!RPLLoader_InflateSectionData(compressedData + 4, compressedSize - 4, uSection->sectionData.data(), uncompressedSize))
+			{
+				delete uSection;
+				return;
+			}
+			inflatedSection = uSection;
+		}, ThreadPool::Priority::High);
+	}
+	taskGroup.Wait();
+	return inflatedSections;
+}
+
+// if inflatedSection is set it is used instead of reading the section from the RPL file. Takes ownership of it
+bool RPLLoader_LoadSingleSection(RPLModule* rplLoaderContext, sint32 sectionIndex, RPLMappingRegion* regionMappingInfo, MPTR mappedAddress, RPLUncompressedSection* inflatedSection = nullptr)
 {
 	rplSectionEntryNew_t* section = RPLLoader_GetSection(rplLoaderContext, sectionIndex);
 	if (section == nullptr)
@@ -436,7 +485,7 @@ bool RPLLoader_LoadSingleSection(RPLModule* rplLoaderContext, sint32 sectionInde
 	rplLoaderContext->debugSectionLoadMask[sectionIndex] = true;
 
 	// extract section
-	RPLUncompressedSection* uncompressedSection = RPLLoader_LoadUncompressedSection(rplLoaderContext, sectionIndex);
+	RPLUncompressedSection* uncompressedSection = inflatedSection ? inflatedSection : RPLLoader_LoadUncompressedSection(rplLoaderContext, sectionIndex);
 	if (uncompressedSection == nullptr)
 	{
 		rplLoaderContext->hasError = true;
@@ -543,6 +592,14 @@ bool RPLLoader_LoadSections(sint32 aProcId, RPLModule* rplLoaderContext)
 	rplLoaderContext->regionOrigAddr_text = regionMappingTable.region[RPL_MAPPING_REGION_TEXT].baseAddress;
 	rplLoaderContext->regionOrigAddr_data = regionMappingTable.region[RPL_MAPPING_REGION_DATA].baseAddress;
 
+	// decompress sections in parallel ahead of mapping them
+	BenchmarkTimer inflateTimer;
+	inflateTimer.Start();
+	std::vector<RPLUncompressedSection*> inflatedSections = RPLLoader_InflateMappedSections(rplLoaderContext);
+	inflateTimer.Stop();
+	BenchmarkTimer mapTimer;
+	mapTimer.Start();
+
 	// load data sections
 	for (sint32 i = 0; i < (sint32)rplLoaderContext->rplHeader.sectionTableEntryCount; i++)
 	{
@@ -558,7 +615,7 @@ bool RPLLoader_LoadSections(sint32 aProcId, RPLModule* rplLoaderContext)
 		if ((sectionFlags & 1) == 0)
 			continue;
 
-		RPLLoader_LoadSingleSection(rplLoaderContext, i, regionMappingTable.region + RPL_MAPPING_REGION_DATA, rplLoaderContext->regionMappingBase_data);
+		RPLLoader_LoadSingleSection(rplLoaderContext, i, regionMappingTable.region + RPL_MAPPING_REGION_DATA, rplLoaderContext->regionMappingBase_data, std::exchange(inflatedSections[i], nullptr));
 	}
 	// load loaderinfo sections
 	for (sint32 i = 0; i < (sint32)rplLoaderContext->rplHeader.sectionTableEntryCount; i++)
@@ -576,7 +633,7 @@ bool RPLLoader_LoadSections(sint32 aProcId, RPLModule* rplLoaderContext)
 			continue;
 		bool readRaw = false;
 
-		RPLLoader_LoadSingleSection(rplLoaderContext, i, regionMappingTable.region + RPL_MAPPING_REGION_LOADERINFO, rplLoaderContext->regionMappingBase_loaderInfo);
+		RPLLoader_LoadSingleSection(rplLoaderContext, i, regionMappingTable.region + RPL_MAPPING_REGION_LOADERINFO, rplLoaderContext->regionMappingBase_loaderInfo, std::exchange(inflatedSections[i], nullptr));
 
 		if (sectionType == SHT_RPL_EXPORTS)
 		{
@@ -617,8 +674,16 @@ bool RPLLoader_LoadSections(sint32 aProcId, RPLModule* rplLoaderContext)
 			cemu_assert_debug(false);
 		}
 
-		RPLLoader_LoadSingleSection(rplLoaderContext, i, regionMappingTable.region + RPL_MAPPING_REGION_TEXT, textSectionMappedBase);
+		RPLLoader_LoadSingleSection(rplLoaderContext, i, regionMappingTable.region + RPL_MAPPING_REGION_TEXT, textSectionMappedBase, std::exchange(inflatedSections[i], nullptr));
+	}
+	// all mapped sections should have been consumed
+	for (auto& itr : inflatedSections)
+	{
+		cemu_assert_debug(itr == nullptr);
+		delete itr;
 	}
+	mapTimer.Stop();
+	cemuLog_logDebug(LogType::Force, "RPLLoader: {} - Decompressed sections in {:.2f}ms, mapped sections in {:.2f}ms", rplLoaderContext->moduleName, inflateTimer.GetElapsedMilliseconds(), mapTimer.GetElapsedMilliseconds());
 	// load temp region sections
 	uint32 tempRegionSize = regionMappingTable.region[RPL_MAPPING_REGION_TEMP].endAddress - regionMappingTable.region[RPL_MAPPING_REGION_TEMP].baseAddress;
 	uint8* tempRegionPtr;
@@ -689,14 +754,15 @@ struct RPLSharedImportTracking
 
 static_assert(sizeof(RPLFileSymtabEntry) == 0x10, "rplSymtabEntry_t has invalid size");
 
-typedef struct
+struct MappedFunctionImportKeyHash
 {
-	uint64 hash1;
-	uint64 hash2;
-	uint32 address;
-}mappedFunctionImport_t;
+	size_t operator()(const std::pair<uint64, uint64>& key) const
+	{
+		return (size_t)(key.first ^ std::rotl<uint64>(key.second, 17));
+	}
+};
 
-std::vector<mappedFunctionImport_t> list_mappedFunctionImports = std::vector<mappedFunctionImport_t>();
+std::unordered_map<std::pair<uint64, uint64>, uint32, MappedFunctionImportKeyHash> map_mappedFunctionImports; // (hash1, hash2) of rpl + function name -> HLE stub address
 
 void _calculateMappedImportNameHash(const char* rplName, const char* funcName, uint64* h1Out, uint64* h2Out)
 {
@@ -747,13 +813,9 @@ uint32 rpl_mapHLEImport(RPLModule* rplLoaderContext, const char* rplName, const
 	uint64 mappedImportHash2;
 	_calculateMappedImportNameHash(rplName, funcName, &mappedImportHash1, &mappedImportHash2);
 	// find already mapped name
-	for (auto& importItr : list_mappedFunctionImports)
-	{
-		if (importItr.hash1 == mappedImportHash1 && importItr.hash2 == mappedImportHash2)
-		{
-			return importItr.address;
-		}
-	}
+	auto importItr = map_mappedFunctionImports.find({ mappedImportHash1, mappedImportHash2 });
+	if (importItr != map_mappedFunctionImports.end())
+		return importItr->second;
 	// copy lib file name and cut off .rpl from libName if present
 	char libName[512];
 	strcpy_s(libName, rplName);
@@ -775,11 +837,7 @@ uint32 rpl_mapHLEImport(RPLModule* rplLoaderContext, const char* rplName, const
 		uint32 opcode = (1 << 26) | functionIndex;
 		memory_write<uint32>(codeAddr, opcode);
 		// register mapped import
-		mappedFunctionImport_t newImport;
-		newImport.hash1 = mappedImportHash1;
-		newImport.hash2 = mappedImportHash2;
-		newImport.address = codeAddr;
-		list_mappedFunctionImports.push_back(newImport);
+		map_mappedFunctionImports.try_emplace({ mappedImportHash1, mappedImportHash2 }, codeAddr);
 		// remember in symbol storage for debugger
 		rplSymbolStorage_store(libName, funcName, codeAddr);
 		return codeAddr;
@@ -810,11 +868,7 @@ uint32 rpl_mapHLEImport(RPLModule* rplLoaderContext, const char* rplName, const
 	// align address to 4 byte boundary
 	currentAddress = (currentAddress + 3)&~3;
 	// register mapped import
-	mappedFunctionImport_t newImport;
-	newImport.hash1 = mappedImportHash1;
-	newImport.hash2 = mappedImportHash2;
-	newImport.address = codeStart;
-	list_mappedFunctionImports.push_back(newImport);
+	map_mappedFunctionImports.try_emplace({ mappedImportHash1, mappedImportHash2 }, codeStart);
 	// remember in symbol storage for debugger
 	rplSymbolStorage_store(libName, funcName, codeStart);
 	// return address of code start
@@ -1059,7 +1113,8 @@ bool RPLLoader_FixImportSymbols(RPLModule* rplLoaderContext, sint32 symtabSectio
 	return true;
 }
 
-bool RPLLoader_ApplySingleReloc(RPLModule* rplLoaderContext, uint32 uknR3, uint8* relocTargetSectionAddress, uint32 relocType, bool isSymbolBinding2, uint32 relocOffset, uint32 relocAddend, uint32 symbolAddress, sint16 tlsModuleIndex)
+// if allowTrampolines is false then relocations which need a far jump trampoline are not applied and false is returned instead
+bool RPLLoader_ApplySingleReloc(RPLModule* rplLoaderContext, uint32 uknR3, uint8* relocTargetSectionAddress, uint32 relocType, bool isSymbolBinding2, uint32 relocOffset, uint32 relocAddend, uint32 symbolAddress, sint16 tlsModuleIndex, bool allowTrampolines = true)
 {
 	MPTR relocTargetSectionMPTR = memory_getVirtualOffsetFromPointer(relocTargetSectionAddress);
 	MPTR relocAddrMPTR = relocTargetSectionMPTR + relocOffset;
@@ -1093,6 +1148,8 @@ bool RPLLoader_ApplySingleReloc(RPLModule* rplLoaderContext, uint32 uknR3, uint8
 		if ((jumpDistance>>25) != 0 && (jumpDistance >> 25) != 0x7F)
 		{
 			// can't reach with 24bit jump, use trampoline + absolute branch
+			if (!allowTrampolines)
+				return false;
 			MPTR trampolineAddr = _generateTrampolineFarJump(rplLoaderContext, relocDestAddr);
 			// make absolute branch
 			cemu_assert_debug((opc >> 26) == 18); // should be B/BL instruction
@@ -1231,7 +1288,20 @@ bool RPLLoader_ApplySingleReloc(RPLModule* rplLoaderContext, uint32 uknR3, uint8
 	return true;
 }
 
-bool RPLLoader_ApplyRelocs(RPLModule* rplLoaderContext, sint32 relaSectionIndex, rplSectionEntryNew_t* section, uint32 linkMode)
+struct RPLDeferredReloc
+{
+	uint8* relocTargetSectionAddress;
+	uint32 relocType;
+	bool isSymbolBinding2;
+	uint32 relocOffset;
+	uint32 relocAddend;
+	uint32 symbolAddress;
+	sint16 tlsModuleIndex;
+};
+
+// if deferredRelocs is set, then relocations which require a trampoline are not applied but added to the list instead
+// this allows multiple relocation sections to be processed in parallel, since trampoline allocation is not thread-safe
+bool RPLLoader_ApplyRelocs(RPLModule* rplLoaderContext, sint32 relaSectionIndex, rplSectionEntryNew_t* section, uint32 linkMode, std::vector<RPLDeferredReloc>* deferredRelocs = nullptr)
 {
 	uint32 relocTargetSectionIndex = section->relocTargetSectionIndex;
 	if (relocTargetSectionIndex >= (uint32)rplLoaderContext->rplHeader.sectionTableEntryCount)
@@ -1260,23 +1330,8 @@ bool RPLLoader_ApplyRelocs(RPLModule* rplLoaderContext, sint32 relaSectionIndex,
 		relocData = (uint8*)malloc(relocUncompressedSize);
 		relocSize = relocUncompressedSize;
 		// decompress
-		int ret;
-		z_stream strm;
-		strm.zalloc = Z_NULL;
-		strm.zfree = Z_NULL;
-		strm.opaque = Z_NULL;
-		ret = inflateInit(&strm);
-		if (ret == Z_OK)
-		{
-			strm.avail_in = (uint32)section->sectionSize - 4;
-			strm.next_in = relocRawData + 4;
-			strm.avail_out = relocUncompressedSize;
-			strm.next_out = relocData;
-			ret = inflate(&strm, Z_FULL_FLUSH);
-			cemu_assert_debug(ret == Z_OK || ret == Z_STREAM_END);
-			cemu_assert_debug(strm.avail_in == 0 && strm.avail_out == 0);
-			inflateEnd(&strm);
-		}
+		bool inflateSuccess = RPLLoader_InflateSectionData(relocRawData + 4, (uint32)section->sectionSize - 4, relocData, relocUncompressedSize);
+		cemu_assert_debug(inflateSuccess);
 	}
 	else
 	{
@@ -1351,7 +1406,8 @@ bool RPLLoader_ApplyRelocs(RPLModule* rplLoaderContext, sint32 relaSectionIndex,
 			tlsModuleIndex = rplLoaderContext->fileInfo.tlsModuleIndex;
 		}
 		uint32 relocOffset = (uint32)reloc->relocOffset - (uint32)rplLoaderContext->sectionTablePtr[relocTargetSectionIndex].virtualAddress;
-		RPLLoader_ApplySingleReloc(rplLoaderContext, 0, relocTargetSectionAddress, relocType, symbolBinding == 2, relocOffset, reloc->relocAddend, symbolAddress, tlsModuleIndex);
+		if (!RPLLoader_ApplySingleReloc(rplLoaderContext, 0, relocTargetSectionAddress, relocType, symbolBinding == 2, relocOffset, reloc->relocAddend, symbolAddress, tlsModuleIndex, deferredRelocs == nullptr))
+			deferredRelocs->push_back({relocTargetSectionAddress, relocType, symbolBinding == 2, relocOffset, reloc->relocAddend, symbolAddress, tlsModuleIndex});
 
 		// next reloc
 		reloc++;
@@ -1375,14 +1431,57 @@ bool RPLLoader_HandleRelocs(RPLModule* rplLoaderContext, std::span<RPLSharedImpo
 	}
 
 	// apply relocs again after we have fixed the import section
-	for (sint32 i = 0; i < (sint32)rplLoaderContext->rplHeader.sectionTableEntryCount; i++)
+	// relocation sections are grouped by the section they patch. Groups don't write to the same memory and are processed in parallel
+	BenchmarkTimer relocTimer;
+	relocTimer.Start();
+	sint32 sectionCount = rplLoaderContext->rplHeader.sectionTableEntryCount;
+	std::vector<std::vector<sint32>> relaSectionsPerTarget(sectionCount);
+	size_t groupCount = 0;
+	for (sint32 i = 0; i < sectionCount; i++)
 	{
 		rplSectionEntryNew_t* section = rplLoaderContext->sectionTablePtr + i;
 		uint32 sectionType = section->type;
 		if (sectionType != SHT_RELA)
 			continue;
-		RPLLoader_ApplyRelocs(rplLoaderContext, i, section, linkMode);
+		uint32 relocTargetSectionIndex = section->relocTargetSectionIndex;
+		if (relocTargetSectionIndex >= (uint32)sectionCount)
+			assert_dbg();
+		if (relaSectionsPerTarget[relocTargetSectionIndex].empty())
+			groupCount++;
+		relaSectionsPerTarget[relocTargetSectionIndex].emplace_back(i);
 	}
+	if (groupCount <= 1)
+	{
+		for (auto& relaSections : relaSectionsPerTarget)
+		{
+			for (sint32 relaSectionIndex : relaSections)
+				RPLLoader_ApplyRelocs(rplLoaderContext, relaSectionIndex, rplLoaderContext->sectionTablePtr + relaSectionIndex, linkMode);
+		}
+	}
+	else
+	{
+		std::vector<std::vector<RPLDeferredReloc>> deferredRelocsPerSection(sectionCount);
+		ThreadPool::TaskGroup taskGroup;
+		for (auto& relaSections : relaSectionsPerTarget)
+		{
+			if (relaSections.empty())
+				continue;
+			taskGroup.Run([rplLoaderContext, &relaSections, &deferredRelocsPerSection, linkMode]()
+			{
+				for (sint32 relaSectionIndex : relaSections)
+					RPLLoader_ApplyRelocs(rplLoaderContext, relaSectionIndex, rplLoaderContext->sectionTablePtr + relaSectionIndex, linkMode, deferredRelocsPerSection.data() + relaSectionIndex);
+			}, ThreadPool::Priority::High);
+		}
+		taskGroup.Wait();
+		// generate trampolines in section order, so their layout is the same as with serial processing
+		for (auto& deferredRelocs : deferredRelocsPerSection)
+		{
+			for (auto& reloc : deferredRelocs)
+				RPLLoader_ApplySingleReloc(rplLoaderContext, 0, reloc.relocTargetSectionAddress, reloc.relocType, reloc.isSymbolBinding2, reloc.relocOffset, reloc.relocAddend, reloc.symbolAddress, reloc.tlsModuleIndex);
+		}
+	}
+	relocTimer.Stop();
+	cemuLog_logDebug(LogType::Force, "RPLLoader: {} - Applied relocations (link mode {}) in {:.2f}ms", rplLoaderContext->moduleName, linkMode, relocTimer.GetElapsedMilliseconds());
 	return true;
 }
 
@@ -1430,6 +1529,67 @@ void RPLLoader_InitState()
     RPLLoader_UnloadAll();
 }
 
+// Persistent cache of per-module data which only depends on the contents of the RPL file
+// Modules are identified by a hash over the raw (compressed) file, so the cache is shared between titles and any update or DLC
+// that changes a module automatically gets a new entry
+// Currently this stores the Cemuhook patch CRC, whose calculation requires a separate serial pass which inflates every section
+// The relocated module image itself is not cached. Load addresses, HLE import stubs, TLS indices and trampolines depend on the
+// order in which modules and imports are allocated at runtime, and graphic pack patches are applied after linking
+// A linked image also can't be validated per module: Import resolution reads the relocated export tables of other modules, and linking
+// has side effects (HLE stub registration, trampoline maps, proxy symbols) which would have to be replayed. A pre-linked snapshot would
+// need to cover the whole set of modules loaded at boot together with the loader's allocator state
+
+#define RPL_MODULE_CACHE_VERSION	1 // bump whenever the format of the stored data or the way it is calculated changes
+
+struct
+{
+	std::mutex mutex;
+	FileCache* cache{};
+	bool openFailed{};
+}s_rplModuleCache;
+
+static FileCache::FileName RPLModuleCache_getModuleName(std::span<const uint8> rplData)
+{
+	uint64 h = 0x6e3c9a1f52b4d807ull;
+	size_t numWords = rplData.size() / 8;
+	for (size_t i = 0; i < numWords; i++)
+	{
+		uint64 v;
+		memcpy(&v, rplData.data() + i * 8, 8);
+		h = std::rotl<uint64>(h ^ v, 23) * 0x9e3779b97f4a7c15ull;
+	}
+	for (size_t i = numWords * 8; i < rplData.size(); i++)
+		h = std::rotl<uint64>(h ^ (uint64)rplData[i], 23) * 0x9e3779b97f4a7c15ull;
+	uint32 crc = crc32_calc(rplData.data(), rplData.size());
+	return FileCache::FileName(((uint64)rplData.size() << 32) | (uint64)crc, h);
+}
+
+static FileCache* RPLModuleCache_Get()
+{
+	if (s_rplModuleCache.cache || s_rplModuleCache.openFailed)
+		return s_rplModuleCache.cache;
+	std::error_code ec;
+	fs::create_directories(ActiveSettings::GetCachePath("rpl"), ec);
+	const auto pathCacheFile = ActiveSettings::GetCachePath("rpl/modules.bin");
+	s_rplModuleCache.cache = FileCache::Open(pathCacheFile, true, RPL_MODULE_CACHE_VERSION + 0x52a1c7e3);
+	if (!s_rplModuleCache.cache)
+	{
+		cemuLog_log(LogType::Force, "Failed to open or create RPL module cache: {}", _pathToUtf8(pathCacheFile));
+		s_rplModuleCache.openFailed = true;
+		return nullptr;
+	}
+	s_rplModuleCache.cache->UseCompression(false);
+	return s_rplModuleCache.cache;
+}
+
+void RPLModuleCache_Close()
+{
+	std::unique_lock _l(s_rplModuleCache.mutex);
+	delete s_rplModuleCache.cache;
+	s_rplModuleCache.cache = nullptr;
+	s_rplModuleCache.openFailed = false;
+}
+
 void RPLLoader_BeginCemuhookCRC(RPLModule* rpl)
 {
 	// calculate some values required for CRC
@@ -1491,26 +1651,13 @@ void RPLLoader_BeginCemuhookCRC(RPLModule* rpl)
 			}
 			memoryAllocated = true;
 			// decompress
-			z_stream strm;
-			strm.zalloc = Z_NULL;
-			strm.zfree = Z_NULL;
-			strm.opaque = Z_NULL;
-			inflateInit(&strm);
-			strm.avail_in = sectionCompressedSize - 4;
-			strm.next_in = rpl->RPLRawData.data() + (uint32)sectionFileOffset + 4;
-			strm.avail_out = decompressedSize;
-			strm.next_out = (Bytef*)rawData;
-			auto ret = inflate(&strm, Z_FULL_FLUSH);
-			if (ret != Z_OK && ret != Z_STREAM_END || strm.avail_in != 0 || strm.avail_out != 0)
+			if (!RPLLoader_InflateSectionData(rpl->RPLRawData.data() + (uint32)sectionFileOffset + 4, sectionCompressedSize - 4, (uint8*)rawData, decompressedSize))
 			{
 				cemuLog_logDebug(LogType::Force, "RPLLoader-CRC: Unable to decompress section {}", i);
-				cemuLog_logDebug(LogType::Force, "zRet {} availIn {} availOut {}", ret, (sint32)strm.avail_in, (sint32)strm.avail_out);
 				cemu_assert_debug(false);
 				free(rawData);
-				inflateEnd(&strm);
 				continue;
 			}
-			inflateEnd(&strm);
 		}
 		else
 		{
@@ -1534,6 +1681,39 @@ void RPLLoader_BeginCemuhookCRC(RPLModule* rpl)
 	}
 }
 
+// get the Cemuhook patch CRC from the module cache or calculate and store it
+void RPLLoader_CalculatePatchCRC(RPLModule* rpl)
+{
+	FileCache::FileName cacheName = RPLModuleCache_getModuleName(rpl->RPLRawData);
+	std::unique_lock _l(s_rplModuleCache.mutex);
+	FileCache* cache = RPLModuleCache_Get();
+	if (cache)
+	{
+		std::vector<uint8> fileData;
+		if (cache->GetFile({ cacheName.name1, cacheName.name2 }, fileData))
+		{
+			MemStreamReader streamReader(fileData.data(), (sint32)fileData.size());
+			uint32 sectionCount = streamReader.readBE<uint32>();
+			uint32 patchCRC = streamReader.readBE<uint32>();
+			if (!streamReader.hasError() && sectionCount == (uint32)rpl->rplHeader.sectionTableEntryCount)
+			{
+				rpl->patchCRC = patchCRC;
+				return;
+			}
+			cache->DeleteFile({ cacheName.name1, cacheName.name2 });
+		}
+	}
+	RPLLoader_BeginCemuhookCRC(rpl);
+	if (cache)
+	{
+		MemStreamWriter memWriter(8);
+		memWriter.writeBE<uint32>((uint32)rpl->rplHeader.sectionTableEntryCount);
+		memWriter.writeBE<uint32>(rpl->patchCRC);
+		auto blob = memWriter.getResult();
+		cache->AddFile({ cacheName.name1, cacheName.name2 }, blob.data(), (sint32)blob.size());
+	}
+}
+
 void RPLLoader_incrementModuleDependencyRefs(RPLModule* rpl)
 {
 	for (uint32 i = 0; i < (uint32)rpl->rplHeader.sectionTableEntryCount; i++)
@@ -1597,7 +1777,7 @@ RPLModule* RPLLoader_LoadFromMemory(uint8* rplData, sint32 size, std::string_vie
 		return nullptr;
 	}
 	RPLLoader_InitModuleAllocator(rpl);
-	RPLLoader_BeginCemuhookCRC(rpl);
+	RPLLoader_CalculatePatchCRC(rpl);
 	if (RPLLoader_LoadSections(0, rpl) == false)
 	{
 		delete rpl;
@@ -2521,7 +2701,8 @@ void RPLLoader_UnloadAll()
 	rplSymbolStorage_unloadAll();
 	// free all code imports
 	g_heapTrampolineArea.releaseAll();
-	list_mappedFunctionImports.clear();
+	map_mappedFunctionImports.clear();
+	RPLModuleCache_Close();
 	g_map_callableExports.clear();
 	rplLoader_applicationHasMemoryControl = false;
 	rplLoader_maxCodeAddress = 0;
@@ -67,6 +67,7 @@ namespace TCL
 	std::atomic<uint32> tclRingBufferA[TCL_RING_BUFFER_SIZE];
 	std::atomic<uint32> tclRingBufferA_readIndex{0};
 	std::atomic<uint32> tclRingBufferA_writeIndex{0};
+	std::atomic<uint32> tclRingBufferA_writeSignal{0}; // incremented after every write so a waiting reader can block on it
 
 	// GPU code calls this to grab the next command word
 	bool TCLGPUReadRBWord(uint32& cmdWord)
@@ -80,6 +81,23 @@ namespace TCL
 		return true;
 	}
 
+	// blocks until the ringbuffer is no longer empty. To abort the wait, set cancel and then call TCLGPUCancelWaitForRBWord()
+	void TCLGPUWaitForRBWord(const std::atomic_bool& cancel)
+	{
+		uint32 writeSignal = tclRingBufferA_writeSignal.load(std::memory_order::acquire);
+		if (cancel)
+			return;
+		if (tclRingBufferA_readIndex.load(std::memory_order::relaxed) != tclRingBufferA_writeIndex.load(std::memory_order::acquire))
+			return;
+		tclRingBufferA_writeSignal.wait(writeSignal, std::memory_order::acquire);
+	}
+
+	void TCLGPUCancelWaitForRBWord()
+	{
+		tclRingBufferA_writeSignal.fetch_add(1, std::memory_order::release);
+		tclRingBufferA_writeSignal.notify_all();
+	}
+
 	void TCLWaitForRBSpace(uint32be numU32s)
 	{
 		uint32 writeIndex = tclRingBufferA_writeIndex.load(std::memory_order::relaxed);
@@ -110,6 +128,8 @@ namespace TCL
 		}
 
 		tclRingBufferA_writeIndex.store(writeIndex, std::memory_order::release);
+		tclRingBufferA_writeSignal.fetch_add(1, std::memory_order::release);
+		tclRingBufferA_writeSignal.notify_one();
 	}
 
 	#define EVENT_TYPE_TS		5
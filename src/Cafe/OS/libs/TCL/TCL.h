@@ -20,6 +20,8 @@ namespace TCL
 
 	// called from Latte code
 	bool TCLGPUReadRBWord(uint32& cmdWord);
+	void TCLGPUWaitForRBWord(const std::atomic_bool& cancel);
+	void TCLGPUCancelWaitForRBWord();
 	void TCLGPUNotifyNewRetirementTimestamp();
 
 	COSModule* GetModule();
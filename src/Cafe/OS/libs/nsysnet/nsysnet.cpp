@@ -6,6 +6,7 @@
 #include "Cafe/OS/libs/coreinit/coreinit_GHS.h"
 
 #include "Common/socket.h"
+#include "Cafe/HW/MMU/MemoryWriteTracker.h"
 
 #if BOOST_OS_UNIX
 #include <netinet/tcp.h>
@@ -1061,6 +1062,7 @@ void nsysnetExport_recv(PPCInterpreter_t* hCPU)
 		_setSocketSendRecvNonBlockingMode(vs->s, requestIsNonBlocking);
 	}
 	// receive
+	MemoryWriteTrackerHostWriteScope hostWriteScope(msg, std::max(len, 0));
 	sint32 hr = recv(vs->s, msg, len, hostFlags);
 	_translateError(hr <= 0 ? -1 : 0, GETLASTERR);
 	if (requestIsNonBlocking != vs->isNonBlocking)
@@ -1595,6 +1597,9 @@ void nsysnetExport_recvfrom(PPCInterpreter_t* hCPU)
 	if (vs->isNonBlocking)
 		requestIsNonBlocking = vs->isNonBlocking;
 
+	// the host socket writes directly into guest memory
+	MemoryWriteTrackerHostWriteScope hostWriteScope(msg, std::max(len, 0));
+
 	sockaddr fromAddrHost;
 	socklen_t fromLenHost = sizeof(fromAddrHost);
 	sint32 wsaError = 0;
@@ -221,4 +221,19 @@ namespace snd_core
 	extern SysAllocator<sint32, AX_SAMPLES_MAX * AX_TV_CHANNEL_COUNT> __AXTVOutputBuffer;
 	extern SysAllocator<sint32, AX_SAMPLES_MAX * AX_DRC_CHANNEL_COUNT * 2> __AXDRCOutputBuffer;
 
+	// mixer kernels (ax_mix_simd.cpp)
+	constexpr float AX_MIX_CLAMP_MAX = 8388352.0f; // 16bit signed range << 8
+	constexpr float AX_MIX_CLAMP_MIN = -8388608.0f;
+
+	void AXMix_ConvertPCM16(const uint16* input, sint16* output, sint32 count); // big-endian to native
+	void AXMix_ConvertPCM8(const sint8* input, sint16* output, sint32 count); // output is shifted left by 8
+	// linearly interpolates between input[n] and input[n+1] where n is the integer part of the playback position. The position is advanced before each output sample
+	void AXMix_ResampleLinear(const sint16* input, float* output, sint32 count, uint32 fracPos, uint32 ratio);
+	void AXMix_MixInto(const float* input, float* output, sint32 count, float volume);
+	void AXMix_MixIntoRamp(const float* input, float* output, sint32 count, const float* volumeRamp);
+	void AXMix_MixIntoS32BE(const float* input, sint32* output, sint32 count, float volume);
+	void AXMix_Scale(float* data, sint32 count, float volume, bool clamp);
+	void AXMix_ScaleRamp(float* data, sint32 count, const float* volumeRamp, bool clamp);
+	float AXMix_GenerateVolumeRamp(float* volumeRamp, sint32 count, float volume, float delta); // returns the final volume
+
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Cafe/OS/libs/snd_core/ax_internal.h"
 #include "Cafe/HW/MMU/MMU.h"
 #include "config/ActiveSettings.h"
+#include "util/ThreadPool/ThreadPool.h"
 
 void mic_updateOnAXFrame();
 
@@ -242,89 +243,51 @@ namespace snd_core
 		}
 	}
 
+	// the linear resampler interpolates between two consecutive samples of a buffer which starts with the four history samples, followed by the newly read samples
+	// ADPCM and PCM8 voices keep the newest history sample in the first slot and interpolate between the two newest samples
+	// PCM16 voices store the history in order and interpolate between the two oldest samples
+	const sint32 AX_RESAMPLER_MAX_INPUT = 4096;
+
+	void AX_LoadResamplerHistory(AXVPBInternal_t* internalShadowCopy, sint16* sampleBuffer, bool newestFirst)
+	{
+		for (sint32 i = 0; i < 4; i++)
+		{
+			sint32 historyIndex = newestFirst ? ((i + 1) & 3) : i;
+			sampleBuffer[i] = _swapEndianS16(internalShadowCopy->src.historySamples[historyIndex]);
+		}
+	}
+
+	void AX_ResampleLinearFromBuffer(AXVPBInternal_t* internalShadowCopy, const sint16* sampleBuffer, float* output, sint32 sampleCount, uint32 currentFracPos, uint32 ratio, bool newestFirst)
+	{
+		const sint16* interpolationBase = sampleBuffer + (newestFirst ? 2 : 0);
+		AXMix_ResampleLinear(interpolationBase, output, sampleCount, currentFracPos, ratio);
+		// update state
+		uint32 finalFracPos = currentFracPos + ratio * (uint32)sampleCount;
+		const sint16* history = sampleBuffer + (finalFracPos >> 16);
+		internalShadowCopy->src.currentFrac = _swapEndianU16((uint16)(finalFracPos & 0xFFFF));
+		for (sint32 i = 0; i < 4; i++)
+		{
+			sint32 historyIndex = newestFirst ? ((i + 3) & 3) : i;
+			internalShadowCopy->src.historySamples[i] = _swapEndianS16(history[historyIndex]);
+		}
+	}
+
 	void AX_DecodeSamplesADPCM_Linear(AXVPBInternal_t* internalShadowCopy, float* output, sint32 sampleCount)
 	{
 		uint32 currentFracPos = (uint32)_swapEndianU16(internalShadowCopy->src.currentFrac);
 		uint32 ratio = _swapEndianU32(*(uint32*)&internalShadowCopy->src.ratioHigh);
 
-		sint16 historySamples[4];
-		historySamples[0] = _swapEndianS16(internalShadowCopy->src.historySamples[0]);
-		historySamples[1] = _swapEndianS16(internalShadowCopy->src.historySamples[1]);
-		historySamples[2] = _swapEndianS16(internalShadowCopy->src.historySamples[2]);
-		historySamples[3] = _swapEndianS16(internalShadowCopy->src.historySamples[3]);
-
-		sint32 historyIndex = 0;
-
 		sint32 numberOfDecodedAdpcmSamples = (sint32)((currentFracPos + ratio * sampleCount) >> 16);
-		sint16 adpcmSampleBuffer[4096];
-		if (numberOfDecodedAdpcmSamples >= 4096)
+		if (numberOfDecodedAdpcmSamples >= AX_RESAMPLER_MAX_INPUT)
 		{
 			memset(output, 0, sizeof(float)*sampleCount);
 			cemuLog_log(LogType::Force, "Too many ADPCM samples to decode. ratio = {:08x}", ratio);
 			return;
 		}
-		AX_readADPCMSamples(internalShadowCopy, adpcmSampleBuffer, numberOfDecodedAdpcmSamples);
-
-		sint32 readSampleCount = 0;
-
-		if (ratio == 0x10000 && currentFracPos == 0)
-		{
-			// optimized path when accessing only fully aligned samples
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				cemu_assert_debug(readSampleCount < numberOfDecodedAdpcmSamples);
-				// get next sample
-				sint16 s = adpcmSampleBuffer[readSampleCount];
-				readSampleCount++;
-				historyIndex = (historyIndex + 1) & 3;
-				historySamples[historyIndex] = s;
-				// use previous sample
-				sint32 previousSample = historySamples[(historyIndex + 3) & 3];
-				sint32 p0 = previousSample << 8;
-				*output = (float)p0;
-				output++;
-			}
-		}
-		else
-		{
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				// move playback pos
-				currentFracPos += ratio;
-				// get more samples if needed
-				while (currentFracPos >= 0x10000)
-				{
-					cemu_assert_debug(readSampleCount < numberOfDecodedAdpcmSamples);
-					sint16 s = adpcmSampleBuffer[readSampleCount];
-					readSampleCount++;
-					currentFracPos -= 0x10000;
-					historyIndex = (historyIndex + 1) & 3;
-					historySamples[historyIndex] = s;
-				}
-				// linear interpolation of current sample
-				sint32 previousSample = historySamples[(historyIndex + 3) & 3];
-				sint32 nextSample = historySamples[historyIndex];
-
-				sint32 p0 = (sint32)previousSample * (sint32)(0x10000 - currentFracPos);
-				sint32 p1 = (sint32)nextSample * (sint32)(currentFracPos);
-
-				p0 >>= 7;
-				p1 >>= 7;
-
-				sint32 interpolatedSample = p0 + p1;
-				interpolatedSample >>= 1;
-
-				*output = (float)interpolatedSample;
-				output++;
-			}
-		}
-		cemu_assert_debug(readSampleCount == numberOfDecodedAdpcmSamples);
-		// set variables
-		internalShadowCopy->src.currentFrac = _swapEndianU16((uint16)(currentFracPos));
-		internalShadowCopy->src.historySamples[0] = _swapEndianS16(historySamples[(historyIndex + 0) & 3]);
-		internalShadowCopy->src.historySamples[1] = _swapEndianS16(historySamples[(historyIndex + 1) & 3]);
-		internalShadowCopy->src.historySamples[2] = _swapEndianS16(historySamples[(historyIndex + 2) & 3]);
-		internalShadowCopy->src.historySamples[3] = _swapEndianS16(historySamples[(historyIndex + 3) & 3]);
+		sint16 sampleBuffer[4 + AX_RESAMPLER_MAX_INPUT];
+		AX_LoadResamplerHistory(internalShadowCopy, sampleBuffer, true);
+		AX_readADPCMSamples(internalShadowCopy, sampleBuffer + 4, numberOfDecodedAdpcmSamples);
+		AX_ResampleLinearFromBuffer(internalShadowCopy, sampleBuffer, output, sampleCount, currentFracPos, ratio, true);
 	}
 
 	void AX_DecodeSamplesADPCM_Tap(AXVPBInternal_t* internalShadowCopy, float* output, sint32 sampleCount)
@@ -347,69 +310,49 @@ namespace snd_core
 		uint8* endOffsetAddr = memory_base + (endOffsetPtr | (ptrHighExtension << 29));
 		uint8* currentOffsetAddr = memory_base + (currentOffsetPtr | (ptrHighExtension << 29));
 
-		sint16 historySamples[4];
-		historySamples[0] = _swapEndianS16(internalShadowCopy->src.historySamples[0]);
-		historySamples[1] = _swapEndianS16(internalShadowCopy->src.historySamples[1]);
-		historySamples[2] = _swapEndianS16(internalShadowCopy->src.historySamples[2]);
-		historySamples[3] = _swapEndianS16(internalShadowCopy->src.historySamples[3]);
-
-		sint32 historyIndex = 0;
-
-		for (sint32 i = 0; i<sampleCount; i++)
+		sint32 readSampleCount = (sint32)((currentFracPos + ratio * sampleCount) >> 16);
+		if (readSampleCount >= AX_RESAMPLER_MAX_INPUT)
 		{
-			currentFracPos += ratio;
-			while (currentFracPos >= 0x10000)
+			memset(output, 0, sizeof(float)*sampleCount);
+			cemuLog_log(LogType::Force, "Too many PCM8 samples to read. ratio = {:08x}", ratio);
+			return;
+		}
+		sint16 sampleBuffer[4 + AX_RESAMPLER_MAX_INPUT];
+		AX_LoadResamplerHistory(internalShadowCopy, sampleBuffer, true);
+		// read samples in runs which end at the end offset
+		sint16* sampleWriter = sampleBuffer + 4;
+		sint32 remainingSamples = readSampleCount;
+		while (remainingSamples > 0)
+		{
+			if (internalShadowCopy->playbackState == 0)
 			{
-				// read next sample
-				historyIndex = (historyIndex + 1) & 3;
-				if (internalShadowCopy->playbackState)
-				{
-					sint32 s = (sint32)(sint8)*currentOffsetAddr;
-					s <<= 8;
-					historySamples[historyIndex] = s;
-					if (currentOffsetAddr == endOffsetAddr)
-					{
-						if (internalShadowCopy->internalOffsets.loopFlag)
-						{
-							// loop
-							currentOffsetAddr = memory_base + (loopOffsetPtr | (ptrHighExtension << 29));
-						}
-						else
-						{
-							// stop playing
-							internalShadowCopy->playbackState = 0;
-						}
-					}
-					else
-					{
-						currentOffsetAddr++;
-					}
-				}
-				else
-				{
-					// voice not playing, read sample as 0
-					historySamples[historyIndex] = 0;
-				}
-				currentFracPos -= 0x10000;
+				// voice not playing, read samples as 0
+				std::fill_n(sampleWriter, remainingSamples, (sint16)0);
+				break;
+			}
+			bool reachesEnd = currentOffsetAddr <= endOffsetAddr && (endOffsetAddr - currentOffsetAddr) < remainingSamples;
+			sint32 runLength = reachesEnd ? (sint32)(endOffsetAddr - currentOffsetAddr) + 1 : remainingSamples;
+			AXMix_ConvertPCM8((const sint8*)currentOffsetAddr, sampleWriter, runLength);
+			sampleWriter += runLength;
+			remainingSamples -= runLength;
+			if (!reachesEnd)
+			{
+				currentOffsetAddr += runLength;
+				break;
+			}
+			if (internalShadowCopy->internalOffsets.loopFlag)
+			{
+				// loop
+				currentOffsetAddr = memory_base + (loopOffsetPtr | (ptrHighExtension << 29));
+			}
+			else
+			{
+				// stop playing, the offset stays at the end offset
+				currentOffsetAddr = endOffsetAddr;
+				internalShadowCopy->playbackState = 0;
 			}
-			// interpolate sample
-			sint32 previousSample = historySamples[(historyIndex + 3) & 3];
-			sint32 nextSample = historySamples[historyIndex];
-			sint32 p0 = (sint32)previousSample * (sint32)(0x10000 - currentFracPos);
-			sint32 p1 = (sint32)nextSample * (sint32)(currentFracPos);
-			p0 >>= 7;
-			p1 >>= 7;
-			sint32 interpolatedSample = p0 + p1;
-			interpolatedSample >>= 1;
-			*output = (float)interpolatedSample;
-			output++;
 		}
-		// set variables
-		internalShadowCopy->src.currentFrac = _swapEndianU16((uint16)(currentFracPos));
-		internalShadowCopy->src.historySamples[0] = _swapEndianS16(historySamples[(historyIndex + 0) & 3]);
-		internalShadowCopy->src.historySamples[1] = _swapEndianS16(historySamples[(historyIndex + 1) & 3]);
-		internalShadowCopy->src.historySamples[2] = _swapEndianS16(historySamples[(historyIndex + 2) & 3]);
-		internalShadowCopy->src.historySamples[3] = _swapEndianS16(historySamples[(historyIndex + 3) & 3]);
+		AX_ResampleLinearFromBuffer(internalShadowCopy, sampleBuffer, output, sampleCount, currentFracPos, ratio, true);
 		// store current offset
 		currentOffsetPtr = (uint32)((uint8*)currentOffsetAddr - memory_base);
 		currentOffsetPtr &= 0x1FFFFFFF; // is this correct?
@@ -457,73 +400,51 @@ namespace snd_core
 		uint16* endOffsetAddr = (uint16*)(memory_base + ((endOffsetPtr * 2) | (ptrHighExtension << 29)));
 		uint16* currentOffsetAddr = (uint16*)(memory_base + ((currentOffsetPtr * 2) | (ptrHighExtension << 29)));
 
-		sint16 historySamples[4];
-		historySamples[0] = _swapEndianS16(internalShadowCopy->src.historySamples[0]);
-		historySamples[1] = _swapEndianS16(internalShadowCopy->src.historySamples[1]);
-		historySamples[2] = _swapEndianS16(internalShadowCopy->src.historySamples[2]);
-		historySamples[3] = _swapEndianS16(internalShadowCopy->src.historySamples[3]);
-
-		sint32 historyIndex = 0;
-
-		sint32 s = 0;
-		for (sint32 i = 0; i < sampleCount; i++)
+		sint32 readSampleCount = (sint32)((currentFracPos + ratio * sampleCount) >> 16);
+		if (readSampleCount >= AX_RESAMPLER_MAX_INPUT)
 		{
-			currentFracPos += ratio;
-			while (currentFracPos >= 0x10000)
+			memset(output, 0, sizeof(float)*sampleCount);
+			cemuLog_log(LogType::Force, "Too many PCM16 samples to read. ratio = {:08x}", ratio);
+			return;
+		}
+		sint16 sampleBuffer[4 + AX_RESAMPLER_MAX_INPUT];
+		AX_LoadResamplerHistory(internalShadowCopy, sampleBuffer, false);
+		// read samples in runs which end at the end offset
+		sint16* sampleWriter = sampleBuffer + 4;
+		sint32 remainingSamples = readSampleCount;
+		sint16 lastSample = 0;
+		while (remainingSamples > 0)
+		{
+			if (internalShadowCopy->playbackState == 0)
 			{
-				// read next sample
-				sint32 prevIndex = historyIndex;
-				historyIndex = (historyIndex + 1) & 3;
-				if (internalShadowCopy->playbackState)
-				{
-					s = _swapEndianS16(*currentOffsetAddr);
-					historySamples[prevIndex] = s;
-					if (currentOffsetAddr == endOffsetAddr)
-					{
-						if (internalShadowCopy->internalOffsets.loopFlag)
-						{
-							// loop
-							currentOffsetAddr = (uint16*)(memory_base + ((loopOffsetPtr * 2) | (ptrHighExtension << 29)));
-						}
-						else
-						{
-							// stop playing
-							internalShadowCopy->playbackState = 0;
-						}
-					}
-					else
-					{
-						currentOffsetAddr++; // increment pointer only if not at end offset
-					}
-				}
-				else
-				{
-					// voice not playing -> repeat previous sample
-					historySamples[prevIndex] = s;
-				}
-				currentFracPos -= 0x10000;
+				// voice not playing -> repeat previous sample
+				std::fill_n(sampleWriter, remainingSamples, lastSample);
+				break;
+			}
+			bool reachesEnd = currentOffsetAddr <= endOffsetAddr && (endOffsetAddr - currentOffsetAddr) < remainingSamples;
+			sint32 runLength = reachesEnd ? (sint32)(endOffsetAddr - currentOffsetAddr) + 1 : remainingSamples;
+			AXMix_ConvertPCM16(currentOffsetAddr, sampleWriter, runLength);
+			sampleWriter += runLength;
+			remainingSamples -= runLength;
+			lastSample = sampleWriter[-1];
+			if (!reachesEnd)
+			{
+				currentOffsetAddr += runLength; // increment pointer only if not at end offset
+				break;
+			}
+			if (internalShadowCopy->internalOffsets.loopFlag)
+			{
+				// loop
+				currentOffsetAddr = (uint16*)(memory_base + ((loopOffsetPtr * 2) | (ptrHighExtension << 29)));
+			}
+			else
+			{
+				// stop playing, the offset stays at the end offset
+				currentOffsetAddr = endOffsetAddr;
+				internalShadowCopy->playbackState = 0;
 			}
-			// interpolate sample
-			sint32 curSample = historySamples[historyIndex];
-			sint32 nextSample = historySamples[(historyIndex + 1) & 3];
-
-			sint32 p0 = (sint32)curSample * (sint32)(0x10000 - currentFracPos);
-			sint32 p1 = (sint32)nextSample * (sint32)(currentFracPos);
-			p0 >>= 7;
-			p1 >>= 7;
-			sint32 interpolatedSample = p0 + p1;
-			interpolatedSample >>= 1;
-
-			*output = (float)interpolatedSample;
-			output++;
 		}
-
-		// set variables
-		internalShadowCopy->src.currentFrac = _swapEndianU16((uint16)(currentFracPos));
-		internalShadowCopy->src.historySamples[0] = _swapEndianS16(historySamples[(historyIndex + 0) & 3]);
-		internalShadowCopy->src.historySamples[1] = _swapEndianS16(historySamples[(historyIndex + 1) & 3]);
-		internalShadowCopy->src.historySamples[2] = _swapEndianS16(historySamples[(historyIndex + 2) & 3]);
-		internalShadowCopy->src.historySamples[3] = _swapEndianS16(historySamples[(historyIndex + 3) & 3]);
+		AX_ResampleLinearFromBuffer(internalShadowCopy, sampleBuffer, output, sampleCount, currentFracPos, ratio, false);
 		// store current offset
 		currentOffsetPtr = (uint32)((uint8*)currentOffsetAddr - memory_base);
 		currentOffsetPtr &= 0x1FFFFFFF;
@@ -635,19 +556,15 @@ namespace snd_core
 		if (deltaI != 0)
 		{
 			float delta = (float)deltaI / (float)0x8000;
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				vol += delta;
-				outputSamples[i] += inputSamples[i] * vol;
-			}
+			float volumeRamp[AX_SAMPLES_MAX];
+			cemu_assert_debug(sampleCount <= AX_SAMPLES_MAX);
+			vol = AXMix_GenerateVolumeRamp(volumeRamp, sampleCount, vol, delta);
+			AXMix_MixIntoRamp(inputSamples, outputSamples, sampleCount, volumeRamp);
 		}
 		else
 		{
 			// optimized version for delta == 0.0
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				outputSamples[i] += inputSamples[i] * vol;
-			}
+			AXMix_MixInto(inputSamples, outputSamples, sampleCount, vol);
 		}
 		uint16 volI = (uint16)(vol * 32768.0f);
 		mix->vol = _swapEndianU16(volI);
@@ -667,34 +584,18 @@ namespace snd_core
 		if (volumeDelta == 0)
 		{
 			// without delta
-			for (sint32 i = 0; i < sampleCount; i += 4)
-			{
-				sampleData[i+0] *= volumeScaler;
-				sampleData[i+1] *= volumeScaler;
-				sampleData[i+2] *= volumeScaler;
-				sampleData[i+3] *= volumeScaler;
-			}
+			AXMix_Scale(sampleData, sampleCount, volumeScaler, false);
 			return;
 		}
 		// with delta
 		float volumeScalerDelta = volumeDelta / 32768.0f;
-		for (sint32 i = 0; i < sampleCount; i++)
-		{
-			volumeScaler += (float)volumeScalerDelta;
-			sampleData[i] *= volumeScaler;
-		}
+		float volumeRamp[AX_SAMPLES_MAX];
+		cemu_assert_debug(sampleCount <= AX_SAMPLES_MAX);
+		AXMix_GenerateVolumeRamp(volumeRamp, sampleCount, volumeScaler, volumeScalerDelta);
+		AXMix_ScaleRamp(sampleData, sampleCount, volumeRamp, false);
 		internalShadowCopy->veVolume = (uint16)((sint32)internalShadowCopy->veVolume + volumeDelta * sampleCount);
 	}
 
-	FORCE_INLINE float ClampADSRSample(float x)
-	{
-		if (x > 8388352.0f)
-			return 8388352.0f;
-		if (x < -8388608.0f)
-			return -8388608.0f;
-		return x;
-	}
-
 	void AXVoiceMix_ApplyADSR_Sndcore2(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount)
 	{
 		// sndcore2 clamps samples to -8388608,8388352 range (16bit signed range << 8)
@@ -709,22 +610,15 @@ namespace snd_core
 		if (volumeDelta == 0)
 		{
 			// without delta
-			for (sint32 i = 0; i < sampleCount; i += 4)
-			{
-				sampleData[i+0] = ClampADSRSample(sampleData[i+0] * volumeScaler);
-				sampleData[i+1] = ClampADSRSample(sampleData[i+1] * volumeScaler);
-				sampleData[i+2] = ClampADSRSample(sampleData[i+2] * volumeScaler);
-				sampleData[i+3] = ClampADSRSample(sampleData[i+3] * volumeScaler);
-			}
+			AXMix_Scale(sampleData, sampleCount, volumeScaler, true);
 			return;
 		}
 		// with delta
 		float volumeScalerDelta = volumeDelta / 32768.0f;
-		for (sint32 i = 0; i < sampleCount; i++)
-		{
-			volumeScaler += volumeScalerDelta;
-			sampleData[i] = ClampADSRSample(sampleData[i] * volumeScaler);
-		}
+		float volumeRamp[AX_SAMPLES_MAX];
+		cemu_assert_debug(sampleCount <= AX_SAMPLES_MAX);
+		AXMix_GenerateVolumeRamp(volumeRamp, sampleCount, volumeScaler, volumeScalerDelta);
+		AXMix_ScaleRamp(sampleData, sampleCount, volumeRamp, true);
 		internalShadowCopy->veVolume = finalVolume;
 	}
 
@@ -811,61 +705,128 @@ namespace snd_core
 	}
 
 	// mix audio generated from voice into main bus and aux buses
-	void AXVoiceMix_MixIntoBuses(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount, sint32 samplesPerFrame)
+	void AXVoiceMix_MixIntoTVBus(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount, sint32 samplesPerFrame, sint32 busIndex)
 	{
-		// TV mixing
-		for (sint32 busIndex = 0; busIndex < AX_BUS_COUNT; busIndex++)
+		for (sint32 channel = 0; channel < 6; channel++)
 		{
-			for (sint32 channel = 0; channel < 6; channel++)
+			uint32 channelMixMask = (_swapEndianU16(internalShadowCopy->deviceMixMaskTV[busIndex]) >> (channel * 2)) & 3;
+			if (channelMixMask == 0)
 			{
-				uint32 channelMixMask = (_swapEndianU16(internalShadowCopy->deviceMixMaskTV[busIndex]) >> (channel * 2)) & 3;
-				if (channelMixMask == 0)
-				{
-					internalShadowCopy->reserved1E8[busIndex*AX_TV_CHANNEL_COUNT + channel] = 0;
-					continue;
-				}
-				AXCHMIX_DEPR* mix = internalShadowCopy->deviceMixTV + channel * 4 + busIndex;
-				float* output = __AXMixBufferTV + (busIndex * 6 + channel) * samplesPerFrame;
-				AXVoiceMix_MergeInto(sampleData, output, sampleCount, mix, _swapEndianS16(mix->delta));
-				internalShadowCopy->reserved1E8[busIndex*AX_TV_CHANNEL_COUNT + channel] = mix->vol;
+				internalShadowCopy->reserved1E8[busIndex*AX_TV_CHANNEL_COUNT + channel] = 0;
+				continue;
 			}
+			AXCHMIX_DEPR* mix = internalShadowCopy->deviceMixTV + channel * 4 + busIndex;
+			float* output = __AXMixBufferTV + (busIndex * 6 + channel) * samplesPerFrame;
+			AXVoiceMix_MergeInto(sampleData, output, sampleCount, mix, _swapEndianS16(mix->delta));
+			internalShadowCopy->reserved1E8[busIndex*AX_TV_CHANNEL_COUNT + channel] = mix->vol;
 		}
-		// DRC0 mixing
-		for (sint32 busIndex = 0; busIndex < AX_BUS_COUNT; busIndex++)
+	}
+
+	void AXVoiceMix_MixIntoDRCBus(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount, sint32 samplesPerFrame, sint32 busIndex)
+	{
+		for (sint32 channel = 0; channel < AX_DRC_CHANNEL_COUNT; channel++)
 		{
-			for (sint32 channel = 0; channel < AX_DRC_CHANNEL_COUNT; channel++)
-			{
-				uint32 channelMixMask = (_swapEndianU16(internalShadowCopy->deviceMixMaskDRC[busIndex]) >> (channel * 2)) & 3;
+			uint32 channelMixMask = (_swapEndianU16(internalShadowCopy->deviceMixMaskDRC[busIndex]) >> (channel * 2)) & 3;
 
-				if (channelMixMask == 0)
-				{
-					//internalShadowCopy->reserved1E8[busIndex*AX_DRC_CHANNEL_COUNT + channel] = 0;
-					continue;
-				}
-				AXCHMIX_DEPR* mix = internalShadowCopy->deviceMixDRC + channel * 4 + busIndex;
-				float* output = __AXMixBufferDRC + (busIndex * AX_DRC_CHANNEL_COUNT + channel) * samplesPerFrame;
-				AXVoiceMix_MergeInto(sampleData, output, sampleCount, mix, _swapEndianS16(mix->delta));
+			if (channelMixMask == 0)
+			{
+				//internalShadowCopy->reserved1E8[busIndex*AX_DRC_CHANNEL_COUNT + channel] = 0;
+				continue;
 			}
+			AXCHMIX_DEPR* mix = internalShadowCopy->deviceMixDRC + channel * 4 + busIndex;
+			float* output = __AXMixBufferDRC + (busIndex * AX_DRC_CHANNEL_COUNT + channel) * samplesPerFrame;
+			AXVoiceMix_MergeInto(sampleData, output, sampleCount, mix, _swapEndianS16(mix->delta));
 		}
+	}
+
+	void AXVoiceMix_MixIntoBuses(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount, sint32 samplesPerFrame)
+	{
+		// TV mixing
+		for (sint32 busIndex = 0; busIndex < AX_BUS_COUNT; busIndex++)
+			AXVoiceMix_MixIntoTVBus(internalShadowCopy, sampleData, sampleCount, samplesPerFrame, busIndex);
+		// DRC0 mixing
+		for (sint32 busIndex = 0; busIndex < AX_BUS_COUNT; busIndex++)
+			AXVoiceMix_MixIntoDRCBus(internalShadowCopy, sampleData, sampleCount, samplesPerFrame, busIndex);
 
 		// DRC1 mixing + RMT mixing
 		// todo
 	}
 
+	// decode voice samples and apply per-voice effects
+	void AXVoiceMix_ProcessVoice(AXVPBInternal_t* internalVoice, float* sampleData, sint32 sampleCount)
+	{
+		AXVoiceMix_DecodeSamples(internalVoice, sampleData, sampleCount);
+		AXVoiceMix_ApplyADSR(internalVoice, sampleData, sampleCount);
+		AXVoiceMix_ApplyBiquad(internalVoice, sampleData, sampleCount);
+		AXVoiceMix_ApplyLowPass(internalVoice, sampleData, sampleCount);
+	}
+
+	// with enough active voices the mixing is spread over the thread pool in two passes
+	// first the voices are processed into separate sample buffers, voices don't depend on each other at this stage
+	// then each bus of each device accumulates the voices in list order. Every output buffer sees the same sequence of additions as in the serial mix, which keeps the result bit-exact
+	const sint32 AX_PARALLEL_MIX_MIN_VOICES = 12;
+	const sint32 AX_PARALLEL_MIX_VOICES_PER_TASK = 8;
+
+	struct
+	{
+		AXVPBInternal_t* voices[AX_MAX_VOICES];
+		float sampleData[AX_MAX_VOICES][AX_SAMPLES_MAX];
+		ThreadPool::TaskGroup tasks;
+	}s_axParallelMix;
+
+	void AXMix_ProcessVoicesParallel(sint32 voiceCount, sint32 sampleCount)
+	{
+		// decode
+		for (sint32 firstVoice = 0; firstVoice < voiceCount; firstVoice += AX_PARALLEL_MIX_VOICES_PER_TASK)
+		{
+			s_axParallelMix.tasks.Run([firstVoice, voiceCount, sampleCount]()
+			{
+				sint32 lastVoice = std::min(firstVoice + AX_PARALLEL_MIX_VOICES_PER_TASK, voiceCount);
+				for (sint32 i = firstVoice; i < lastVoice; i++)
+					AXVoiceMix_ProcessVoice(s_axParallelMix.voices[i], s_axParallelMix.sampleData[i], sampleCount);
+			}, ThreadPool::Priority::High);
+		}
+		s_axParallelMix.tasks.Wait();
+		// mix into buses
+		for (sint32 busIndex = 0; busIndex < AX_BUS_COUNT; busIndex++)
+		{
+			s_axParallelMix.tasks.Run([busIndex, voiceCount, sampleCount]()
+			{
+				for (sint32 i = 0; i < voiceCount; i++)
+					AXVoiceMix_MixIntoTVBus(s_axParallelMix.voices[i], s_axParallelMix.sampleData[i], sampleCount, sampleCount, busIndex);
+			}, ThreadPool::Priority::High);
+			s_axParallelMix.tasks.Run([busIndex, voiceCount, sampleCount]()
+			{
+				for (sint32 i = 0; i < voiceCount; i++)
+					AXVoiceMix_MixIntoDRCBus(s_axParallelMix.voices[i], s_axParallelMix.sampleData[i], sampleCount, sampleCount, busIndex);
+			}, ThreadPool::Priority::High);
+		}
+		s_axParallelMix.tasks.Wait();
+	}
+
 	void AXMix_ProcessVoices(AXVPBInternal_t* firstVoice)
 	{
 		if (firstVoice == nullptr)
 			return;
 		size_t sampleCount = AXGetInputSamplesPerFrame();
-		AXVPBInternal_t* internalVoice = firstVoice;
 		cemu_assert_debug(sndGeneric.initParam.frameLength == 0);
+		if (ThreadPool::GetWorkerCount() > 1)
+		{
+			sint32 voiceCount = 0;
+			for (AXVPBInternal_t* internalVoice = firstVoice; internalVoice && voiceCount < AX_MAX_VOICES; internalVoice = internalVoice->nextToProcess.GetPtr())
+				s_axParallelMix.voices[voiceCount++] = internalVoice;
+			bool isListComplete = s_axParallelMix.voices[voiceCount - 1]->nextToProcess.GetPtr() == nullptr;
+			if (voiceCount >= AX_PARALLEL_MIX_MIN_VOICES && isListComplete)
+			{
+				AXMix_ProcessVoicesParallel(voiceCount, (sint32)sampleCount);
+				return;
+			}
+		}
+		AXVPBInternal_t* internalVoice = firstVoice;
 		float tmpSampleBuffer[AX_SAMPLES_MAX];
 		while (internalVoice)
 		{
-			AXVoiceMix_DecodeSamples(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_ApplyADSR(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_ApplyBiquad(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_ApplyLowPass(internalVoice, tmpSampleBuffer, sampleCount);
+			AXVoiceMix_ProcessVoice(internalVoice, tmpSampleBuffer, sampleCount);
 			AXVoiceMix_MixIntoBuses(internalVoice, tmpSampleBuffer, sampleCount, sampleCount);
 			// next
 			internalVoice = internalVoice->nextToProcess.GetPtr();
@@ -893,14 +854,7 @@ namespace snd_core
 		else
 		{
 			// no delta
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				float s = *input;
-				input++;
-				s *= volumeF;
-				*output = _swapEndianS32(_swapEndianS32(*output) + (sint32)s);
-				output++;
-			}
+			AXMix_MixIntoS32BE(input, output, sampleCount, volumeF);
 		}
 	}
 
@@ -0,0 +1,502 @@
+#include "Cafe/OS/libs/snd_core/ax.h"
+#include "Cafe/OS/libs/snd_core/ax_internal.h"
+#include "Common/cpu_features.h"
+
+#if defined(ARCH_X86_64) && defined(__GNUC__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Vectorized sample conversion, resampling and mixing kernels used by the voice mixer (ax_mix.cpp)
+// All variants produce the same results as the scalar code. Float operations are applied in the same order and volume ramps are accumulated sequentially before they are applied
+
+namespace snd_core
+{
+	// returns the sample at ptr[0] in the lower 16 bit and ptr[1] in the upper 16 bit
+	FORCE_INLINE sint32 _AXMix_loadSamplePair(const sint16* ptr)
+	{
+		uint32 v;
+		memcpy(&v, ptr, sizeof(uint32));
+		return (sint32)v;
+	}
+
+	/* scalar */
+
+	void AXMix_ConvertPCM16_Scalar(const uint16* input, sint16* output, sint32 count)
+	{
+		for (sint32 i = 0; i < count; i++)
+			output[i] = _swapEndianS16(input[i]);
+	}
+
+	void AXMix_ConvertPCM8_Scalar(const sint8* input, sint16* output, sint32 count)
+	{
+		for (sint32 i = 0; i < count; i++)
+			output[i] = (sint16)((sint32)input[i] << 8);
+	}
+
+	void AXMix_ResampleLinear_Scalar(const sint16* input, float* output, sint32 count, uint32 fracPos, uint32 ratio)
+	{
+		for (sint32 i = 0; i < count; i++)
+		{
+			fracPos += ratio;
+			uint32 sampleIndex = fracPos >> 16;
+			sint32 frac = (sint32)(fracPos & 0xFFFF);
+			sint32 p0 = (sint32)input[sampleIndex] * (0x10000 - frac);
+			sint32 p1 = (sint32)input[sampleIndex + 1] * frac;
+			p0 >>= 7;
+			p1 >>= 7;
+			output[i] = (float)((p0 + p1) >> 1);
+		}
+	}
+
+	template<bool TRamp>
+	void AXMix_MixInto_Scalar(const float* input, float* output, sint32 count, const float* volumeRamp, float volume)
+	{
+		for (sint32 i = 0; i < count; i++)
+			output[i] += input[i] * (TRamp ? volumeRamp[i] : volume);
+	}
+
+	void AXMix_MixIntoS32BE_Scalar(const float* input, sint32* output, sint32 count, float volume)
+	{
+		for (sint32 i = 0; i < count; i++)
+			output[i] = _swapEndianS32(_swapEndianS32(output[i]) + (sint32)(input[i] * volume));
+	}
+
+	template<bool TRamp, bool TClamp>
+	void AXMix_Scale_Scalar(float* data, sint32 count, const float* volumeRamp, float volume)
+	{
+		for (sint32 i = 0; i < count; i++)
+		{
+			float s = data[i] * (TRamp ? volumeRamp[i] : volume);
+			if constexpr (TClamp)
+			{
+				if (s > AX_MIX_CLAMP_MAX)
+					s = AX_MIX_CLAMP_MAX;
+				else if (s < AX_MIX_CLAMP_MIN)
+					s = AX_MIX_CLAMP_MIN;
+			}
+			data[i] = s;
+		}
+	}
+
+#if defined(ARCH_X86_64)
+
+	/* SSE */
+
+	ATTRIBUTE_SSE41
+	void AXMix_ConvertPCM16_SSE41(const uint16* input, sint16* output, sint32 count)
+	{
+		const __m128i mShuffle16Swap = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+		sint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i mSamples = _mm_loadu_si128((const __m128i*)(input + i));
+			_mm_storeu_si128((__m128i*)(output + i), _mm_shuffle_epi8(mSamples, mShuffle16Swap));
+		}
+		AXMix_ConvertPCM16_Scalar(input + i, output + i, count - i);
+	}
+
+	void AXMix_ConvertPCM8_SSE2(const sint8* input, sint16* output, sint32 count)
+	{
+		// interleaving with zero bytes places each sample in the upper half of a 16bit word, which is the same as shifting left by 8
+		const __m128i mZero = _mm_setzero_si128();
+		sint32 i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i mSamples = _mm_loadu_si128((const __m128i*)(input + i));
+			_mm_storeu_si128((__m128i*)(output + i + 0), _mm_unpacklo_epi8(mZero, mSamples));
+			_mm_storeu_si128((__m128i*)(output + i + 8), _mm_unpackhi_epi8(mZero, mSamples));
+		}
+		AXMix_ConvertPCM8_Scalar(input + i, output + i, count - i);
+	}
+
+	ATTRIBUTE_SSE41
+	void AXMix_ResampleLinear_SSE41(const sint16* input, float* output, sint32 count, uint32 fracPos, uint32 ratio)
+	{
+		const __m128i mFracMask = _mm_set1_epi32(0xFFFF);
+		const __m128i mOne = _mm_set1_epi32(0x10000);
+		const __m128i mPosStep = _mm_set1_epi32((sint32)(ratio * 4));
+		__m128i mPos = _mm_add_epi32(_mm_set1_epi32((sint32)fracPos), _mm_mullo_epi32(_mm_set1_epi32((sint32)ratio), _mm_setr_epi32(1, 2, 3, 4)));
+		alignas(16) uint32 sampleIndex[4];
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_store_si128((__m128i*)sampleIndex, _mm_srli_epi32(mPos, 16));
+			__m128i mPair = _mm_setr_epi32(_AXMix_loadSamplePair(input + sampleIndex[0]), _AXMix_loadSamplePair(input + sampleIndex[1]), _AXMix_loadSamplePair(input + sampleIndex[2]), _AXMix_loadSamplePair(input + sampleIndex[3]));
+			__m128i mFrac = _mm_and_si128(mPos, mFracMask);
+			__m128i mCur = _mm_srai_epi32(_mm_slli_epi32(mPair, 16), 16);
+			__m128i mNext = _mm_srai_epi32(mPair, 16);
+			__m128i mP0 = _mm_srai_epi32(_mm_mullo_epi32(mCur, _mm_sub_epi32(mOne, mFrac)), 7);
+			__m128i mP1 = _mm_srai_epi32(_mm_mullo_epi32(mNext, mFrac), 7);
+			_mm_storeu_ps(output + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_add_epi32(mP0, mP1), 1)));
+			mPos = _mm_add_epi32(mPos, mPosStep);
+		}
+		AXMix_ResampleLinear_Scalar(input, output + i, count - i, fracPos + ratio * (uint32)i, ratio);
+	}
+
+	template<bool TRamp>
+	void AXMix_MixInto_SSE(const float* input, float* output, sint32 count, const float* volumeRamp, float volume)
+	{
+		__m128 mVolume = _mm_set1_ps(volume);
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			if constexpr (TRamp)
+				mVolume = _mm_loadu_ps(volumeRamp + i);
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(_mm_loadu_ps(input + i), mVolume)));
+		}
+		AXMix_MixInto_Scalar<TRamp>(input + i, output + i, count - i, TRamp ? volumeRamp + i : nullptr, volume);
+	}
+
+	ATTRIBUTE_SSE41
+	void AXMix_MixIntoS32BE_SSE41(const float* input, sint32* output, sint32 count, float volume)
+	{
+		const __m128i mShuffle32Swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		const __m128 mVolume = _mm_set1_ps(volume);
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i mOutput = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(output + i)), mShuffle32Swap);
+			__m128i mInput = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(input + i), mVolume));
+			_mm_storeu_si128((__m128i*)(output + i), _mm_shuffle_epi8(_mm_add_epi32(mOutput, mInput), mShuffle32Swap));
+		}
+		AXMix_MixIntoS32BE_Scalar(input + i, output + i, count - i, volume);
+	}
+
+	template<bool TRamp, bool TClamp>
+	void AXMix_Scale_SSE(float* data, sint32 count, const float* volumeRamp, float volume)
+	{
+		const __m128 mClampMax = _mm_set1_ps(AX_MIX_CLAMP_MAX);
+		const __m128 mClampMin = _mm_set1_ps(AX_MIX_CLAMP_MIN);
+		__m128 mVolume = _mm_set1_ps(volume);
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			if constexpr (TRamp)
+				mVolume = _mm_loadu_ps(volumeRamp + i);
+			__m128 mSamples = _mm_mul_ps(_mm_loadu_ps(data + i), mVolume);
+			if constexpr (TClamp)
+				mSamples = _mm_max_ps(_mm_min_ps(mSamples, mClampMax), mClampMin);
+			_mm_storeu_ps(data + i, mSamples);
+		}
+		AXMix_Scale_Scalar<TRamp, TClamp>(data + i, count - i, TRamp ? volumeRamp + i : nullptr, volume);
+	}
+
+	/* AVX2 */
+
+	ATTRIBUTE_AVX2
+	void AXMix_ConvertPCM16_AVX2(const uint16* input, sint16* output, sint32 count)
+	{
+		const __m256i mShuffle16Swap = _mm256_set_epi8(30, 31, 28, 29, 26, 27, 24, 25, 22, 23, 20, 21, 18, 19, 16, 17, 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+		sint32 i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m256i mSamples = _mm256_loadu_si256((const __m256i*)(input + i));
+			_mm256_storeu_si256((__m256i*)(output + i), _mm256_shuffle_epi8(mSamples, mShuffle16Swap));
+		}
+		AXMix_ConvertPCM16_SSE41(input + i, output + i, count - i);
+	}
+
+	ATTRIBUTE_AVX2
+	void AXMix_ResampleLinear_AVX2(const sint16* input, float* output, sint32 count, uint32 fracPos, uint32 ratio)
+	{
+		const __m256i mFracMask = _mm256_set1_epi32(0xFFFF);
+		const __m256i mOne = _mm256_set1_epi32(0x10000);
+		const __m256i mPosStep = _mm256_set1_epi32((sint32)(ratio * 8));
+		__m256i mPos = _mm256_add_epi32(_mm256_set1_epi32((sint32)fracPos), _mm256_mullo_epi32(_mm256_set1_epi32((sint32)ratio), _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8)));
+		sint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			// a 32bit gather with a scale of 2 fetches each sample together with its successor
+			__m256i mPair = _mm256_i32gather_epi32((const int*)input, _mm256_srli_epi32(mPos, 16), 2);
+			__m256i mFrac = _mm256_and_si256(mPos, mFracMask);
+			__m256i mCur = _mm256_srai_epi32(_mm256_slli_epi32(mPair, 16), 16);
+			__m256i mNext = _mm256_srai_epi32(mPair, 16);
+			__m256i mP0 = _mm256_srai_epi32(_mm256_mullo_epi32(mCur, _mm256_sub_epi32(mOne, mFrac)), 7);
+			__m256i mP1 = _mm256_srai_epi32(_mm256_mullo_epi32(mNext, mFrac), 7);
+			_mm256_storeu_ps(output + i, _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_add_epi32(mP0, mP1), 1)));
+			mPos = _mm256_add_epi32(mPos, mPosStep);
+		}
+		AXMix_ResampleLinear_Scalar(input, output + i, count - i, fracPos + ratio * (uint32)i, ratio);
+	}
+
+	template<bool TRamp>
+	ATTRIBUTE_AVX2
+	void AXMix_MixInto_AVX2(const float* input, float* output, sint32 count, const float* volumeRamp, float volume)
+	{
+		__m256 mVolume = _mm256_set1_ps(volume);
+		sint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			if constexpr (TRamp)
+				mVolume = _mm256_loadu_ps(volumeRamp + i);
+			_mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(output + i), _mm256_mul_ps(_mm256_loadu_ps(input + i), mVolume)));
+		}
+		AXMix_MixInto_SSE<TRamp>(input + i, output + i, count - i, TRamp ? volumeRamp + i : nullptr, volume);
+	}
+
+	ATTRIBUTE_AVX2
+	void AXMix_MixIntoS32BE_AVX2(const float* input, sint32* output, sint32 count, float volume)
+	{
+		const __m256i mShuffle32Swap = _mm256_set_epi8(28, 29, 30, 31, 24, 25, 26, 27, 20, 21, 22, 23, 16, 17, 18, 19, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		const __m256 mVolume = _mm256_set1_ps(volume);
+		sint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i mOutput = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(output + i)), mShuffle32Swap);
+			__m256i mInput = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(input + i), mVolume));
+			_mm256_storeu_si256((__m256i*)(output + i), _mm256_shuffle_epi8(_mm256_add_epi32(mOutput, mInput), mShuffle32Swap));
+		}
+		AXMix_MixIntoS32BE_SSE41(input + i, output + i, count - i, volume);
+	}
+
+	template<bool TRamp, bool TClamp>
+	ATTRIBUTE_AVX2
+	void AXMix_Scale_AVX2(float* data, sint32 count, const float* volumeRamp, float volume)
+	{
+		const __m256 mClampMax = _mm256_set1_ps(AX_MIX_CLAMP_MAX);
+		const __m256 mClampMin = _mm256_set1_ps(AX_MIX_CLAMP_MIN);
+		__m256 mVolume = _mm256_set1_ps(volume);
+		sint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			if constexpr (TRamp)
+				mVolume = _mm256_loadu_ps(volumeRamp + i);
+			__m256 mSamples = _mm256_mul_ps(_mm256_loadu_ps(data + i), mVolume);
+			if constexpr (TClamp)
+				mSamples = _mm256_max_ps(_mm256_min_ps(mSamples, mClampMax), mClampMin);
+			_mm256_storeu_ps(data + i, mSamples);
+		}
+		AXMix_Scale_SSE<TRamp, TClamp>(data + i, count - i, TRamp ? volumeRamp + i : nullptr, volume);
+	}
+
+#elif defined(__aarch64__)
+
+	/* NEON */
+
+	void AXMix_ConvertPCM16_NEON(const uint16* input, sint16* output, sint32 count)
+	{
+		sint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x16_t samples = vld1q_u8((const uint8*)(input + i));
+			vst1q_u8((uint8*)(output + i), vrev16q_u8(samples));
+		}
+		AXMix_ConvertPCM16_Scalar(input + i, output + i, count - i);
+	}
+
+	void AXMix_ConvertPCM8_NEON(const sint8* input, sint16* output, sint32 count)
+	{
+		sint32 i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			int8x16_t samples = vld1q_s8(input + i);
+			vst1q_s16(output + i + 0, vshll_n_s8(vget_low_s8(samples), 8));
+			vst1q_s16(output + i + 8, vshll_n_s8(vget_high_s8(samples), 8));
+		}
+		AXMix_ConvertPCM8_Scalar(input + i, output + i, count - i);
+	}
+
+	void AXMix_ResampleLinear_NEON(const sint16* input, float* output, sint32 count, uint32 fracPos, uint32 ratio)
+	{
+		static const uint32 s_laneStep[4] = { 1, 2, 3, 4 };
+		const uint32x4_t posStep = vdupq_n_u32(ratio * 4);
+		const int32x4_t one = vdupq_n_s32(0x10000);
+		uint32x4_t pos = vmlaq_n_u32(vdupq_n_u32(fracPos), vld1q_u32(s_laneStep), ratio);
+		uint32 sampleIndex[4];
+		sint32 samplePair[4];
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			vst1q_u32(sampleIndex, vshrq_n_u32(pos, 16));
+			samplePair[0] = _AXMix_loadSamplePair(input + sampleIndex[0]);
+			samplePair[1] = _AXMix_loadSamplePair(input + sampleIndex[1]);
+			samplePair[2] = _AXMix_loadSamplePair(input + sampleIndex[2]);
+			samplePair[3] = _AXMix_loadSamplePair(input + sampleIndex[3]);
+			int32x4_t pair = vld1q_s32(samplePair);
+			int32x4_t frac = vreinterpretq_s32_u32(vandq_u32(pos, vdupq_n_u32(0xFFFF)));
+			int32x4_t cur = vshrq_n_s32(vshlq_n_s32(pair, 16), 16);
+			int32x4_t next = vshrq_n_s32(pair, 16);
+			int32x4_t p0 = vshrq_n_s32(vmulq_s32(cur, vsubq_s32(one, frac)), 7);
+			int32x4_t p1 = vshrq_n_s32(vmulq_s32(next, frac), 7);
+			vst1q_f32(output + i, vcvtq_f32_s32(vshrq_n_s32(vaddq_s32(p0, p1), 1)));
+			pos = vaddq_u32(pos, posStep);
+		}
+		AXMix_ResampleLinear_Scalar(input, output + i, count - i, fracPos + ratio * (uint32)i, ratio);
+	}
+
+	template<bool TRamp>
+	void AXMix_MixInto_NEON(const float* input, float* output, sint32 count, const float* volumeRamp, float volume)
+	{
+		float32x4_t vol = vdupq_n_f32(volume);
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			if constexpr (TRamp)
+				vol = vld1q_f32(volumeRamp + i);
+			vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vmulq_f32(vld1q_f32(input + i), vol)));
+		}
+		AXMix_MixInto_Scalar<TRamp>(input + i, output + i, count - i, TRamp ? volumeRamp + i : nullptr, volume);
+	}
+
+	void AXMix_MixIntoS32BE_NEON(const float* input, sint32* output, sint32 count, float volume)
+	{
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			int32x4_t out = vreinterpretq_s32_u8(vrev32q_u8(vld1q_u8((const uint8*)(output + i))));
+			int32x4_t in = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(input + i), volume));
+			vst1q_u8((uint8*)(output + i), vrev32q_u8(vreinterpretq_u8_s32(vaddq_s32(out, in))));
+		}
+		AXMix_MixIntoS32BE_Scalar(input + i, output + i, count - i, volume);
+	}
+
+	template<bool TRamp, bool TClamp>
+	void AXMix_Scale_NEON(float* data, sint32 count, const float* volumeRamp, float volume)
+	{
+		const float32x4_t clampMax = vdupq_n_f32(AX_MIX_CLAMP_MAX);
+		const float32x4_t clampMin = vdupq_n_f32(AX_MIX_CLAMP_MIN);
+		float32x4_t vol = vdupq_n_f32(volume);
+		sint32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			if constexpr (TRamp)
+				vol = vld1q_f32(volumeRamp + i);
+			float32x4_t samples = vmulq_f32(vld1q_f32(data + i), vol);
+			if constexpr (TClamp)
+				samples = vmaxq_f32(vminq_f32(samples, clampMax), clampMin);
+			vst1q_f32(data + i, samples);
+		}
+		AXMix_Scale_Scalar<TRamp, TClamp>(data + i, count - i, TRamp ? volumeRamp + i : nullptr, volume);
+	}
+
+#endif
+
+	/* dispatch */
+
+	void AXMix_ConvertPCM16(const uint16* input, sint16* output, sint32 count)
+	{
+#if defined(ARCH_X86_64)
+		if (g_CPUFeatures.x86.avx2)
+			AXMix_ConvertPCM16_AVX2(input, output, count);
+		else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+			AXMix_ConvertPCM16_SSE41(input, output, count);
+		else
+			AXMix_ConvertPCM16_Scalar(input, output, count);
+#elif defined(__aarch64__)
+		AXMix_ConvertPCM16_NEON(input, output, count);
+#else
+		AXMix_ConvertPCM16_Scalar(input, output, count);
+#endif
+	}
+
+	void AXMix_ConvertPCM8(const sint8* input, sint16* output, sint32 count)
+	{
+#if defined(ARCH_X86_64)
+		AXMix_ConvertPCM8_SSE2(input, output, count);
+#elif defined(__aarch64__)
+		AXMix_ConvertPCM8_NEON(input, output, count);
+#else
+		AXMix_ConvertPCM8_Scalar(input, output, count);
+#endif
+	}
+
+	void AXMix_ResampleLinear(const sint16* input, float* output, sint32 count, uint32 fracPos, uint32 ratio)
+	{
+#if defined(ARCH_X86_64)
+		if (g_CPUFeatures.x86.avx2)
+			AXMix_ResampleLinear_AVX2(input, output, count, fracPos, ratio);
+		else if (g_CPUFeatures.x86.sse4_1)
+			AXMix_ResampleLinear_SSE41(input, output, count, fracPos, ratio);
+		else
+			AXMix_ResampleLinear_Scalar(input, output, count, fracPos, ratio);
+#elif defined(__aarch64__)
+		AXMix_ResampleLinear_NEON(input, output, count, fracPos, ratio);
+#else
+		AXMix_ResampleLinear_Scalar(input, output, count, fracPos, ratio);
+#endif
+	}
+
+	template<bool TRamp>
+	void _AXMix_MixInto(const float* input, float* output, sint32 count, const float* volumeRamp, float volume)
+	{
+#if defined(ARCH_X86_64)
+		if (g_CPUFeatures.x86.avx2)
+			AXMix_MixInto_AVX2<TRamp>(input, output, count, volumeRamp, volume);
+		else
+			AXMix_MixInto_SSE<TRamp>(input, output, count, volumeRamp, volume);
+#elif defined(__aarch64__)
+		AXMix_MixInto_NEON<TRamp>(input, output, count, volumeRamp, volume);
+#else
+		AXMix_MixInto_Scalar<TRamp>(input, output, count, volumeRamp, volume);
+#endif
+	}
+
+	void AXMix_MixInto(const float* input, float* output, sint32 count, float volume)
+	{
+		_AXMix_MixInto<false>(input, output, count, nullptr, volume);
+	}
+
+	void AXMix_MixIntoRamp(const float* input, float* output, sint32 count, const float* volumeRamp)
+	{
+		_AXMix_MixInto<true>(input, output, count, volumeRamp, 0.0f);
+	}
+
+	void AXMix_MixIntoS32BE(const float* input, sint32* output, sint32 count, float volume)
+	{
+#if defined(ARCH_X86_64)
+		if (g_CPUFeatures.x86.avx2)
+			AXMix_MixIntoS32BE_AVX2(input, output, count, volume);
+		else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+			AXMix_MixIntoS32BE_SSE41(input, output, count, volume);
+		else
+			AXMix_MixIntoS32BE_Scalar(input, output, count, volume);
+#elif defined(__aarch64__)
+		AXMix_MixIntoS32BE_NEON(input, output, count, volume);
+#else
+		AXMix_MixIntoS32BE_Scalar(input, output, count, volume);
+#endif
+	}
+
+	template<bool TRamp, bool TClamp>
+	void _AXMix_Scale(float* data, sint32 count, const float* volumeRamp, float volume)
+	{
+#if defined(ARCH_X86_64)
+		if (g_CPUFeatures.x86.avx2)
+			AXMix_Scale_AVX2<TRamp, TClamp>(data, count, volumeRamp, volume);
+		else
+			AXMix_Scale_SSE<TRamp, TClamp>(data, count, volumeRamp, volume);
+#elif defined(__aarch64__)
+		AXMix_Scale_NEON<TRamp, TClamp>(data, count, volumeRamp, volume);
+#else
+		AXMix_Scale_Scalar<TRamp, TClamp>(data, count, volumeRamp, volume);
+#endif
+	}
+
+	void AXMix_Scale(float* data, sint32 count, float volume, bool clamp)
+	{
+		if (clamp)
+			_AXMix_Scale<false, true>(data, count, nullptr, volume);
+		else
+			_AXMix_Scale<false, false>(data, count, nullptr, volume);
+	}
+
+	void AXMix_ScaleRamp(float* data, sint32 count, const float* volumeRamp, bool clamp)
+	{
+		if (clamp)
+			_AXMix_Scale<true, true>(data, count, volumeRamp, 0.0f);
+		else
+			_AXMix_Scale<true, false>(data, count, volumeRamp, 0.0f);
+	}
+
+	float AXMix_GenerateVolumeRamp(float* volumeRamp, sint32 count, float volume, float delta)
+	{
+		for (sint32 i = 0; i < count; i++)
+		{
+			volume += delta;
+			volumeRamp[i] = volume;
+		}
+		return volume;
+	}
+}
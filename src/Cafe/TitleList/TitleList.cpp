@@ -25,6 +25,8 @@ std::thread sTLRefreshWorker;
 bool sTLRefreshWorkerActive{false};
 std::atomic_uint32_t sTLRefreshRequests{};
 std::atomic_bool sTLIsScanMandatory{ false };
+std::vector<std::function<void()>> sTLScanJobs; // parsing of discovered titles, deferred until the directory scan is done
+constexpr uint32 TL_SCAN_MAX_THREADS = 4;
 
 // callback list
 struct TitleListCallbackEntry 
@@ -256,6 +258,26 @@ void CafeTitleList::AddTitleFromPath(fs::path path)
 		delete titleInfo;
 }
 
+// parsing titles mostly waits on disk I/O, so this runs on a few dedicated threads instead of the shared thread pool
+static void _RunScanJobs()
+{
+	std::atomic_size_t nextJobIndex{0};
+	auto scanThread = [&nextJobIndex]()
+	{
+		SetThreadName("TitleListScan");
+		size_t jobIndex;
+		while ((jobIndex = nextJobIndex.fetch_add(1)) < sTLScanJobs.size())
+			sTLScanJobs[jobIndex]();
+	};
+	std::vector<std::thread> threads;
+	uint32 threadCount = (uint32)std::min<size_t>(sTLScanJobs.size(), TL_SCAN_MAX_THREADS);
+	for (uint32 i = 0; i < threadCount; i++)
+		threads.emplace_back(scanThread);
+	for (auto& thread : threads)
+		thread.join();
+	sTLScanJobs.clear();
+}
+
 bool CafeTitleList::RefreshWorkerThread()
 {
 	SetThreadName("TitleListWorker");
@@ -288,6 +310,7 @@ bool CafeTitleList::RefreshWorkerThread()
 			ScanMLCPath(mlcPath / "sys/title/00050030");
 		}
 
+		_RunScanJobs();
 		// remove any titles that are still pending
 		for (auto& itPending : sTLListPending)
 		{
@@ -380,17 +403,20 @@ void CafeTitleList::ScanGamePath(const fs::path& path)
 			continue;
 		if (!_IsKnownFileNameOrExtension(it))
 			continue;
-		AddTitleFromPath(it);
+		sTLScanJobs.emplace_back([filePath = it]() { AddTitleFromPath(filePath); });
 	}
 	// is the current directory a title folder?
 	if (hasContentFolder && hasCodeFolder && hasMetaFolder)
 	{
 		// verify if this folder is a valid title
-		TitleInfo* titleInfo = new TitleInfo(path);
-		if (titleInfo->IsValid())
-			AddDiscoveredTitle(titleInfo);
-		else
-			delete titleInfo;
+		sTLScanJobs.emplace_back([path]()
+		{
+			TitleInfo* titleInfo = new TitleInfo(path);
+			if (titleInfo->IsValid())
+				AddDiscoveredTitle(titleInfo);
+			else
+				delete titleInfo;
+		});
 		// if there are other folders besides content/code/meta then traverse those
 		if (dirsInDirectory.size() > 3)
 		{
@@ -440,11 +466,14 @@ void CafeTitleList::ScanMLCPath(const fs::path& path)
 			fs::is_directory(it.path() / "content", ec) &&
 			fs::is_directory(it.path() / "meta", ec))
 		{
-			TitleInfo* titleInfo = new TitleInfo(it);
-			if (titleInfo->IsValid() && titleInfo->ParseXmlInfo())
-				AddDiscoveredTitle(titleInfo);
-			else
-				delete titleInfo;
+			sTLScanJobs.emplace_back([titlePath = it.path()]()
+			{
+				TitleInfo* titleInfo = new TitleInfo(titlePath);
+				if (titleInfo->IsValid() && titleInfo->ParseXmlInfo())
+					AddDiscoveredTitle(titleInfo);
+				else
+					delete titleInfo;
+			});
 		}
 	}
 }
@@ -6,78 +6,12 @@
 #include "zlib.h"
 #include "Common/FileStream.h"
 
-struct FileCacheAsyncJob
-{
-	FileCache* fileCache;
-	uint64 name1;
-	uint64 name2;
-	std::vector<uint8> fileData;
-};
-
-struct _FileCacheAsyncWriter
-{
-	_FileCacheAsyncWriter()
-	{
-		m_isRunning.store(true);
-		m_fileCacheThread = std::thread(&_FileCacheAsyncWriter::FileCacheThread, this);
-	}
-
-	~_FileCacheAsyncWriter()
-	{
-		if (m_isRunning.load())
-		{
-			m_isRunning.store(false);
-			m_fileCacheCondVar.notify_one();
-			m_fileCacheThread.join();
-		}
-	}
-
-	void AddJob(FileCache* fileCache, const FileCache::FileName& name, const uint8* fileData, sint32 fileSize)
-	{
-		FileCacheAsyncJob async;
-		async.fileCache = fileCache;
-		async.name1 = name.name1;
-		async.name2 = name.name2;
-		async.fileData = { fileData, fileData + fileSize };
-
-		std::unique_lock lock(m_fileCacheMutex);
-		m_writeRequests.emplace_back(std::move(async));
-
-		lock.unlock();
-		m_fileCacheCondVar.notify_one();
-	}
-
-private:
-	void FileCacheThread()
-	{
-		SetThreadName("fileCache");
-		while (true)
-		{
-			std::unique_lock lock(m_fileCacheMutex);
-			while (m_writeRequests.empty())
-			{
-				m_fileCacheCondVar.wait(lock);
-				if (!m_isRunning.load(std::memory_order::relaxed))
-					return;
-			}
-
-			std::vector<FileCacheAsyncJob> requestsCopy;
-			requestsCopy.swap(m_writeRequests); // fast copy & clear
-			lock.unlock();
-
-			for (const auto& entry : requestsCopy)
-			{
-				entry.fileCache->AddFile({ entry.name1, entry.name2 }, entry.fileData.data(), (sint32)entry.fileData.size());
-			}
-		}
-	}
-
-	std::thread m_fileCacheThread;
-	std::mutex m_fileCacheMutex;
-	std::condition_variable m_fileCacheCondVar;
-	std::vector<FileCacheAsyncJob> m_writeRequests;
-	std::atomic_bool m_isRunning;
-}FileCacheAsyncWriter;
+#if !BOOST_OS_WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #define FILECACHE_MAGIC_V1					0x8371b694 // used prior to Cemu 1.7.4, only supported caches up to 4GB
 #define FILECACHE_MAGIC_V2					0x8371b695 // added support for large caches
@@ -120,13 +54,14 @@ FileCache* FileCache::Create(const fs::path& path, uint32 extraVersion)
 	// write file table
 	fs->SetPosition(fileCache->dataOffset+fileCache->fileTableOffset);
 	fs->writeData(fileCache->fileTableEntries, fileCache->fileTableSize);
+	fileCache->_rebuildFileIndex();
 	// done
 	return fileCache;
 }
 
-FileCache* FileCache::_OpenExisting(const fs::path& path, bool compareExtraVersion, uint32 extraVersion)
+FileCache* FileCache::_OpenExisting(const fs::path& path, bool compareExtraVersion, uint32 extraVersion, bool readOnly)
 {
-	FileStream* fs = FileStream::openFile2(path, true);
+	FileStream* fs = FileStream::openFile2(path, !readOnly);
 	if (!fs)
 		return nullptr;
 	// read header
@@ -216,6 +151,13 @@ FileCache* FileCache::_OpenExisting(const fs::path& path, bool compareExtraVersi
 		delete fileCache;
 		return nullptr;
 	}
+	fileCache->_rebuildFileIndex();
+	if (readOnly && !fileCache->_mapFile(path))
+	{
+		cemuLog_log(LogType::Force, "Failed to map cache file \"{}\"", _pathToUtf8(path));
+		delete fileCache;
+		return nullptr;
+	}
 	return fileCache;
 }
 
@@ -234,15 +176,109 @@ FileCache* FileCache::Open(const fs::path& path)
 	return _OpenExisting(path, false, 0);
 }
 
+FileCache* FileCache::OpenReadOnly(const fs::path& path, uint32 extraVersion)
+{
+	return _OpenExisting(path, true, extraVersion, true);
+}
+
 FileCache::~FileCache()
 {
+	asyncWriteTask.Wait();
+	_unmapFile();
 	free(this->fileTableEntries);
 	delete fileStream;
 }
 
+bool FileCache::_mapFile(const fs::path& path)
+{
+#if BOOST_OS_WINDOWS
+	HANDLE hFile = CreateFileW(path.generic_wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!hMapping)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+	mappedFileHandle = hFile;
+	mappedMappingHandle = hMapping;
+	mappedData = (const uint8*)view;
+	mappedSize = (uint64)fileSize.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+		return false;
+	mappedData = (const uint8*)view;
+	mappedSize = (uint64)fileStat.st_size;
+#endif
+	return true;
+}
+
+void FileCache::_unmapFile()
+{
+	if (!mappedData)
+		return;
+#if BOOST_OS_WINDOWS
+	UnmapViewOfFile(mappedData);
+	CloseHandle((HANDLE)mappedMappingHandle);
+	CloseHandle((HANDLE)mappedFileHandle);
+	mappedMappingHandle = nullptr;
+	mappedFileHandle = nullptr;
+#else
+	munmap((void*)mappedData, (size_t)mappedSize);
+#endif
+	mappedData = nullptr;
+	mappedSize = 0;
+}
+
+void FileCache::_rebuildFileIndex()
+{
+	fileIndex.clear();
+	fileIndex.reserve(this->fileTableEntryCount);
+	for (sint32 i = 0; i < this->fileTableEntryCount; i++)
+	{
+		if (this->fileTableEntries[i].name1 == FILECACHE_FILETABLE_FREE_NAME && this->fileTableEntries[i].name2 == FILECACHE_FILETABLE_FREE_NAME)
+			continue;
+		fileIndex.try_emplace({ this->fileTableEntries[i].name1, this->fileTableEntries[i].name2 }, i);
+	}
+}
+
+sint32 FileCache::_findEntryIndex(uint64 name1, uint64 name2)
+{
+	auto it = fileIndex.find({ name1, name2 });
+	if (it == fileIndex.end())
+		return -1;
+	return it->second;
+}
+
 void FileCache::fileCache_updateFiletable(sint32 extraEntriesToAllocate)
 {
 	// recreate file table with bigger size (optional)
+	fileIndex.erase({ FILECACHE_FILETABLE_NAME1, FILECACHE_FILETABLE_NAME2 });
 	this->fileTableEntries[0].name1 = FILECACHE_FILETABLE_FREE_NAME;
 	this->fileTableEntries[0].name2 = FILECACHE_FILETABLE_FREE_NAME;
 	sint32 newFileTableEntryCount = this->fileTableEntryCount + extraEntriesToAllocate;
@@ -336,6 +372,11 @@ void FileCache::_addFileInternal(uint64 name1, uint64 name2, const uint8* fileDa
 {
 	if (fileSize < 0)
 		return;
+	if (IsReadOnly())
+	{
+		cemu_assert_debug(false);
+		return;
+	}
 	if (!enableCompression)
 		noCompression = true;
 	// compress data
@@ -363,16 +404,8 @@ void FileCache::_addFileInternal(uint64 name1, uint64 name2, const uint8* fileDa
 	}
 	std::unique_lock lock(this->mutex);
 	// find free entry in file table
-	sint32 entryIndex = -1;
-	// scan for already existing entry
-	for (sint32 i = 0; i < this->fileTableEntryCount; i++)
-	{
-		if (this->fileTableEntries[i].name1 == name1 && this->fileTableEntries[i].name2 == name2)
-		{
-			entryIndex = i;
-			break;
-		}
-	}
+	// check for already existing entry first
+	sint32 entryIndex = _findEntryIndex(name1, name2);
 	if (entryIndex == -1)
 	{
 		while (true)
@@ -459,6 +492,7 @@ void FileCache::_addFileInternal(uint64 name1, uint64 name2, const uint8* fileDa
 	this->fileTableEntries[entryIndex].extraReserved1 = 0;
 	this->fileTableEntries[entryIndex].extraReserved2 = 0;
 	this->fileTableEntries[entryIndex].extraReserved3 = 0;
+	fileIndex.insert_or_assign({ name1, name2 }, entryIndex);
 	// write file data
 	fileStream->SetPosition(this->dataOffset + currentStartOffset);
 	fileStream->writeData(rawData, rawSize);
@@ -484,35 +518,95 @@ bool FileCache::DeleteFile(const FileName&& name)
 {
 	if( name.name1 == FILECACHE_FILETABLE_NAME1 && name.name2 == FILECACHE_FILETABLE_NAME2 )
 		return false; // prevent filetable from being deleted
-	std::unique_lock lock(this->mutex);
-	FileTableEntry* entry = this->fileTableEntries;
-	FileTableEntry* entryLast = this->fileTableEntries+this->fileTableEntryCount;
-	while( entry < entryLast )
+	if (IsReadOnly())
 	{
-		if( entry->name1 == name.name1 && entry->name2 == name.name2 )
+		cemu_assert_debug(false);
+		return false;
+	}
+	std::unique_lock lock(this->mutex);
+	sint32 entryIndex = _findEntryIndex(name.name1, name.name2);
+	if (entryIndex < 0)
+		return false;
+	FileTableEntry* entry = this->fileTableEntries + entryIndex;
+	entry->name1 = FILECACHE_FILETABLE_FREE_NAME;
+	entry->name2 = FILECACHE_FILETABLE_FREE_NAME;
+	entry->fileOffset = 0;
+	entry->fileSize = 0;
+	fileIndex.erase({ name.name1, name.name2 });
+	// a duplicate entry with the same name may exist further down the table
+	for (sint32 i = entryIndex + 1; i < this->fileTableEntryCount; i++)
+	{
+		if (this->fileTableEntries[i].name1 == name.name1 && this->fileTableEntries[i].name2 == name.name2)
 		{
-			entry->name1 = FILECACHE_FILETABLE_FREE_NAME;
-			entry->name2 = FILECACHE_FILETABLE_FREE_NAME;
-			entry->fileOffset = 0;
-			entry->fileSize = 0;
-			// store updated entry to file cache
-			size_t entryIndex = entry - this->fileTableEntries;
-			fileStream->SetPosition(this->dataOffset+this->fileTableOffset+(uint64)(sizeof(FileTableEntry)*entryIndex));
-			fileStream->writeData(this->fileTableEntries+entryIndex, sizeof(FileTableEntry));
-			return true;
+			fileIndex.emplace(std::make_pair(name.name1, name.name2), i);
+			break;
 		}
-		entry++;
 	}
-	return false;
+	// store updated entry to file cache
+	fileStream->SetPosition(this->dataOffset+this->fileTableOffset+(uint64)(sizeof(FileTableEntry)*entryIndex));
+	fileStream->writeData(this->fileTableEntries+entryIndex, sizeof(FileTableEntry));
+	return true;
 }
 
 void FileCache::AddFileAsync(const FileName& name, const uint8* fileData, sint32 fileSize)
 {
-	FileCacheAsyncWriter.AddJob(this, name, fileData, fileSize);
+	std::unique_lock lock(asyncWriteMutex);
+	asyncWriteQueue.emplace_back(AsyncWriteJob{ name.name1, name.name2, { fileData, fileData + fileSize } });
+	if (asyncWriteScheduled)
+		return;
+	asyncWriteScheduled = true;
+	lock.unlock();
+	asyncWriteTask.Run([this]()
+	{
+		std::unique_lock lock(asyncWriteMutex);
+		while (!asyncWriteQueue.empty())
+		{
+			std::vector<AsyncWriteJob> requests;
+			requests.swap(asyncWriteQueue);
+			lock.unlock();
+			for (const auto& entry : requests)
+				AddFile({ entry.name1, entry.name2 }, entry.fileData.data(), (sint32)entry.fileData.size());
+			lock.lock();
+		}
+		asyncWriteScheduled = false;
+	}, ThreadPool::Priority::Low);
+}
+
+bool FileCache::_getMappedFileData(const FileTableEntry* entry, std::span<const uint8>& dataOut)
+{
+	cemu_assert_debug(mappedData);
+	uint64 offset = this->dataOffset + entry->fileOffset;
+	if (offset > mappedSize || entry->fileSize > mappedSize - offset)
+	{
+		cemuLog_log(LogType::Force, "FileCache: Entry exceeds size of the cache file");
+		return false;
+	}
+	dataOut = { mappedData + offset, entry->fileSize };
+	return true;
 }
 
 bool FileCache::_getFileDataInternal(const FileTableEntry* entry, std::vector<uint8>& dataOut)
 {
+	if (IsReadOnly())
+	{
+		std::span<const uint8> mappedFileData;
+		if (!_getMappedFileData(entry, mappedFileData))
+		{
+			dataOut.clear();
+			return false;
+		}
+		if ((entry->flags&FileTableEntry::FLAG_COMPRESSED) == 0)
+		{
+			dataOut.assign(mappedFileData.begin(), mappedFileData.end());
+			return true;
+		}
+		if (!_uncompressFileData(mappedFileData.data(), mappedFileData.size(), dataOut))
+		{
+			dataOut.clear();
+			return false;
+		}
+		return true;
+	}
 	std::vector<uint8> rawData(entry->fileSize);
 
 	fileStream->SetPosition(this->dataOffset + entry->fileOffset);
@@ -534,21 +628,58 @@ bool FileCache::_getFileDataInternal(const FileTableEntry* entry, std::vector<ui
 	return true;
 }
 
+// in read-only mode the file table and index never change, so lookups don't need to lock
 bool FileCache::GetFile(const FileName&& name, std::vector<uint8>& dataOut)
 {
-	std::unique_lock lock(this->mutex);
-	FileTableEntry* entry = this->fileTableEntries;
-	FileTableEntry* entryLast = this->fileTableEntries+this->fileTableEntryCount;
-	while( entry < entryLast )
+	std::unique_lock lock(this->mutex, std::defer_lock);
+	if (!IsReadOnly())
+		lock.lock();
+	sint32 entryIndex = _findEntryIndex(name.name1, name.name2);
+	if (entryIndex < 0)
 	{
-		if( entry->name1 == name.name1 && entry->name2 == name.name2 )
-		{
-			return _getFileDataInternal(entry, dataOut);
-		}
-		entry++;
+		dataOut.clear();
+		return false;
+	}
+	return _getFileDataInternal(this->fileTableEntries + entryIndex, dataOut);
+}
+
+bool FileCache::GetFileView(const FileName&& name, std::span<const uint8>& viewOut)
+{
+	if (!IsReadOnly())
+	{
+		cemu_assert_debug(false);
+		return false;
 	}
-	dataOut.clear();
-	return false;
+	sint32 entryIndex = _findEntryIndex(name.name1, name.name2);
+	if (entryIndex < 0)
+		return false;
+	const FileTableEntry* entry = this->fileTableEntries + entryIndex;
+	if ((entry->flags&FileTableEntry::FLAG_COMPRESSED) != 0)
+		return false;
+	return _getMappedFileData(entry, viewOut);
+}
+
+bool FileCache::GetFileViewByIndex(sint32 index, uint64* name1, uint64* name2, std::span<const uint8>& viewOut)
+{
+	if (!IsReadOnly())
+	{
+		cemu_assert_debug(false);
+		return false;
+	}
+	if (index < 0 || index >= this->fileTableEntryCount)
+		return false;
+	const FileTableEntry* entry = this->fileTableEntries + index;
+	if (entry->name1 == FILECACHE_FILETABLE_FREE_NAME && entry->name2 == FILECACHE_FILETABLE_FREE_NAME)
+		return false;
+	if (entry->name1 == FILECACHE_FILETABLE_NAME1 && entry->name2 == FILECACHE_FILETABLE_NAME2)
+		return false;
+	if ((entry->flags&FileTableEntry::FLAG_COMPRESSED) != 0)
+		return false;
+	if(name1)
+		*name1 = entry->name1;
+	if(name2)
+		*name2 = entry->name2;
+	return _getMappedFileData(entry, viewOut);
 }
 
 bool FileCache::GetFileByIndex(sint32 index, uint64* name1, uint64* name2, std::vector<uint8>& dataOut)
@@ -566,7 +697,9 @@ bool FileCache::GetFileByIndex(sint32 index, uint64* name1, uint64* name2, std::
 	if (entry->name1 == FILECACHE_FILETABLE_NAME1 && entry->name2 == FILECACHE_FILETABLE_NAME2)
 		return false;
 
-	std::unique_lock lock(this->mutex);
+	std::unique_lock lock(this->mutex, std::defer_lock);
+	if (!IsReadOnly())
+		lock.lock();
 	if(name1)
 		*name1 = entry->name1;
 	if(name2)
@@ -576,16 +709,10 @@ bool FileCache::GetFileByIndex(sint32 index, uint64* name1, uint64* name2, std::
 
 bool FileCache::HasFile(const FileName&& name)
 {
-	std::unique_lock lock(this->mutex);
-	FileTableEntry* entry = this->fileTableEntries;
-	FileTableEntry* entryLast = this->fileTableEntries + this->fileTableEntryCount;
-	while (entry < entryLast)
-	{
-		if (entry->name1 == name.name1 && entry->name2 == name.name2)
-			return true;
-		entry++;
-	}
-	return false;
+	std::unique_lock lock(this->mutex, std::defer_lock);
+	if (!IsReadOnly())
+		lock.lock();
+	return _findEntryIndex(name.name1, name.name2) >= 0;
 }
 
 sint32 FileCache::GetMaximumFileIndex()
@@ -595,7 +722,9 @@ sint32 FileCache::GetMaximumFileIndex()
 
 sint32 FileCache::GetFileCount()
 {
-	std::unique_lock lock(this->mutex);
+	std::unique_lock lock(this->mutex, std::defer_lock);
+	if (!IsReadOnly())
+		lock.lock();
 	sint32 fileCount = 0;
 	FileTableEntry* entry = this->fileTableEntries;
 	FileTableEntry* entryLast = this->fileTableEntries+this->fileTableEntryCount;
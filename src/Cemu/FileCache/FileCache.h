@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mutex>
+#include "util/ThreadPool/ThreadPool.h"
 
 class FileCache
 {
@@ -38,6 +39,8 @@ public:
 	static FileCache* Create(const fs::path& path, uint32 extraVersion = 0);
 	static FileCache* Open(const fs::path& path, bool allowCreate, uint32 extraVersion = 0);
 	static FileCache* Open(const fs::path& path); // open without extraVersion check
+	// open an existing cache as a read-only memory mapped file. Lookups do not lock and can be done from any number of threads in parallel
+	static FileCache* OpenReadOnly(const fs::path& path, uint32 extraVersion = 0);
 
 	void UseCompression(bool enable) { enableCompression = enable; };
 
@@ -47,6 +50,12 @@ public:
 	bool GetFile(const FileName&& name, std::vector<uint8>& dataOut);
 	bool GetFileByIndex(sint32 index, uint64* name1, uint64* name2, std::vector<uint8>& dataOut);
 	bool HasFile(const FileName&& name);
+	// zero-copy access to the data of an uncompressed file. Only available for caches opened with OpenReadOnly()
+	// the returned view stays valid until the FileCache is destroyed
+	bool GetFileView(const FileName&& name, std::span<const uint8>& viewOut);
+	bool GetFileViewByIndex(sint32 index, uint64* name1, uint64* name2, std::span<const uint8>& viewOut);
+
+	bool IsReadOnly() const { return mappedData != nullptr; }
 
 	sint32 GetFileCount();
 
@@ -74,11 +83,19 @@ private:
 
 	FileCache() {};
 
-	static FileCache* _OpenExisting(const fs::path& path, bool compareExtraVersion, uint32 extraVersion = 0);
+	static FileCache* _OpenExisting(const fs::path& path, bool compareExtraVersion, uint32 extraVersion = 0, bool readOnly = false);
+
+	bool _mapFile(const fs::path& path);
+	void _unmapFile();
 
 	void fileCache_updateFiletable(sint32 extraEntriesToAllocate);
 	void _addFileInternal(uint64 name1, uint64 name2, const uint8* fileData, sint32 fileSize, bool noCompression);
 	bool _getFileDataInternal(const FileTableEntry* entry, std::vector<uint8>& dataOut);
+	bool _getMappedFileData(const FileTableEntry* entry, std::span<const uint8>& dataOut);
+
+	// name to file table index lookup
+	void _rebuildFileIndex();
+	sint32 _findEntryIndex(uint64 name1, uint64 name2);
 
 	class FileStream* fileStream{};
 	uint64 dataOffset{};
@@ -89,8 +106,33 @@ private:
 	// file table (as stored in file)
 	uint64 fileTableOffset{};
 	uint32 fileTableSize{};
+	// hash index for the file table
+	struct FileIndexHash
+	{
+		size_t operator()(const std::pair<uint64, uint64>& name) const
+		{
+			return (size_t)(name.first ^ (name.second * 0x9E3779B97F4A7C15ull));
+		}
+	};
+	std::unordered_map<std::pair<uint64, uint64>, sint32, FileIndexHash> fileIndex;
 	// options
 	bool enableCompression{true};
+	// read-only mode (memory mapped)
+	const uint8* mappedData{};
+	uint64 mappedSize{};
+	void* mappedFileHandle{}; // only used on Windows
+	void* mappedMappingHandle{}; // only used on Windows
 
 	std::recursive_mutex mutex;
+	// asynchronous writes. Queued entries are written by a single task on the shared thread pool
+	struct AsyncWriteJob
+	{
+		uint64 name1;
+		uint64 name2;
+		std::vector<uint8> fileData;
+	};
+	std::mutex asyncWriteMutex;
+	std::vector<AsyncWriteJob> asyncWriteQueue;
+	bool asyncWriteScheduled{false};
+	ThreadPool::TaskGroup asyncWriteTask;
 };
@@ -30,6 +30,19 @@ inline void cpuidex(int cpuInfo[4], int functionId, int subFunctionId) {
 #error No definition for cpuidex
 #endif
 }
+
+// reads XCR0 to check which register states are enabled by the OS
+inline uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#elif defined(__GNUC__)
+	uint32_t eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((uint64_t)edx << 32) | eax;
+#else
+#error No definition for xgetbv
+#endif
+}
 #endif
 
 
@@ -61,9 +74,14 @@ CPUFeaturesImpl::CPUFeaturesImpl()
 	x86.aesni = ((cpuInfo[2] >> 25) & 1) != 0;
 	x86.ssse3 = ((cpuInfo[2] >> 9) & 1) != 0;
 	x86.sse4_1 = ((cpuInfo[2] >> 19) & 1) != 0;
+	const bool osxsave = ((cpuInfo[2] >> 27) & 1) != 0;
 	cpuidex(cpuInfo, 0x7, 0);
 	x86.avx2 = ((cpuInfo[1] >> 5) & 1) != 0;
 	x86.bmi2 = ((cpuInfo[1] >> 8) & 1) != 0;
+	// AVX-512 additionally requires the OS to save the opmask and ZMM register state (XCR0 bits 1, 2, 5, 6 and 7)
+	const bool avx512StateEnabled = osxsave && (xgetbv0() & 0xE6) == 0xE6;
+	x86.avx512f = avx512StateEnabled && ((cpuInfo[1] >> 16) & 1) != 0;
+	x86.avx512bw = avx512StateEnabled && ((cpuInfo[1] >> 30) & 1) != 0;
 	cpuid(cpuInfo, 0x80000007);
 	x86.invariant_tsc = ((cpuInfo[3] >> 8) & 1);
 	// get CPU brand name
@@ -106,6 +124,10 @@ std::string CPUFeaturesImpl::GetCommaSeparatedExtensionList()
 		appendExt("AVX");
 	if (x86.avx2)
 		appendExt("AVX2");
+	if (x86.avx512f)
+		appendExt("AVX512F");
+	if (x86.avx512bw)
+		appendExt("AVX512BW");
 	if (x86.lzcnt)
 		appendExt("LZCNT");
 	if (x86.movbe)
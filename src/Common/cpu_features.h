@@ -1,10 +1,12 @@
 #ifdef __GNUC__
 #define ATTRIBUTE_AVX2 __attribute__((target("avx2")))
 #define ATTRIBUTE_SSE41 __attribute__((target("sse4.1")))
+#define ATTRIBUTE_AVX512BW __attribute__((target("avx512f,avx512bw")))
 #define ATTRIBUTE_AESNI __attribute__((target("aes")))
 #else
 #define ATTRIBUTE_AVX2
 #define ATTRIBUTE_SSE41
+#define ATTRIBUTE_AVX512BW
 #define ATTRIBUTE_AESNI
 #endif
 
@@ -24,6 +26,8 @@ public:
 		bool sse4_1{ false };
 		bool avx{ false };
 		bool avx2{ false };
+		bool avx512f{ false };
+		bool avx512bw{ false };
 		bool lzcnt{ false };
 		bool movbe{ false };
 		bool bmi2{ false };
@@ -1,6 +1,164 @@
 #include "Common/unix/FileStream_unix.h"
 #include <cstdarg>
 
+#if BOOST_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// index of directories which were searched for case-insensitive matches
+// each directory is scanned once and its entries are stored by lowercase name. The directory is then watched via inotify to keep the index in sync with the host filesystem
+class PathCIIndex
+{
+	static constexpr size_t MAX_DIRECTORIES = 4096; // stay well below the default inotify watch limit
+
+	struct Directory
+	{
+		int watchDescriptor;
+		std::unordered_map<std::string, std::string> entries; // lowercase name -> actual name
+	};
+
+public:
+	~PathCIIndex()
+	{
+		if (m_inotifyFd >= 0)
+			close(m_inotifyFd);
+	}
+
+	// returns false if the directory cannot be indexed, in which case the caller has to fall back to scanning it
+	// otherwise matchOut is set to the actual name of the entry or left empty if no entry matches
+	bool Lookup(const fs::path& dirPath, const std::string& name, std::string& matchOut)
+	{
+		std::unique_lock _l(m_mutex);
+		if (m_inotifyFd < 0)
+		{
+			if (m_initFailed)
+				return false;
+			m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (m_inotifyFd < 0)
+			{
+				m_initFailed = true;
+				return false;
+			}
+		}
+		ProcessEvents();
+		auto it = m_directories.find(dirPath.native());
+		if (it == m_directories.end())
+		{
+			it = AddDirectory(dirPath);
+			if (it == m_directories.end())
+				return false;
+		}
+		auto entryIt = it->second.entries.find(boost::algorithm::to_lower_copy(name));
+		if (entryIt != it->second.entries.end())
+			matchOut = entryIt->second;
+		else
+			matchOut.clear();
+		return true;
+	}
+
+private:
+	std::unordered_map<std::string, Directory>::iterator AddDirectory(const fs::path& dirPath)
+	{
+		if (m_directories.size() >= MAX_DIRECTORIES)
+			Clear();
+		// start watching before the scan so that no modification is missed
+		int wd = inotify_add_watch(m_inotifyFd, dirPath.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+		if (wd < 0)
+			return m_directories.end();
+		if (m_watchToDirectory.contains(wd))
+			return m_directories.end(); // same directory reached via a different path. Not worth handling
+		Directory dir;
+		dir.watchDescriptor = wd;
+		std::error_code listErr;
+		for (auto&& dirEntry : fs::directory_iterator(dirPath, listErr))
+			AddEntry(dir, dirEntry.path().filename().string());
+		if (listErr)
+		{
+			inotify_rm_watch(m_inotifyFd, wd);
+			return m_directories.end();
+		}
+		m_watchToDirectory.emplace(wd, dirPath.native());
+		return m_directories.emplace(dirPath.native(), std::move(dir)).first;
+	}
+
+	static void AddEntry(Directory& dir, const std::string& name)
+	{
+		dir.entries.try_emplace(boost::algorithm::to_lower_copy(name), name); // on case-only collisions the first entry wins, same as with a directory scan
+	}
+
+	void RemoveDirectory(int wd)
+	{
+		auto it = m_watchToDirectory.find(wd);
+		if (it == m_watchToDirectory.end())
+			return;
+		inotify_rm_watch(m_inotifyFd, wd);
+		m_directories.erase(it->second);
+		m_watchToDirectory.erase(it);
+	}
+
+	void Clear()
+	{
+		for (auto& it : m_watchToDirectory)
+			inotify_rm_watch(m_inotifyFd, it.first);
+		m_watchToDirectory.clear();
+		m_directories.clear();
+	}
+
+	// apply all pending modification events to the index
+	void ProcessEvents()
+	{
+		alignas(inotify_event) char buffer[4096];
+		while (true)
+		{
+			ssize_t len = read(m_inotifyFd, buffer, sizeof(buffer));
+			if (len <= 0)
+				break;
+			for (char* ptr = buffer; ptr < buffer + len;)
+			{
+				const inotify_event* ev = (const inotify_event*)ptr;
+				ptr += sizeof(inotify_event) + ev->len;
+				if (ev->mask & IN_Q_OVERFLOW)
+				{
+					Clear();
+					continue;
+				}
+				auto it = m_watchToDirectory.find(ev->wd);
+				if (it == m_watchToDirectory.end())
+					continue;
+				if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+				{
+					RemoveDirectory(ev->wd);
+					continue;
+				}
+				if (ev->len == 0)
+					continue;
+				Directory& dir = m_directories[it->second];
+				std::string name(ev->name);
+				if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					AddEntry(dir, name);
+				}
+				else if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					// another entry which only differs in case may still exist, rescan the directory on next access
+					auto entryIt = dir.entries.find(boost::algorithm::to_lower_copy(name));
+					if (entryIt != dir.entries.end() && entryIt->second == name)
+						RemoveDirectory(ev->wd);
+				}
+			}
+		}
+	}
+
+	std::mutex m_mutex;
+	int m_inotifyFd{-1};
+	bool m_initFailed{false};
+	std::unordered_map<std::string, Directory> m_directories; // key is the host path of the directory
+	std::unordered_map<int, std::string> m_watchToDirectory;
+};
+
+static PathCIIndex s_pathCIIndex;
+#endif
+
 fs::path findPathCI(const fs::path& path)
 {
 	if (fs::exists(path)) return path;
@@ -12,6 +170,12 @@ fs::path findPathCI(const fs::path& path)
 	else if (!fs::exists(parentPath))
 		parentPath = findPathCI(parentPath);
 
+#if BOOST_OS_LINUX
+	std::string match;
+	if (s_pathCIIndex.Lookup(parentPath, fName.string(), match))
+		return match.empty() ? (parentPath / fName) : (parentPath / match);
+#endif
+
 	std::error_code listErr;
 	for (auto&& dirEntry : fs::directory_iterator(parentPath, listErr))
 		if (boost::iequals(dirEntry.path().filename().string(), fName.string()))
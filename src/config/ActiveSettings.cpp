@@ -106,6 +106,16 @@ bool ActiveSettings::WaitForGX2DrawDoneEnabled()
 	return GetConfig().gx2drawdone_sync;
 }
 
+bool ActiveSettings::PageWriteTrackingEnabled()
+{
+	return GetConfig().page_write_tracking;
+}
+
+bool ActiveSettings::GPUCommandPreDecodingEnabled()
+{
+	return GetConfig().gpu_command_predecoding;
+}
+
 GraphicAPI ActiveSettings::GetGraphicsAPI()
 {
 	const GraphicAPI api = g_current_game_profile->GetGraphicsAPI().value_or(GetConfig().graphic_api);
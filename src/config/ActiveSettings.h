@@ -92,6 +92,8 @@ public:
 	[[nodiscard]] static PrecompiledShaderOption GetPrecompiledShadersOption();
 	[[nodiscard]] static bool RenderUpsideDownEnabled();
 	[[nodiscard]] static bool WaitForGX2DrawDoneEnabled();
+	[[nodiscard]] static bool PageWriteTrackingEnabled();
+	[[nodiscard]] static bool GPUCommandPreDecodingEnabled();
 	[[nodiscard]] static GraphicAPI GetGraphicsAPI();
 
 	// gamma
@@ -414,6 +414,14 @@ wxPanel* GeneralSettings2::AddGraphicsPage(wxNotebook* notebook)
 		m_gx2drawdone_sync->SetToolTip(_("If synchronization is requested by the game, the emulated CPU will wait for the GPU to finish all operations.\nThis is more accurate behavior, but may cause lower performance"));
 		graphic_misc_row->Add(m_gx2drawdone_sync, 0, wxALL, 5);
 
+		m_page_write_tracking = new wxCheckBox(box, wxID_ANY, _("Page write tracking"));
+		m_page_write_tracking->SetToolTip(_("Uses memory page protection to detect CPU writes to textures and buffers instead of hashing their data every frame.\nCan improve performance in games with many textures. Experimental, takes effect on the next title launch"));
+		graphic_misc_row->Add(m_page_write_tracking, 0, wxALL, 5);
+
+		m_gpu_command_predecoding = new wxCheckBox(box, wxID_ANY, _("GPU command pre-decoding"));
+		m_gpu_command_predecoding->SetToolTip(_("Parses the GPU command stream on a separate thread ahead of execution, so the GPU thread only has to run the decoded commands.\nCan improve performance in games which are limited by the GPU thread. Experimental, takes effect on the next title launch"));
+		graphic_misc_row->Add(m_gpu_command_predecoding, 0, wxALL, 5);
+
 #ifdef ENABLE_METAL
 		m_force_mesh_shaders = new wxCheckBox(box, wxID_ANY, _("Force mesh shaders"));
 		m_force_mesh_shaders->SetToolTip(_("Force mesh shaders on all GPUs that support them. Mesh shaders are disabled by default on Intel GPUs due to potential stability issues.\nMetal only"));
@@ -1270,6 +1278,8 @@ void GeneralSettings2::StoreConfig()
 	config.force_mesh_shaders = m_force_mesh_shaders->IsChecked();
 #endif
 	config.async_compile = m_async_compile->IsChecked();
+	config.page_write_tracking = m_page_write_tracking->IsChecked();
+	config.gpu_command_predecoding = m_gpu_command_predecoding->IsChecked();
 
 	config.overlay.position = (ScreenPosition)m_overlay_position->GetSelection(); wxASSERT((int)config.overlay.position <= (int)ScreenPosition::kBottomRight);
 	config.overlay.text_color = m_overlay_font_color->GetColour().GetRGBA();
@@ -1918,6 +1928,8 @@ void GeneralSettings2::ApplyConfig()
 	}
 	m_async_compile->SetValue(config.async_compile);
 	m_gx2drawdone_sync->SetValue(config.gx2drawdone_sync);
+	m_page_write_tracking->SetValue(config.page_write_tracking);
+	m_gpu_command_predecoding->SetValue(config.gpu_command_predecoding);
 #ifdef ENABLE_METAL
 	m_force_mesh_shaders->SetValue(config.force_mesh_shaders);
 #endif
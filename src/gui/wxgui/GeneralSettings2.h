@@ -72,7 +72,7 @@ private:
 	wxSpinCtrlDouble* m_userDisplayGamma;
 	wxCheckBox* m_userDisplayisSRGB;
 
-	wxCheckBox *m_async_compile, *m_gx2drawdone_sync;
+	wxCheckBox *m_async_compile, *m_gx2drawdone_sync, *m_page_write_tracking, *m_gpu_command_predecoding;
 #ifdef ENABLE_METAL
 	wxCheckBox *m_force_mesh_shaders;
 #endif
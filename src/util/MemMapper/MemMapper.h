@@ -21,4 +21,7 @@ namespace MemMapper
 
 	void* AllocateMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags, bool fromReservation = false);
 	void FreeMemory(void* baseAddr, size_t size, bool fromReservation = false);
+
+	// change the permissions of already committed pages
+	bool ProtectMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags);
 };
\ No newline at end of file
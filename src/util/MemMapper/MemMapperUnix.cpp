@@ -67,4 +67,9 @@ namespace MemMapper
 			munmap(baseAddr, size);
 	}
 
+	bool ProtectMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags)
+	{
+		return mprotect(baseAddr, size, GetProt(permissionFlags)) == 0;
+	}
+
 };
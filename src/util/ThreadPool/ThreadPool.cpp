@@ -0,0 +1,239 @@
+#include "ThreadPool.h"
+#include "util/helpers/helpers.h"
+#include "util/helpers/fspinlock.h"
+
+#if BOOST_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+static struct
+{
+	uint32 threadCount{0};
+	bool pinToCores{false};
+	std::atomic_bool isStarted{false};
+}s_threadPoolConfig;
+
+class ThreadPoolExecutor
+{
+	struct Worker
+	{
+		FSpinlock lock;
+		std::deque<std::function<void()>> queue[ThreadPool::PRIORITY_COUNT];
+		std::thread thread;
+	};
+
+public:
+	ThreadPoolExecutor()
+	{
+		uint32 threadCount = s_threadPoolConfig.threadCount;
+		if (threadCount == 0)
+			threadCount = std::max<uint32>(std::thread::hardware_concurrency(), 2);
+		m_workers.resize(threadCount);
+		for (auto& it : m_workers)
+			it = std::make_unique<Worker>();
+		for (uint32 i = 0; i < threadCount; i++)
+			m_workers[i]->thread = std::thread(&ThreadPoolExecutor::WorkerThread, this, i);
+	}
+
+	~ThreadPoolExecutor()
+	{
+		{
+			std::unique_lock _l(m_sleepMutex);
+			m_stopRequested = true;
+			m_sleepCondVar.notify_all();
+		}
+		for (auto& it : m_workers)
+			it->thread.join();
+	}
+
+	void Submit(std::function<void()>&& task, ThreadPool::Priority priority)
+	{
+		// tasks submitted by a worker go to its own deque, others are distributed round-robin
+		uint32 workerIndex = (s_currentWorkerIndex >= 0 && s_currentExecutor == this) ? (uint32)s_currentWorkerIndex : (m_nextWorkerIndex.fetch_add(1, std::memory_order_relaxed) % (uint32)m_workers.size());
+		Worker& worker = *m_workers[workerIndex];
+		worker.lock.lock();
+		worker.queue[(size_t)priority].emplace_back(std::move(task));
+		worker.lock.unlock();
+		m_numQueuedTasks.fetch_add(1);
+		if (m_numSleepingWorkers.load() > 0)
+		{
+			std::unique_lock _l(m_sleepMutex);
+			m_sleepCondVar.notify_one();
+		}
+	}
+
+	uint32 GetWorkerCount() const
+	{
+		return (uint32)m_workers.size();
+	}
+
+	bool IsWorkerThread() const
+	{
+		return s_currentExecutor == this;
+	}
+
+private:
+	// own deque is served from the back, other deques are stolen from the front
+	// all deques are drained by priority, so a high priority task on another worker is preferred over a low priority task on our own
+	bool TryGetTask(sint32 selfIndex, std::function<void()>& taskOut)
+	{
+		const uint32 workerCount = (uint32)m_workers.size();
+		for (size_t p = 0; p < ThreadPool::PRIORITY_COUNT; p++)
+		{
+			if (selfIndex >= 0)
+			{
+				Worker& self = *m_workers[selfIndex];
+				self.lock.lock();
+				if (!self.queue[p].empty())
+				{
+					taskOut = std::move(self.queue[p].back());
+					self.queue[p].pop_back();
+					self.lock.unlock();
+					m_numQueuedTasks.fetch_sub(1);
+					return true;
+				}
+				self.lock.unlock();
+			}
+			const uint32 startIndex = selfIndex >= 0 ? (uint32)selfIndex + 1 : 0;
+			for (uint32 i = 0; i < workerCount; i++)
+			{
+				Worker& victim = *m_workers[(startIndex + i) % workerCount];
+				if (&victim == (selfIndex >= 0 ? m_workers[selfIndex].get() : nullptr))
+					continue;
+				victim.lock.lock();
+				if (!victim.queue[p].empty())
+				{
+					taskOut = std::move(victim.queue[p].front());
+					victim.queue[p].pop_front();
+					victim.lock.unlock();
+					m_numQueuedTasks.fetch_sub(1);
+					return true;
+				}
+				victim.lock.unlock();
+			}
+		}
+		return false;
+	}
+
+	void WorkerThread(uint32 workerIndex)
+	{
+		SetThreadName(fmt::format("ThreadPool{}", workerIndex).c_str());
+		if (s_threadPoolConfig.pinToCores)
+			PinToCore(workerIndex % std::max<uint32>(std::thread::hardware_concurrency(), 1));
+		s_currentExecutor = this;
+		s_currentWorkerIndex = (sint32)workerIndex;
+		std::function<void()> task;
+		while (true)
+		{
+			if (TryGetTask((sint32)workerIndex, task))
+			{
+				task();
+				task = nullptr;
+				continue;
+			}
+			std::unique_lock _l(m_sleepMutex);
+			if (m_stopRequested && m_numQueuedTasks.load() <= 0)
+				break;
+			m_numSleepingWorkers++;
+			m_sleepCondVar.wait(_l, [this] { return m_numQueuedTasks.load() > 0 || m_stopRequested; });
+			m_numSleepingWorkers--;
+		}
+		s_currentExecutor = nullptr;
+		s_currentWorkerIndex = -1;
+	}
+
+	static void PinToCore(uint32 coreIndex)
+	{
+#if BOOST_OS_WINDOWS
+		SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (coreIndex % (sizeof(DWORD_PTR) * 8)));
+#elif BOOST_OS_LINUX
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(coreIndex, &cpuSet);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+#endif
+	}
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::atomic<uint32> m_nextWorkerIndex{0};
+	std::atomic<sint32> m_numQueuedTasks{0}; // may be briefly negative since tasks can be taken before the submitter increments it
+	std::atomic<sint32> m_numSleepingWorkers{0};
+	std::mutex m_sleepMutex;
+	std::condition_variable m_sleepCondVar;
+	bool m_stopRequested{false};
+
+	static inline thread_local ThreadPoolExecutor* s_currentExecutor{nullptr};
+	static inline thread_local sint32 s_currentWorkerIndex{-1};
+};
+
+static ThreadPoolExecutor& GetThreadPoolExecutor()
+{
+	static ThreadPoolExecutor s_executor;
+	s_threadPoolConfig.isStarted = true;
+	return s_executor;
+}
+
+void ThreadPool::Submit(std::function<void()> task, Priority priority)
+{
+	GetThreadPoolExecutor().Submit(std::move(task), priority);
+}
+
+void ThreadPool::Configure(uint32 threadCount, bool pinToCores)
+{
+	cemu_assert_debug(!s_threadPoolConfig.isStarted);
+	s_threadPoolConfig.threadCount = threadCount;
+	s_threadPoolConfig.pinToCores = pinToCores;
+}
+
+uint32 ThreadPool::GetWorkerCount()
+{
+	return GetThreadPoolExecutor().GetWorkerCount();
+}
+
+bool ThreadPool::IsWorkerThread()
+{
+	return GetThreadPoolExecutor().IsWorkerThread();
+}
+
+void ThreadPool::TaskGroup::Run(std::function<void()> task, Priority priority)
+{
+	m_state->pendingTasks.fetch_add(1);
+	m_state->mutex.lock();
+	m_state->queue.emplace_back(std::move(task));
+	m_state->mutex.unlock();
+	// the handle does nothing if a waiting thread already took the task
+	ThreadPool::Submit([state = m_state]()
+	{
+		RunNextTask(*state);
+	}, priority);
+}
+
+// runs the oldest queued task of the group. Returns false if there was none
+bool ThreadPool::TaskGroup::RunNextTask(SharedState& state)
+{
+	std::unique_lock _l(state.mutex);
+	if (state.queue.empty())
+		return false;
+	std::function<void()> task = std::move(state.queue.front());
+	state.queue.pop_front();
+	_l.unlock();
+	task();
+	_l.lock();
+	if (state.pendingTasks.fetch_sub(1) == 1)
+		state.condVar.notify_all();
+	return true;
+}
+
+void ThreadPool::TaskGroup::Wait()
+{
+	SharedState& state = *m_state;
+	while (state.pendingTasks.load() != 0)
+	{
+		if (RunNextTask(state))
+			continue;
+		// remaining tasks are already running on other threads
+		std::unique_lock _l(state.mutex);
+		state.condVar.wait(_l, [&state] { return state.pendingTasks.load() == 0 || !state.queue.empty(); });
+	}
+}
@@ -1,15 +1,69 @@
+#pragma once
 #include <thread>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 
+// Shared work-stealing executor
+// Every worker owns a set of deques (one per priority). Workers pop their own tasks LIFO and steal from the front of other workers' deques when idle
+// Tasks should be short and must not block for long periods of time. Use FireAndForget() for work that waits on I/O or other threads
 class ThreadPool
 {
 public:
+	enum class Priority : uint8
+	{
+		High = 0, // work the caller is likely to wait on soon
+		Normal = 1,
+		Low = 2, // background work like cache writes
+	};
+	static constexpr size_t PRIORITY_COUNT = 3;
+
+	// tracks a set of tasks which can be waited on
+	// the tasks are kept in a queue owned by the group and the pool only receives a handle which runs the next one of them
+	// this way a waiting thread can execute tasks of its own group, without picking up unrelated (and potentially long running) work
+	class TaskGroup
+	{
+	public:
+		TaskGroup() : m_state(std::make_shared<SharedState>()) {}
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+		~TaskGroup() { Wait(); }
+
+		void Run(std::function<void()> task, Priority priority = Priority::Normal);
+		// blocks until all tasks of the group have finished. The calling thread helps executing the group's queued tasks in the meantime
+		void Wait();
+		bool IsDone() const { return m_state->pendingTasks.load() == 0; }
+
+	private:
+		// outlives the group as long as there are handles left in the pool
+		struct SharedState
+		{
+			std::atomic<uint32> pendingTasks{0};
+			std::mutex mutex;
+			std::condition_variable condVar;
+			std::deque<std::function<void()>> queue;
+		};
+
+		static bool RunNextTask(SharedState& state);
+
+		std::shared_ptr<SharedState> m_state;
+	};
+
+	static void Submit(std::function<void()> task, Priority priority = Priority::Normal);
+	// optional. Has to be called before the first task is submitted. A thread count of zero creates one worker per logical core
+	// with pinToCores each worker is bound to a single core (not supported on macOS)
+	static void Configure(uint32 threadCount, bool pinToCores);
+	static uint32 GetWorkerCount();
+	static bool IsWorkerThread();
+
+	// runs the function on a new detached thread
 	template<class TFunction, class... TArgs>
 	static void FireAndForget(TFunction&& f, TArgs&&... args)
 	{
-		// todo - find a way to use std::async here so we can utilize thread pooling?
 		std::thread t(std::forward<TFunction>(f), std::forward<TArgs>(args)...);
 		t.detach();
 	}
-
-
-};
\ No newline at end of file
+};
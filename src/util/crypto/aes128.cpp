@@ -12,6 +12,10 @@
 #include "aes128.h"
 #include "Common/cpu_features.h"
 
+#if defined(__aarch64__) && defined(__ARM_FEATURE_AES)
+#include <arm_neon.h>
+#endif
+
 /*****************************************************************************/
 /* Defines:                                                                  */
 /*****************************************************************************/
@@ -742,7 +746,60 @@ ATTRIBUTE_AESNI void AESNI128_CBC_decryptWithExpandedKey(const unsigned char *in
 		length = length / 16 + 1;
 	else length /= 16;
 	feedback = _mm_loadu_si128((__m128i*)ivec);
-	for (unsigned long i = 0; i < length; i++)
+	unsigned long i = 0;
+	// unlike encryption, CBC decryption has no dependency between blocks
+	// process 8 blocks at once so that the latency of AESDEC is hidden
+	for (; i + 8 <= length; i += 8)
+	{
+		__m128i c0 = _mm_loadu_si128(&((__m128i*)in)[i + 0]);
+		__m128i c1 = _mm_loadu_si128(&((__m128i*)in)[i + 1]);
+		__m128i c2 = _mm_loadu_si128(&((__m128i*)in)[i + 2]);
+		__m128i c3 = _mm_loadu_si128(&((__m128i*)in)[i + 3]);
+		__m128i c4 = _mm_loadu_si128(&((__m128i*)in)[i + 4]);
+		__m128i c5 = _mm_loadu_si128(&((__m128i*)in)[i + 5]);
+		__m128i c6 = _mm_loadu_si128(&((__m128i*)in)[i + 6]);
+		__m128i c7 = _mm_loadu_si128(&((__m128i*)in)[i + 7]);
+		__m128i roundKey = ((__m128i*)key)[10];
+		__m128i d0 = _mm_xor_si128(c0, roundKey);
+		__m128i d1 = _mm_xor_si128(c1, roundKey);
+		__m128i d2 = _mm_xor_si128(c2, roundKey);
+		__m128i d3 = _mm_xor_si128(c3, roundKey);
+		__m128i d4 = _mm_xor_si128(c4, roundKey);
+		__m128i d5 = _mm_xor_si128(c5, roundKey);
+		__m128i d6 = _mm_xor_si128(c6, roundKey);
+		__m128i d7 = _mm_xor_si128(c7, roundKey);
+		for (j = 9; j > 0; j--)
+		{
+			roundKey = ((__m128i*)key)[j];
+			d0 = _mm_aesdec_si128(d0, roundKey);
+			d1 = _mm_aesdec_si128(d1, roundKey);
+			d2 = _mm_aesdec_si128(d2, roundKey);
+			d3 = _mm_aesdec_si128(d3, roundKey);
+			d4 = _mm_aesdec_si128(d4, roundKey);
+			d5 = _mm_aesdec_si128(d5, roundKey);
+			d6 = _mm_aesdec_si128(d6, roundKey);
+			d7 = _mm_aesdec_si128(d7, roundKey);
+		}
+		roundKey = ((__m128i*)key)[0];
+		d0 = _mm_xor_si128(_mm_aesdeclast_si128(d0, roundKey), feedback);
+		d1 = _mm_xor_si128(_mm_aesdeclast_si128(d1, roundKey), c0);
+		d2 = _mm_xor_si128(_mm_aesdeclast_si128(d2, roundKey), c1);
+		d3 = _mm_xor_si128(_mm_aesdeclast_si128(d3, roundKey), c2);
+		d4 = _mm_xor_si128(_mm_aesdeclast_si128(d4, roundKey), c3);
+		d5 = _mm_xor_si128(_mm_aesdeclast_si128(d5, roundKey), c4);
+		d6 = _mm_xor_si128(_mm_aesdeclast_si128(d6, roundKey), c5);
+		d7 = _mm_xor_si128(_mm_aesdeclast_si128(d7, roundKey), c6);
+		_mm_storeu_si128(&((__m128i*)out)[i + 0], d0);
+		_mm_storeu_si128(&((__m128i*)out)[i + 1], d1);
+		_mm_storeu_si128(&((__m128i*)out)[i + 2], d2);
+		_mm_storeu_si128(&((__m128i*)out)[i + 3], d3);
+		_mm_storeu_si128(&((__m128i*)out)[i + 4], d4);
+		_mm_storeu_si128(&((__m128i*)out)[i + 5], d5);
+		_mm_storeu_si128(&((__m128i*)out)[i + 6], d6);
+		_mm_storeu_si128(&((__m128i*)out)[i + 7], d7);
+		feedback = c7;
+	}
+	for (; i < length; i++)
 	{
 		lastin = _mm_loadu_si128(&((__m128i*)in)[i]);
 		data = _mm_xor_si128(lastin, ((__m128i*)key)[10]);
@@ -794,6 +851,79 @@ ATTRIBUTE_AESNI void __aesni__AES128_ECB_encrypt(uint8* input, const uint8* key,
 }
 #endif
 
+#if defined(__aarch64__) && defined(__ARM_FEATURE_AES)
+// decryption round keys for the equivalent inverse cipher, derived from the encryption key schedule
+void ARMCE128_KeyExpansionDecrypt(const uint8* key, uint8x16_t* decKeys)
+{
+	aes128Ctx_t aesCtx;
+	KeyExpansion(&aesCtx, key);
+	decKeys[0] = vld1q_u8(aesCtx.RoundKey + 10 * 16);
+	for (sint32 i = 1; i < 10; i++)
+		decKeys[i] = vaesimcq_u8(vld1q_u8(aesCtx.RoundKey + (10 - i) * 16));
+	decKeys[10] = vld1q_u8(aesCtx.RoundKey);
+}
+
+void ARMCE128_CBC_decryptWithExpandedKey(const uint8* in, uint8* out, const uint8* ivec, uint32 length, const uint8x16_t* decKeys)
+{
+	uint32 numBlocks = length / 16;
+	uint8x16_t feedback = vld1q_u8(ivec);
+	uint32 i = 0;
+	// process 8 independent blocks at once to keep the AES pipeline busy, same as the AES-NI path
+	for (; i + 8 <= numBlocks; i += 8)
+	{
+		uint8x16_t c0 = vld1q_u8(in + (i + 0) * 16);
+		uint8x16_t c1 = vld1q_u8(in + (i + 1) * 16);
+		uint8x16_t c2 = vld1q_u8(in + (i + 2) * 16);
+		uint8x16_t c3 = vld1q_u8(in + (i + 3) * 16);
+		uint8x16_t c4 = vld1q_u8(in + (i + 4) * 16);
+		uint8x16_t c5 = vld1q_u8(in + (i + 5) * 16);
+		uint8x16_t c6 = vld1q_u8(in + (i + 6) * 16);
+		uint8x16_t c7 = vld1q_u8(in + (i + 7) * 16);
+		uint8x16_t d0 = c0, d1 = c1, d2 = c2, d3 = c3, d4 = c4, d5 = c5, d6 = c6, d7 = c7;
+		for (int r = 0; r < 9; r++)
+		{
+			uint8x16_t roundKey = decKeys[r];
+			d0 = vaesimcq_u8(vaesdq_u8(d0, roundKey));
+			d1 = vaesimcq_u8(vaesdq_u8(d1, roundKey));
+			d2 = vaesimcq_u8(vaesdq_u8(d2, roundKey));
+			d3 = vaesimcq_u8(vaesdq_u8(d3, roundKey));
+			d4 = vaesimcq_u8(vaesdq_u8(d4, roundKey));
+			d5 = vaesimcq_u8(vaesdq_u8(d5, roundKey));
+			d6 = vaesimcq_u8(vaesdq_u8(d6, roundKey));
+			d7 = vaesimcq_u8(vaesdq_u8(d7, roundKey));
+		}
+		vst1q_u8(out + (i + 0) * 16, veorq_u8(veorq_u8(vaesdq_u8(d0, decKeys[9]), decKeys[10]), feedback));
+		vst1q_u8(out + (i + 1) * 16, veorq_u8(veorq_u8(vaesdq_u8(d1, decKeys[9]), decKeys[10]), c0));
+		vst1q_u8(out + (i + 2) * 16, veorq_u8(veorq_u8(vaesdq_u8(d2, decKeys[9]), decKeys[10]), c1));
+		vst1q_u8(out + (i + 3) * 16, veorq_u8(veorq_u8(vaesdq_u8(d3, decKeys[9]), decKeys[10]), c2));
+		vst1q_u8(out + (i + 4) * 16, veorq_u8(veorq_u8(vaesdq_u8(d4, decKeys[9]), decKeys[10]), c3));
+		vst1q_u8(out + (i + 5) * 16, veorq_u8(veorq_u8(vaesdq_u8(d5, decKeys[9]), decKeys[10]), c4));
+		vst1q_u8(out + (i + 6) * 16, veorq_u8(veorq_u8(vaesdq_u8(d6, decKeys[9]), decKeys[10]), c5));
+		vst1q_u8(out + (i + 7) * 16, veorq_u8(veorq_u8(vaesdq_u8(d7, decKeys[9]), decKeys[10]), c6));
+		feedback = c7;
+	}
+	for (; i < numBlocks; i++)
+	{
+		uint8x16_t cipher = vld1q_u8(in + i * 16);
+		uint8x16_t plain = cipher;
+		for (int r = 0; r < 9; r++)
+			plain = vaesimcq_u8(vaesdq_u8(plain, decKeys[r]));
+		plain = veorq_u8(vaesdq_u8(plain, decKeys[9]), decKeys[10]);
+		vst1q_u8(out + i * 16, veorq_u8(plain, feedback));
+		feedback = cipher;
+	}
+}
+
+void __armce__AES128_CBC_decrypt(uint8* output, uint8* input, uint32 length, const uint8* key, const uint8* iv)
+{
+	uint8x16_t decKeys[11];
+	ARMCE128_KeyExpansionDecrypt(key, decKeys);
+	uint8 zeroIv[16] = { 0 };
+	ARMCE128_CBC_decryptWithExpandedKey(input, output, iv ? iv : zeroIv, length, decKeys);
+}
+
+#endif
+
 void(*AES128_ECB_encrypt)(uint8* input, const uint8* key, uint8* output);
 void (*AES128_CBC_decrypt)(uint8* output, uint8* input, uint32 length, const uint8* key, const uint8* iv) = nullptr;
 
@@ -850,8 +980,13 @@ void AES128_init()
 		AES128_CBC_decrypt = __soft__AES128_CBC_decrypt;
 		AES128_ECB_encrypt = __soft__AES128_ECB_encrypt;
 	}
+    #elif defined(__aarch64__) && defined(__ARM_FEATURE_AES)
+	// ARMv8 crypto extension
+	AES128_CBC_decrypt = __armce__AES128_CBC_decrypt;
+	AES128_ECB_encrypt = __soft__AES128_ECB_encrypt;
     #else
 	AES128_CBC_decrypt = __soft__AES128_CBC_decrypt;
 	AES128_ECB_encrypt = __soft__AES128_ECB_encrypt;
     #endif
 }
+